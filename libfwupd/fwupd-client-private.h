@@ -15,10 +15,18 @@
 void
 fwupd_client_download_bytes2_async(FwupdClient *self,
 				   GPtrArray *urls,
+				   const gchar *checksum,
 				   FwupdClientDownloadFlags flags,
 				   GCancellable *cancellable,
 				   GAsyncReadyCallback callback,
 				   gpointer callback_data) G_GNUC_NON_NULL(1, 2);
+void
+fwupd_client_download_checksums_async(FwupdClient *self,
+				      GPtrArray *urls,
+				      GPtrArray *checksums,
+				      GCancellable *cancellable,
+				      GAsyncReadyCallback callback,
+				      gpointer callback_data) G_GNUC_NON_NULL(1, 2, 3);
 
 #ifdef HAVE_GIO_UNIX
 void
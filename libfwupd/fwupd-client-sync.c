@@ -239,6 +239,102 @@ fwupd_client_get_plugins(FwupdClient *self, GCancellable *cancellable, GError **
 	return g_steal_pointer(&helper->array);
 }
 
+static void
+fwupd_client_get_plugin_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->val =
+	    fwupd_client_get_plugin_statistics_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_plugin_statistics:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets how long each plugin has spent enumerating devices.
+ *
+ * Returns: (transfer full): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_plugin_statistics(FwupdClient *self, GCancellable *cancellable, GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_plugin_statistics_async(self,
+						 cancellable,
+						 fwupd_client_get_plugin_statistics_cb,
+						 helper);
+	g_main_loop_run(helper->loop);
+	if (helper->val == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->val);
+}
+
+static void
+fwupd_client_get_engine_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->val =
+	    fwupd_client_get_engine_statistics_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_engine_statistics:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets statistics for the daemon, for instance the release cache hit ratio.
+ *
+ * Returns: (transfer full): a #GVariant of type `a{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_engine_statistics(FwupdClient *self, GCancellable *cancellable, GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_engine_statistics_async(self,
+						 cancellable,
+						 fwupd_client_get_engine_statistics_cb,
+						 helper);
+	g_main_loop_run(helper->loop);
+	if (helper->val == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->val);
+}
+
 static void
 fwupd_client_get_history_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -1298,6 +1394,60 @@ fwupd_client_get_host_security_events(FwupdClient *self,
 	return g_steal_pointer(&helper->array);
 }
 
+static void
+fwupd_client_get_host_security_statistics_cb(GObject *source,
+					     GAsyncResult *res,
+					     gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->val = fwupd_client_get_host_security_statistics_finish(FWUPD_CLIENT(source),
+								       res,
+								       &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_host_security_statistics:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets how long each device and plugin took to add the host security attributes.
+ *
+ * Returns: (transfer full): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_host_security_statistics(FwupdClient *self,
+					  GCancellable *cancellable,
+					  GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_host_security_statistics_async(
+	    self,
+	    cancellable,
+	    fwupd_client_get_host_security_statistics_cb,
+	    helper);
+	g_main_loop_run(helper->loop);
+	if (helper->val == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->val);
+}
+
 static void
 fwupd_client_get_device_by_id_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -2480,6 +2630,63 @@ fwupd_client_download_bytes(FwupdClient *self,
 	return g_steal_pointer(&helper->bytes);
 }
 
+static void
+fwupd_client_download_releases_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->ret =
+	    fwupd_client_download_releases_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_download_releases:
+ * @self: a #FwupdClient
+ * @releases: (element-type FwupdRelease): releases
+ * @download_flags: download flags, e.g. %FWUPD_CLIENT_DOWNLOAD_FLAG_NONE
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Downloads the firmware for several releases at the same time into the download cache.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fwupd_client_download_releases(FwupdClient *self,
+			       GPtrArray *releases,
+			       FwupdClientDownloadFlags download_flags,
+			       GCancellable *cancellable,
+			       GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), FALSE);
+	g_return_val_if_fail(releases != NULL, FALSE);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return FALSE;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_download_releases_async(self,
+					     releases,
+					     download_flags,
+					     cancellable,
+					     fwupd_client_download_releases_cb,
+					     helper);
+	g_main_loop_run(helper->loop);
+	if (!helper->ret) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * fwupd_client_download_file:
  * @self: a #FwupdClient
@@ -26,6 +26,14 @@ GPtrArray *
 fwupd_client_get_plugins(FwupdClient *self,
 			 GCancellable *cancellable,
 			 GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_plugin_statistics(FwupdClient *self,
+				   GCancellable *cancellable,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_engine_statistics(FwupdClient *self,
+				   GCancellable *cancellable,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 GPtrArray *
 fwupd_client_get_history(FwupdClient *self,
 			 GCancellable *cancellable,
@@ -125,6 +133,11 @@ fwupd_client_get_host_security_events(FwupdClient *self,
 				      guint limit,
 				      GCancellable *cancellable,
 				      GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_host_security_statistics(FwupdClient *self,
+					  GCancellable *cancellable,
+					  GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1);
 FwupdDevice *
 fwupd_client_get_device_by_id(FwupdClient *self,
 			      const gchar *device_id,
@@ -241,6 +254,12 @@ fwupd_client_download_bytes(FwupdClient *self,
 			    GCancellable *cancellable,
 			    GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 gboolean
+fwupd_client_download_releases(FwupdClient *self,
+			       GPtrArray *releases,
+			       FwupdClientDownloadFlags download_flags,
+			       GCancellable *cancellable,
+			       GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
+gboolean
 fwupd_client_download_file(FwupdClient *self,
 			   const gchar *url,
 			   GFile *file,
@@ -7,6 +7,7 @@
 #include "config.h"
 
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 #ifdef HAVE_LIBCURL
 #include <curl/curl.h>
 #endif
@@ -17,6 +18,7 @@
 #include <sys/utsname.h>
 #endif
 
+#include <errno.h>
 #include <fcntl.h>
 #include <locale.h>
 #include <string.h>
@@ -64,6 +66,8 @@ typedef struct {
 	guint32 battery_level;
 	guint32 battery_threshold;
 	guint download_retries;
+	guint download_max_parallel;
+	gchar *download_cache_dir;
 	GMutex idle_mutex; /* for @idle_id and @idle_sources */
 	guint idle_id;
 	GPtrArray *idle_sources; /* element-type FwupdClientContextHelper */
@@ -85,14 +89,36 @@ typedef struct {
 } FwupdClientPrivate;
 
 #ifdef HAVE_LIBCURL
+typedef struct {
+	CURL *curl;
+	gchar errbuf[CURL_ERROR_SIZE];
+	GByteArray *buf;	/* in-memory payload, or the error response */
+	GOutputStream *ostream; /* nullable, streaming to the .part file */
+	struct curl_slist *headers;
+	curl_off_t resume_from;
+	gchar *checksum; /* nullable */
+	gchar *fn;	 /* nullable */
+	gchar *fn_part;	 /* nullable */
+	gchar *fn_info;	 /* nullable */
+	gchar *etag;
+	gchar *last_modified;
+	GError *error;
+} FwupdCurlDownloadHelper;
+
 typedef struct {
 	GPtrArray *urls;
+	guint urls_idx;
+	gchar *checksum; /* nullable */
 	CURL *curl;
 	curl_mime *mime;
 	struct curl_slist *headers;
+	FwupdCurlDownloadHelper *download; /* nullable, only when using curl multi */
 } FwupdCurlHelper;
 #endif
 
+/* cached downloads not used for this long are deleted */
+#define FWUPD_CLIENT_DOWNLOAD_CACHE_MAX_AGE (30 * 24 * 60 * 60) /* s */
+
 enum {
 	SIGNAL_CHANGED,
 	SIGNAL_STATUS_CHANGED,
@@ -131,9 +157,43 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(CURLU, curl_url_cleanup)
 typedef char CURLSTR;
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(CURLSTR, curl_free)
 
+static FwupdCurlDownloadHelper *
+fwupd_client_curl_download_helper_new(CURL *curl, const gchar *checksum)
+{
+	FwupdCurlDownloadHelper *helper = g_new0(FwupdCurlDownloadHelper, 1);
+	helper->curl = curl;
+	helper->buf = g_byte_array_new();
+	helper->checksum = g_strdup(checksum);
+	return helper;
+}
+
+static void
+fwupd_client_curl_download_helper_free(FwupdCurlDownloadHelper *helper)
+{
+	if (helper->headers != NULL) {
+		(void)curl_easy_setopt(helper->curl, CURLOPT_HTTPHEADER, NULL);
+		curl_slist_free_all(helper->headers);
+	}
+	if (helper->buf != NULL)
+		g_byte_array_unref(helper->buf);
+	if (helper->ostream != NULL)
+		g_object_unref(helper->ostream);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper->checksum);
+	g_free(helper->fn);
+	g_free(helper->fn_part);
+	g_free(helper->fn_info);
+	g_free(helper->etag);
+	g_free(helper->last_modified);
+	g_free(helper);
+}
+
 static void
 fwupd_client_curl_helper_free(FwupdCurlHelper *helper)
 {
+	if (helper->download != NULL)
+		fwupd_client_curl_download_helper_free(helper->download);
 	if (helper->curl != NULL)
 		curl_easy_cleanup(helper->curl);
 	if (helper->mime != NULL)
@@ -142,10 +202,12 @@ fwupd_client_curl_helper_free(FwupdCurlHelper *helper)
 		curl_slist_free_all(helper->headers);
 	if (helper->urls != NULL)
 		g_ptr_array_unref(helper->urls);
+	g_free(helper->checksum);
 	g_free(helper);
 }
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(FwupdCurlHelper, fwupd_client_curl_helper_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FwupdCurlDownloadHelper, fwupd_client_curl_download_helper_free)
 #endif
 
 typedef struct {
@@ -479,6 +541,79 @@ fwupd_client_download_set_retries(FwupdClient *self, guint retries)
 	priv->download_retries = retries;
 }
 
+/**
+ * fwupd_client_download_set_max_parallel:
+ * @self: a #FwupdClient
+ * @max_parallel: number of downloads, defaulting to 4
+ *
+ * Sets the maximum number of downloads that should run at the same time when downloading
+ * several releases using [method@Client.download_releases_async].
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_download_set_max_parallel(FwupdClient *self, guint max_parallel)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(max_parallel > 0);
+	priv->download_max_parallel = max_parallel;
+}
+
+static void
+fwupd_client_download_cache_prune(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	const gchar *fn;
+	gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+	g_autoptr(GDir) dir = NULL;
+
+	dir = g_dir_open(priv->download_cache_dir, 0, NULL);
+	if (dir == NULL)
+		return;
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		GStatBuf st = {0};
+		g_autofree gchar *path = g_build_filename(priv->download_cache_dir, fn, NULL);
+		if (g_stat(path, &st) != 0)
+			continue;
+		if (now - (gint64)st.st_mtime < FWUPD_CLIENT_DOWNLOAD_CACHE_MAX_AGE)
+			continue;
+		g_debug("deleting stale cached download %s", path);
+		if (g_unlink(path) != 0)
+			g_debug("failed to delete %s", path);
+	}
+}
+
+/**
+ * fwupd_client_download_set_cache_dir:
+ * @self: a #FwupdClient
+ * @cache_dir: (nullable): a writable directory, or %NULL to disable the cache
+ *
+ * Sets the directory used to cache downloaded files.
+ *
+ * When set, firmware and metadata with a known checksum are stored by checksum and are not
+ * downloaded again, other files are revalidated with the server using a conditional request,
+ * and interrupted downloads are resumed when retrying. Files are streamed to disk rather than
+ * being kept in memory while downloading.
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_download_set_cache_dir(FwupdClient *self, const gchar *cache_dir)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+
+	/* not changed */
+	if (g_strcmp0(priv->download_cache_dir, cache_dir) == 0)
+		return;
+
+	g_free(priv->download_cache_dir);
+	priv->download_cache_dir = g_strdup(cache_dir);
+	if (priv->download_cache_dir != NULL)
+		fwupd_client_download_cache_prune(self);
+}
+
 static void
 fwupd_client_set_host_bkc(FwupdClient *self, const gchar *host_bkc)
 {
@@ -1613,6 +1748,90 @@ fwupd_client_get_host_security_events_finish(FwupdClient *self, GAsyncResult *re
 	return g_task_propagate_pointer(G_TASK(res), error);
 }
 
+static void
+fwupd_client_get_host_security_statistics_cb(GObject *source,
+					     GAsyncResult *res,
+					     gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		fwupd_client_fixup_dbus_error(error);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer(task,
+			      g_variant_get_child_value(val, 0),
+			      (GDestroyNotify)g_variant_unref);
+}
+
+/**
+ * fwupd_client_get_host_security_statistics_async:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: (scope async) (closure callback_data): the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets how long each device and plugin took to add the host security attributes.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_get_host_security_statistics_async(FwupdClient *self,
+						GCancellable *cancellable,
+						GAsyncReadyCallback callback,
+						gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetHostSecurityStatistics",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_host_security_statistics_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_host_security_statistics_finish:
+ * @self: a #FwupdClient
+ * @res: (not nullable): the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of [method@FwupdClient.get_host_security_statistics_async].
+ *
+ * Returns: (transfer full): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_host_security_statistics_finish(FwupdClient *self,
+						 GAsyncResult *res,
+						 GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
 static GHashTable *
 fwupd_client_report_metadata_hash_from_variant(GVariant *value)
 {
@@ -1883,6 +2102,166 @@ fwupd_client_get_plugins_finish(FwupdClient *self, GAsyncResult *res, GError **e
 	return g_task_propagate_pointer(G_TASK(res), error);
 }
 
+static void
+fwupd_client_get_plugin_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		fwupd_client_fixup_dbus_error(error);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer(task,
+			      g_variant_get_child_value(val, 0),
+			      (GDestroyNotify)g_variant_unref);
+}
+
+/**
+ * fwupd_client_get_plugin_statistics_async:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: (scope async) (closure callback_data): the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets how long each plugin has spent enumerating devices.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_get_plugin_statistics_async(FwupdClient *self,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetPluginStatistics",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_plugin_statistics_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_plugin_statistics_finish:
+ * @self: a #FwupdClient
+ * @res: (not nullable): the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of [method@FwupdClient.get_plugin_statistics_async].
+ *
+ * Returns: (transfer full): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_plugin_statistics_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
+static void
+fwupd_client_get_engine_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		fwupd_client_fixup_dbus_error(error);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer(task,
+			      g_variant_get_child_value(val, 0),
+			      (GDestroyNotify)g_variant_unref);
+}
+
+/**
+ * fwupd_client_get_engine_statistics_async:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: (scope async) (closure callback_data): the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets statistics for the daemon, for instance the release cache hit ratio.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_get_engine_statistics_async(FwupdClient *self,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetEngineStatistics",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_engine_statistics_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_engine_statistics_finish:
+ * @self: a #FwupdClient
+ * @res: (not nullable): the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of [method@FwupdClient.get_engine_statistics_async].
+ *
+ * Returns: (transfer full): a #GVariant of type `a{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fwupd_client_get_engine_statistics_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
 static void
 fwupd_client_get_history_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -3463,20 +3842,69 @@ fwupd_client_is_url_p2p(const gchar *perhaps_url)
 	return FALSE;
 }
 
-static void
-fwupd_client_install_release_remote_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+static GPtrArray *
+fwupd_client_release_build_uris(FwupdRemote *remote, FwupdRelease *release, GError **error)
 {
-	GPtrArray *locations;
-	const gchar *uri_tmp;
-	g_autofree gchar *fn = NULL;
-	g_autoptr(FwupdRemote) remote = NULL;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GTask) task = G_TASK(user_data);
+	GPtrArray *locations = fwupd_release_get_locations(release);
 	g_autoptr(GPtrArray) uris_built = g_ptr_array_new_with_free_func(g_free);
-	FwupdClientInstallReleaseData *data = g_task_get_task_data(task);
-	GCancellable *cancellable = g_task_get_cancellable(task);
 
-	/* if a remote-id was specified, the remote has to exist */
+	/* maybe get payload from Passim */
+	if (fwupd_remote_has_flag(remote, FWUPD_REMOTE_FLAG_ALLOW_P2P_FIRMWARE)) {
+		const gchar *checksum_sha256 =
+		    fwupd_checksum_get_by_kind(fwupd_release_get_checksums(release),
+					       G_CHECKSUM_SHA256);
+		if (checksum_sha256 != NULL) {
+			g_autofree gchar *basename =
+			    g_path_get_basename(fwupd_release_get_filename(release));
+			g_ptr_array_add(uris_built,
+					g_strdup_printf("https://localhost:27500/%s?sha256=%s",
+							basename,
+							checksum_sha256));
+		}
+	}
+
+	/* remote file */
+	for (guint i = 0; i < locations->len; i++) {
+		const gchar *uri_tmp = g_ptr_array_index(locations, i);
+		if (fwupd_client_is_url_p2p(uri_tmp)) {
+			g_ptr_array_add(uris_built, g_strdup(uri_tmp));
+		} else if (fwupd_client_is_url_http(uri_tmp)) {
+			g_autofree gchar *uri_str = NULL;
+			uri_str = fwupd_remote_build_firmware_uri(remote, uri_tmp, error);
+			if (uri_str == NULL)
+				return NULL;
+			g_ptr_array_add(uris_built, g_steal_pointer(&uri_str));
+		} else {
+			g_debug("do not how to handle URI %s", uri_tmp);
+		}
+	}
+	if (uris_built->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "No URIs to download");
+		return NULL;
+	}
+
+	/* success */
+	return g_steal_pointer(&uris_built);
+}
+
+static void
+fwupd_client_install_release_remote_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	GPtrArray *locations;
+	const gchar *checksum;
+	const gchar *uri_tmp;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FwupdRemote) remote = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GPtrArray) uris_built = NULL;
+	FwupdClientInstallReleaseData *data = g_task_get_task_data(task);
+	GCancellable *cancellable = g_task_get_cancellable(task);
+
+	/* if a remote-id was specified, the remote has to exist */
 	remote = fwupd_client_get_remote_by_id_finish(FWUPD_CLIENT(source), res, &error);
 	if (remote == NULL) {
 		g_task_return_error(task, g_steal_pointer(&error));
@@ -3516,49 +3944,18 @@ fwupd_client_install_release_remote_cb(GObject *source, GAsyncResult *res, gpoin
 		return;
 	}
 
-	/* maybe get payload from Passim */
-	if (fwupd_remote_has_flag(remote, FWUPD_REMOTE_FLAG_ALLOW_P2P_FIRMWARE)) {
-		const gchar *checksum_sha256 =
-		    fwupd_checksum_get_by_kind(fwupd_release_get_checksums(data->release),
-					       G_CHECKSUM_SHA256);
-		if (checksum_sha256 != NULL) {
-			g_autofree gchar *basename =
-			    g_path_get_basename(fwupd_release_get_filename(data->release));
-			g_ptr_array_add(uris_built,
-					g_strdup_printf("https://localhost:27500/%s?sha256=%s",
-							basename,
-							checksum_sha256));
-		}
-	}
-
-	/* remote file */
-	for (guint i = 0; i < locations->len; i++) {
-		uri_tmp = g_ptr_array_index(locations, i);
-		if (fwupd_client_is_url_p2p(uri_tmp)) {
-			g_ptr_array_add(uris_built, g_strdup(uri_tmp));
-		} else if (fwupd_client_is_url_http(uri_tmp)) {
-			g_autofree gchar *uri_str = NULL;
-			uri_str = fwupd_remote_build_firmware_uri(remote, uri_tmp, &error);
-			if (uri_str == NULL) {
-				g_task_return_error(task, g_steal_pointer(&error));
-				return;
-			}
-			g_ptr_array_add(uris_built, g_steal_pointer(&uri_str));
-		} else {
-			g_debug("do not how to handle URI %s", uri_tmp);
-		}
-	}
-	if (uris_built->len == 0) {
-		g_task_return_new_error(task,
-					FWUPD_ERROR,
-					FWUPD_ERROR_INVALID_FILE,
-					"No URIs to download");
+	/* build the remote-specific URIs */
+	uris_built = fwupd_client_release_build_uris(remote, data->release, &error);
+	if (uris_built == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
 
-	/* download file */
+	/* download file, or use the cached copy with the same checksum */
+	checksum = fwupd_checksum_get_best(fwupd_release_get_checksums(data->release));
 	fwupd_client_download_bytes2_async(FWUPD_CLIENT(source),
 					   uris_built,
+					   checksum,
 					   data->download_flags,
 					   cancellable,
 					   fwupd_client_install_release_download_cb,
@@ -3646,8 +4043,11 @@ fwupd_client_install_release_async(FwupdClient *self,
 	/* work out what remote-specific URI fields this should use */
 	remote_id = fwupd_release_get_remote_id(release);
 	if (remote_id == NULL) {
+		const gchar *checksum =
+		    fwupd_checksum_get_best(fwupd_release_get_checksums(release));
 		fwupd_client_download_bytes2_async(self,
 						   fwupd_release_get_locations(release),
+						   checksum,
 						   download_flags,
 						   cancellable,
 						   fwupd_client_install_release_download_cb,
@@ -4437,6 +4837,7 @@ fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpo
 	}
 	fwupd_client_download_bytes2_async(self,
 					   urls,
+					   fwupd_remote_get_checksum_metadata(data->remote),
 					   FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
 					   cancellable,
 					   fwupd_client_refresh_remote_metadata_cb,
@@ -5537,13 +5938,266 @@ fwupd_client_download_ipfs(FwupdClient *self,
 	return g_steal_pointer(&bstdout);
 }
 
-static GBytes *
-fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GError **error)
+static size_t
+fwupd_client_download_stream_write_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
 {
-	CURLcode res;
-	gchar errbuf[CURL_ERROR_SIZE] = {'\0'};
+	FwupdCurlDownloadHelper *helper = (FwupdCurlDownloadHelper *)userdata;
+	gsize realsize = size * nmemb;
 	glong status_code = 0;
-	g_autoptr(GByteArray) buf = g_byte_array_new();
+
+	/* error responses are kept in memory so they can be shown to the user */
+	(void)curl_easy_getinfo(helper->curl, CURLINFO_RESPONSE_CODE, &status_code);
+	if (helper->ostream == NULL || status_code >= 300) {
+		g_byte_array_append(helper->buf, (const guint8 *)ptr, realsize);
+		return realsize;
+	}
+
+	/* the server ignored the range request, so start again */
+	if (helper->resume_from > 0 && status_code != 206) {
+		g_debug("server ignored range request, restarting download");
+		if (!g_seekable_truncate(G_SEEKABLE(helper->ostream), 0, NULL, &helper->error))
+			return 0;
+		helper->resume_from = 0;
+	}
+	if (!g_output_stream_write_all(helper->ostream, ptr, realsize, NULL, NULL, &helper->error))
+		return 0;
+	return realsize;
+}
+
+static size_t
+fwupd_client_download_header_cb(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+	FwupdCurlDownloadHelper *helper = (FwupdCurlDownloadHelper *)userdata;
+	gsize realsize = size * nitems;
+	g_autofree gchar *line = g_strndup(buffer, realsize);
+
+	/* a new response, e.g. after a redirect */
+	if (g_str_has_prefix(line, "HTTP/")) {
+		g_clear_pointer(&helper->etag, g_free);
+		g_clear_pointer(&helper->last_modified, g_free);
+	} else if (g_ascii_strncasecmp(line, "ETag:", 5) == 0) {
+		g_free(helper->etag);
+		helper->etag = g_strstrip(g_strdup(line + 5));
+	} else if (g_ascii_strncasecmp(line, "Last-Modified:", 14) == 0) {
+		g_free(helper->last_modified);
+		helper->last_modified = g_strstrip(g_strdup(line + 14));
+	}
+	return realsize;
+}
+
+/* the checksum comes from the remote metadata, so never trust it as a filename */
+static gboolean
+fwupd_client_download_cache_checksum_valid(const gchar *checksum, GError **error)
+{
+	gsize len = strlen(checksum);
+	gssize len_expected = g_checksum_type_get_length(fwupd_checksum_guess_kind(checksum));
+
+	if (len_expected <= 0 || len != (gsize)len_expected * 2) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "checksum %s has invalid length %u",
+			    checksum,
+			    (guint)len);
+		return FALSE;
+	}
+	for (gsize i = 0; i < len; i++) {
+		if (!g_ascii_isdigit(checksum[i]) && (checksum[i] < 'a' || checksum[i] > 'f')) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "checksum %s is not lowercase hex",
+				    checksum);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static gchar *
+fwupd_client_download_cache_build_filename(FwupdClient *self,
+					   const gchar *url,
+					   const gchar *checksum,
+					   GError **error)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autofree gchar *basename = NULL;
+
+	/* content-addressed, so the same firmware from any mirror is only downloaded once */
+	if (checksum != NULL) {
+		if (!fwupd_client_download_cache_checksum_valid(checksum, error))
+			return NULL;
+		return g_build_filename(priv->download_cache_dir, checksum, NULL);
+	}
+	basename = g_compute_checksum_for_string(G_CHECKSUM_SHA256, url, -1);
+	return g_build_filename(priv->download_cache_dir, basename, NULL);
+}
+
+static GBytes *
+fwupd_client_download_cache_load(const gchar *fn, const gchar *checksum, GError **error)
+{
+	gsize bufsz = 0;
+	gchar *buf = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	/* read a copy, as the file can be replaced or pruned while the caller still uses it */
+	if (!g_file_get_contents(fn, &buf, &bufsz, error))
+		return NULL;
+	blob = g_bytes_new_take(buf, bufsz);
+	if (checksum != NULL) {
+		GChecksumType checksum_kind = fwupd_checksum_guess_kind(checksum);
+		g_autofree gchar *checksum_actual = NULL;
+
+		checksum_actual = g_compute_checksum_for_bytes(checksum_kind, blob);
+		if (g_strcmp0(checksum, checksum_actual) != 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "checksum invalid, expected %s and got %s",
+				    checksum,
+				    checksum_actual);
+			return NULL;
+		}
+	}
+
+	/* used, so do not prune */
+	if (g_utime(fn, NULL) != 0)
+		g_debug("failed to update timestamp of %s", fn);
+	return g_steal_pointer(&blob);
+}
+
+static gboolean
+fwupd_client_download_cache_open(FwupdClient *self,
+				 FwupdCurlDownloadHelper *helper,
+				 const gchar *url,
+				 GError **error)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	GStatBuf st = {0};
+	g_autoptr(GFile) file_part = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	helper->fn = fwupd_client_download_cache_build_filename(self, url, helper->checksum, error);
+	if (helper->fn == NULL)
+		return FALSE;
+	helper->fn_part = g_strdup_printf("%s.part", helper->fn);
+	if (helper->checksum == NULL)
+		helper->fn_info = g_strdup_printf("%s.info", helper->fn);
+	file_part = g_file_new_for_path(helper->fn_part);
+
+	if (g_mkdir_with_parents(priv->download_cache_dir, 0700) == -1) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to create %s: %s",
+			    priv->download_cache_dir,
+			    g_strerror(errno));
+		return FALSE;
+	}
+
+	/* revalidate the existing copy using whatever the server sent last time */
+	if (helper->fn_info != NULL) {
+		if (g_file_test(helper->fn, G_FILE_TEST_EXISTS) &&
+		    g_key_file_load_from_file(kf, helper->fn_info, G_KEY_FILE_NONE, NULL)) {
+			g_autofree gchar *etag =
+			    g_key_file_get_string(kf, "download", "ETag", NULL);
+			g_autofree gchar *last_modified =
+			    g_key_file_get_string(kf, "download", "LastModified", NULL);
+			if (etag != NULL) {
+				g_autofree gchar *hdr = g_strdup_printf("If-None-Match: %s", etag);
+				helper->headers = curl_slist_append(helper->headers, hdr);
+			}
+			if (last_modified != NULL) {
+				g_autofree gchar *hdr =
+				    g_strdup_printf("If-Modified-Since: %s", last_modified);
+				helper->headers = curl_slist_append(helper->headers, hdr);
+			}
+		}
+
+		/* the file may have changed on the server since, so never resume */
+		(void)g_unlink(helper->fn_part);
+	}
+
+	/* continue an interrupted download -- the checksum is verified at the end */
+	if (g_stat(helper->fn_part, &st) == 0 && st.st_size > 0) {
+		helper->resume_from = st.st_size;
+		g_info("resuming download of %s from %" G_GINT64_FORMAT,
+		       helper->fn_part,
+		       (gint64)helper->resume_from);
+	}
+	helper->ostream =
+	    G_OUTPUT_STREAM(g_file_append_to(file_part, G_FILE_CREATE_PRIVATE, NULL, error));
+	if (helper->ostream == NULL) {
+		g_prefix_error(error, "failed to open %s: ", helper->fn_part);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static GBytes *
+fwupd_client_download_cache_commit(FwupdCurlDownloadHelper *helper,
+				   glong status_code,
+				   GError **error)
+{
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	if (!g_output_stream_close(helper->ostream, NULL, error))
+		return NULL;
+
+	/* not modified, so the cached copy is still valid */
+	if (status_code == 304) {
+		g_info("%s not modified, using cached copy", helper->fn);
+		(void)g_unlink(helper->fn_part);
+		if (helper->fn_info != NULL &&
+		    !g_key_file_load_from_file(kf, helper->fn_info, G_KEY_FILE_NONE, error))
+			return NULL;
+	} else {
+		/* never let a corrupt download into the cache */
+		if (helper->checksum != NULL) {
+			g_autoptr(GBytes) blob = NULL;
+			blob = fwupd_client_download_cache_load(helper->fn_part,
+								helper->checksum,
+								error);
+			if (blob == NULL) {
+				(void)g_unlink(helper->fn_part);
+				return NULL;
+			}
+		}
+		(void)g_unlink(helper->fn);
+		if (g_rename(helper->fn_part, helper->fn) != 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_WRITE,
+				    "failed to rename %s: %s",
+				    helper->fn_part,
+				    g_strerror(errno));
+			return NULL;
+		}
+		if (helper->etag != NULL)
+			g_key_file_set_string(kf, "download", "ETag", helper->etag);
+		if (helper->last_modified != NULL)
+			g_key_file_set_string(kf,
+					      "download",
+					      "LastModified",
+					      helper->last_modified);
+	}
+
+	/* save the validators for next time */
+	if (helper->fn_info != NULL && !g_key_file_save_to_file(kf, helper->fn_info, error))
+		return NULL;
+	return fwupd_client_download_cache_load(helper->fn, NULL, error);
+}
+
+static gboolean
+fwupd_client_download_http_setup(FwupdClient *self,
+				 FwupdCurlDownloadHelper *helper,
+				 const gchar *url,
+				 GError **error)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	CURL *curl = helper->curl;
 
 	/* relax the SSL checks on localhost URLs and broken corporate proxies */
 	if (fwupd_client_is_localhost(url) || g_getenv("DISABLE_SSL_STRICT") != NULL) {
@@ -5554,35 +6208,59 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 		(void)curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 1L);
 	}
 
-	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+	/* stream to the cache rather than into memory */
+	if (priv->download_cache_dir != NULL) {
+		if (!fwupd_client_download_cache_open(self, helper, url, error))
+			return FALSE;
+	}
+
 	(void)curl_easy_setopt(curl, CURLOPT_URL, url);
-	(void)curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
-	(void)curl_easy_setopt(curl,
-			       CURLOPT_WRITEFUNCTION,
-			       fwupd_client_download_write_callback_cb);
-	(void)curl_easy_setopt(curl, CURLOPT_WRITEDATA, buf);
-	res = curl_easy_perform(curl);
-	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
-	fwupd_client_set_percentage(self, 100);
+	(void)curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, helper->errbuf);
+	(void)curl_easy_setopt(curl, CURLOPT_HTTPHEADER, helper->headers);
+	(void)curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, helper->resume_from);
+	(void)curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, fwupd_client_download_header_cb);
+	(void)curl_easy_setopt(curl, CURLOPT_HEADERDATA, helper);
+	(void)curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fwupd_client_download_stream_write_cb);
+	(void)curl_easy_setopt(curl, CURLOPT_WRITEDATA, helper);
+	return TRUE;
+}
+
+static GBytes *
+fwupd_client_download_http_finish(FwupdCurlDownloadHelper *helper, CURLcode res, GError **error)
+{
+	glong status_code = 0;
+
+	if (helper->error != NULL) {
+		g_propagate_prefixed_error(error,
+					   g_steal_pointer(&helper->error),
+					   "failed to write %s: ",
+					   helper->fn_part);
+		return NULL;
+	}
 	if (res != CURLE_OK) {
-		if (errbuf[0] != '\0') {
+		/* a dropped connection is transient, and can be resumed when retrying */
+		FwupdError error_code = FWUPD_ERROR_INVALID_FILE;
+		if (res == CURLE_PARTIAL_FILE || res == CURLE_RECV_ERROR ||
+		    res == CURLE_OPERATION_TIMEDOUT)
+			error_code = FWUPD_ERROR_TIMED_OUT;
+		if (helper->errbuf[0] != '\0') {
 			g_set_error(error,
 				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
+				    error_code,
 				    "failed to download file: %s",
-				    errbuf);
+				    helper->errbuf);
 			return NULL;
 		}
 		g_set_error(error,
 			    FWUPD_ERROR,
-			    FWUPD_ERROR_INVALID_FILE,
+			    error_code,
 			    "failed to download file: %s",
 			    curl_easy_strerror(res));
 		return NULL;
 	}
 
 	/* check for server limit */
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
+	curl_easy_getinfo(helper->curl, CURLINFO_RESPONSE_CODE, &status_code);
 	g_info("status-code was %ld", status_code);
 	if (status_code == 429) {
 		g_set_error_literal(error,
@@ -5591,8 +6269,18 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 				    "Failed to download due to server limit");
 		return NULL;
 	}
+	if (status_code == 416 && helper->resume_from > 0) {
+		g_clear_object(&helper->ostream);
+		(void)g_unlink(helper->fn_part);
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_TIMED_OUT,
+				    "Failed to resume download, starting again");
+		return NULL;
+	}
 	if (status_code == 502 || status_code == 503 || status_code == 504) {
-		g_autofree gchar *str = g_strndup((const gchar *)buf->data, MIN(buf->len, 4000));
+		g_autofree gchar *str =
+		    g_strndup((const gchar *)helper->buf->data, MIN(helper->buf->len, 4000));
 		if (g_str_is_ascii(str)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
@@ -5610,7 +6298,8 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 		return NULL;
 	}
 	if (status_code >= 400) {
-		g_autofree gchar *str = g_strndup((const gchar *)buf->data, MIN(buf->len, 4000));
+		g_autofree gchar *str =
+		    g_strndup((const gchar *)helper->buf->data, MIN(helper->buf->len, 4000));
 		if (g_str_is_ascii(str)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
@@ -5628,7 +6317,30 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 		return NULL;
 	}
 
-	return g_bytes_new(buf->data, buf->len);
+	/* downloaded into memory */
+	if (helper->ostream == NULL)
+		return g_bytes_new(helper->buf->data, helper->buf->len);
+	return fwupd_client_download_cache_commit(helper, status_code, error);
+}
+
+static GBytes *
+fwupd_client_download_http(FwupdClient *self,
+			   CURL *curl,
+			   const gchar *url,
+			   const gchar *checksum,
+			   GError **error)
+{
+	CURLcode res;
+	g_autoptr(FwupdCurlDownloadHelper) helper = NULL;
+
+	helper = fwupd_client_curl_download_helper_new(curl, checksum);
+	if (!fwupd_client_download_http_setup(self, helper, url, error))
+		return NULL;
+	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+	res = curl_easy_perform(curl);
+	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
+	fwupd_client_set_percentage(self, 100);
+	return fwupd_client_download_http_finish(helper, res, error);
 }
 
 static gboolean
@@ -5640,7 +6352,11 @@ fwupd_client_download_error_is_fatal(const GError *error)
 }
 
 static GBytes *
-fwupd_client_download_http_retry(FwupdClient *self, CURL *curl, const gchar *url, GError **error)
+fwupd_client_download_http_retry(FwupdClient *self,
+				 CURL *curl,
+				 const gchar *url,
+				 const gchar *checksum,
+				 GError **error)
 {
 	FwupdClientPrivate *priv = GET_PRIVATE(self);
 	gulong delay_ms = 2500;
@@ -5648,7 +6364,7 @@ fwupd_client_download_http_retry(FwupdClient *self, CURL *curl, const gchar *url
 		g_autoptr(GBytes) blob = NULL;
 		g_autoptr(GError) error_local = NULL;
 
-		blob = fwupd_client_download_http(self, curl, url, &error_local);
+		blob = fwupd_client_download_http(self, curl, url, checksum, &error_local);
 		if (blob != NULL)
 			return g_steal_pointer(&blob);
 		if (i >= priv->download_retries ||
@@ -5661,6 +6377,33 @@ fwupd_client_download_http_retry(FwupdClient *self, CURL *curl, const gchar *url
 	}
 	return NULL;
 }
+
+static GBytes *
+fwupd_client_download_cache_lookup(FwupdClient *self, const gchar *checksum)
+{
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (checksum == NULL)
+		return NULL;
+	fn = fwupd_client_download_cache_build_filename(self, NULL, checksum, &error_local);
+	if (fn == NULL) {
+		g_info("not using cache: %s", error_local->message);
+		return NULL;
+	}
+	if (!g_file_test(fn, G_FILE_TEST_EXISTS))
+		return NULL;
+	blob = fwupd_client_download_cache_load(fn, checksum, &error_local);
+	if (blob == NULL) {
+		g_info("ignoring cached %s: %s", fn, error_local->message);
+		(void)g_unlink(fn);
+		return NULL;
+	}
+	g_info("using cached %s", fn);
+	return g_steal_pointer(&blob);
+}
+
 static void
 fwupd_client_download_bytes_thread_cb(GTask *task,
 				      gpointer source_object,
@@ -5668,9 +6411,21 @@ fwupd_client_download_bytes_thread_cb(GTask *task,
 				      GCancellable *cancellable)
 {
 	FwupdClient *self = FWUPD_CLIENT(source_object);
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
 	FwupdCurlHelper *helper = g_task_get_task_data(task);
 	g_autoptr(GBytes) blob = NULL;
 
+	/* already downloaded */
+	if (priv->download_cache_dir != NULL && helper->checksum != NULL) {
+		blob = fwupd_client_download_cache_lookup(self, helper->checksum);
+		if (blob != NULL) {
+			g_task_return_pointer(task,
+					      g_steal_pointer(&blob),
+					      (GDestroyNotify)g_bytes_unref);
+			return;
+		}
+	}
+
 	for (guint i = 0; i < helper->urls->len; i++) {
 		const gchar *url = g_ptr_array_index(helper->urls, i);
 		g_autoptr(GError) error = NULL;
@@ -5680,7 +6435,11 @@ fwupd_client_download_bytes_thread_cb(GTask *task,
 			return;
 		}
 		if (fwupd_client_is_url_http(url)) {
-			blob = fwupd_client_download_http_retry(self, helper->curl, url, &error);
+			blob = fwupd_client_download_http_retry(self,
+								helper->curl,
+								url,
+								helper->checksum,
+								&error);
 			if (blob != NULL)
 				break;
 		} else if (fwupd_client_is_url_ipfs(url)) {
@@ -5710,6 +6469,7 @@ fwupd_client_download_bytes_thread_cb(GTask *task,
 void
 fwupd_client_download_bytes2_async(FwupdClient *self,
 				   GPtrArray *urls,
+				   const gchar *checksum,
 				   FwupdClientDownloadFlags flags,
 				   GCancellable *cancellable,
 				   GAsyncReadyCallback callback,
@@ -5738,6 +6498,7 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
+	helper->checksum = g_strdup(checksum);
 	g_task_set_task_data(task,
 			     g_steal_pointer(&helper),
 			     (GDestroyNotify)fwupd_client_curl_helper_free);
@@ -5786,7 +6547,13 @@ fwupd_client_download_bytes_async(FwupdClient *self,
 
 	/* just proxy */
 	g_ptr_array_add(urls, g_strdup(url));
-	fwupd_client_download_bytes2_async(self, urls, flags, cancellable, callback, callback_data);
+	fwupd_client_download_bytes2_async(self,
+					   urls,
+					   NULL,
+					   flags,
+					   cancellable,
+					   callback,
+					   callback_data);
 }
 
 /**
@@ -5810,6 +6577,413 @@ fwupd_client_download_bytes_finish(FwupdClient *self, GAsyncResult *res, GError
 	return g_task_propagate_pointer(G_TASK(res), error);
 }
 
+#ifdef HAVE_LIBCURL
+typedef struct {
+	GPtrArray *releases; /* element-type FwupdRelease */
+	FwupdClientDownloadFlags download_flags;
+	GPtrArray *helpers; /* element-type FwupdCurlHelper */
+} FwupdClientDownloadReleasesData;
+
+static void
+fwupd_client_download_releases_data_free(FwupdClientDownloadReleasesData *data)
+{
+	if (data->releases != NULL)
+		g_ptr_array_unref(data->releases);
+	if (data->helpers != NULL)
+		g_ptr_array_unref(data->helpers);
+	g_free(data);
+}
+
+static FwupdCurlHelper *
+fwupd_client_download_releases_helper_new(FwupdClient *self,
+					  GPtrArray *urls,
+					  const gchar *checksum,
+					  GError **error)
+{
+	g_autoptr(FwupdCurlHelper) helper = NULL;
+
+	helper = fwupd_client_curl_new(self, error);
+	if (helper == NULL)
+		return NULL;
+	helper->urls = g_ptr_array_ref(urls);
+	helper->checksum = g_strdup(checksum);
+
+	/* progress is reported per release, not per transfer */
+	(void)curl_easy_setopt(helper->curl, CURLOPT_NOPROGRESS, 1L);
+	return g_steal_pointer(&helper);
+}
+
+/* starts the transfer using the current URL, or the next one that can be used */
+static gboolean
+fwupd_client_download_releases_start(FwupdClient *self,
+				     CURLM *multi,
+				     FwupdCurlHelper *helper,
+				     GError **error)
+{
+	for (; helper->urls_idx < helper->urls->len; helper->urls_idx++) {
+		const gchar *url = g_ptr_array_index(helper->urls, helper->urls_idx);
+		if (!fwupd_client_is_url_http(url))
+			continue;
+		g_info("prefetching %s", url);
+		if (!fwupd_client_curl_helper_set_proxy(self, helper, url, error))
+			return FALSE;
+		g_clear_pointer(&helper->download, fwupd_client_curl_download_helper_free);
+		helper->download =
+		    fwupd_client_curl_download_helper_new(helper->curl, helper->checksum);
+		if (!fwupd_client_download_http_setup(self, helper->download, url, error))
+			return FALSE;
+		(void)curl_easy_setopt(helper->curl, CURLOPT_PRIVATE, helper);
+		if (curl_multi_add_handle(multi, helper->curl) != CURLM_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to add transfer for %s",
+				    url);
+			return FALSE;
+		}
+		return TRUE;
+	}
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no more URIs to try");
+	return FALSE;
+}
+
+static gboolean
+fwupd_client_download_releases_multi(FwupdClient *self,
+				     CURLM *multi,
+				     GPtrArray *helpers,
+				     GCancellable *cancellable,
+				     GError **error)
+{
+	guint done = 0;
+	gint running = 0;
+
+	for (guint i = 0; i < helpers->len; i++) {
+		FwupdCurlHelper *helper = g_ptr_array_index(helpers, i);
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		/* already downloaded */
+		blob = fwupd_client_download_cache_lookup(self, helper->checksum);
+		if (blob != NULL) {
+			done++;
+			continue;
+		}
+		if (!fwupd_client_download_releases_start(self, multi, helper, &error_local)) {
+			g_info("not prefetching %s: %s", helper->checksum, error_local->message);
+			done++;
+		}
+	}
+	fwupd_client_set_percentage(self, (done * 100) / helpers->len);
+
+	/* all transfers share the connection cache, and are limited by the multi handle */
+	do {
+		CURLMsg *msg;
+		gint msgs_left = 0;
+
+		if (g_cancellable_set_error_if_cancelled(cancellable, error))
+			return FALSE;
+		if (curl_multi_perform(multi, &running) != CURLM_OK) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to perform transfers");
+			return FALSE;
+		}
+		while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+			CURL *curl = msg->easy_handle;
+			CURLcode res = msg->data.result;
+			FwupdCurlHelper *helper = NULL;
+			g_autoptr(GBytes) blob = NULL;
+			g_autoptr(GError) error_local = NULL;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			(void)curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char **)&helper);
+			(void)curl_multi_remove_handle(multi, curl);
+			blob =
+			    fwupd_client_download_http_finish(helper->download, res, &error_local);
+			if (blob == NULL) {
+				g_autoptr(GError) error_next = NULL;
+				g_info("failed to prefetch %s: %s",
+				       (const gchar *)g_ptr_array_index(helper->urls,
+									helper->urls_idx),
+				       error_local->message);
+				helper->urls_idx++;
+				if (fwupd_client_download_releases_start(self,
+									 multi,
+									 helper,
+									 &error_next)) {
+					running++;
+					continue;
+				}
+			}
+			done++;
+			fwupd_client_set_percentage(self, (done * 100) / helpers->len);
+		}
+		if (running > 0 && curl_multi_wait(multi, NULL, 0, 1000, NULL) != CURLM_OK) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to wait for transfers");
+			return FALSE;
+		}
+	} while (running > 0);
+
+	/* success */
+	return TRUE;
+}
+
+static void
+fwupd_client_download_releases_thread_cb(GTask *task,
+					 gpointer source_object,
+					 gpointer task_data,
+					 GCancellable *cancellable)
+{
+	FwupdClient *self = FWUPD_CLIENT(source_object);
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdClientDownloadReleasesData *data = g_task_get_task_data(task);
+	CURLM *multi = curl_multi_init();
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+
+	(void)curl_multi_setopt(multi,
+				CURLMOPT_MAX_TOTAL_CONNECTIONS,
+				(long)priv->download_max_parallel);
+	(void)curl_multi_setopt(multi,
+				CURLMOPT_MAX_HOST_CONNECTIONS,
+				(long)priv->download_max_parallel);
+#if CURL_AT_LEAST_VERSION(7, 67, 0)
+	(void)curl_multi_setopt(multi,
+				CURLMOPT_MAX_CONCURRENT_STREAMS,
+				(long)priv->download_max_parallel);
+#endif
+	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+	ret = fwupd_client_download_releases_multi(self, multi, data->helpers, cancellable, &error);
+	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
+
+	/* the easy handles are owned by the helpers */
+	for (guint i = 0; i < data->helpers->len; i++) {
+		FwupdCurlHelper *helper = g_ptr_array_index(data->helpers, i);
+		(void)curl_multi_remove_handle(multi, helper->curl);
+	}
+	(void)curl_multi_cleanup(multi);
+	if (!ret) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	g_task_return_boolean(task, TRUE);
+}
+
+static void
+fwupd_client_download_releases_remotes_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClient *self = FWUPD_CLIENT(source);
+	g_autoptr(GTask) task = G_TASK(user_data);
+	FwupdClientDownloadReleasesData *data = g_task_get_task_data(task);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) checksums = g_hash_table_new(g_str_hash, g_str_equal);
+	g_autoptr(GPtrArray) remotes = NULL;
+
+	remotes = fwupd_client_get_remotes_finish(self, res, &error);
+	if (remotes == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	data->helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_curl_helper_free);
+	for (guint i = 0; i < data->releases->len; i++) {
+		FwupdRelease *release = g_ptr_array_index(data->releases, i);
+		FwupdRemote *remote = NULL;
+		const gchar *checksum;
+		g_autoptr(FwupdCurlHelper) helper = NULL;
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GPtrArray) uris = NULL;
+		g_autoptr(GPtrArray) urls = NULL;
+
+		/* only content-addressed payloads can be found again when installing */
+		checksum = fwupd_checksum_get_best(fwupd_release_get_checksums(release));
+		if (checksum == NULL || g_hash_table_contains(checksums, checksum))
+			continue;
+		for (guint j = 0; j < remotes->len; j++) {
+			FwupdRemote *remote_tmp = g_ptr_array_index(remotes, j);
+			if (g_strcmp0(fwupd_remote_get_id(remote_tmp),
+				      fwupd_release_get_remote_id(release)) == 0) {
+				remote = remote_tmp;
+				break;
+			}
+		}
+		if (remote == NULL || fwupd_remote_get_kind(remote) != FWUPD_REMOTE_KIND_DOWNLOAD)
+			continue;
+
+		uris = fwupd_client_release_build_uris(remote, release, &error_local);
+		if (uris == NULL) {
+			g_debug("not prefetching %s: %s", checksum, error_local->message);
+			continue;
+		}
+		urls = fwupd_client_filter_locations(uris, data->download_flags, &error_local);
+		if (urls == NULL) {
+			g_debug("not prefetching %s: %s", checksum, error_local->message);
+			continue;
+		}
+		helper = fwupd_client_download_releases_helper_new(self, urls, checksum, &error);
+		if (helper == NULL) {
+			g_task_return_error(task, g_steal_pointer(&error));
+			return;
+		}
+		g_hash_table_add(checksums, helper->checksum);
+		g_ptr_array_add(data->helpers, g_steal_pointer(&helper));
+	}
+	if (data->helpers->len == 0) {
+		g_task_return_boolean(task, TRUE);
+		return;
+	}
+	g_task_run_in_thread(task, fwupd_client_download_releases_thread_cb);
+}
+#endif
+
+/**
+ * fwupd_client_download_releases_async:
+ * @self: a #FwupdClient
+ * @releases: (element-type FwupdRelease): releases
+ * @download_flags: download flags, e.g. %FWUPD_CLIENT_DOWNLOAD_FLAG_ONLY_P2P
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: (scope async) (closure callback_data): the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Downloads the firmware for several releases at the same time into the download cache, so that
+ * a later [method@Client.install_release_async] does not have to wait for the network.
+ *
+ * Releases without a checksum, or from remotes that are not downloaded, are ignored, as are
+ * releases that fail to download -- these are retried when the release is installed.
+ *
+ * A download cache directory must have been set using [method@Client.download_set_cache_dir].
+ *
+ * NOTE: This method is thread-safe, but progress signals will be
+ * emitted in the global default main context, if not explicitly set with
+ * [method@Client.set_main_context].
+ *
+ * Since: 2.0.2
+ **/
+void
+fwupd_client_download_releases_async(FwupdClient *self,
+				     GPtrArray *releases,
+				     FwupdClientDownloadFlags download_flags,
+				     GCancellable *cancellable,
+				     GAsyncReadyCallback callback,
+				     gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+#ifdef HAVE_LIBCURL
+	FwupdClientDownloadReleasesData *data;
+#endif
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(releases != NULL);
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	task = g_task_new(self, cancellable, callback, callback_data);
+#ifdef HAVE_LIBCURL
+	if (priv->download_cache_dir == NULL) {
+		g_task_return_new_error(task,
+					FWUPD_ERROR,
+					FWUPD_ERROR_NOT_SUPPORTED,
+					"no download cache directory set");
+		return;
+	}
+	data = g_new0(FwupdClientDownloadReleasesData, 1);
+	data->releases = g_ptr_array_ref(releases);
+	data->download_flags = download_flags;
+	g_task_set_task_data(task, data, (GDestroyNotify)fwupd_client_download_releases_data_free);
+
+	/* the remotes are needed to build the firmware URIs */
+	fwupd_client_get_remotes_async(self,
+				       cancellable,
+				       fwupd_client_download_releases_remotes_cb,
+				       g_steal_pointer(&task));
+#else
+	g_task_return_new_error(task, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no libcurl support");
+#endif
+}
+
+/* only used for the self tests, as the releases need the daemon to build the URLs */
+void
+fwupd_client_download_checksums_async(FwupdClient *self,
+				      GPtrArray *urls,
+				      GPtrArray *checksums,
+				      GCancellable *cancellable,
+				      GAsyncReadyCallback callback,
+				      gpointer callback_data)
+{
+	g_autoptr(GTask) task = NULL;
+#ifdef HAVE_LIBCURL
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdClientDownloadReleasesData *data;
+#endif
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(urls != NULL);
+	g_return_if_fail(checksums != NULL);
+	g_return_if_fail(urls->len == checksums->len);
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+
+	task = g_task_new(self, cancellable, callback, callback_data);
+#ifdef HAVE_LIBCURL
+	if (priv->download_cache_dir == NULL) {
+		g_task_return_new_error(task,
+					FWUPD_ERROR,
+					FWUPD_ERROR_NOT_SUPPORTED,
+					"no download cache directory set");
+		return;
+	}
+	data = g_new0(FwupdClientDownloadReleasesData, 1);
+	data->helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_curl_helper_free);
+	g_task_set_task_data(task, data, (GDestroyNotify)fwupd_client_download_releases_data_free);
+	for (guint i = 0; i < urls->len; i++) {
+		const gchar *checksum = g_ptr_array_index(checksums, i);
+		g_autoptr(FwupdCurlHelper) helper = NULL;
+		g_autoptr(GError) error = NULL;
+		g_autoptr(GPtrArray) urls_tmp = g_ptr_array_new_with_free_func(g_free);
+
+		g_ptr_array_add(urls_tmp, g_strdup(g_ptr_array_index(urls, i)));
+		helper =
+		    fwupd_client_download_releases_helper_new(self, urls_tmp, checksum, &error);
+		if (helper == NULL) {
+			g_task_return_error(task, g_steal_pointer(&error));
+			return;
+		}
+		g_ptr_array_add(data->helpers, g_steal_pointer(&helper));
+	}
+	g_task_run_in_thread(task, fwupd_client_download_releases_thread_cb);
+#else
+	g_task_return_new_error(task, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no libcurl support");
+#endif
+}
+
+/**
+ * fwupd_client_download_releases_finish:
+ * @self: a #FwupdClient
+ * @res: (not nullable): the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of [method@FwupdClient.download_releases_async].
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fwupd_client_download_releases_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), FALSE);
+	g_return_val_if_fail(g_task_is_valid(res, self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return g_task_propagate_boolean(G_TASK(res), error);
+}
+
 #ifdef HAVE_LIBCURL
 static void
 fwupd_client_upload_bytes_thread_cb(GTask *task,
@@ -7592,6 +8766,7 @@ fwupd_client_init(FwupdClient *self)
 	priv->hints = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	priv->battery_level = FWUPD_BATTERY_LEVEL_INVALID;
 	priv->battery_threshold = FWUPD_BATTERY_LEVEL_INVALID;
+	priv->download_max_parallel = 4;
 	priv->immediate_requests =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
 
@@ -7606,6 +8781,7 @@ fwupd_client_finalize(GObject *object)
 	FwupdClientPrivate *priv = GET_PRIVATE(self);
 
 	g_clear_pointer(&priv->main_ctx, g_main_context_unref);
+	g_free(priv->download_cache_dir);
 	g_free(priv->user_agent);
 	g_free(priv->package_name);
 	g_free(priv->package_version);
@@ -134,6 +134,26 @@ fwupd_client_get_plugins_finish(FwupdClient *self,
 				GAsyncResult *res,
 				GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 void
+fwupd_client_get_plugin_statistics_async(FwupdClient *self,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data) G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_plugin_statistics_finish(FwupdClient *self,
+					  GAsyncResult *res,
+					  GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1, 2);
+void
+fwupd_client_get_engine_statistics_async(FwupdClient *self,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data) G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_engine_statistics_finish(FwupdClient *self,
+					  GAsyncResult *res,
+					  GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1, 2);
+void
 fwupd_client_get_history_async(FwupdClient *self,
 			       GCancellable *cancellable,
 			       GAsyncReadyCallback callback,
@@ -318,6 +338,16 @@ fwupd_client_get_host_security_events_finish(FwupdClient *self,
 					     GError **error) G_GNUC_WARN_UNUSED_RESULT
     G_GNUC_NON_NULL(1, 2);
 void
+fwupd_client_get_host_security_statistics_async(FwupdClient *self,
+						GCancellable *cancellable,
+						GAsyncReadyCallback callback,
+						gpointer callback_data) G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_host_security_statistics_finish(FwupdClient *self,
+						 GAsyncResult *res,
+						 GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1, 2);
+void
 fwupd_client_get_device_by_id_async(FwupdClient *self,
 				    const gchar *device_id,
 				    GCancellable *cancellable,
@@ -627,6 +657,22 @@ fwupd_client_download_bytes_finish(FwupdClient *self,
 void
 fwupd_client_download_set_retries(FwupdClient *self, guint retries) G_GNUC_NON_NULL(1);
 void
+fwupd_client_download_set_cache_dir(FwupdClient *self, const gchar *cache_dir) G_GNUC_NON_NULL(1);
+void
+fwupd_client_download_set_max_parallel(FwupdClient *self, guint max_parallel) G_GNUC_NON_NULL(1);
+void
+fwupd_client_download_releases_async(FwupdClient *self,
+				     GPtrArray *releases,
+				     FwupdClientDownloadFlags download_flags,
+				     GCancellable *cancellable,
+				     GAsyncReadyCallback callback,
+				     gpointer callback_data) G_GNUC_NON_NULL(1, 2);
+gboolean
+fwupd_client_download_releases_finish(FwupdClient *self,
+				      GAsyncResult *res,
+				      GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1, 2);
+void
 fwupd_client_upload_bytes_async(FwupdClient *self,
 				const gchar *url,
 				const gchar *payload,
@@ -75,6 +75,7 @@ enum {
 	PROP_ID,
 	PROP_VERSION,
 	PROP_VERSION_FORMAT,
+	PROP_VERSION_BOOTLOADER,
 	PROP_FLAGS,
 	PROP_REQUEST_FLAGS,
 	PROP_STATUS,
@@ -1264,6 +1265,7 @@ fwupd_device_set_version_bootloader(FwupdDevice *self, const gchar *version_boot
 
 	g_free(priv->version_bootloader);
 	priv->version_bootloader = g_strdup(version_bootloader);
+	g_object_notify(G_OBJECT(self), "version-bootloader");
 }
 
 /**
@@ -3603,6 +3605,9 @@ fwupd_device_get_property(GObject *object, guint prop_id, GValue *value, GParamS
 	case PROP_VERSION_FORMAT:
 		g_value_set_uint(value, priv->version_format);
 		break;
+	case PROP_VERSION_BOOTLOADER:
+		g_value_set_string(value, priv->version_bootloader);
+		break;
 	case PROP_FLAGS:
 		g_value_set_uint64(value, priv->flags);
 		break;
@@ -3653,6 +3658,9 @@ fwupd_device_set_property(GObject *object, guint prop_id, const GValue *value, G
 	case PROP_VERSION_FORMAT:
 		fwupd_device_set_version_format(self, g_value_get_uint(value));
 		break;
+	case PROP_VERSION_BOOTLOADER:
+		fwupd_device_set_version_bootloader(self, g_value_get_string(value));
+		break;
 	case PROP_FLAGS:
 		fwupd_device_set_flags(self, g_value_get_uint64(value));
 		break;
@@ -3740,6 +3748,20 @@ fwupd_device_class_init(FwupdDeviceClass *klass)
 				  G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
 	g_object_class_install_property(object_class, PROP_VERSION_FORMAT, pspec);
 
+	/**
+	 * FwupdDevice:version-bootloader:
+	 *
+	 * The bootloader version of the device.
+	 *
+	 * Since: 2.0.2
+	 */
+	pspec = g_param_spec_string("version-bootloader",
+				    NULL,
+				    NULL,
+				    NULL,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_VERSION_BOOTLOADER, pspec);
+
 	/**
 	 * FwupdDevice:flags:
 	 *
@@ -6,6 +6,7 @@
 
 #include "config.h"
 
+#include <glib/gstdio.h>
 #include <locale.h>
 #include <string.h>
 
@@ -836,6 +837,349 @@ fwupd_client_remotes_func(void)
 	g_assert_null(remote3);
 }
 
+#ifdef HAVE_LIBCURL
+#define FWUPD_TEST_HTTP_ETAG "\"fwupd-self-test\""
+
+typedef struct {
+	GBytes *payload;
+	gint request_cnt;
+	gint resume_from;
+	gint not_modified;
+	gint drop_connection; /* send half of the body and then close */
+} FwupdTestHttpServer;
+
+typedef struct {
+	GMainLoop *loop;
+	GBytes *blob;
+	gboolean ret;
+	GError *error;
+} FwupdTestDownloadHelper;
+
+static gboolean
+fwupd_test_http_server_run_cb(GThreadedSocketService *service,
+			      GSocketConnection *connection,
+			      GObject *source_object,
+			      gpointer user_data)
+{
+	FwupdTestHttpServer *server = (FwupdTestHttpServer *)user_data;
+	GOutputStream *ostream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+	gboolean not_modified = FALSE;
+	gsize bufsz = 0;
+	gsize len;
+	gsize offset = 0;
+	guint8 variant = 0;
+	const guint8 *buf = g_bytes_get_data(server->payload, &bufsz);
+	g_autoptr(GDataInputStream) istream = NULL;
+	g_autoptr(GString) hdr = g_string_new(NULL);
+
+	/* parse just enough of the request */
+	istream = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+	g_data_input_stream_set_newline_type(istream, G_DATA_STREAM_NEWLINE_TYPE_CR_LF);
+	while (TRUE) {
+		g_autofree gchar *line =
+		    g_data_input_stream_read_line(istream, NULL, NULL, NULL);
+		if (line == NULL || line[0] == '\0')
+			break;
+		if (g_str_has_prefix(line, "GET /firmware-"))
+			variant = (guint8)g_ascii_strtoull(line + 14, NULL, 10);
+		else if (g_ascii_strncasecmp(line, "If-None-Match: ", 15) == 0)
+			not_modified = g_strcmp0(line + 15, FWUPD_TEST_HTTP_ETAG) == 0;
+		else if (g_ascii_strncasecmp(line, "Range: bytes=", 13) == 0)
+			offset = g_ascii_strtoull(line + 13, NULL, 10);
+	}
+	g_atomic_int_set(&server->resume_from, (gint)offset);
+	g_atomic_int_set(&server->not_modified, not_modified);
+	g_atomic_int_inc(&server->request_cnt);
+
+	/* build the response */
+	len = bufsz - offset;
+	if (not_modified) {
+		g_string_append(hdr, "HTTP/1.1 304 Not Modified\r\n");
+		len = 0;
+	} else if (offset > 0) {
+		g_string_append(hdr, "HTTP/1.1 206 Partial Content\r\n");
+		g_string_append_printf(hdr,
+				       "Content-Range: bytes %" G_GSIZE_FORMAT "-%" G_GSIZE_FORMAT
+				       "/%" G_GSIZE_FORMAT "\r\n",
+				       offset,
+				       bufsz - 1,
+				       bufsz);
+	} else {
+		g_string_append(hdr, "HTTP/1.1 200 OK\r\n");
+	}
+	g_string_append(hdr, "ETag: " FWUPD_TEST_HTTP_ETAG "\r\n");
+	if (!not_modified)
+		g_string_append_printf(hdr, "Content-Length: %" G_GSIZE_FORMAT "\r\n", len);
+	g_string_append(hdr, "Connection: close\r\n\r\n");
+	if (!g_output_stream_write_all(ostream, hdr->str, hdr->len, NULL, NULL, NULL))
+		return TRUE;
+
+	/* simulate a connection dropped half way through */
+	if (g_atomic_int_compare_and_exchange(&server->drop_connection, TRUE, FALSE))
+		len /= 2;
+
+	/* /firmware-N.bin has the first byte changed so that each file has a different hash */
+	if (variant != 0 && offset == 0 && len > 0) {
+		guint8 tmp = buf[0] ^ variant;
+		(void)g_output_stream_write_all(ostream, &tmp, 1, NULL, NULL, NULL);
+		offset++;
+		len--;
+	}
+	(void)g_output_stream_write_all(ostream, buf + offset, len, NULL, NULL, NULL);
+	(void)g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+	return TRUE;
+}
+
+static void
+fwupd_client_download_cache_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdTestDownloadHelper *helper = (FwupdTestDownloadHelper *)user_data;
+	helper->blob =
+	    fwupd_client_download_bytes_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+static GBytes *
+fwupd_client_download_cache_checksum(FwupdClient *client,
+				     const gchar *url,
+				     const gchar *checksum,
+				     GError **error)
+{
+	FwupdTestDownloadHelper helper = {.loop = g_main_loop_new(NULL, FALSE)};
+	g_autoptr(GPtrArray) urls = g_ptr_array_new_with_free_func(g_free);
+
+	g_ptr_array_add(urls, g_strdup(url));
+	fwupd_client_download_bytes2_async(client,
+					   urls,
+					   checksum,
+					   FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+					   NULL,
+					   fwupd_client_download_cache_cb,
+					   &helper);
+	g_main_loop_run(helper.loop);
+	g_main_loop_unref(helper.loop);
+	if (helper.blob == NULL) {
+		g_propagate_error(error, helper.error);
+		return NULL;
+	}
+	return helper.blob;
+}
+
+static void
+fwupd_client_download_cache_func(void)
+{
+	FwupdTestHttpServer server = {0};
+	const gchar *fn;
+	gboolean ret;
+	guint16 port;
+	g_autofree gchar *cache_dir = NULL;
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *url = NULL;
+	g_autofree guint8 *buf = g_malloc(0x10000);
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob4 = NULL;
+	g_autoptr(GBytes) blob5 = NULL;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file_stale = NULL;
+	g_autoptr(GSocketService) service = g_threaded_socket_service_new(2);
+
+	/* serve a payload from a local HTTP server */
+	for (guint i = 0; i < 0x10000; i++)
+		buf[i] = (guint8)(i * 7);
+	server.payload = g_bytes_new(buf, 0x10000);
+	port = g_socket_listener_add_any_inet_port(G_SOCKET_LISTENER(service), NULL, &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(port, !=, 0);
+	g_signal_connect(service, "run", G_CALLBACK(fwupd_test_http_server_run_cb), &server);
+	g_socket_service_start(service);
+	url = g_strdup_printf("http://127.0.0.1:%u/firmware.bin", port);
+
+	cache_dir = g_dir_make_tmp("fwupd-self-test-XXXXXX", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(cache_dir);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	fwupd_client_download_set_cache_dir(client, cache_dir);
+
+	/* downloaded in full */
+	blob1 = fwupd_client_download_bytes(client,
+					   url,
+					   FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+					   NULL,
+					   &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob1);
+	g_assert_true(g_bytes_equal(blob1, server.payload));
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 1);
+	g_assert_false(g_atomic_int_get(&server.not_modified));
+
+	/* revalidated using the ETag */
+	blob2 = fwupd_client_download_bytes(client,
+					   url,
+					   FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+					   NULL,
+					   &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_true(g_bytes_equal(blob2, server.payload));
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 2);
+	g_assert_true(g_atomic_int_get(&server.not_modified));
+
+	/* content-addressed, and resumed after the connection was dropped */
+	checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, server.payload);
+	g_atomic_int_set(&server.drop_connection, TRUE);
+	blob3 = fwupd_client_download_cache_checksum(client, url, checksum, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_TIMED_OUT);
+	g_assert_null(blob3);
+	g_clear_error(&error);
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 3);
+	blob3 = fwupd_client_download_cache_checksum(client, url, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob3);
+	g_assert_true(g_bytes_equal(blob3, server.payload));
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 4);
+	g_assert_cmpint(g_atomic_int_get(&server.resume_from), ==, 0x10000 / 2);
+
+	/* already in the cache, so no request at all */
+	blob4 = fwupd_client_download_cache_checksum(client, url, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob4);
+	g_assert_true(g_bytes_equal(blob4, server.payload));
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 4);
+
+	/* the checksum is used as a filename, so it has to be a real hash */
+	blob5 = fwupd_client_download_cache_checksum(client, url, "../../tmp/self-test", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_null(blob5);
+	g_clear_error(&error);
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 4);
+
+	/* entries that have not been used for a long time are pruned */
+	file_stale = g_file_new_build_filename(cache_dir, checksum, NULL);
+	ret = g_file_set_attribute_uint64(file_stale,
+					  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					  (guint64)g_get_real_time() / G_USEC_PER_SEC -
+					      60 * 24 * 60 * 60,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fwupd_client_download_set_cache_dir(client, NULL);
+	fwupd_client_download_set_cache_dir(client, cache_dir);
+	g_assert_false(g_file_query_exists(file_stale, NULL));
+
+	/* clean up */
+	g_socket_service_stop(service);
+	g_socket_listener_close(G_SOCKET_LISTENER(service));
+	dir = g_dir_open(cache_dir, 0, &error);
+	g_assert_no_error(error);
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *path = g_build_filename(cache_dir, fn, NULL);
+		g_assert_cmpint(g_unlink(path), ==, 0);
+	}
+	g_assert_cmpint(g_rmdir(cache_dir), ==, 0);
+	g_bytes_unref(server.payload);
+}
+
+static void
+fwupd_client_download_checksums_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdTestDownloadHelper *helper = (FwupdTestDownloadHelper *)user_data;
+	helper->ret =
+	    fwupd_client_download_releases_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+static void
+fwupd_client_download_multi_func(void)
+{
+	FwupdTestHttpServer server = {0};
+	FwupdTestDownloadHelper helper = {0};
+	const gchar *fn;
+	guint16 port;
+	g_autofree gchar *cache_dir = NULL;
+	g_autofree guint8 *buf = g_malloc(0x10000);
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) urls = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GSocketService) service = g_threaded_socket_service_new(8);
+
+	/* serve a payload from a local HTTP server */
+	for (guint i = 0; i < 0x10000; i++)
+		buf[i] = (guint8)(i * 7);
+	server.payload = g_bytes_new(buf, 0x10000);
+	port = g_socket_listener_add_any_inet_port(G_SOCKET_LISTENER(service), NULL, &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(port, !=, 0);
+	g_signal_connect(service, "run", G_CALLBACK(fwupd_test_http_server_run_cb), &server);
+	g_socket_service_start(service);
+
+	cache_dir = g_dir_make_tmp("fwupd-self-test-XXXXXX", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(cache_dir);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	fwupd_client_download_set_cache_dir(client, cache_dir);
+	fwupd_client_download_set_max_parallel(client, 2);
+
+	/* five different files, all downloaded using the same multi handle */
+	for (guint i = 1; i <= 5; i++) {
+		g_autofree gchar *url =
+		    g_strdup_printf("http://127.0.0.1:%u/firmware-%u.bin", port, i);
+		g_ptr_array_add(urls, g_steal_pointer(&url));
+
+		/* the server changes the first byte, which is zero */
+		buf[0] = (guint8)i;
+		g_ptr_array_add(checksums,
+				g_compute_checksum_for_data(G_CHECKSUM_SHA256, buf, 0x10000));
+	}
+	helper.loop = g_main_loop_new(NULL, FALSE);
+	fwupd_client_download_checksums_async(client,
+					      urls,
+					      checksums,
+					      NULL,
+					      fwupd_client_download_checksums_cb,
+					      &helper);
+	g_main_loop_run(helper.loop);
+	g_main_loop_unref(helper.loop);
+	g_assert_no_error(helper.error);
+	g_assert_true(helper.ret);
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 5);
+
+	/* all in the cache, and verified */
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *checksum = g_ptr_array_index(checksums, i);
+		g_autoptr(GBytes) blob = NULL;
+
+		blob = fwupd_client_download_cache_checksum(client,
+							    g_ptr_array_index(urls, i),
+							    checksum,
+							    &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob);
+		g_assert_cmpint(g_bytes_get_size(blob), ==, 0x10000);
+	}
+	g_assert_cmpint(g_atomic_int_get(&server.request_cnt), ==, 5);
+
+	/* clean up */
+	g_socket_service_stop(service);
+	g_socket_listener_close(G_SOCKET_LISTENER(service));
+	dir = g_dir_open(cache_dir, 0, &error);
+	g_assert_no_error(error);
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *path = g_build_filename(cache_dir, fn, NULL);
+		g_assert_cmpint(g_unlink(path), ==, 0);
+	}
+	g_assert_cmpint(g_rmdir(cache_dir), ==, 0);
+	g_bytes_unref(server.payload);
+}
+#endif
+
 static gboolean
 fwupd_has_system_bus(void)
 {
@@ -1251,6 +1595,10 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{filter}", fwupd_device_filter_func);
 	g_test_add_func("/fwupd/security-attr", fwupd_security_attr_func);
 	g_test_add_func("/fwupd/bios-attrs", fwupd_bios_settings_func);
+#ifdef HAVE_LIBCURL
+	g_test_add_func("/fwupd/client{download-cache}", fwupd_client_download_cache_func);
+	g_test_add_func("/fwupd/client{download-multi}", fwupd_client_download_multi_func);
+#endif
 	if (fwupd_has_system_bus()) {
 		g_test_add_func("/fwupd/client{remotes}", fwupd_client_remotes_func);
 		g_test_add_func("/fwupd/client{devices}", fwupd_client_devices_func);
@@ -23,9 +23,23 @@
 #include "fu-partial-input-stream.h"
 #include "fu-string.h"
 
+typedef struct {
+	gsize offset; /* of the compressed payload, after the CFDATA header */
+	gsize size;
+} FuCabFirmwareBlock;
+
+typedef struct {
+	GArray *blocks;  /* of FuCabFirmwareBlock, only set for deferred MSZIP */
+	GPtrArray *imgs; /* of FuFirmware, not yet decompressed */
+	gsize size_uncomp;
+} FuCabFirmwareFolder;
+
 typedef struct {
 	gboolean compressed;
 	gboolean only_basename;
+	gboolean lazy_decompress;
+	GInputStream *stream;
+	GPtrArray *folders; /* of FuCabFirmwareFolder */
 } FuCabFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuCabFirmware, fu_cab_firmware, FU_TYPE_FIRMWARE)
@@ -71,6 +85,44 @@ fu_cab_firmware_set_compressed(FuCabFirmware *self, gboolean compressed)
 	priv->compressed = compressed;
 }
 
+/**
+ * fu_cab_firmware_get_lazy_decompress:
+ * @self: a #FuCabFirmware
+ *
+ * Gets if compressed files should only be decompressed when required.
+ *
+ * Returns: boolean
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_cab_firmware_get_lazy_decompress(FuCabFirmware *self)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CAB_FIRMWARE(self), FALSE);
+	return priv->lazy_decompress;
+}
+
+/**
+ * fu_cab_firmware_set_lazy_decompress:
+ * @self: a #FuCabFirmware
+ * @lazy_decompress: boolean
+ *
+ * Sets if compressed files should only be decompressed when required.
+ *
+ * If set, images stored in MSZIP folders have no stream or bytes set after parsing, and
+ * fu_cab_firmware_decompress_images() has to be used before the image data can be read.
+ *
+ * Since: 2.0.2
+ **/
+void
+fu_cab_firmware_set_lazy_decompress(FuCabFirmware *self, gboolean lazy_decompress)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CAB_FIRMWARE(self));
+	priv->lazy_decompress = lazy_decompress;
+}
+
 /**
  * fu_cab_firmware_get_only_basename:
  * @self: a #FuCabFirmware
@@ -133,6 +185,23 @@ fu_cab_firmware_parse_helper_free(FuCabFirmwareParseHelper *helper)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuCabFirmwareParseHelper, fu_cab_firmware_parse_helper_free)
 
+static FuCabFirmwareFolder *
+fu_cab_firmware_folder_new(void)
+{
+	FuCabFirmwareFolder *folder = g_new0(FuCabFirmwareFolder, 1);
+	folder->blocks = g_array_new(FALSE, FALSE, sizeof(FuCabFirmwareBlock));
+	folder->imgs = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	return folder;
+}
+
+static void
+fu_cab_firmware_folder_free(FuCabFirmwareFolder *folder)
+{
+	g_array_unref(folder->blocks);
+	g_ptr_array_unref(folder->imgs);
+	g_free(folder);
+}
+
 /* compute the MS cabinet checksum */
 static gboolean
 fu_cab_firmware_compute_checksum(const guint8 *buf, gsize bufsz, guint32 *checksum, GError **error)
@@ -186,13 +255,90 @@ fu_cab_firmware_zstream_deflater_free(z_stream_deflater *zstrm)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(z_stream_deflater, fu_cab_firmware_zstream_deflater_free)
 
+/* decompress Zlib data after removing *another *header... */
+static GBytes *
+fu_cab_firmware_inflate_block(FuCabFirmwareParseHelper *helper,
+			      gsize offset,
+			      gsize size,
+			      GError **error)
+{
+	int zret;
+	g_autofree gchar *kind = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) bytes_comp = NULL;
+
+	/* check compressed header */
+	bytes_comp = fu_input_stream_read_bytes(helper->stream, offset, size, error);
+	if (bytes_comp == NULL)
+		return NULL;
+	kind = fu_memstrsafe(g_bytes_get_data(bytes_comp, NULL),
+			     g_bytes_get_size(bytes_comp),
+			     0x0,
+			     2,
+			     error);
+	if (kind == NULL)
+		return NULL;
+	if (g_strcmp0(kind, "CK") != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "compressed header invalid: %s",
+			    kind);
+		return NULL;
+	}
+	if (helper->decompress_buf == NULL)
+		helper->decompress_buf = g_malloc0(helper->decompress_bufsz);
+	helper->zstrm.avail_in = g_bytes_get_size(bytes_comp) - 2;
+	helper->zstrm.next_in = (z_const Bytef *)g_bytes_get_data(bytes_comp, NULL) + 2;
+	while (1) {
+		helper->zstrm.avail_out = helper->decompress_bufsz;
+		helper->zstrm.next_out = helper->decompress_buf;
+		zret = inflate(&helper->zstrm, Z_BLOCK);
+		if (zret == Z_STREAM_END)
+			break;
+		g_byte_array_append(buf,
+				    helper->decompress_buf,
+				    helper->decompress_bufsz - helper->zstrm.avail_out);
+		if (zret != Z_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "inflate error @0x%x: %s",
+				    (guint)offset,
+				    zError(zret));
+			return NULL;
+		}
+	}
+	zret = inflateReset(&helper->zstrm);
+	if (zret != Z_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "failed to reset inflate: %s",
+			    zError(zret));
+		return NULL;
+	}
+	zret = inflateSetDictionary(&helper->zstrm, buf->data, buf->len);
+	if (zret != Z_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "failed to set inflate dictionary: %s",
+			    zError(zret));
+		return NULL;
+	}
+	return g_byte_array_free_to_bytes(g_steal_pointer(&buf)); /* nocheck:blocked */
+}
+
 static gboolean
 fu_cab_firmware_parse_data(FuCabFirmware *self,
 			   FuCabFirmwareParseHelper *helper,
 			   gsize *offset,
+			   FuCabFirmwareFolder *folder,
 			   GInputStream *folder_data,
 			   GError **error)
 {
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
 	gsize blob_comp;
 	gsize blob_uncomp;
 	gsize hdr_sz;
@@ -266,77 +412,17 @@ fu_cab_firmware_parse_data(FuCabFirmware *self,
 		}
 	}
 
-	/* decompress Zlib data after removing *another *header... */
-	if (helper->compression == FU_CAB_COMPRESSION_MSZIP) {
-		int zret;
-		g_autofree gchar *kind = NULL;
-		g_autoptr(GByteArray) buf = g_byte_array_new();
-		g_autoptr(GBytes) bytes_comp = NULL;
+	/* defer decompression until the image is actually required */
+	folder->size_uncomp += blob_uncomp;
+	if (helper->compression == FU_CAB_COMPRESSION_MSZIP && priv->lazy_decompress) {
+		FuCabFirmwareBlock block = {.offset = *offset + hdr_sz, .size = blob_comp};
+		g_array_append_val(folder->blocks, block);
+	} else if (helper->compression == FU_CAB_COMPRESSION_MSZIP) {
 		g_autoptr(GBytes) bytes_uncomp = NULL;
-
-		/* check compressed header */
-		bytes_comp =
-		    fu_input_stream_read_bytes(helper->stream, *offset + hdr_sz, blob_comp, error);
-		if (bytes_comp == NULL)
-			return FALSE;
-		kind = fu_memstrsafe(g_bytes_get_data(bytes_comp, NULL),
-				     g_bytes_get_size(bytes_comp),
-				     0x0,
-				     2,
-				     error);
-		if (kind == NULL)
-			return FALSE;
-		if (g_strcmp0(kind, "CK") != 0) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "compressed header invalid: %s",
-				    kind);
-			return FALSE;
-		}
-		if (helper->decompress_buf == NULL)
-			helper->decompress_buf = g_malloc0(helper->decompress_bufsz);
-		helper->zstrm.avail_in = g_bytes_get_size(bytes_comp) - 2;
-		helper->zstrm.next_in = (z_const Bytef *)g_bytes_get_data(bytes_comp, NULL) + 2;
-		while (1) {
-			helper->zstrm.avail_out = helper->decompress_bufsz;
-			helper->zstrm.next_out = helper->decompress_buf;
-			zret = inflate(&helper->zstrm, Z_BLOCK);
-			if (zret == Z_STREAM_END)
-				break;
-			g_byte_array_append(buf,
-					    helper->decompress_buf,
-					    helper->decompress_bufsz - helper->zstrm.avail_out);
-			if (zret != Z_OK) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "inflate error @0x%x: %s",
-					    (guint)*offset,
-					    zError(zret));
-				return FALSE;
-			}
-		}
-		zret = inflateReset(&helper->zstrm);
-		if (zret != Z_OK) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "failed to reset inflate: %s",
-				    zError(zret));
-			return FALSE;
-		}
-		zret = inflateSetDictionary(&helper->zstrm, buf->data, buf->len);
-		if (zret != Z_OK) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "failed to set inflate dictionary: %s",
-				    zError(zret));
-			return FALSE;
-		}
 		bytes_uncomp =
-		    g_byte_array_free_to_bytes(g_steal_pointer(&buf)); /* nocheck:blocked */
+		    fu_cab_firmware_inflate_block(helper, *offset + hdr_sz, blob_comp, error);
+		if (bytes_uncomp == NULL)
+			return FALSE;
 		fu_composite_input_stream_add_bytes(FU_COMPOSITE_INPUT_STREAM(folder_data),
 						    bytes_uncomp);
 	} else {
@@ -359,9 +445,13 @@ fu_cab_firmware_parse_folder(FuCabFirmware *self,
 			     GError **error)
 {
 	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuCabFirmwareFolder *folder = fu_cab_firmware_folder_new();
 	gsize offset_folder;
 	g_autoptr(GByteArray) st = NULL;
 
+	/* the folder index is the same as the CFFOLDER index */
+	g_ptr_array_add(priv->folders, folder);
+
 	/* parse header */
 	st = fu_struct_cab_folder_parse_stream(helper->stream, offset, error);
 	if (st == NULL)
@@ -391,7 +481,12 @@ fu_cab_firmware_parse_folder(FuCabFirmware *self,
 	/* parse CDATA */
 	offset_folder = fu_struct_cab_folder_get_offset(st);
 	for (guint i = 0; i < fu_struct_cab_folder_get_ndatab(st); i++) {
-		if (!fu_cab_firmware_parse_data(self, helper, &offset_folder, folder_data, error))
+		if (!fu_cab_firmware_parse_data(self,
+						helper,
+						&offset_folder,
+						folder,
+						folder_data,
+						error))
 			return FALSE;
 	}
 
@@ -406,6 +501,7 @@ fu_cab_firmware_parse_file(FuCabFirmware *self,
 			   GError **error)
 {
 	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuCabFirmwareFolder *folder;
 	GInputStream *folder_data;
 	guint16 date;
 	guint16 index;
@@ -435,6 +531,18 @@ fu_cab_firmware_parse_file(FuCabFirmware *self,
 		return FALSE;
 	}
 	folder_data = g_ptr_array_index(helper->folder_data, index);
+	folder = g_ptr_array_index(priv->folders, index);
+	if ((guint64)fu_struct_cab_file_get_uoffset(st) + fu_struct_cab_file_get_usize(st) >
+	    folder->size_uncomp) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "file at 0x%x of size 0x%x outside folder of size 0x%x",
+			    fu_struct_cab_file_get_uoffset(st),
+			    fu_struct_cab_file_get_usize(st),
+			    (guint)folder->size_uncomp);
+		return FALSE;
+	}
 
 	/* parse filename */
 	*offset += FU_STRUCT_CAB_FILE_SIZE;
@@ -465,14 +573,22 @@ fu_cab_firmware_parse_file(FuCabFirmware *self,
 	} else {
 		fu_firmware_set_id(FU_FIRMWARE(img), filename->str);
 	}
-	stream = fu_partial_input_stream_new(folder_data,
-					     fu_struct_cab_file_get_uoffset(st),
-					     fu_struct_cab_file_get_usize(st),
-					     error);
-	if (stream == NULL)
-		return FALSE;
-	if (!fu_firmware_parse_stream(FU_FIRMWARE(img), stream, 0x0, helper->install_flags, error))
-		return FALSE;
+	if (folder->blocks->len > 0) {
+		g_ptr_array_add(folder->imgs, g_object_ref(img));
+	} else {
+		stream = fu_partial_input_stream_new(folder_data,
+						     fu_struct_cab_file_get_uoffset(st),
+						     fu_struct_cab_file_get_usize(st),
+						     error);
+		if (stream == NULL)
+			return FALSE;
+		if (!fu_firmware_parse_stream(FU_FIRMWARE(img),
+					      stream,
+					      0x0,
+					      helper->install_flags,
+					      error))
+			return FALSE;
+	}
 	if (!fu_firmware_add_image_full(FU_FIRMWARE(self), FU_FIRMWARE(img), error))
 		return FALSE;
 
@@ -525,6 +641,119 @@ fu_cab_firmware_parse_helper_new(GInputStream *stream, FwupdInstallFlags flags,
 	return g_steal_pointer(&helper);
 }
 
+/* decompress the folder only as far as required, keeping just the data for @imgs */
+static gboolean
+fu_cab_firmware_decompress_folder(FuCabFirmware *self,
+				  FuCabFirmwareFolder *folder,
+				  GPtrArray *imgs,
+				  GError **error)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	gsize offset_end = 0;
+	gsize offset_uncomp = 0;
+	g_autoptr(FuCabFirmwareParseHelper) helper = NULL;
+	g_autoptr(GPtrArray) bufs =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+
+	for (guint i = 0; i < imgs->len; i++) {
+		FuFirmware *img = g_ptr_array_index(imgs, i);
+		gsize img_end = fu_firmware_get_offset(img) + fu_firmware_get_size(img);
+		offset_end = MAX(offset_end, img_end);
+		g_ptr_array_add(bufs, g_byte_array_sized_new(fu_firmware_get_size(img)));
+	}
+	helper = fu_cab_firmware_parse_helper_new(priv->stream, FWUPD_INSTALL_FLAG_NONE, error);
+	if (helper == NULL)
+		return FALSE;
+	for (guint i = 0; i < folder->blocks->len && offset_uncomp < offset_end; i++) {
+		FuCabFirmwareBlock *block = &g_array_index(folder->blocks, FuCabFirmwareBlock, i);
+		const guint8 *buf;
+		gsize bufsz = 0;
+		g_autoptr(GBytes) blob = NULL;
+
+		/* each block uses the previous block as the dictionary */
+		blob = fu_cab_firmware_inflate_block(helper, block->offset, block->size, error);
+		if (blob == NULL)
+			return FALSE;
+		buf = g_bytes_get_data(blob, &bufsz);
+		for (guint j = 0; j < imgs->len; j++) {
+			FuFirmware *img = g_ptr_array_index(imgs, j);
+			GByteArray *img_buf = g_ptr_array_index(bufs, j);
+			gsize start = MAX(fu_firmware_get_offset(img), offset_uncomp);
+			gsize end = MIN(fu_firmware_get_offset(img) + fu_firmware_get_size(img),
+					offset_uncomp + bufsz);
+			if (start >= end)
+				continue;
+			g_byte_array_append(img_buf, buf + (start - offset_uncomp), end - start);
+		}
+		offset_uncomp += bufsz;
+	}
+
+	/* set the data and remove from the pending list */
+	for (guint i = 0; i < imgs->len; i++) {
+		FuFirmware *img = g_ptr_array_index(imgs, i);
+		GByteArray *img_buf = g_ptr_array_index(bufs, i);
+		g_autoptr(GBytes) blob = NULL;
+
+		if (img_buf->len != fu_firmware_get_size(img)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "%s was truncated, expected 0x%x bytes and got 0x%x",
+				    fu_firmware_get_id(img),
+				    (guint)fu_firmware_get_size(img),
+				    img_buf->len);
+			return FALSE;
+		}
+		blob = g_bytes_new(img_buf->data, img_buf->len);
+		fu_firmware_set_bytes(img, blob);
+		g_ptr_array_remove(folder->imgs, img);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_cab_firmware_decompress_images:
+ * @self: a #FuCabFirmware
+ * @imgs: (element-type FuFirmware): images
+ * @error: (nullable): optional return location for an error
+ *
+ * Decompresses the images that were deferred when parsing using lazy decompression.
+ * Images that have already been decompressed are ignored.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_cab_firmware_decompress_images(FuCabFirmware *self, GPtrArray *imgs, GError **error)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	g_return_val_if_fail(FU_IS_CAB_FIRMWARE(self), FALSE);
+	g_return_val_if_fail(imgs != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	for (guint i = 0; i < priv->folders->len; i++) {
+		FuCabFirmwareFolder *folder = g_ptr_array_index(priv->folders, i);
+		g_autoptr(GPtrArray) imgs_folder = g_ptr_array_new();
+
+		for (guint j = 0; j < imgs->len; j++) {
+			FuFirmware *img = g_ptr_array_index(imgs, j);
+			if (g_ptr_array_find(folder->imgs, img, NULL))
+				g_ptr_array_add(imgs_folder, img);
+		}
+		if (imgs_folder->len == 0)
+			continue;
+		if (!fu_cab_firmware_decompress_folder(self, folder, imgs_folder, error))
+			return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gboolean
 fu_cab_firmware_parse(FuFirmware *firmware,
 		      GInputStream *stream,
@@ -532,6 +761,7 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 		      GError **error)
 {
 	FuCabFirmware *self = FU_CAB_FIRMWARE(firmware);
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
 	gsize off_cffile = 0;
 	gsize offset = 0;
 	gsize streamsz = 0;
@@ -603,6 +833,9 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 	helper = fu_cab_firmware_parse_helper_new(stream, flags, error);
 	if (helper == NULL)
 		return FALSE;
+	g_ptr_array_set_size(priv->folders, 0);
+	if (priv->lazy_decompress)
+		g_set_object(&priv->stream, stream);
 
 	/* reserved sizes */
 	offset += st->len;
@@ -619,12 +852,14 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 
 	/* parse CFFOLDER */
 	for (guint i = 0; i < fu_struct_cab_header_get_nr_folders(st); i++) {
+		FuCabFirmwareFolder *folder;
 		g_autoptr(GInputStream) folder_data = fu_composite_input_stream_new();
 		if (!fu_cab_firmware_parse_folder(self, helper, i, offset, folder_data, error))
 			return FALSE;
 		if (!fu_input_stream_size(folder_data, &streamsz, error))
 			return FALSE;
-		if (streamsz == 0) {
+		folder = g_ptr_array_index(priv->folders, i);
+		if (streamsz == 0 && folder->blocks->len == 0) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
@@ -662,6 +897,10 @@ fu_cab_firmware_write(FuFirmware *firmware, GError **error)
 	g_autoptr(GPtrArray) chunks_zlib =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
 
+	/* anything not yet required */
+	if (!fu_cab_firmware_decompress_images(self, imgs, error))
+		return NULL;
+
 	/* create linear CFDATA block */
 	for (guint i = 0; i < imgs->len; i++) {
 		FuFirmware *img = g_ptr_array_index(imgs, i);
@@ -875,10 +1114,23 @@ fu_cab_firmware_export(FuFirmware *firmware, FuFirmwareExportFlags flags, XbBuil
 	fu_xmlb_builder_insert_kb(bn, "only_basename", priv->only_basename);
 }
 
+static void
+fu_cab_firmware_finalize(GObject *object)
+{
+	FuCabFirmware *self = FU_CAB_FIRMWARE(object);
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	if (priv->stream != NULL)
+		g_object_unref(priv->stream);
+	g_ptr_array_unref(priv->folders);
+	G_OBJECT_CLASS(fu_cab_firmware_parent_class)->finalize(object);
+}
+
 static void
 fu_cab_firmware_class_init(FuCabFirmwareClass *klass)
 {
 	FuFirmwareClass *firmware_class = FU_FIRMWARE_CLASS(klass);
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_cab_firmware_finalize;
 	firmware_class->validate = fu_cab_firmware_validate;
 	firmware_class->parse = fu_cab_firmware_parse;
 	firmware_class->write = fu_cab_firmware_write;
@@ -889,6 +1141,8 @@ fu_cab_firmware_class_init(FuCabFirmwareClass *klass)
 static void
 fu_cab_firmware_init(FuCabFirmware *self)
 {
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	priv->folders = g_ptr_array_new_with_free_func((GDestroyNotify)fu_cab_firmware_folder_free);
 	g_type_ensure(FU_TYPE_CAB_IMAGE);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_STORED_SIZE);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_CHECKSUM);
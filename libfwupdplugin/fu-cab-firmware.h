@@ -24,6 +24,14 @@ gboolean
 fu_cab_firmware_get_only_basename(FuCabFirmware *self) G_GNUC_NON_NULL(1);
 void
 fu_cab_firmware_set_only_basename(FuCabFirmware *self, gboolean only_basename) G_GNUC_NON_NULL(1);
+gboolean
+fu_cab_firmware_get_lazy_decompress(FuCabFirmware *self) G_GNUC_NON_NULL(1);
+void
+fu_cab_firmware_set_lazy_decompress(FuCabFirmware *self, gboolean lazy_decompress)
+    G_GNUC_NON_NULL(1);
+gboolean
+fu_cab_firmware_decompress_images(FuCabFirmware *self, GPtrArray *imgs, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 
 FuCabFirmware *
 fu_cab_firmware_new(void) G_GNUC_WARN_UNUSED_RESULT;
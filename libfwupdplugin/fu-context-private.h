@@ -71,6 +71,17 @@ fu_context_get_config(FuContext *self) G_GNUC_NON_NULL(1);
 void
 fu_context_set_chassis_kind(FuContext *self, FuSmbiosChassisKind chassis_kind) G_GNUC_NON_NULL(1);
 
+FuFirmware *
+fu_context_get_firmware_cache(FuContext *self, GType gtype, const gchar *key) G_GNUC_NON_NULL(1, 3);
+void
+fu_context_add_firmware_cache(FuContext *self, const gchar *key, FuFirmware *firmware)
+    G_GNUC_NON_NULL(1, 2, 3);
+GHashTable *
+fu_context_get_setup_cache(FuContext *self) G_GNUC_NON_NULL(1);
+gchar *
+fu_context_get_quirks_guid(FuContext *self) G_GNUC_NON_NULL(1);
+void
+fu_context_set_setup_cache(FuContext *self, GHashTable *setup_cache) G_GNUC_NON_NULL(1);
 gpointer
 fu_context_get_data(FuContext *self, const gchar *key);
 void
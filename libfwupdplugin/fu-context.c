@@ -45,7 +45,11 @@ typedef struct {
 	GHashTable *udev_subsystems; /* utf8:GPtrArray */
 	GPtrArray *esp_volumes;
 	GHashTable *firmware_gtypes; /* utf8:GType */
+	GHashTable *firmware_cache;  /* utf8:FuFirmware */
+	GQueue firmware_cache_keys;  /* utf8, least recently used first */
+	GMutex firmware_cache_mutex; /* for firmware_cache and firmware_cache_keys */
 	GHashTable *hwid_flags;	     /* str: */
+	GHashTable *setup_cache;     /* (nullable) utf8:JsonNode */
 	FuPowerState power_state;
 	FuLidState lid_state;
 	FuDisplayState display_state;
@@ -73,6 +77,8 @@ static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuContext, fu_context, G_TYPE_OBJECT)
 
+#define FU_CONTEXT_FIRMWARE_CACHE_MAX 64
+
 #define GET_PRIVATE(o) (fu_context_get_instance_private(o))
 
 static GFile *
@@ -1995,6 +2001,106 @@ fu_context_get_backend_by_name(FuContext *self, const gchar *name, GError **erro
 	return NULL;
 }
 
+static gchar *
+fu_context_firmware_cache_key(GType gtype, const gchar *key)
+{
+	return g_strdup_printf("%s:%s", g_type_name(gtype), key);
+}
+
+/* private */
+FuFirmware *
+fu_context_get_firmware_cache(FuContext *self, GType gtype, const gchar *key)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	FuFirmware *firmware = NULL;
+	gpointer key_cache = NULL;
+	g_autofree gchar *key_full = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	key_full = fu_context_firmware_cache_key(gtype, key);
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+	if (!g_hash_table_lookup_extended(priv->firmware_cache,
+					  key_full,
+					  &key_cache,
+					  (gpointer *)&firmware))
+		return NULL;
+
+	/* now the most recently used */
+	g_queue_remove(&priv->firmware_cache_keys, key_cache);
+	g_queue_push_tail(&priv->firmware_cache_keys, key_cache);
+	return g_object_ref(firmware);
+}
+
+/* private: cache parsed firmware so that it does not have to be parsed again on replug --
+ * the firmware must not be modified after it has been added */
+void
+fu_context_add_firmware_cache(FuContext *self, const gchar *key, FuFirmware *firmware)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	gpointer key_cache = NULL;
+	g_autofree gchar *key_full = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	g_return_if_fail(key != NULL);
+	g_return_if_fail(FU_IS_FIRMWARE(firmware));
+
+	key_full = fu_context_firmware_cache_key(G_OBJECT_TYPE(firmware), key);
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+
+	/* replace the value, keeping the existing key */
+	if (g_hash_table_lookup_extended(priv->firmware_cache, key_full, &key_cache, NULL)) {
+		g_hash_table_insert(priv->firmware_cache,
+				    g_steal_pointer(&key_full),
+				    g_object_ref(firmware));
+		g_queue_remove(&priv->firmware_cache_keys, key_cache);
+		g_queue_push_tail(&priv->firmware_cache_keys, key_cache);
+		return;
+	}
+
+	/* only drop the least recently used */
+	while (g_queue_get_length(&priv->firmware_cache_keys) >= FU_CONTEXT_FIRMWARE_CACHE_MAX) {
+		gchar *key_old = g_queue_pop_head(&priv->firmware_cache_keys);
+		g_hash_table_remove(priv->firmware_cache, key_old);
+	}
+	g_queue_push_tail(&priv->firmware_cache_keys, key_full);
+	g_hash_table_insert(priv->firmware_cache,
+			    g_steal_pointer(&key_full),
+			    g_object_ref(firmware));
+}
+
+/* private: owned by the daemon, and only set when the setup cache is enabled */
+GHashTable *
+fu_context_get_setup_cache(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	return priv->setup_cache;
+}
+
+/* private */
+gchar *
+fu_context_get_quirks_guid(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	return fu_quirks_get_guid(priv->quirks);
+}
+
+/* private */
+void
+fu_context_set_setup_cache(FuContext *self, GHashTable *setup_cache)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	if (priv->setup_cache != NULL)
+		g_hash_table_unref(priv->setup_cache);
+	priv->setup_cache = setup_cache != NULL ? g_hash_table_ref(setup_cache) : NULL;
+}
+
 /* private */
 gpointer
 fu_context_get_data(FuContext *self, const gchar *key)
@@ -2102,6 +2208,11 @@ fu_context_finalize(GObject *object)
 	g_object_unref(priv->smbios);
 	g_object_unref(priv->host_bios_settings);
 	g_hash_table_unref(priv->firmware_gtypes);
+	g_queue_clear(&priv->firmware_cache_keys);
+	g_hash_table_unref(priv->firmware_cache);
+	g_mutex_clear(&priv->firmware_cache_mutex);
+	if (priv->setup_cache != NULL)
+		g_hash_table_unref(priv->setup_cache);
 	g_hash_table_unref(priv->udev_subsystems);
 	g_ptr_array_unref(priv->esp_volumes);
 	g_ptr_array_unref(priv->backends);
@@ -2274,6 +2385,10 @@ fu_context_init(FuContext *self)
 						      g_free,
 						      (GDestroyNotify)g_ptr_array_unref);
 	priv->firmware_gtypes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	priv->firmware_cache =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	g_queue_init(&priv->firmware_cache_keys);
+	g_mutex_init(&priv->firmware_cache_mutex);
 	priv->quirks = fu_quirks_new(self);
 	priv->host_bios_settings = fu_bios_settings_new();
 	priv->esp_volumes = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
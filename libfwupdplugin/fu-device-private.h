@@ -74,6 +74,23 @@ void
 fu_device_set_custom_flags(FuDevice *self, const gchar *custom_flags) G_GNUC_NON_NULL(1);
 void
 fu_device_register_private_flag_safe(FuDevice *self, const gchar *flag);
+gint64
+fu_device_get_probe_duration(FuDevice *self) G_GNUC_NON_NULL(1);
+gint64
+fu_device_get_setup_duration(FuDevice *self) G_GNUC_NON_NULL(1);
+gchar *
+fu_device_build_setup_cache_key(FuDevice *self) G_GNUC_NON_NULL(1);
+JsonNode *
+fu_device_save_setup_snapshot(FuDevice *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_device_restore_setup_snapshot(FuDevice *self, JsonNode *json_node, GError **error)
+    G_GNUC_NON_NULL(1, 2);
+gboolean
+fu_device_matches_setup_snapshot(FuDevice *self, JsonNode *json_node) G_GNUC_NON_NULL(1, 2);
+const gchar *
+fu_device_get_setup_cache_key(FuDevice *self) G_GNUC_NON_NULL(1);
+void
+fu_device_set_setup_cache_key(FuDevice *self, const gchar *setup_cache_key) G_GNUC_NON_NULL(1);
 
 void
 fu_device_add_event(FuDevice *self, FuDeviceEvent *event);
@@ -78,6 +78,9 @@ typedef struct {
 	gint poll_locker_cnt;
 	gboolean done_probe;
 	gboolean done_setup;
+	gint64 probe_duration; /* µs */
+	gint64 setup_duration; /* µs */
+	gchar *setup_cache_key;
 	gboolean device_id_valid;
 	guint64 size_min;
 	guint64 size_max;
@@ -297,6 +300,8 @@ fu_device_register_flags(FuDevice *self)
 	fu_device_register_private_flag_safe(self, FU_DEVICE_PRIVATE_FLAG_USE_RUNTIME_VERSION);
 	fu_device_register_private_flag_safe(self, FU_DEVICE_PRIVATE_FLAG_SKIPS_RESTART);
 	fu_device_register_private_flag_safe(self, FU_DEVICE_PRIVATE_FLAG_IS_FAKE);
+	fu_device_register_private_flag_safe(self, FU_DEVICE_PRIVATE_FLAG_INSTALL_MAIN_THREAD);
+	fu_device_register_private_flag_safe(self, FU_DEVICE_PRIVATE_FLAG_NO_SETUP_CACHE);
 }
 
 static void
@@ -689,6 +694,117 @@ fu_device_retry(FuDevice *self,
 	return fu_device_retry_full(self, func, count, priv->retry_delay, user_data, error);
 }
 
+/* exponential backoff limits for fu_device_retry_poll() */
+#define FU_DEVICE_RETRY_POLL_DELAY_MIN 250    /* µs */
+#define FU_DEVICE_RETRY_POLL_DELAY_MAX 100000 /* µs */
+
+/* tries needed for the delay to back off from the minimum to the maximum */
+#define FU_DEVICE_RETRY_POLL_BACKOFF_TRIES 10
+
+static gboolean
+fu_device_is_emulated_or_proxy(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	if (fu_device_has_flag(self, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+	if (priv->proxy != NULL && fu_device_has_flag(priv->proxy, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+	return FALSE;
+}
+
+/**
+ * fu_device_retry_poll:
+ * @self: a #FuDevice
+ * @func: (scope call) (closure user_data): a function to execute
+ * @timeout_ms: the maximum time to wait in milliseconds
+ * @user_data: (nullable): a helper to pass to @func
+ * @error: (nullable): optional return location for an error
+ *
+ * Calls a specific function until it succeeds, which is useful when waiting for a device to
+ * finish an operation. The function should fail with %FWUPD_ERROR_BUSY while the operation is
+ * still in progress; any other error is returned straight away.
+ *
+ * Rather than using a fixed delay between tries, the delay starts at a few hundred microseconds
+ * and doubles on each try up to 100ms. The delay is counted from the start of each try, so any
+ * time that @func already waited for is not slept again.
+ *
+ * No delays are performed when the device is emulated.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_device_retry_poll(FuDevice *self,
+		     FuDeviceRetryFunc func,
+		     guint timeout_ms,
+		     gpointer user_data,
+		     GError **error)
+{
+	gboolean emulated;
+	gint64 delay = FU_DEVICE_RETRY_POLL_DELAY_MIN;
+	gint64 start = g_get_monotonic_time();
+	guint tries_max;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
+	g_return_val_if_fail(timeout_ms > 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* emulated devices do not sleep, so stop after as many tries as a real device would
+	 * have been given before the timeout */
+	emulated = fu_device_is_emulated_or_proxy(self);
+	tries_max = FU_DEVICE_RETRY_POLL_BACKOFF_TRIES +
+		    (timeout_ms / (FU_DEVICE_RETRY_POLL_DELAY_MAX / 1000)) + 1;
+	for (guint i = 0;; i++) {
+		g_autoptr(GError) error_local = NULL;
+		gint64 elapsed;
+		gint64 sleep_us;
+		gint64 try_start = g_get_monotonic_time();
+
+		/* run function, if success return success */
+		if (func(self, user_data, &error_local))
+			break;
+
+		/* sanity check */
+		if (error_local == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "exec failed but no error set!");
+			return FALSE;
+		}
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_BUSY)) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+
+		/* too long */
+		elapsed = g_get_monotonic_time() - start;
+		if ((emulated && i + 1 >= tries_max) ||
+		    (!emulated && elapsed >= (gint64)timeout_ms * 1000)) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&error_local),
+						   "failed after %ums and %u tries: ",
+						   timeout_ms,
+						   i + 1);
+			return FALSE;
+		}
+		if (emulated)
+			continue;
+
+		/* back off */
+		sleep_us = delay - (g_get_monotonic_time() - try_start);
+		delay = MIN(delay * 2, FU_DEVICE_RETRY_POLL_DELAY_MAX);
+		sleep_us = MIN(sleep_us, ((gint64)timeout_ms * 1000) - elapsed);
+		if (sleep_us > 0)
+			g_usleep(sleep_us);
+	}
+
+	/* success */
+	return TRUE;
+}
+
 /**
  * fu_device_sleep:
  * @self: a #FuDevice
@@ -5350,7 +5466,10 @@ fu_device_probe(FuDevice *self, GError **error)
 
 	/* subclassed */
 	if (device_class->probe != NULL) {
-		if (!device_class->probe(self, error))
+		gint64 start = g_get_monotonic_time();
+		gboolean ret = device_class->probe(self, error);
+		priv->probe_duration = g_get_monotonic_time() - start;
+		if (!ret)
 			return FALSE;
 	}
 
@@ -5365,6 +5484,42 @@ fu_device_probe(FuDevice *self, GError **error)
 	return TRUE;
 }
 
+/**
+ * fu_device_get_probe_duration:
+ * @self: a #FuDevice
+ *
+ * Gets how long the last call to the `->probe()` vfunc took.
+ *
+ * Returns: duration in microseconds, or 0 if not probed
+ *
+ * Since: 2.0.2
+ **/
+gint64
+fu_device_get_probe_duration(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), 0);
+	return priv->probe_duration;
+}
+
+/**
+ * fu_device_get_setup_duration:
+ * @self: a #FuDevice
+ *
+ * Gets how long the last call to the `->setup()` vfunc took.
+ *
+ * Returns: duration in microseconds, or 0 if not set up
+ *
+ * Since: 2.0.2
+ **/
+gint64
+fu_device_get_setup_duration(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), 0);
+	return priv->setup_duration;
+}
+
 /**
  * fu_device_probe_complete:
  * @self: a #FuDevice
@@ -5512,7 +5667,10 @@ fu_device_setup(FuDevice *self, GError **error)
 
 	/* subclassed */
 	if (device_class->setup != NULL) {
-		if (!device_class->setup(self, error))
+		gint64 start = g_get_monotonic_time();
+		gboolean ret = device_class->setup(self, error);
+		priv->setup_duration = g_get_monotonic_time() - start;
+		if (!ret)
 			return FALSE;
 	}
 
@@ -5597,6 +5755,8 @@ fu_device_probe_invalidate(FuDevice *self)
 	g_return_if_fail(FU_IS_DEVICE(self));
 	priv->done_probe = FALSE;
 	priv->done_setup = FALSE;
+	priv->probe_duration = 0;
+	priv->setup_duration = 0;
 	if (device_class->invalidate != NULL)
 		device_class->invalidate(self);
 }
@@ -6107,6 +6267,352 @@ fu_device_incorporate_flag(FuDevice *self, FuDevice *donor, FwupdDeviceFlags fla
 	}
 }
 
+/**
+ * fu_device_build_setup_cache_key:
+ * @self: a #FuDevice
+ *
+ * Builds a key that identifies the device after it has been probed, but before it has been set
+ * up. If the key is the same as a previous run then the same hardware is connected to the same
+ * port, and the result of ->setup() is expected to be identical.
+ *
+ * Returns: (transfer full): a SHA-1 hash
+ *
+ * Since: 2.0.2
+ **/
+gchar *
+fu_device_build_setup_cache_key(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	GPtrArray *instance_ids;
+	g_autoptr(GString) str = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+
+	instance_ids = fwupd_device_get_instance_ids(FWUPD_DEVICE(self));
+	str = g_string_new(G_OBJECT_TYPE_NAME(self));
+	g_string_append_printf(str,
+			       "\n%s\n%s\n%s\n%04x:%04x",
+			       priv->backend_id != NULL ? priv->backend_id : "",
+			       priv->physical_id != NULL ? priv->physical_id : "",
+			       priv->logical_id != NULL ? priv->logical_id : "",
+			       priv->vid,
+			       priv->pid);
+	for (guint i = 0; i < instance_ids->len; i++) {
+		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
+		g_string_append_printf(str, "\n%s", instance_id);
+	}
+	if (priv->instance_id_quirks != NULL) {
+		for (guint i = 0; i < priv->instance_id_quirks->len; i++) {
+			const gchar *instance_id = g_ptr_array_index(priv->instance_id_quirks, i);
+			g_string_append_printf(str, "\n%s", instance_id);
+		}
+	}
+	return g_compute_checksum_for_string(G_CHECKSUM_SHA1, str->str, str->len);
+}
+
+/* flags that are set when updating or by the daemon, rather than by ->probe() or ->setup() */
+#define FU_DEVICE_SETUP_SNAPSHOT_RUNTIME_FLAGS                                                     \
+	(FWUPD_DEVICE_FLAG_SUPPORTED | FWUPD_DEVICE_FLAG_NEEDS_REBOOT |                            \
+	 FWUPD_DEVICE_FLAG_REPORTED | FWUPD_DEVICE_FLAG_NOTIFIED |                                 \
+	 FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG | FWUPD_DEVICE_FLAG_NEEDS_SHUTDOWN |                    \
+	 FWUPD_DEVICE_FLAG_ANOTHER_WRITE_REQUIRED | FWUPD_DEVICE_FLAG_NEEDS_ACTIVATION |           \
+	 FWUPD_DEVICE_FLAG_HISTORICAL | FWUPD_DEVICE_FLAG_WILL_DISAPPEAR |                         \
+	 FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN | FWUPD_DEVICE_FLAG_UNREACHABLE |                      \
+	 FWUPD_DEVICE_FLAG_EMULATED | FWUPD_DEVICE_FLAG_EMULATION_TAG)
+
+static gboolean
+fu_device_setup_snapshot_is_runtime_private_flag(const gchar *flag)
+{
+	const gchar *flags_runtime[] = {FU_DEVICE_PRIVATE_FLAG_IS_OPEN,
+					FU_DEVICE_PRIVATE_FLAG_REGISTERED,
+					FU_DEVICE_PRIVATE_FLAG_UNCONNECTED,
+					FU_DEVICE_PRIVATE_FLAG_UPDATE_PENDING,
+					NULL};
+	return g_strv_contains(flags_runtime, flag);
+}
+
+static guint64
+fu_device_setup_snapshot_get_flags(JsonObject *obj)
+{
+	JsonArray *array;
+	guint64 flags = FWUPD_DEVICE_FLAG_NONE;
+
+	if (!json_object_has_member(obj, FWUPD_RESULT_KEY_FLAGS))
+		return flags;
+	array = json_object_get_array_member(obj, FWUPD_RESULT_KEY_FLAGS);
+	for (guint i = 0; i < json_array_get_length(array); i++) {
+		const gchar *tmp = json_array_get_string_element(array, i);
+		flags |= fwupd_device_flag_from_string(tmp);
+	}
+	return flags;
+}
+
+/**
+ * fu_device_get_setup_cache_key:
+ * @self: a #FuDevice
+ *
+ * Gets the key used when the device was saved to, or restored from, the setup cache.
+ *
+ * Returns: a string, or %NULL if the device is not cached
+ *
+ * Since: 2.0.2
+ **/
+const gchar *
+fu_device_get_setup_cache_key(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+	return priv->setup_cache_key;
+}
+
+/**
+ * fu_device_set_setup_cache_key:
+ * @self: a #FuDevice
+ * @setup_cache_key: (nullable): a string, typically from fu_device_build_setup_cache_key()
+ *
+ * Sets the key used when the device was saved to, or restored from, the setup cache.
+ *
+ * Since: 2.0.2
+ **/
+void
+fu_device_set_setup_cache_key(FuDevice *self, const gchar *setup_cache_key)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_DEVICE(self));
+	if (g_strcmp0(priv->setup_cache_key, setup_cache_key) == 0)
+		return;
+	g_free(priv->setup_cache_key);
+	priv->setup_cache_key = g_strdup(setup_cache_key);
+}
+
+/**
+ * fu_device_save_setup_snapshot:
+ * @self: a #FuDevice
+ *
+ * Saves the properties of the device that were set by ->setup() so they can be restored using
+ * fu_device_restore_setup_snapshot() without talking to the hardware.
+ *
+ * Properties that change at runtime, for instance the update state or device problems, are not
+ * included.
+ *
+ * Returns: (transfer full): a #JsonNode
+ *
+ * Since: 2.0.2
+ **/
+JsonNode *
+fu_device_save_setup_snapshot(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	JsonArray *array_flags = json_array_new();
+	JsonNode *json_node;
+	JsonObject *obj;
+	guint64 flags = fu_device_get_flags(self) & ~FU_DEVICE_SETUP_SNAPSHOT_RUNTIME_FLAGS;
+	const gchar *keys_runtime[] = {FWUPD_RESULT_KEY_BATTERY_LEVEL,
+				       FWUPD_RESULT_KEY_BATTERY_THRESHOLD,
+				       FWUPD_RESULT_KEY_CREATED,
+				       FWUPD_RESULT_KEY_FLAGS,
+				       FWUPD_RESULT_KEY_MODIFIED,
+				       FWUPD_RESULT_KEY_PERCENTAGE,
+				       FWUPD_RESULT_KEY_PLUGIN,
+				       FWUPD_RESULT_KEY_PROBLEMS,
+				       FWUPD_RESULT_KEY_STATUS,
+				       FWUPD_RESULT_KEY_UPDATE_ERROR,
+				       FWUPD_RESULT_KEY_UPDATE_STATE,
+				       "Releases",
+				       NULL};
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+
+	json_builder_begin_object(builder);
+	fwupd_codec_to_json(FWUPD_CODEC(self), builder, FWUPD_CODEC_FLAG_TRUSTED);
+	if (priv->instance_id_quirks != NULL && priv->instance_id_quirks->len > 0) {
+		json_builder_set_member_name(builder, "InstanceIdQuirks");
+		json_builder_begin_array(builder);
+		for (guint i = 0; i < priv->instance_id_quirks->len; i++) {
+			const gchar *instance_id = g_ptr_array_index(priv->instance_id_quirks, i);
+			json_builder_add_string_value(builder, instance_id);
+		}
+		json_builder_end_array(builder);
+	}
+	if (priv->private_flags->len > 0) {
+		json_builder_set_member_name(builder, "PrivateFlags");
+		json_builder_begin_array(builder);
+		for (guint i = 0; i < priv->private_flags->len; i++) {
+			const gchar *flag = g_ptr_array_index(priv->private_flags, i);
+			if (fu_device_setup_snapshot_is_runtime_private_flag(flag))
+				continue;
+			json_builder_add_string_value(builder, flag);
+		}
+		json_builder_end_array(builder);
+	}
+	if (priv->size_min > 0)
+		fwupd_codec_json_append_int(builder, "FirmwareSizeMin", priv->size_min);
+	if (priv->size_max > 0)
+		fwupd_codec_json_append_int(builder, "FirmwareSizeMax", priv->size_max);
+	if (priv->metadata != NULL && g_hash_table_size(priv->metadata) > 0) {
+		GHashTableIter iter;
+		gpointer key, value;
+		json_builder_set_member_name(builder, "Metadata");
+		json_builder_begin_object(builder);
+		g_hash_table_iter_init(&iter, priv->metadata);
+		while (g_hash_table_iter_next(&iter, &key, &value))
+			fwupd_codec_json_append(builder, key, value);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_object(builder);
+
+	/* these are not set by ->setup() */
+	json_node = json_builder_get_root(builder);
+	obj = json_node_get_object(json_node);
+	for (guint i = 0; keys_runtime[i] != NULL; i++) {
+		if (json_object_has_member(obj, keys_runtime[i]))
+			json_object_remove_member(obj, keys_runtime[i]);
+	}
+
+	/* only the flags set by ->probe() and ->setup() */
+	for (guint i = 0; i < 64; i++) {
+		if ((flags & ((guint64)1 << i)) == 0)
+			continue;
+		json_array_add_string_element(array_flags,
+					      fwupd_device_flag_to_string((guint64)1 << i));
+	}
+	json_object_set_array_member(obj, FWUPD_RESULT_KEY_FLAGS, array_flags);
+	return json_node;
+}
+
+/**
+ * fu_device_restore_setup_snapshot:
+ * @self: a #FuDevice
+ * @json_node: a #JsonNode from fu_device_save_setup_snapshot()
+ * @error: (nullable): optional return location for an error
+ *
+ * Restores the properties that were set by ->setup() the last time the device was enumerated.
+ * The device is not marked as set up, and so ->setup() is still run the first time the device
+ * is opened, for instance when updating the firmware.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_device_restore_setup_snapshot(FuDevice *self, JsonNode *json_node, GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	JsonObject *obj;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(json_node != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* sanity check */
+	if (!JSON_NODE_HOLDS_OBJECT(json_node)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "not JSON object");
+		return FALSE;
+	}
+	obj = json_node_get_object(json_node);
+	if (!json_object_has_member(obj, FWUPD_RESULT_KEY_DEVICE_ID)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "no %s property in object",
+			    FWUPD_RESULT_KEY_DEVICE_ID);
+		return FALSE;
+	}
+
+	/* add the instance IDs before the baseclass does so that the quirks also match */
+	if (json_object_has_member(obj, FWUPD_RESULT_KEY_INSTANCE_IDS)) {
+		JsonArray *array = json_object_get_array_member(obj, FWUPD_RESULT_KEY_INSTANCE_IDS);
+		for (guint i = 0; i < json_array_get_length(array); i++) {
+			const gchar *instance_id = json_array_get_string_element(array, i);
+			if (fu_device_has_instance_id(self, instance_id))
+				continue;
+			fu_device_add_instance_id(self, instance_id);
+		}
+	}
+	if (json_object_has_member(obj, "InstanceIdQuirks")) {
+		JsonArray *array = json_object_get_array_member(obj, "InstanceIdQuirks");
+		for (guint i = 0; i < json_array_get_length(array); i++) {
+			const gchar *instance_id = json_array_get_string_element(array, i);
+			if (fu_device_has_instance_id_quirk(self, instance_id))
+				continue;
+			fu_device_add_instance_id_full(self,
+						       instance_id,
+						       FU_DEVICE_INSTANCE_FLAG_QUIRKS);
+		}
+	}
+	if (!fwupd_codec_from_json(FWUPD_CODEC(self), json_node, error))
+		return FALSE;
+	priv->device_id_valid = TRUE;
+
+	/* FuDevice */
+	if (json_object_has_member(obj, "PrivateFlags")) {
+		JsonArray *array = json_object_get_array_member(obj, "PrivateFlags");
+		for (guint i = 0; i < json_array_get_length(array); i++)
+			fu_device_add_private_flag(self, json_array_get_string_element(array, i));
+	}
+	if (json_object_has_member(obj, "FirmwareSizeMin")) {
+		gint64 tmp = json_object_get_int_member_with_default(obj, "FirmwareSizeMin", 0);
+		fu_device_set_firmware_size_min(self, tmp);
+	}
+	if (json_object_has_member(obj, "FirmwareSizeMax")) {
+		gint64 tmp = json_object_get_int_member_with_default(obj, "FirmwareSizeMax", 0);
+		fu_device_set_firmware_size_max(self, tmp);
+	}
+	if (json_object_has_member(obj, "Metadata")) {
+		JsonObject *obj_md = json_object_get_object_member(obj, "Metadata");
+		g_autoptr(GList) keys = json_object_get_members(obj_md);
+		for (GList *l = keys; l != NULL; l = l->next) {
+			const gchar *key = l->data;
+			const gchar *value =
+			    json_object_get_string_member_with_default(obj_md, key, NULL);
+			if (value != NULL)
+				fu_device_set_metadata(self, key, value);
+		}
+	}
+
+	/* convert the instance IDs added by ->probe() */
+	fu_device_convert_instance_ids(self);
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_device_matches_setup_snapshot:
+ * @self: a #FuDevice
+ * @json_node: a #JsonNode from fu_device_save_setup_snapshot()
+ *
+ * Checks if the version and the flags set by ->probe() and ->setup() are still the same as when
+ * the snapshot was saved.
+ *
+ * Returns: %TRUE if the snapshot is still valid
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_device_matches_setup_snapshot(FuDevice *self, JsonNode *json_node)
+{
+	JsonObject *obj;
+	guint64 flags = fu_device_get_flags(self) & ~FU_DEVICE_SETUP_SNAPSHOT_RUNTIME_FLAGS;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(json_node != NULL, FALSE);
+
+	if (!JSON_NODE_HOLDS_OBJECT(json_node))
+		return FALSE;
+	obj = json_node_get_object(json_node);
+	if (g_strcmp0(json_object_get_string_member_with_default(obj,
+								 FWUPD_RESULT_KEY_VERSION,
+								 NULL),
+		      fu_device_get_version(self)) != 0)
+		return FALSE;
+	return fu_device_setup_snapshot_get_flags(obj) == flags;
+}
+
 /**
  * fu_device_incorporate_from_component: (skip):
  * @self: a device
@@ -7455,6 +7961,7 @@ fu_device_finalize(GObject *object)
 	g_free(priv->update_image);
 	g_free(priv->proxy_guid);
 	g_free(priv->custom_flags);
+	g_free(priv->setup_cache_key);
 
 	G_OBJECT_CLASS(fu_device_parent_class)->finalize(object);
 }
@@ -781,6 +781,26 @@ fu_device_new(FuContext *ctx);
  */
 #define FU_DEVICE_PRIVATE_FLAG_IS_FAKE "is-fake"
 
+/**
+ * FU_DEVICE_PRIVATE_FLAG_INSTALL_MAIN_THREAD:
+ *
+ * The device iterates the default main context during the update, and so cannot be updated from
+ * the daemon install worker thread.
+ *
+ * Since: 2.0.2
+ */
+#define FU_DEVICE_PRIVATE_FLAG_INSTALL_MAIN_THREAD "install-main-thread"
+
+/**
+ * FU_DEVICE_PRIVATE_FLAG_NO_SETUP_CACHE:
+ *
+ * Do not restore the device from the setup cache when the daemon is restarted, for instance
+ * because the version can change without the device being re-enumerated.
+ *
+ * Since: 2.0.2
+ */
+#define FU_DEVICE_PRIVATE_FLAG_NO_SETUP_CACHE "no-setup-cache"
+
 /* accessors */
 gchar *
 fu_device_to_string(FuDevice *self) G_GNUC_NON_NULL(1);
@@ -1054,6 +1074,12 @@ fu_device_retry_full(FuDevice *self,
 		     guint delay,
 		     gpointer user_data,
 		     GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+gboolean
+fu_device_retry_poll(FuDevice *self,
+		     FuDeviceRetryFunc func,
+		     guint timeout_ms,
+		     gpointer user_data,
+		     GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 void
 fu_device_sleep(FuDevice *self, guint delay_ms) G_GNUC_NON_NULL(1);
 void
@@ -229,3 +229,63 @@ fu_firmware_strparse_uint32_safe(const gchar *data,
 		*value = (guint32)valuetmp;
 	return TRUE;
 }
+
+/* the nibble value plus one, so that zero means an invalid character */
+static const guint8 fu_firmware_strparse_hex_table[256] = {
+    ['0'] = 0x01, ['1'] = 0x02, ['2'] = 0x03, ['3'] = 0x04, ['4'] = 0x05, ['5'] = 0x06,
+    ['6'] = 0x07, ['7'] = 0x08, ['8'] = 0x09, ['9'] = 0x0A, ['A'] = 0x0B, ['B'] = 0x0C,
+    ['C'] = 0x0D, ['D'] = 0x0E, ['E'] = 0x0F, ['F'] = 0x10, ['a'] = 0x0B, ['b'] = 0x0C,
+    ['c'] = 0x0D, ['d'] = 0x0E, ['e'] = 0x0F, ['f'] = 0x10,
+};
+
+/**
+ * fu_firmware_strparse_buf_safe:
+ * @data: source string
+ * @datasz: size of @data, typically the same as `strlen(data)`
+ * @offset: offset in chars into @data to read
+ * @buf: destination buffer
+ * @bufsz: number of bytes to decode into @buf, using `bufsz * 2` chars from @data
+ * @error: (nullable): optional return location for an error
+ *
+ * Decodes a run of base 16 digit pairs into a buffer in one pass, without allocating.
+ *
+ * Returns: %TRUE if parsed, %FALSE otherwise
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_firmware_strparse_buf_safe(const gchar *data,
+			      gsize datasz,
+			      gsize offset,
+			      guint8 *buf,
+			      gsize bufsz,
+			      GError **error)
+{
+	const guint8 *str = (const guint8 *)data + offset;
+
+	if (offset > datasz || bufsz > (datasz - offset) / 2) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "cannot parse 0x%x bytes of hex at offset 0x%x from 0x%x chars",
+			    (guint)bufsz,
+			    (guint)offset,
+			    (guint)datasz);
+		return FALSE;
+	}
+	for (gsize i = 0; i < bufsz; i++) {
+		guint8 hi = fu_firmware_strparse_hex_table[str[i * 2]];
+		guint8 lo = fu_firmware_strparse_hex_table[str[(i * 2) + 1]];
+		if (hi == 0 || lo == 0) {
+			g_autofree gchar *strsafe = fu_strsafe((const gchar *)str + (i * 2), 2);
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "cannot parse %s as hex",
+				    strsafe);
+			return FALSE;
+		}
+		buf[i] = ((hi - 1) << 4) | (lo - 1);
+	}
+	return TRUE;
+}
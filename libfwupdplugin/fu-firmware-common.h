@@ -38,3 +38,10 @@ fu_firmware_strparse_uint32_safe(const gchar *data,
 				 gsize offset,
 				 guint32 *value,
 				 GError **error) G_GNUC_NON_NULL(1);
+gboolean
+fu_firmware_strparse_buf_safe(const gchar *data,
+			      gsize datasz,
+			      gsize offset,
+			      guint8 *buf,
+			      gsize bufsz,
+			      GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 4);
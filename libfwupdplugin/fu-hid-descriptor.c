@@ -22,12 +22,37 @@
  *
  * Each report is a image of this firmware object and each report has children of #FuHidReportItem.
  *
+ * When parsed, the reports are also stored in a compact table which is used for
+ * fu_hid_descriptor_find_report(). The images are all created by the parse, so that the object is
+ * not modified afterwards and can be shared between devices.
+ *
  * Documented: https://www.usb.org/sites/default/files/hid1_11.pdf
  *
  * See also: [class@FuFirmware]
  */
 
-G_DEFINE_TYPE(FuHidDescriptor, fu_hid_descriptor, FU_TYPE_FIRMWARE)
+/* a parsed item, without the overhead of a FuHidReportItem */
+typedef struct {
+	guint32 offset;
+	guint32 value;
+	guint8 tag;
+} FuHidDescriptorItem;
+
+/* a report is a range of indexes into report_items, deduped by tag like FuHidReport */
+typedef struct {
+	guint64 tags; /* bitmask */
+	guint report_items_idx;
+	guint report_items_cnt;
+} FuHidDescriptorReport;
+
+typedef struct {
+	GArray *items;	      /* of FuHidDescriptorItem */
+	GArray *report_items; /* of guint, index into items */
+	GArray *reports;      /* of FuHidDescriptorReport */
+} FuHidDescriptorPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE(FuHidDescriptor, fu_hid_descriptor, FU_TYPE_FIRMWARE)
+#define GET_PRIVATE(o) (fu_hid_descriptor_get_instance_private(o))
 
 #define FU_HID_DESCRIPTOR_TABLE_LOCAL_SIZE_MAX	 1024
 #define FU_HID_DESCRIPTOR_TABLE_LOCAL_DUPES_MAX	 16
@@ -35,37 +60,223 @@ G_DEFINE_TYPE(FuHidDescriptor, fu_hid_descriptor, FU_TYPE_FIRMWARE)
 #define FU_HID_DESCRIPTOR_TABLE_GLOBAL_DUPES_MAX 64
 
 static guint
-fu_hid_descriptor_count_table_dupes(GPtrArray *table, FuHidReportItem *item)
+fu_hid_descriptor_count_table_dupes(FuHidDescriptor *self, GArray *table, FuHidDescriptorItem *item)
 {
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
 	guint cnt = 0;
 	for (guint i = 0; i < table->len; i++) {
-		FuHidReportItem *item_tmp = g_ptr_array_index(table, i);
-		if (fu_hid_report_item_get_kind(item) == fu_hid_report_item_get_kind(item_tmp) &&
-		    fu_hid_report_item_get_value(item) == fu_hid_report_item_get_value(item_tmp) &&
-		    fu_firmware_get_idx(FU_FIRMWARE(item)) ==
-			fu_firmware_get_idx(FU_FIRMWARE(item_tmp)))
+		guint idx = g_array_index(table, guint, i);
+		FuHidDescriptorItem *item_tmp =
+		    &g_array_index(priv->items, FuHidDescriptorItem, idx);
+		if (item->tag == item_tmp->tag && item->value == item_tmp->value)
 			cnt++;
 	}
 	return cnt;
 }
 
+/* this matches what fu_hid_report_item_parse() does */
+static gboolean
+fu_hid_descriptor_parse_item(const guint8 *buf,
+			     gsize bufsz,
+			     gsize offset,
+			     FuHidDescriptorItem *item,
+			     gsize *itemsz,
+			     GError **error)
+{
+	const guint8 size_lookup[] = {0, 1, 2, 4};
+	guint8 data_size;
+	guint8 val = 0;
+
+	if (!fu_memread_uint8_safe(buf, bufsz, offset, &val, error))
+		return FALSE;
+	data_size = size_lookup[val & 0b11];
+	item->offset = offset;
+	item->tag = (val & 0b11111100) >> 2;
+	item->value = 0;
+
+	if (item->tag == FU_HID_ITEM_TAG_LONG && data_size == 2) {
+		if (!fu_memread_uint8_safe(buf, bufsz, offset + 1, &data_size, error))
+			return FALSE;
+	} else {
+		if (offset + 1 + data_size > bufsz) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "HID item @0x%x has 0x%x bytes of data, but only 0x%x remain",
+				    (guint)offset,
+				    data_size,
+				    (guint)(bufsz - (offset + 1)));
+			return FALSE;
+		}
+		if (data_size == 1) {
+			guint8 value = 0;
+			if (!fu_memread_uint8_safe(buf, bufsz, offset + 1, &value, error))
+				return FALSE;
+			item->value = value;
+		} else if (data_size == 2) {
+			guint16 value = 0;
+			if (!fu_memread_uint16_safe(buf,
+						    bufsz,
+						    offset + 1,
+						    &value,
+						    G_LITTLE_ENDIAN,
+						    error))
+				return FALSE;
+			item->value = value;
+		} else if (data_size == 4) {
+			if (!fu_memread_uint32_safe(buf,
+						    bufsz,
+						    offset + 1,
+						    &item->value,
+						    G_LITTLE_ENDIAN,
+						    error))
+				return FALSE;
+		}
+	}
+
+	/* success */
+	*itemsz = 1 + data_size;
+	return TRUE;
+}
+
+static gboolean
+fu_hid_descriptor_add_report(FuHidDescriptor *self,
+			     GArray *table_state,
+			     GArray *table_local,
+			     GError **error)
+{
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	FuHidDescriptorReport report = {.report_items_idx = priv->report_items->len};
+	guint images_max = fu_firmware_get_images_max(FU_FIRMWARE(self));
+
+	/* sanity check */
+	if (images_max > 0 && priv->reports->len >= images_max) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "too many images, limit is %u",
+			    images_max);
+		return FALSE;
+	}
+
+	/* copy the table state then the local items, where a later tag replaces an earlier one
+	 * in the same way as FU_FIRMWARE_FLAG_DEDUPE_IDX */
+	for (guint i = 0; i < table_state->len + table_local->len; i++) {
+		guint idx = i < table_state->len
+				? g_array_index(table_state, guint, i)
+				: g_array_index(table_local, guint, i - table_state->len);
+		FuHidDescriptorItem *item = &g_array_index(priv->items, FuHidDescriptorItem, idx);
+		guint64 tag_bit = (guint64)1 << item->tag;
+		if (report.tags & tag_bit) {
+			for (guint j = report.report_items_idx; j < priv->report_items->len; j++) {
+				guint idx_tmp = g_array_index(priv->report_items, guint, j);
+				FuHidDescriptorItem *item_tmp =
+				    &g_array_index(priv->items, FuHidDescriptorItem, idx_tmp);
+				if (item_tmp->tag == item->tag) {
+					g_array_remove_index(priv->report_items, j);
+					break;
+				}
+			}
+		}
+		g_array_append_val(priv->report_items, idx);
+		report.tags |= tag_bit;
+	}
+	report.report_items_cnt = priv->report_items->len - report.report_items_idx;
+	g_array_append_val(priv->reports, report);
+
+	/* success */
+	return TRUE;
+}
+
+static FuHidReport *
+fu_hid_descriptor_build_report(FuHidDescriptor *self,
+			       GInputStream *stream,
+			       GPtrArray *report_items,
+			       FuHidDescriptorReport *report,
+			       GError **error)
+{
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuHidReport) report_obj = fu_hid_report_new();
+
+	for (guint i = 0; i < report->report_items_cnt; i++) {
+		guint idx = g_array_index(priv->report_items, guint, report->report_items_idx + i);
+		FuHidDescriptorItem *item = &g_array_index(priv->items, FuHidDescriptorItem, idx);
+		g_autoptr(FuFirmware) item_obj = NULL;
+
+		/* items are shared between reports, just like the table state */
+		if (g_ptr_array_index(report_items, idx) != NULL) {
+			item_obj = g_object_ref(g_ptr_array_index(report_items, idx));
+		} else {
+			item_obj = FU_FIRMWARE(fu_hid_report_item_new());
+			if (!fu_firmware_parse_stream(item_obj,
+						      stream,
+						      item->offset,
+						      FWUPD_INSTALL_FLAG_NONE,
+						      error))
+				return NULL;
+			g_ptr_array_index(report_items, idx) = g_object_ref(item_obj);
+		}
+		if (!fu_firmware_add_image_full(FU_FIRMWARE(report_obj), item_obj, error))
+			return NULL;
+	}
+
+	/* success */
+	return g_steal_pointer(&report_obj);
+}
+
+/* create the FuHidReport objects from the compiled table */
+static gboolean
+fu_hid_descriptor_add_report_images(FuHidDescriptor *self, GInputStream *stream, GError **error)
+{
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GPtrArray) report_items = NULL;
+
+	report_items = g_ptr_array_new_full(priv->items->len, (GDestroyNotify)g_object_unref);
+	g_ptr_array_set_size(report_items, priv->items->len);
+	for (guint i = 0; i < priv->reports->len; i++) {
+		FuHidDescriptorReport *report =
+		    &g_array_index(priv->reports, FuHidDescriptorReport, i);
+		g_autoptr(FuHidReport) report_obj = NULL;
+		report_obj =
+		    fu_hid_descriptor_build_report(self, stream, report_items, report, error);
+		if (report_obj == NULL)
+			return FALSE;
+		if (!fu_firmware_add_image_full(FU_FIRMWARE(self), FU_FIRMWARE(report_obj), error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_hid_descriptor_parse(FuFirmware *firmware,
 			GInputStream *stream,
 			FwupdInstallFlags flags,
 			GError **error)
 {
+	FuHidDescriptor *self = FU_HID_DESCRIPTOR(firmware);
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
 	gsize offset = 0;
-	gsize streamsz = 0;
-	g_autoptr(GPtrArray) table_state =
-	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	g_autoptr(GPtrArray) table_local =
-	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	if (!fu_input_stream_size(stream, &streamsz, error))
+	gsize bufsz = 0;
+	const guint8 *buf;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GArray) table_state = g_array_new(FALSE, FALSE, sizeof(guint));
+	g_autoptr(GArray) table_local = g_array_new(FALSE, FALSE, sizeof(guint));
+
+	g_array_set_size(priv->items, 0);
+	g_array_set_size(priv->report_items, 0);
+	g_array_set_size(priv->reports, 0);
+
+	if (!fu_input_stream_size(stream, &bufsz, error))
+		return FALSE;
+	blob = fu_input_stream_read_bytes(stream, 0x0, bufsz, error);
+	if (blob == NULL)
 		return FALSE;
-	while (offset < streamsz) {
-		g_autofree gchar *itemstr = NULL;
-		g_autoptr(FuHidReportItem) item = fu_hid_report_item_new();
+	buf = g_bytes_get_data(blob, &bufsz);
+	while (offset < bufsz) {
+		FuHidDescriptorItem item = {0};
+		FuHidItemKind kind;
+		gsize itemsz = 0;
+		guint idx = priv->items->len;
 
 		/* sanity check */
 		if (table_state->len > FU_HID_DESCRIPTOR_TABLE_GLOBAL_SIZE_MAX) {
@@ -85,17 +296,15 @@ fu_hid_descriptor_parse(FuFirmware *firmware,
 			return FALSE;
 		}
 
-		if (!fu_firmware_parse_stream(FU_FIRMWARE(item), stream, offset, flags, error))
+		if (!fu_hid_descriptor_parse_item(buf, bufsz, offset, &item, &itemsz, error))
 			return FALSE;
-		offset += fu_firmware_get_size(FU_FIRMWARE(item));
-
-		/* only for debugging */
-		itemstr = fu_firmware_to_string(FU_FIRMWARE(item));
-		g_debug("add to table-state:\n%s", itemstr);
+		offset += itemsz;
+		g_array_append_val(priv->items, item);
 
 		/* if there is a sane number of duplicate tokens then add to table */
-		if (fu_hid_report_item_get_kind(item) == FU_HID_ITEM_KIND_GLOBAL) {
-			if (fu_hid_descriptor_count_table_dupes(table_state, item) >
+		kind = item.tag & 0b11;
+		if (kind == FU_HID_ITEM_KIND_GLOBAL) {
+			if (fu_hid_descriptor_count_table_dupes(self, table_state, &item) >
 			    FU_HID_DESCRIPTOR_TABLE_GLOBAL_DUPES_MAX) {
 				g_set_error(
 				    error,
@@ -103,13 +312,12 @@ fu_hid_descriptor_parse(FuFirmware *firmware,
 				    FWUPD_ERROR_INVALID_DATA,
 				    "table invalid @0x%x, too many duplicate global %s tokens",
 				    (guint)offset,
-				    fu_firmware_get_id(FU_FIRMWARE(item)));
+				    fu_hid_item_tag_to_string(item.tag));
 				return FALSE;
 			}
-			g_ptr_array_add(table_state, g_object_ref(item));
-		} else if (fu_hid_report_item_get_kind(item) == FU_HID_ITEM_KIND_LOCAL ||
-			   fu_hid_report_item_get_kind(item) == FU_HID_ITEM_KIND_MAIN) {
-			if (fu_hid_descriptor_count_table_dupes(table_local, item) >
+			g_array_append_val(table_state, idx);
+		} else if (kind == FU_HID_ITEM_KIND_LOCAL || kind == FU_HID_ITEM_KIND_MAIN) {
+			if (fu_hid_descriptor_count_table_dupes(self, table_local, &item) >
 			    FU_HID_DESCRIPTOR_TABLE_LOCAL_DUPES_MAX) {
 				g_set_error(
 				    error,
@@ -117,43 +325,26 @@ fu_hid_descriptor_parse(FuFirmware *firmware,
 				    FWUPD_ERROR_INVALID_DATA,
 				    "table invalid @0x%x, too many duplicate %s %s:0x%x tokens",
 				    (guint)offset,
-				    fu_hid_item_kind_to_string(fu_hid_report_item_get_kind(item)),
-				    fu_firmware_get_id(FU_FIRMWARE(item)),
-				    fu_hid_report_item_get_value(item));
+				    fu_hid_item_kind_to_string(kind),
+				    fu_hid_item_tag_to_string(item.tag),
+				    item.value);
 				return FALSE;
 			}
-			g_ptr_array_add(table_local, g_object_ref(item));
+			g_array_append_val(table_local, idx);
 		}
 
 		/* add report */
-		if (fu_hid_report_item_get_kind(item) == FU_HID_ITEM_KIND_MAIN) {
-			g_autoptr(FuHidReport) report = fu_hid_report_new();
-
-			/* copy the table state to the new report */
-			for (guint i = 0; i < table_state->len; i++) {
-				FuHidReportItem *item_tmp = g_ptr_array_index(table_state, i);
-				if (!fu_firmware_add_image_full(FU_FIRMWARE(report),
-								FU_FIRMWARE(item_tmp),
-								error))
-					return FALSE;
-			}
-			for (guint i = 0; i < table_local->len; i++) {
-				FuHidReportItem *item_tmp = g_ptr_array_index(table_local, i);
-				if (!fu_firmware_add_image_full(FU_FIRMWARE(report),
-								FU_FIRMWARE(item_tmp),
-								error))
-					return FALSE;
-			}
-			if (!fu_firmware_add_image_full(firmware, FU_FIRMWARE(report), error))
+		if (kind == FU_HID_ITEM_KIND_MAIN) {
+			if (!fu_hid_descriptor_add_report(self, table_state, table_local, error))
 				return FALSE;
 
 			/* remove all the local items */
-			g_ptr_array_set_size(table_local, 0);
+			g_array_set_size(table_local, 0);
 		}
 	}
 
-	/* success */
-	return TRUE;
+	/* create all the images now, as a parsed descriptor may be shared between devices */
+	return fu_hid_descriptor_add_report_images(self, stream, error);
 }
 
 static gboolean
@@ -228,6 +419,62 @@ typedef struct {
 	guint32 value;
 } FuHidDescriptorCondition;
 
+static FuHidReport *
+fu_hid_descriptor_find_report_compiled(FuHidDescriptor *self, GPtrArray *conditions, GError **error)
+{
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	guint64 tags = 0;
+	g_autofree guint8 *cond_tags = g_new0(guint8, conditions->len + 1);
+	g_autoptr(GPtrArray) reports = NULL;
+
+	/* an unknown ID can never match */
+	for (guint j = 0; j < conditions->len; j++) {
+		FuHidDescriptorCondition *cond = g_ptr_array_index(conditions, j);
+		cond_tags[j] = fu_hid_item_tag_from_string(cond->id);
+		if (g_strcmp0(fu_hid_item_tag_to_string(cond_tags[j]), cond->id) != 0) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_FOUND,
+					    "no report found");
+			return NULL;
+		}
+		tags |= (guint64)1 << cond_tags[j];
+	}
+
+	/* return the first report that matches *all* conditions */
+	for (guint i = 0; i < priv->reports->len; i++) {
+		FuHidDescriptorReport *report =
+		    &g_array_index(priv->reports, FuHidDescriptorReport, i);
+		gboolean matched = TRUE;
+
+		/* quick check all the tags exist */
+		if ((report->tags & tags) != tags)
+			continue;
+		for (guint j = 0; matched && j < conditions->len; j++) {
+			FuHidDescriptorCondition *cond = g_ptr_array_index(conditions, j);
+			for (guint k = 0; k < report->report_items_cnt; k++) {
+				guint idx = g_array_index(priv->report_items,
+							  guint,
+							  report->report_items_idx + k);
+				FuHidDescriptorItem *item =
+				    &g_array_index(priv->items, FuHidDescriptorItem, idx);
+				if (item->tag == cond_tags[j]) {
+					matched = item->value == cond->value;
+					break;
+				}
+			}
+		}
+		if (!matched)
+			continue;
+
+		/* the image was created for each report when parsing */
+		reports = fu_firmware_get_images(FU_FIRMWARE(self));
+		return g_object_ref(g_ptr_array_index(reports, i));
+	}
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no report found");
+	return NULL;
+}
+
 /**
  * fu_hid_descriptor_find_report:
  * @self: a #FuHidDescriptor
@@ -243,9 +490,10 @@ typedef struct {
 FuHidReport *
 fu_hid_descriptor_find_report(FuHidDescriptor *self, GError **error, ...)
 {
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
 	va_list args;
 	g_autoptr(GPtrArray) conditions = g_ptr_array_new_with_free_func(g_free);
-	g_autoptr(GPtrArray) reports = fu_firmware_get_images(FU_FIRMWARE(self));
+	g_autoptr(GPtrArray) reports = NULL;
 
 	g_return_val_if_fail(FU_IS_HID_DESCRIPTOR(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
@@ -262,7 +510,12 @@ fu_hid_descriptor_find_report(FuHidDescriptor *self, GError **error, ...)
 	}
 	va_end(args);
 
+	/* use the compiled table if parsed */
+	if (priv->reports->len > 0)
+		return fu_hid_descriptor_find_report_compiled(self, conditions, error);
+
 	/* return the first report that matches *all* conditions */
+	reports = fu_firmware_get_images(FU_FIRMWARE(self));
 	for (guint i = 0; i < reports->len; i++) {
 		FuHidReport *report = g_ptr_array_index(reports, i);
 		gboolean matched = TRUE;
@@ -286,9 +539,24 @@ fu_hid_descriptor_find_report(FuHidDescriptor *self, GError **error, ...)
 	return NULL;
 }
 
+static void
+fu_hid_descriptor_finalize(GObject *object)
+{
+	FuHidDescriptor *self = FU_HID_DESCRIPTOR(object);
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	g_array_unref(priv->items);
+	g_array_unref(priv->report_items);
+	g_array_unref(priv->reports);
+	G_OBJECT_CLASS(fu_hid_descriptor_parent_class)->finalize(object);
+}
+
 static void
 fu_hid_descriptor_init(FuHidDescriptor *self)
 {
+	FuHidDescriptorPrivate *priv = GET_PRIVATE(self);
+	priv->items = g_array_new(FALSE, FALSE, sizeof(FuHidDescriptorItem));
+	priv->report_items = g_array_new(FALSE, FALSE, sizeof(guint));
+	priv->reports = g_array_new(FALSE, FALSE, sizeof(FuHidDescriptorReport));
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_NO_AUTO_DETECTION);
 	fu_firmware_set_size_max(FU_FIRMWARE(self), 64 * 1024);
 	fu_firmware_set_images_max(FU_FIRMWARE(self),
@@ -300,7 +568,9 @@ fu_hid_descriptor_init(FuHidDescriptor *self)
 static void
 fu_hid_descriptor_class_init(FuHidDescriptorClass *klass)
 {
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
 	FuFirmwareClass *firmware_class = FU_FIRMWARE_CLASS(klass);
+	object_class->finalize = fu_hid_descriptor_finalize;
 	firmware_class->parse = fu_hid_descriptor_parse;
 	firmware_class->write = fu_hid_descriptor_write;
 }
@@ -8,6 +8,7 @@
 
 #include "config.h"
 
+#include "fu-context-private.h"
 #include "fu-dump.h"
 #include "fu-hid-device.h"
 #include "fu-string.h"
@@ -99,6 +100,7 @@ fu_hid_device_set_property(GObject *object, guint prop_id, const GValue *value,
 GPtrArray *
 fu_hid_device_parse_descriptors(FuHidDevice *self, GError **error)
 {
+	FuContext *ctx = fu_device_get_context(FU_DEVICE(self));
 	g_autoptr(GPtrArray) fws = NULL;
 	g_autoptr(GPtrArray) descriptors =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
@@ -111,11 +113,24 @@ fu_hid_device_parse_descriptors(FuHidDevice *self, GError **error)
 		return NULL;
 	for (guint i = 0; i < fws->len; i++) {
 		GBytes *fw = g_ptr_array_index(fws, i);
-		g_autoptr(FuFirmware) descriptor = fu_hid_descriptor_new();
+		g_autoptr(FuFirmware) descriptor = NULL;
 		g_autofree gchar *title = g_strdup_printf("HidDescriptor:0x%x", i);
+		g_autofree gchar *key = NULL;
+
+		/* the same descriptor is seen every time the device is replugged */
 		fu_dump_bytes(G_LOG_DOMAIN, title, fw);
-		if (!fu_firmware_parse_bytes(descriptor, fw, 0x0, FWUPD_INSTALL_FLAG_NONE, error))
-			return NULL;
+		key = g_compute_checksum_for_bytes(G_CHECKSUM_SHA1, fw);
+		descriptor = fu_context_get_firmware_cache(ctx, FU_TYPE_HID_DESCRIPTOR, key);
+		if (descriptor == NULL) {
+			descriptor = fu_hid_descriptor_new();
+			if (!fu_firmware_parse_bytes(descriptor,
+						     fw,
+						     0x0,
+						     FWUPD_INSTALL_FLAG_NONE,
+						     error))
+				return NULL;
+			fu_context_add_firmware_cache(ctx, key, descriptor);
+		}
 		g_ptr_array_add(descriptors, g_steal_pointer(&descriptor));
 	}
 	return g_steal_pointer(&descriptors);
@@ -15,6 +15,7 @@
 #include "fu-common.h"
 #include "fu-firmware-common.h"
 #include "fu-ihex-firmware.h"
+#include "fu-input-stream.h"
 #include "fu-mem.h"
 #include "fu-string.h"
 
@@ -26,37 +27,42 @@
  * See also: [class@FuFirmware]
  */
 
+#define FU_IHEX_FIRMWARE_TOKENS_MAX 100000 /* lines */
+#define FU_IHEX_FIRMWARE_LINE_MAX   521	   /* chars, with 0xff bytes of data */
+
+typedef struct {
+	FwupdInstallFlags flags;
+	GByteArray *buf;     /* (nullable): only when building the image */
+	GPtrArray *records;  /* (nullable): only when building the records */
+	GBytes *img_sig;     /* (nullable) */
+	GError *error;      /* (nullable): first error building the image */
+	guint8 padding_value;
+	gchar line[FU_IHEX_FIRMWARE_LINE_MAX];
+	gsize linesz;
+	guint line_idx;
+	gboolean line_ignore; /* after a comment, \r or ^Z */
+	gboolean line_comment;
+	gboolean got_nul;
+	gboolean got_eof;
+	gboolean got_sig;
+	guint record_idx;
+	guint32 abs_addr;
+	guint32 addr_last;
+	guint32 img_addr;
+	guint32 seg_addr;
+} FuIhexFirmwareParseHelper;
+
 typedef struct {
-	GPtrArray *records;
+	GPtrArray *records;		   /* (nullable): built on demand */
+	GInputStream *stream;		   /* (nullable): as tokenized */
+	FwupdInstallFlags flags;	   /* as tokenized */
+	FuIhexFirmwareParseHelper *helper; /* (nullable): from ->tokenize() */
 	guint8 padding_value;
 } FuIhexFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuIhexFirmware, fu_ihex_firmware, FU_TYPE_FIRMWARE)
 #define GET_PRIVATE(o) (fu_ihex_firmware_get_instance_private(o))
 
-#define FU_IHEX_FIRMWARE_TOKENS_MAX 100000 /* lines */
-
-/**
- * fu_ihex_firmware_get_records:
- * @self: A #FuIhexFirmware
- *
- * Returns the raw lines from tokenization.
- *
- * This might be useful if the plugin is expecting the hex file to be a list
- * of operations, rather than a simple linear image with filled holes.
- *
- * Returns: (transfer none) (element-type FuIhexFirmwareRecord): records
- *
- * Since: 1.3.4
- **/
-GPtrArray *
-fu_ihex_firmware_get_records(FuIhexFirmware *self)
-{
-	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
-	g_return_val_if_fail(FU_IS_IHEX_FIRMWARE(self), NULL);
-	return priv->records;
-}
-
 /**
  * fu_ihex_firmware_set_padding_value:
  * @self: A #FuIhexFirmware
@@ -85,121 +91,287 @@ fu_ihex_firmware_record_free(FuIhexFirmwareRecord *rcd)
 	g_free(rcd);
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuIhexFirmwareRecord, fu_ihex_firmware_record_free)
+static void
+fu_ihex_firmware_parse_helper_free(FuIhexFirmwareParseHelper *helper)
+{
+	if (helper->buf != NULL)
+		g_byte_array_unref(helper->buf);
+	if (helper->img_sig != NULL)
+		g_bytes_unref(helper->img_sig);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper);
+}
 
-static FuIhexFirmwareRecord *
-fu_ihex_firmware_record_new(guint ln, const gchar *line, FwupdInstallFlags flags, GError **error)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuIhexFirmwareParseHelper, fu_ihex_firmware_parse_helper_free)
+
+static gboolean
+fu_ihex_firmware_parse_data(FuIhexFirmwareParseHelper *helper,
+			    guint ln,
+			    guint8 record_type,
+			    guint16 rec_addr16,
+			    const guint8 *data,
+			    guint8 byte_cnt,
+			    GError **error)
 {
-	g_autoptr(FuIhexFirmwareRecord) rcd = NULL;
-	gsize linesz = strlen(line);
-	guint line_end;
 	guint16 addr16 = 0;
+	guint32 addr;
+	guint32 len_hole;
+
+	/* sanity check */
+	addr = rec_addr16 + helper->seg_addr + helper->abs_addr;
+	if (record_type != FU_IHEX_FIRMWARE_RECORD_TYPE_EOF && byte_cnt == 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "record 0x%x had zero size",
+			    helper->record_idx);
+		return FALSE;
+	}
+	helper->record_idx++;
+
+	/* process different record types */
+	switch (record_type) {
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_DATA:
+
+		/* does not make sense */
+		if (helper->got_eof) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "cannot process data after EOF");
+			return FALSE;
+		}
+
+		/* base address for element */
+		if (helper->img_addr == G_MAXUINT32)
+			helper->img_addr = addr;
+
+		/* does not make sense */
+		if (addr < helper->addr_last) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "invalid address 0x%x, last was 0x%x on line %u",
+				    (guint)addr,
+				    (guint)helper->addr_last,
+				    ln);
+			return FALSE;
+		}
+
+		/* any holes in the hex record */
+		len_hole = addr - helper->addr_last;
+		if (helper->addr_last > 0 && len_hole > 0x100000) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "hole of 0x%x bytes too large to fill on line %u",
+				    (guint)len_hole,
+				    ln);
+			return FALSE;
+		}
+		if (helper->addr_last > 0x0 && len_hole > 1) {
+			g_debug("filling address 0x%08x to 0x%08x on line %u",
+				helper->addr_last + 1,
+				helper->addr_last + len_hole - 1,
+				ln);
+			fu_byte_array_set_size(helper->buf,
+					       helper->buf->len + len_hole - 1,
+					       helper->padding_value);
+		}
+		helper->addr_last = addr + byte_cnt - 1;
+		if (helper->addr_last < addr) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "overflow of address 0x%x on line %u",
+				    (guint)addr,
+				    ln);
+			return FALSE;
+		}
+
+		/* write into buf */
+		g_byte_array_append(helper->buf, data, byte_cnt);
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_EOF:
+		if (helper->got_eof) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "duplicate EOF, perhaps "
+					    "corrupt file");
+			return FALSE;
+		}
+		helper->got_eof = TRUE;
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_LINEAR:
+		if (!fu_memread_uint16_safe(data, byte_cnt, 0x0, &addr16, G_BIG_ENDIAN, error))
+			return FALSE;
+		helper->abs_addr = (guint32)addr16 << 16;
+		g_debug("abs_addr:\t0x%02x on line %u", helper->abs_addr, ln);
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_START_LINEAR:
+		if (!fu_memread_uint32_safe(data,
+					    byte_cnt,
+					    0x0,
+					    &helper->abs_addr,
+					    G_BIG_ENDIAN,
+					    error))
+			return FALSE;
+		g_debug("abs_addr:\t0x%08x on line %u", helper->abs_addr, ln);
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_SEGMENT:
+		if (!fu_memread_uint16_safe(data, byte_cnt, 0x0, &addr16, G_BIG_ENDIAN, error))
+			return FALSE;
+		/* segment base address, so ~1Mb addressable */
+		helper->seg_addr = (guint32)addr16 * 16;
+		g_debug("seg_addr:\t0x%08x on line %u", helper->seg_addr, ln);
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_START_SEGMENT:
+		/* initial content of the CS:IP registers */
+		if (!fu_memread_uint32_safe(data,
+					    byte_cnt,
+					    0x0,
+					    &helper->seg_addr,
+					    G_BIG_ENDIAN,
+					    error))
+			return FALSE;
+		g_debug("seg_addr:\t0x%02x on line %u", helper->seg_addr, ln);
+		break;
+	case FU_IHEX_FIRMWARE_RECORD_TYPE_SIGNATURE:
+		if (helper->got_sig) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "duplicate signature, perhaps "
+					    "corrupt file");
+			return FALSE;
+		}
+		if (byte_cnt > 0)
+			helper->img_sig = g_bytes_new(data, byte_cnt);
+		helper->got_sig = TRUE;
+		break;
+	default:
+		/* vendors sneak in nonstandard sections past the EOF */
+		if (helper->got_eof)
+			break;
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "invalid ihex record type %i on line %u",
+			    record_type,
+			    ln);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_ihex_firmware_parse_record(FuIhexFirmwareParseHelper *helper,
+			      const gchar *line,
+			      gsize linesz,
+			      guint ln,
+			      GError **error)
+{
+	guint8 hdr[4] = {0x0};
+	guint8 data[0xff] = {0x0};
+	guint8 byte_cnt;
+	guint8 record_type;
+	guint16 rec_addr16;
 
 	/* check starting token */
 	if (line[0] != ':') {
-		g_autofree gchar *strsafe = fu_strsafe(line, 5);
+		g_autofree gchar *strsafe = fu_strsafe(line, MIN(linesz, 5));
 		if (strsafe != NULL) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token: %s",
 				    strsafe);
-			return NULL;
+			return FALSE;
 		}
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token");
-		return NULL;
+		return FALSE;
 	}
 
 	/* length, 16-bit address, type */
-	rcd = g_new0(FuIhexFirmwareRecord, 1);
-	rcd->ln = ln;
-	rcd->data = g_byte_array_new();
-	rcd->buf = g_string_new(line);
-	if (!fu_firmware_strparse_uint8_safe(line, linesz, 1, &rcd->byte_cnt, error))
-		return NULL;
-	if (!fu_firmware_strparse_uint16_safe(line, linesz, 3, &addr16, error))
-		return NULL;
-	rcd->addr = addr16;
-	if (!fu_firmware_strparse_uint8_safe(line, linesz, 7, &rcd->record_type, error))
-		return NULL;
-
-	/* position of checksum */
-	line_end = 9 + rcd->byte_cnt * 2;
-	if (line_end > (guint)rcd->buf->len) {
+	if (!fu_firmware_strparse_buf_safe(line, linesz, 1, hdr, sizeof(hdr), error))
+		return FALSE;
+	byte_cnt = hdr[0];
+	rec_addr16 = fu_memread_uint16(hdr + 1, G_BIG_ENDIAN);
+	record_type = hdr[3];
+	if (9 + (gsize)byte_cnt * 2 > linesz) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "line malformed, length: %u",
-			    line_end);
-		return NULL;
+			    9 + (guint)byte_cnt * 2);
+		return FALSE;
 	}
+	if (!fu_firmware_strparse_buf_safe(line, linesz, 9, data, byte_cnt, error))
+		return FALSE;
 
-	/* verify checksum */
-	if ((flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
+	/* verify checksum in the same pass */
+	if ((helper->flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
 		guint8 checksum = 0;
-		for (guint i = 1; i < line_end + 2; i += 2) {
-			guint8 data_tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(line, linesz, i, &data_tmp, error))
-				return NULL;
-			checksum += data_tmp;
-		}
+		if (!fu_firmware_strparse_buf_safe(line,
+						   linesz,
+						   9 + (gsize)byte_cnt * 2,
+						   &checksum,
+						   1,
+						   error))
+			return FALSE;
+		for (guint i = 0; i < sizeof(hdr); i++)
+			checksum += hdr[i];
+		for (guint i = 0; i < byte_cnt; i++)
+			checksum += data[i];
 		if (checksum != 0) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid checksum (0x%02x)",
 				    checksum);
-			return NULL;
+			return FALSE;
 		}
 	}
 
-	/* add data */
-	for (guint i = 9; i < line_end; i += 2) {
-		guint8 tmp_c = 0;
-		if (!fu_firmware_strparse_uint8_safe(line, linesz, i, &tmp_c, error))
-			return NULL;
-		fu_byte_array_append_uint8(rcd->data, tmp_c);
+	/* only allocated when fu_ihex_firmware_get_records() is used */
+	if (helper->records != NULL) {
+		FuIhexFirmwareRecord *rcd = g_new0(FuIhexFirmwareRecord, 1);
+		rcd->ln = ln;
+		rcd->buf = g_string_new_len(line, linesz);
+		rcd->data = g_byte_array_new();
+		g_byte_array_append(rcd->data, data, byte_cnt);
+		rcd->byte_cnt = byte_cnt;
+		rcd->addr = rec_addr16;
+		rcd->record_type = record_type;
+		g_ptr_array_add(helper->records, rcd);
 	}
-	return g_steal_pointer(&rcd);
-}
 
-static const gchar *
-fu_ihex_firmware_record_type_to_string(guint8 record_type)
-{
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_DATA)
-		return "DATA";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_EOF)
-		return "EOF";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_SEGMENT)
-		return "EXTENDED_SEGMENT";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_START_SEGMENT)
-		return "START_SEGMENT";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_LINEAR)
-		return "EXTENDED_LINEAR";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_START_LINEAR)
-		return "ADDR32";
-	if (record_type == FU_IHEX_FIRMWARE_RECORD_TYPE_SIGNATURE)
-		return "SIGNATURE";
-	return NULL;
+	/* a record that does not fit into the image is only fatal in ->parse(), as subclasses
+	 * may replace that with their own interpretation of the records */
+	if (helper->buf != NULL && helper->error == NULL &&
+	    !fu_ihex_firmware_parse_data(helper,
+					 ln,
+					 record_type,
+					 rec_addr16,
+					 data,
+					 byte_cnt,
+					 &helper->error))
+		g_prefix_error(&helper->error, "invalid line %u: ", ln);
+	return TRUE;
 }
 
-typedef struct {
-	FuIhexFirmware *self;
-	FwupdInstallFlags flags;
-} FuIhexFirmwareTokenHelper;
-
 static gboolean
-fu_ihex_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data, GError **error)
+fu_ihex_firmware_parse_line(FuIhexFirmwareParseHelper *helper, GError **error)
 {
-	FuIhexFirmwareTokenHelper *helper = (FuIhexFirmwareTokenHelper *)user_data;
-	FuIhexFirmwarePrivate *priv = GET_PRIVATE(helper->self);
-	g_autoptr(FuIhexFirmwareRecord) rcd = NULL;
+	guint ln = ++helper->line_idx;
 
 	/* sanity check */
-	if (token_idx > FU_IHEX_FIRMWARE_TOKENS_MAX) {
+	if (ln - 1 > FU_IHEX_FIRMWARE_TOKENS_MAX) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_DATA,
@@ -207,37 +379,126 @@ fu_ihex_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 		return FALSE;
 	}
 
-	/* remove WIN32 line endings */
-	g_strdelimit(token->str, "\r\x1a", '\0');
-	token->len = strlen(token->str);
+	/* ignore blank lines and comments */
+	if (helper->linesz > 0 && !helper->line_comment) {
+		if (!fu_ihex_firmware_parse_record(helper,
+						   helper->line,
+						   helper->linesz,
+						   ln,
+						   error)) {
+			g_prefix_error(error, "invalid line %u: ", ln);
+			return FALSE;
+		}
+	}
+	helper->linesz = 0;
+	helper->line_ignore = FALSE;
+	helper->line_comment = FALSE;
+	return TRUE;
+}
+
+static gboolean
+fu_ihex_firmware_parse_chunk_cb(const guint8 *buf, gsize bufsz, gpointer user_data, GError **error)
+{
+	FuIhexFirmwareParseHelper *helper = (FuIhexFirmwareParseHelper *)user_data;
 
-	/* ignore blank lines */
-	if (token->len == 0)
-		return TRUE;
+	for (gsize i = 0; i < bufsz && !helper->got_nul; i++) {
+		gchar c = (gchar)buf[i];
+		if (c == '\n' || c == '\0') {
+			helper->got_nul = c == '\0';
+			if (!fu_ihex_firmware_parse_line(helper, error))
+				return FALSE;
+			continue;
+		}
+		if (helper->line_ignore)
+			continue;
 
-	/* ignore comments */
-	if (g_str_has_prefix(token->str, ";"))
-		return TRUE;
+		/* remove WIN32 line endings */
+		if (c == '\r' || c == '\x1a') {
+			helper->line_ignore = TRUE;
+			continue;
+		}
+		if (helper->linesz == 0 && c == ';') {
+			helper->line_ignore = TRUE;
+			helper->line_comment = TRUE;
+			continue;
+		}
 
-	/* parse record */
-	rcd = fu_ihex_firmware_record_new(token_idx + 1, token->str, helper->flags, error);
-	if (rcd == NULL) {
-		g_prefix_error(error, "invalid line %u: ", token_idx + 1);
-		return FALSE;
+		/* anything past the longest possible record is never read */
+		if (helper->linesz == sizeof(helper->line)) {
+			helper->line_ignore = TRUE;
+			continue;
+		}
+		helper->line[helper->linesz++] = c;
 	}
-	g_ptr_array_add(priv->records, g_steal_pointer(&rcd));
 	return TRUE;
 }
 
-static gboolean
-fu_ihex_firmware_tokenize(FuFirmware *firmware,
-			  GInputStream *stream,
-			  FwupdInstallFlags flags,
-			  GError **error)
+/* decodes each line in a single pass, building the image and/or the records */
+static FuIhexFirmwareParseHelper *
+fu_ihex_firmware_decode(FuIhexFirmware *self,
+			GInputStream *stream,
+			FwupdInstallFlags flags,
+			gboolean with_image,
+			GPtrArray *records,
+			GError **error)
 {
-	FuIhexFirmware *self = FU_IHEX_FIRMWARE(firmware);
-	FuIhexFirmwareTokenHelper helper = {.self = self, .flags = flags};
-	return fu_strsplit_stream(stream, 0x0, "\n", fu_ihex_firmware_tokenize_cb, &helper, error);
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuIhexFirmwareParseHelper) helper = g_new0(FuIhexFirmwareParseHelper, 1);
+
+	helper->flags = flags;
+	helper->records = records;
+	helper->padding_value = priv->padding_value;
+	helper->img_addr = G_MAXUINT32;
+	if (with_image)
+		helper->buf = g_byte_array_new();
+	if (!fu_input_stream_chunkify(stream, fu_ihex_firmware_parse_chunk_cb, helper, error))
+		return NULL;
+	if (helper->linesz > 0 && !helper->got_nul) {
+		if (!fu_ihex_firmware_parse_line(helper, error))
+			return NULL;
+	}
+	return g_steal_pointer(&helper);
+}
+
+/**
+ * fu_ihex_firmware_get_records:
+ * @self: A #FuIhexFirmware
+ *
+ * Returns the raw lines from tokenization.
+ *
+ * This might be useful if the plugin is expecting the hex file to be a list
+ * of operations, rather than a simple linear image with filled holes.
+ *
+ * Returns: (transfer none) (element-type FuIhexFirmwareRecord): records
+ *
+ * Since: 1.3.4
+ **/
+GPtrArray *
+fu_ihex_firmware_get_records(FuIhexFirmware *self)
+{
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_IHEX_FIRMWARE(self), NULL);
+
+	/* the stream was already validated by ->tokenize() */
+	if (priv->records == NULL) {
+		priv->records =
+		    g_ptr_array_new_with_free_func((GFreeFunc)fu_ihex_firmware_record_free);
+		if (priv->stream != NULL) {
+			g_autoptr(FuIhexFirmwareParseHelper) helper = NULL;
+			g_autoptr(GError) error_local = NULL;
+			helper = fu_ihex_firmware_decode(self,
+							 priv->stream,
+							 priv->flags,
+							 FALSE,
+							 priv->records,
+							 &error_local);
+			if (helper == NULL) {
+				g_warning("failed to build records: %s", error_local->message);
+				g_ptr_array_set_size(priv->records, 0);
+			}
+		}
+	}
+	return priv->records;
 }
 
 static gboolean
@@ -248,197 +509,23 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 {
 	FuIhexFirmware *self = FU_IHEX_FIRMWARE(firmware);
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
-	gboolean got_eof = FALSE;
-	gboolean got_sig = FALSE;
-	guint32 abs_addr = 0x0;
-	guint32 addr_last = 0x0;
-	guint32 img_addr = G_MAXUINT32;
-	guint32 seg_addr = 0x0;
+	g_autoptr(FuIhexFirmwareParseHelper) helper = g_steal_pointer(&priv->helper);
 	g_autoptr(GBytes) img_bytes = NULL;
-	g_autoptr(GByteArray) buf = g_byte_array_new();
-
-	/* parse records */
-	for (guint k = 0; k < priv->records->len; k++) {
-		FuIhexFirmwareRecord *rcd = g_ptr_array_index(priv->records, k);
-		guint16 addr16 = 0;
-		guint32 addr = rcd->addr + seg_addr + abs_addr;
-		guint32 len_hole;
-
-		/* debug */
-		g_debug("%s:", fu_ihex_firmware_record_type_to_string(rcd->record_type));
-		g_debug("length:\t0x%02x", rcd->data->len);
-		g_debug("addr:\t0x%08x", addr);
 
-		/* sanity check */
-		if (rcd->record_type != FU_IHEX_FIRMWARE_RECORD_TYPE_EOF && rcd->data->len == 0) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_NOT_SUPPORTED,
-				    "record 0x%x had zero size",
-				    k);
+	/* the image is normally built by ->tokenize() */
+	if (helper == NULL || helper->buf == NULL) {
+		g_clear_pointer(&helper, fu_ihex_firmware_parse_helper_free);
+		helper = fu_ihex_firmware_decode(self, stream, flags, TRUE, NULL, error);
+		if (helper == NULL)
 			return FALSE;
-		}
-
-		/* process different record types */
-		switch (rcd->record_type) {
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_DATA:
-
-			/* does not make sense */
-			if (got_eof) {
-				g_set_error_literal(error,
-						    FWUPD_ERROR,
-						    FWUPD_ERROR_INVALID_FILE,
-						    "cannot process data after EOF");
-				return FALSE;
-			}
-			if (rcd->data->len == 0) {
-				g_set_error_literal(error,
-						    FWUPD_ERROR,
-						    FWUPD_ERROR_INVALID_FILE,
-						    "cannot parse invalid data");
-				return FALSE;
-			}
-
-			/* base address for element */
-			if (img_addr == G_MAXUINT32)
-				img_addr = addr;
-
-			/* does not make sense */
-			if (addr < addr_last) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "invalid address 0x%x, last was 0x%x on line %u",
-					    (guint)addr,
-					    (guint)addr_last,
-					    rcd->ln);
-				return FALSE;
-			}
-
-			/* any holes in the hex record */
-			len_hole = addr - addr_last;
-			if (addr_last > 0 && len_hole > 0x100000) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "hole of 0x%x bytes too large to fill on line %u",
-					    (guint)len_hole,
-					    rcd->ln);
-				return FALSE;
-			}
-			if (addr_last > 0x0 && len_hole > 1) {
-				g_debug("filling address 0x%08x to 0x%08x on line %u",
-					addr_last + 1,
-					addr_last + len_hole - 1,
-					rcd->ln);
-				for (guint j = 1; j < len_hole; j++)
-					fu_byte_array_append_uint8(buf, priv->padding_value);
-			}
-			addr_last = addr + rcd->data->len - 1;
-			if (addr_last < addr) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "overflow of address 0x%x on line %u",
-					    (guint)addr,
-					    rcd->ln);
-				return FALSE;
-			}
-
-			/* write into buf */
-			g_byte_array_append(buf, rcd->data->data, rcd->data->len);
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_EOF:
-			if (got_eof) {
-				g_set_error_literal(error,
-						    FWUPD_ERROR,
-						    FWUPD_ERROR_INVALID_FILE,
-						    "duplicate EOF, perhaps "
-						    "corrupt file");
-				return FALSE;
-			}
-			got_eof = TRUE;
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_LINEAR:
-			if (!fu_memread_uint16_safe(rcd->data->data,
-						    rcd->data->len,
-						    0x0,
-						    &addr16,
-						    G_BIG_ENDIAN,
-						    error))
-				return FALSE;
-			abs_addr = (guint32)addr16 << 16;
-			g_debug("abs_addr:\t0x%02x on line %u", abs_addr, rcd->ln);
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_START_LINEAR:
-			if (!fu_memread_uint32_safe(rcd->data->data,
-						    rcd->data->len,
-						    0x0,
-						    &abs_addr,
-						    G_BIG_ENDIAN,
-						    error))
-				return FALSE;
-			g_debug("abs_addr:\t0x%08x on line %u", abs_addr, rcd->ln);
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_EXTENDED_SEGMENT:
-			if (!fu_memread_uint16_safe(rcd->data->data,
-						    rcd->data->len,
-						    0x0,
-						    &addr16,
-						    G_BIG_ENDIAN,
-						    error))
-				return FALSE;
-			/* segment base address, so ~1Mb addressable */
-			seg_addr = (guint32)addr16 * 16;
-			g_debug("seg_addr:\t0x%08x on line %u", seg_addr, rcd->ln);
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_START_SEGMENT:
-			/* initial content of the CS:IP registers */
-			if (!fu_memread_uint32_safe(rcd->data->data,
-						    rcd->data->len,
-						    0x0,
-						    &seg_addr,
-						    G_BIG_ENDIAN,
-						    error))
-				return FALSE;
-			g_debug("seg_addr:\t0x%02x on line %u", seg_addr, rcd->ln);
-			break;
-		case FU_IHEX_FIRMWARE_RECORD_TYPE_SIGNATURE:
-			if (got_sig) {
-				g_set_error_literal(error,
-						    FWUPD_ERROR,
-						    FWUPD_ERROR_INVALID_FILE,
-						    "duplicate signature, perhaps "
-						    "corrupt file");
-				return FALSE;
-			}
-			if (rcd->data->len > 0) {
-				g_autoptr(GBytes) data_sig =
-				    g_bytes_new(rcd->data->data, rcd->data->len);
-				g_autoptr(FuFirmware) img_sig =
-				    fu_firmware_new_from_bytes(data_sig);
-				fu_firmware_set_id(img_sig, FU_FIRMWARE_ID_SIGNATURE);
-				if (!fu_firmware_add_image_full(firmware, img_sig, error))
-					return FALSE;
-			}
-			got_sig = TRUE;
-			break;
-		default:
-			/* vendors sneak in nonstandard sections past the EOF */
-			if (got_eof)
-				break;
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "invalid ihex record type %i on line %u",
-				    rcd->record_type,
-				    rcd->ln);
-			return FALSE;
-		}
+	}
+	if (helper->error != NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return FALSE;
 	}
 
 	/* no EOF */
-	if (!got_eof) {
+	if (!helper->got_eof) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
@@ -446,14 +533,51 @@ fu_ihex_firmware_parse(FuFirmware *firmware,
 		return FALSE;
 	}
 
+	/* optional signature */
+	if (helper->img_sig != NULL) {
+		g_autoptr(FuFirmware) img_sig = fu_firmware_new_from_bytes(helper->img_sig);
+		fu_firmware_set_id(img_sig, FU_FIRMWARE_ID_SIGNATURE);
+		if (!fu_firmware_add_image_full(firmware, img_sig, error))
+			return FALSE;
+	}
+
 	/* add single image */
-	img_bytes = g_bytes_new(buf->data, buf->len);
-	if (img_addr != G_MAXUINT32)
-		fu_firmware_set_addr(firmware, img_addr);
+	img_bytes = g_byte_array_free_to_bytes(g_steal_pointer(&helper->buf));
+	if (helper->img_addr != G_MAXUINT32)
+		fu_firmware_set_addr(firmware, helper->img_addr);
 	fu_firmware_set_bytes(firmware, img_bytes);
 	return TRUE;
 }
 
+static gboolean
+fu_ihex_firmware_tokenize(FuFirmware *firmware,
+			  GInputStream *stream,
+			  FwupdInstallFlags flags,
+			  GError **error)
+{
+	FuIhexFirmware *self = FU_IHEX_FIRMWARE(firmware);
+	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(firmware);
+	g_autoptr(FuIhexFirmwareParseHelper) helper = NULL;
+
+	/* validate every record, building the image at the same time unless a subclass
+	 * is going to use the records instead */
+	helper = fu_ihex_firmware_decode(self,
+					 stream,
+					 flags,
+					 klass->parse == fu_ihex_firmware_parse,
+					 NULL,
+					 error);
+	if (helper == NULL)
+		return FALSE;
+	g_clear_pointer(&priv->records, g_ptr_array_unref);
+	g_clear_pointer(&priv->helper, fu_ihex_firmware_parse_helper_free);
+	g_set_object(&priv->stream, stream);
+	priv->flags = flags;
+	priv->helper = g_steal_pointer(&helper);
+	return TRUE;
+}
+
 static void
 fu_ihex_firmware_emit_chunk(GString *str,
 			    guint16 address,
@@ -554,7 +678,12 @@ fu_ihex_firmware_finalize(GObject *object)
 {
 	FuIhexFirmware *self = FU_IHEX_FIRMWARE(object);
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
-	g_ptr_array_unref(priv->records);
+	if (priv->records != NULL)
+		g_ptr_array_unref(priv->records);
+	if (priv->stream != NULL)
+		g_object_unref(priv->stream);
+	if (priv->helper != NULL)
+		fu_ihex_firmware_parse_helper_free(priv->helper);
 	G_OBJECT_CLASS(fu_ihex_firmware_parent_class)->finalize(object);
 }
 
@@ -563,7 +692,6 @@ fu_ihex_firmware_init(FuIhexFirmware *self)
 {
 	FuIhexFirmwarePrivate *priv = GET_PRIVATE(self);
 	priv->padding_value = 0x00; /* chosen as we can't write 0xffff to PIC14 */
-	priv->records = g_ptr_array_new_with_free_func((GFreeFunc)fu_ihex_firmware_record_free);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_CHECKSUM);
 	fu_firmware_set_images_max(FU_FIRMWARE(self), 10);
 }
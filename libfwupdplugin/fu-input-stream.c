@@ -700,6 +700,19 @@ fu_input_stream_chunkify(GInputStream *stream,
 	return TRUE;
 }
 
+static gboolean
+fu_input_stream_rewind(GInputStream *stream, GError **error)
+{
+	/* streaming from unseekable stream */
+	if (!G_IS_SEEKABLE(stream) || !g_seekable_can_seek(G_SEEKABLE(stream)))
+		return TRUE;
+	if (!g_seekable_seek(G_SEEKABLE(stream), 0, G_SEEK_SET, NULL, error)) {
+		g_prefix_error(error, "seek to start: ");
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * fu_input_stream_find:
  * @stream: a #GInputStream
@@ -721,10 +734,10 @@ fu_input_stream_find(GInputStream *stream,
 		     gsize *offset,
 		     GError **error)
 {
-	g_autoptr(GByteArray) buf_acc = g_byte_array_new();
 	const gsize blocksz = 0x10000;
+	gsize buf_acc_len = 0;
 	gsize offset_add = 0;
-	gsize offset_cur = 0;
+	g_autofree guint8 *buf_acc = NULL;
 
 	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
@@ -732,36 +745,38 @@ fu_input_stream_find(GInputStream *stream,
 	g_return_val_if_fail(bufsz < blocksz, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	while (offset_cur < bufsz) {
-		g_autoptr(GByteArray) buf_tmp = NULL;
-		g_autoptr(GError) error_local = NULL;
-
-		/* read more data */
-		buf_tmp =
-		    fu_input_stream_read_byte_array(stream, offset_cur, blocksz, &error_local);
-		if (buf_tmp == NULL) {
-			if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE))
-				break;
-			g_propagate_error(error, g_steal_pointer(&error_local));
+	/* one allocation for the whole search */
+	if (!fu_input_stream_rewind(stream, error))
+		return FALSE;
+	buf_acc = g_malloc(blocksz + bufsz);
+	while (TRUE) {
+		gsize offset_tmp = 0;
+		gssize rc;
+
+		/* read more data after anything kept from the last block */
+		rc = g_input_stream_read(stream, buf_acc + buf_acc_len, blocksz, NULL, error);
+		if (rc < 0) {
+			g_prefix_error(error, "failed read at 0x%x: ", (guint)offset_add);
 			return FALSE;
 		}
-		g_byte_array_append(buf_acc, buf_tmp->data, buf_tmp->len);
+		if (rc == 0)
+			break;
+		buf_acc_len += rc;
 
 		/* we found something */
-		if (fu_memmem_safe(buf_acc->data, buf_acc->len, buf, bufsz, offset, NULL)) {
+		if (fu_memmem_safe(buf_acc, buf_acc_len, buf, bufsz, &offset_tmp, NULL)) {
 			if (offset != NULL)
-				*offset += offset_add;
+				*offset = offset_add + offset_tmp;
 			return TRUE;
 		}
 
-		/* truncate the buffer */
-		if (buf_acc->len > bufsz) {
-			offset_add += buf_acc->len - bufsz;
-			g_byte_array_remove_range(buf_acc, 0, buf_acc->len - bufsz);
+		/* only keep the tail that could be the start of a match split across blocks */
+		if (buf_acc_len >= bufsz) {
+			gsize keepsz = bufsz - 1;
+			memmove(buf_acc, buf_acc + buf_acc_len - keepsz, keepsz);
+			offset_add += buf_acc_len - keepsz;
+			buf_acc_len = keepsz;
 		}
-
-		/* move the offset */
-		offset_cur += buf_tmp->len;
 	}
 	g_set_error(error,
 		    FWUPD_ERROR,
@@ -770,3 +785,202 @@ fu_input_stream_find(GInputStream *stream,
 		    (guint)bufsz);
 	return FALSE;
 }
+
+#define FU_INPUT_STREAM_FIND_NONE G_MAXUINT32
+
+/* Aho-Corasick automaton, with the goto and failure functions collapsed into a DFA */
+typedef struct {
+	guint32 *delta;	    /* nstates * 256 */
+	guint32 *dict;	    /* nearest suffix state that is the end of a needle, or 0 */
+	guint32 *state_idx; /* first needle that ends in this state */
+	guint32 *idx_next;  /* next needle with identical contents */
+	gsize *idx_sz;
+	guint32 nstates;
+} FuInputStreamFindHelper;
+
+static void
+fu_input_stream_find_helper_free(FuInputStreamFindHelper *helper)
+{
+	g_free(helper->delta);
+	g_free(helper->dict);
+	g_free(helper->state_idx);
+	g_free(helper->idx_next);
+	g_free(helper->idx_sz);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuInputStreamFindHelper, fu_input_stream_find_helper_free)
+
+static FuInputStreamFindHelper *
+fu_input_stream_find_helper_new(GPtrArray *needles, GError **error)
+{
+	gsize nstates_max = 1;
+	guint32 queue_head = 0;
+	guint32 queue_tail = 0;
+	g_autofree guint32 *fail = NULL;
+	g_autofree guint32 *queue = NULL;
+	g_autoptr(FuInputStreamFindHelper) helper = g_new0(FuInputStreamFindHelper, 1);
+
+	/* each state uses 1KiB, so keep the automaton to a sane size */
+	for (guint i = 0; i < needles->len; i++) {
+		GBytes *needle = g_ptr_array_index(needles, i);
+		if (g_bytes_get_size(needle) == 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "needle 0x%x is empty",
+				    i);
+			return NULL;
+		}
+		nstates_max += g_bytes_get_size(needle);
+	}
+	if (nstates_max > 0x1000) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "needles too large, got 0x%x bytes",
+			    (guint)nstates_max - 1);
+		return NULL;
+	}
+	helper->delta = g_new0(guint32, nstates_max * 256);
+	helper->dict = g_new0(guint32, nstates_max);
+	helper->state_idx = g_new(guint32, nstates_max);
+	helper->idx_next = g_new(guint32, needles->len);
+	helper->idx_sz = g_new(gsize, needles->len);
+	for (gsize i = 0; i < nstates_max; i++)
+		helper->state_idx[i] = FU_INPUT_STREAM_FIND_NONE;
+	helper->nstates = 1;
+
+	/* build the trie, where 0 means no edge as the root is never a child */
+	for (guint i = 0; i < needles->len; i++) {
+		GBytes *needle = g_ptr_array_index(needles, i);
+		gsize bufsz = 0;
+		const guint8 *buf = g_bytes_get_data(needle, &bufsz);
+		guint32 state = 0;
+
+		for (gsize j = 0; j < bufsz; j++) {
+			guint32 *edge = &helper->delta[state * 256 + buf[j]];
+			if (*edge == 0)
+				*edge = helper->nstates++;
+			state = *edge;
+		}
+		helper->idx_sz[i] = bufsz;
+		helper->idx_next[i] = helper->state_idx[state];
+		helper->state_idx[state] = i;
+	}
+
+	/* breadth first, so that the failure state always has a complete row */
+	fail = g_new0(guint32, helper->nstates);
+	queue = g_new(guint32, helper->nstates);
+	for (guint c = 0; c < 256; c++) {
+		if (helper->delta[c] != 0)
+			queue[queue_tail++] = helper->delta[c];
+	}
+	while (queue_head < queue_tail) {
+		guint32 state = queue[queue_head++];
+		for (guint c = 0; c < 256; c++) {
+			guint32 child = helper->delta[state * 256 + c];
+			guint32 state_fail = helper->delta[fail[state] * 256 + c];
+			if (child == 0) {
+				helper->delta[state * 256 + c] = state_fail;
+				continue;
+			}
+			fail[child] = state_fail;
+			helper->dict[child] =
+			    helper->state_idx[state_fail] != FU_INPUT_STREAM_FIND_NONE
+				? state_fail
+				: helper->dict[state_fail];
+			queue[queue_tail++] = child;
+		}
+	}
+
+	/* success */
+	return g_steal_pointer(&helper);
+}
+
+static gint
+fu_input_stream_find_all_sort_cb(gconstpointer a, gconstpointer b)
+{
+	const FuInputStreamMatch *match1 = (const FuInputStreamMatch *)a;
+	const FuInputStreamMatch *match2 = (const FuInputStreamMatch *)b;
+	if (match1->offset != match2->offset)
+		return match1->offset < match2->offset ? -1 : 1;
+	if (match1->idx != match2->idx)
+		return match1->idx < match2->idx ? -1 : 1;
+	return 0;
+}
+
+/**
+ * fu_input_stream_find_all:
+ * @stream: a #GInputStream
+ * @needles: (element-type GBytes): buffers to look for
+ * @matches_max: maximum number of matches to return
+ * @error: (nullable): optional return location for an error
+ *
+ * Finds every occurrence of several memory buffers within an input stream, reading the stream
+ * only once and without loading it into a buffer.
+ *
+ * Overlapping matches are all returned, and @needles may share prefixes or suffixes.
+ *
+ * The search stops as soon as @matches_max needles have been found, which means the matches
+ * are the needles that *end* first in the stream.
+ *
+ * Returns: (transfer container) (element-type FuInputStreamMatch): matches, sorted by offset
+ *
+ * Since: 2.0.2
+ **/
+GArray *
+fu_input_stream_find_all(GInputStream *stream,
+			 GPtrArray *needles,
+			 guint matches_max,
+			 GError **error)
+{
+	const gsize blocksz = 0x10000;
+	gsize offset_add = 0;
+	guint32 state = 0;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(FuInputStreamFindHelper) helper = NULL;
+	g_autoptr(GArray) matches = g_array_new(FALSE, FALSE, sizeof(FuInputStreamMatch));
+
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+	g_return_val_if_fail(needles != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	helper = fu_input_stream_find_helper_new(needles, error);
+	if (helper == NULL)
+		return NULL;
+
+	/* the automaton state carries over, so no data has to be kept between blocks */
+	if (!fu_input_stream_rewind(stream, error))
+		return NULL;
+	buf = g_malloc(blocksz);
+	while (matches->len < matches_max) {
+		gssize rc = g_input_stream_read(stream, buf, blocksz, NULL, error);
+		if (rc < 0) {
+			g_prefix_error(error, "failed read at 0x%x: ", (guint)offset_add);
+			return NULL;
+		}
+		if (rc == 0)
+			break;
+		for (gsize i = 0; i < (gsize)rc && matches->len < matches_max; i++) {
+			state = helper->delta[state * 256 + buf[i]];
+			for (guint32 tmp = state; tmp != 0 && matches->len < matches_max;
+			     tmp = helper->dict[tmp]) {
+				for (guint32 idx = helper->state_idx[tmp];
+				     idx != FU_INPUT_STREAM_FIND_NONE && matches->len < matches_max;
+				     idx = helper->idx_next[idx]) {
+					FuInputStreamMatch match = {
+					    .idx = idx,
+					    .offset = offset_add + i + 1 - helper->idx_sz[idx],
+					};
+					g_array_append_val(matches, match);
+				}
+			}
+		}
+		offset_add += rc;
+	}
+
+	/* success */
+	g_array_sort(matches, fu_input_stream_find_all_sort_cb);
+	return g_steal_pointer(&matches);
+}
@@ -99,3 +99,20 @@ fu_input_stream_find(GInputStream *stream,
 		     gsize bufsz,
 		     gsize *offset,
 		     GError **error) G_GNUC_NON_NULL(1, 2);
+
+/**
+ * FuInputStreamMatch:
+ * @idx: index of the needle that was found
+ * @offset: offset of the needle in the stream
+ *
+ * A needle found by fu_input_stream_find_all().
+ **/
+typedef struct {
+	guint idx;
+	gsize offset;
+} FuInputStreamMatch;
+GArray *
+fu_input_stream_find_all(GInputStream *stream,
+			 GPtrArray *needles,
+			 guint matches_max,
+			 GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
@@ -14,3 +14,9 @@ gboolean
 fu_memchk_read(gsize bufsz, gsize offset, gsize n, GError **error);
 gboolean
 fu_memchk_write(gsize bufsz, gsize offset, gsize n, GError **error);
+gboolean
+fu_memmem_fallback(const guint8 *haystack,
+		   gsize haystack_sz,
+		   const guint8 *needle,
+		   gsize needle_sz,
+		   gsize *offset);
@@ -441,6 +441,30 @@ fu_memcpy_safe(guint8 *dst,
 	return TRUE;
 }
 
+/* used when memmem() is not available; @needle_sz must be between 1 and @haystack_sz */
+gboolean
+fu_memmem_fallback(const guint8 *haystack,
+		   gsize haystack_sz,
+		   const guint8 *needle,
+		   gsize needle_sz,
+		   gsize *offset)
+{
+	/* memchr() is vectorized in every libc, so use it to skip to each candidate */
+	for (gsize i = 0; i <= haystack_sz - needle_sz; i++) {
+		const guint8 *tmp =
+		    memchr(haystack + i, needle[0], haystack_sz - needle_sz - i + 1);
+		if (tmp == NULL)
+			break;
+		i = tmp - haystack;
+		if (memcmp(tmp, needle, needle_sz) == 0) {
+			if (offset != NULL)
+				*offset = i;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 /**
  * fu_memmem_safe:
  * @haystack: destination buffer
@@ -498,13 +522,8 @@ fu_memmem_safe(const guint8 *haystack,
 		return TRUE;
 	}
 #else
-	for (gsize i = 0; i < haystack_sz - needle_sz; i++) {
-		if (memcmp(haystack + i, needle, needle_sz) == 0) {
-			if (offset != NULL)
-				*offset = i;
-			return TRUE;
-		}
-	}
+	if (fu_memmem_fallback(haystack, haystack_sz, needle, needle_sz, offset))
+		return TRUE;
 #endif
 
 	/* not found */
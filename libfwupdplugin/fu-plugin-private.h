@@ -7,6 +7,7 @@
 #pragma once
 
 #include "fu-context.h"
+#include "fu-plugin-struct.h"
 #include "fu-plugin.h"
 #include "fu-security-attrs.h"
 
@@ -22,6 +23,8 @@ guint
 fu_plugin_get_order(FuPlugin *self) G_GNUC_NON_NULL(1);
 void
 fu_plugin_set_order(FuPlugin *self, guint order) G_GNUC_NON_NULL(1);
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self) G_GNUC_NON_NULL(1);
 guint
 fu_plugin_get_priority(FuPlugin *self) G_GNUC_NON_NULL(1);
 void
@@ -30,6 +33,8 @@ gchar *
 fu_plugin_to_string(FuPlugin *self) G_GNUC_NON_NULL(1);
 void
 fu_plugin_add_string(FuPlugin *self, guint idt, GString *str) G_GNUC_NON_NULL(1);
+void
+fu_plugin_add_statistics(FuPlugin *self, GVariantBuilder *builder) G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_plugin_get_rules(FuPlugin *self, FuPluginRule rule) G_GNUC_NON_NULL(1);
 GHashTable *
@@ -36,11 +36,21 @@
 static void
 fu_plugin_finalize(GObject *object);
 
+#define FU_PLUGIN_STATISTIC_BUCKETS 24 /* up to ~16s */
+
+typedef struct {
+	guint count;
+	gint64 total; /* µs */
+	gint64 max;   /* µs */
+	guint histogram[FU_PLUGIN_STATISTIC_BUCKETS]; /* log2(µs) */
+} FuPluginStatistic;
+
 typedef struct {
 	GModule *module;
 	guint order;
 	guint priority;
 	gboolean done_init;
+	gboolean thread_safe;
 	GPtrArray *rules[FU_PLUGIN_RULE_LAST];
 	GPtrArray *devices; /* (nullable) (element-type FuDevice) */
 	GHashTable *runtime_versions;
@@ -53,6 +63,7 @@ typedef struct {
 	GFileMonitor *config_monitor;
 	FuPluginData *data;
 	FuPluginVfuncs vfuncs;
+	FuPluginStatistic *statistics[FU_PLUGIN_STATISTIC_KIND_LAST]; /* (nullable) */
 } FuPluginPrivate;
 
 enum { PROP_0, PROP_CONTEXT, PROP_LAST };
@@ -360,6 +371,101 @@ fu_plugin_open(FuPlugin *self, const gchar *filename, GError **error)
 	return TRUE;
 }
 
+static void
+fu_plugin_add_statistic(FuPlugin *self, FuPluginStatisticKind kind, gint64 duration)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+	FuPluginStatistic *stat = priv->statistics[kind];
+	guint bucket = 0;
+
+	if (stat == NULL) {
+		stat = g_new0(FuPluginStatistic, 1);
+		priv->statistics[kind] = stat;
+	}
+	stat->count++;
+	stat->total += duration;
+	stat->max = MAX(stat->max, duration);
+	for (gint64 tmp = duration; tmp > 1 && bucket < FU_PLUGIN_STATISTIC_BUCKETS - 1; tmp >>= 1)
+		bucket++;
+	stat->histogram[bucket]++;
+}
+
+/* this is the upper limit of the histogram bucket, so only an approximation */
+static gint64
+fu_plugin_statistic_get_percentile(FuPluginStatistic *stat, guint percentile)
+{
+	guint64 threshold = (((guint64)stat->count * percentile) + 99) / 100;
+	guint64 seen = 0;
+
+	for (guint i = 0; i < FU_PLUGIN_STATISTIC_BUCKETS; i++) {
+		seen += stat->histogram[i];
+		if (seen >= threshold)
+			return MIN((((gint64)1) << (i + 1)) - 1, stat->max);
+	}
+	return stat->max;
+}
+
+/**
+ * fu_plugin_add_statistics:
+ * @self: a #FuPlugin
+ * @builder: a #GVariantBuilder of type `aa{sv}`
+ *
+ * Adds the timing statistics for each action the plugin has performed, e.g. `coldplug` or
+ * `probe`. All durations are in microseconds.
+ *
+ * Since: 2.0.2
+ **/
+void
+fu_plugin_add_statistics(FuPlugin *self, GVariantBuilder *builder)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+
+	g_return_if_fail(FU_IS_PLUGIN(self));
+	g_return_if_fail(builder != NULL);
+
+	for (guint i = 0; i < FU_PLUGIN_STATISTIC_KIND_LAST; i++) {
+		FuPluginStatistic *stat = priv->statistics[i];
+		GVariantBuilder builder_tmp;
+
+		if (stat == NULL)
+			continue;
+		g_variant_builder_init(&builder_tmp, G_VARIANT_TYPE_VARDICT);
+		if (fu_plugin_get_name(self) != NULL) {
+			g_variant_builder_add(&builder_tmp,
+					      "{sv}",
+					      "Plugin",
+					      g_variant_new_string(fu_plugin_get_name(self)));
+		}
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "Kind",
+				      g_variant_new_string(fu_plugin_statistic_kind_to_string(i)));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "Count",
+				      g_variant_new_uint32(stat->count));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "DurationTotal",
+				      g_variant_new_uint64(stat->total));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "DurationMax",
+				      g_variant_new_uint64(stat->max));
+		g_variant_builder_add(
+		    &builder_tmp,
+		    "{sv}",
+		    "DurationP50",
+		    g_variant_new_uint64(fu_plugin_statistic_get_percentile(stat, 50)));
+		g_variant_builder_add(
+		    &builder_tmp,
+		    "{sv}",
+		    "DurationP99",
+		    g_variant_new_uint64(fu_plugin_statistic_get_percentile(stat, 99)));
+		g_variant_builder_add_value(builder, g_variant_builder_end(&builder_tmp));
+	}
+}
+
 /**
  * fu_plugin_add_string:
  * @self: a #FuPlugin
@@ -383,6 +489,8 @@ fu_plugin_add_string(FuPlugin *self, guint idt, GString *str)
 	fwupd_codec_add_string(FWUPD_CODEC(self), idt, str);
 	fwupd_codec_string_append_int(str, idt + 1, "Order", priv->order);
 	fwupd_codec_string_append_int(str, idt + 1, "Priority", priv->priority);
+	if (priv->thread_safe)
+		fwupd_codec_string_append_bool(str, idt + 1, "ThreadSafe", priv->thread_safe);
 	if (priv->device_gtype_default != G_TYPE_INVALID) {
 		fwupd_codec_string_append(str,
 					  idt + 1,
@@ -390,6 +498,27 @@ fu_plugin_add_string(FuPlugin *self, guint idt, GString *str)
 					  g_type_name(priv->device_gtype_default));
 	}
 
+	for (guint i = 0; i < FU_PLUGIN_STATISTIC_KIND_LAST; i++) {
+		FuPluginStatistic *stat = priv->statistics[i];
+		gint64 p50;
+		gint64 p99;
+		g_autofree gchar *tmp = NULL;
+		if (stat == NULL)
+			continue;
+		p50 = fu_plugin_statistic_get_percentile(stat, 50);
+		p99 = fu_plugin_statistic_get_percentile(stat, 99);
+		tmp = g_strdup_printf("count:%u,total:%.3fms,max:%.3fms,p50:%.3fms,p99:%.3fms",
+				      stat->count,
+				      (gdouble)stat->total / 1000.f,
+				      (gdouble)stat->max / 1000.f,
+				      (gdouble)p50 / 1000.f,
+				      (gdouble)p99 / 1000.f);
+		fwupd_codec_string_append(str,
+					  idt + 1,
+					  fu_plugin_statistic_kind_to_string(i),
+					  tmp);
+	}
+
 	/* optional */
 	if (vfuncs->to_string != NULL)
 		vfuncs->to_string(self, idt + 1, str);
@@ -509,8 +638,19 @@ fu_plugin_device_add(FuPlugin *self, FuDevice *device)
 	}
 
 	g_debug("emit added from %s: %s", fu_plugin_get_name(self), fu_device_get_id(device));
-	if (fu_device_get_created_usec(device) == 0)
+	if (fu_device_get_created_usec(device) == 0) {
+		if (fu_device_get_probe_duration(device) > 0) {
+			fu_plugin_add_statistic(self,
+						FU_PLUGIN_STATISTIC_KIND_PROBE,
+						fu_device_get_probe_duration(device));
+		}
+		if (fu_device_get_setup_duration(device) > 0) {
+			fu_plugin_add_statistic(self,
+						FU_PLUGIN_STATISTIC_KIND_SETUP,
+						fu_device_get_setup_duration(device));
+		}
 		fu_device_set_created_usec(device, g_get_real_time());
+	}
 	fu_device_set_plugin(device, fu_plugin_get_name(self));
 	g_signal_emit(self, signals[SIGNAL_DEVICE_ADDED], 0, device);
 
@@ -1129,6 +1269,8 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 start;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1148,7 +1290,12 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 	if (vfuncs->coldplug == NULL)
 		return TRUE;
 	g_debug("coldplug(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->coldplug(self, progress, &error_local)) {
+	start = g_get_monotonic_time();
+	ret = vfuncs->coldplug(self, progress, &error_local);
+	fu_plugin_add_statistic(self,
+				FU_PLUGIN_STATISTIC_KIND_COLDPLUG,
+				g_get_monotonic_time() - start);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in coldplug(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -1641,6 +1788,35 @@ fu_plugin_check_supported_device(FuPlugin *self, FuDevice *device)
 	return FALSE;
 }
 
+static gboolean
+fu_plugin_device_setup_cache_supported(FuPlugin *self, FuDevice *device)
+{
+	FuPluginPrivate *priv = GET_PRIVATE(self);
+
+	if (fu_context_get_setup_cache(priv->ctx) == NULL)
+		return FALSE;
+	if (fu_context_has_flag(priv->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS))
+		return FALSE;
+	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED))
+		return FALSE;
+	if (fu_device_has_private_flag(device, FU_DEVICE_PRIVATE_FLAG_NO_SETUP_CACHE))
+		return FALSE;
+
+	/* children are created by ->setup() and the battery level is not stable */
+	if (fu_device_get_children(device)->len > 0)
+		return FALSE;
+	if (fu_device_get_battery_level(device) != FWUPD_BATTERY_LEVEL_INVALID)
+		return FALSE;
+	return TRUE;
+}
+
+static gchar *
+fu_plugin_device_build_setup_cache_key(FuPlugin *self, FuDevice *device)
+{
+	g_autofree gchar *key = fu_device_build_setup_cache_key(device);
+	return g_strdup_printf("%s:%s", fu_plugin_get_name(self), key);
+}
+
 static gboolean
 fu_plugin_backend_device_added(FuPlugin *self,
 			       FuDevice *device,
@@ -1651,6 +1827,7 @@ fu_plugin_backend_device_added(FuPlugin *self,
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	GType device_gtype = fu_device_get_specialized_gtype(FU_DEVICE(device));
 	GType proxy_gtype = fu_device_get_proxy_gtype(FU_DEVICE(device));
+	g_autofree gchar *setup_cache_key = NULL;
 	g_autoptr(FuDevice) dev = NULL;
 	g_autoptr(FuDeviceLocker) locker = NULL;
 
@@ -1720,8 +1897,36 @@ fu_plugin_backend_device_added(FuPlugin *self,
 		}
 	}
 
-	/* open */
+	/* the private flags may be set by quirks matched in ->probe() */
 	proxy = fu_device_get_proxy(dev);
+	if (proxy == NULL && fu_context_get_setup_cache(priv->ctx) != NULL) {
+		if (!fu_device_probe(dev, error))
+			return FALSE;
+		if (fu_plugin_device_setup_cache_supported(self, dev))
+			setup_cache_key = fu_plugin_device_build_setup_cache_key(self, dev);
+	}
+
+	/* the same hardware was set up the last time the daemon was started */
+	if (setup_cache_key != NULL) {
+		GHashTable *setup_cache = fu_context_get_setup_cache(priv->ctx);
+		JsonNode *json_node = g_hash_table_lookup(setup_cache, setup_cache_key);
+		if (json_node != NULL) {
+			g_autoptr(GError) error_local = NULL;
+			if (fu_device_restore_setup_snapshot(dev, json_node, &error_local)) {
+				g_debug("restored %s from setup cache", fu_device_get_id(dev));
+				fu_device_set_setup_cache_key(dev, setup_cache_key);
+				fu_progress_step_done(progress);
+				fu_plugin_device_add(self, dev);
+				fu_plugin_runner_device_added(self, dev);
+				fu_progress_step_done(progress);
+				return TRUE;
+			}
+			g_debug("ignoring setup cache: %s", error_local->message);
+			g_hash_table_remove(setup_cache, setup_cache_key);
+		}
+	}
+
+	/* open */
 	if (proxy != NULL) {
 		g_autoptr(FuDeviceLocker) locker_proxy = NULL;
 		locker_proxy = fu_device_locker_new(proxy, error);
@@ -1734,6 +1939,14 @@ fu_plugin_backend_device_added(FuPlugin *self,
 		return FALSE;
 	fu_progress_step_done(progress);
 
+	/* save for the next time the daemon is started */
+	if (setup_cache_key != NULL && fu_plugin_device_setup_cache_supported(self, dev)) {
+		fu_device_set_setup_cache_key(dev, setup_cache_key);
+		g_hash_table_insert(fu_context_get_setup_cache(priv->ctx),
+				    g_steal_pointer(&setup_cache_key),
+				    fu_device_save_setup_snapshot(dev));
+	}
+
 	/* add */
 	fu_plugin_device_add(self, dev);
 	fu_plugin_runner_device_added(self, dev);
@@ -1762,6 +1975,8 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
+	gint64 start;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1774,10 +1989,15 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 		return TRUE;
 
 	/* optional */
+	start = g_get_monotonic_time();
 	if (vfuncs->backend_device_added == NULL) {
 		if (priv->device_gtypes != NULL ||
 		    fu_device_get_specialized_gtype(device) != G_TYPE_INVALID) {
-			return fu_plugin_backend_device_added(self, device, progress, error);
+			ret = fu_plugin_backend_device_added(self, device, progress, error);
+			fu_plugin_add_statistic(self,
+						FU_PLUGIN_STATISTIC_KIND_BACKEND_DEVICE_ADDED,
+						g_get_monotonic_time() - start);
+			return ret;
 		}
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -1786,7 +2006,11 @@ fu_plugin_runner_backend_device_added(FuPlugin *self,
 		return FALSE;
 	}
 	g_debug("backend_device_added(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_added(self, device, progress, &error_local)) {
+	ret = vfuncs->backend_device_added(self, device, progress, &error_local);
+	fu_plugin_add_statistic(self,
+				FU_PLUGIN_STATISTIC_KIND_BACKEND_DEVICE_ADDED,
+				g_get_monotonic_time() - start);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in backend_device_added(%s)",
 				   fu_plugin_get_name(self));
@@ -2459,6 +2683,47 @@ fu_plugin_set_order(FuPlugin *self, guint order)
 	priv->order = order;
 }
 
+/**
+ * fu_plugin_get_thread_safe:
+ * @self: a #FuPlugin
+ *
+ * Gets if the plugin startup and coldplug can be run in a worker thread.
+ *
+ * Returns: %TRUE if thread-safe
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	return priv->thread_safe;
+}
+
+/**
+ * fu_plugin_set_thread_safe:
+ * @self: a #FuPlugin
+ * @thread_safe: boolean
+ *
+ * Sets if the plugin startup and coldplug can be run in a worker thread at the same time as
+ * other plugins with the same order. Devices added in these vfuncs are added and registered
+ * asynchronously by the daemon.
+ *
+ * The vfuncs must only modify state owned by the plugin itself. Lazily loaded #FuContext state,
+ * for instance the ESP volumes, is not locked and must not be used.
+ *
+ * Plugins can use this method only in fu_plugin_init()
+ *
+ * Since: 2.0.2
+ **/
+void
+fu_plugin_set_thread_safe(FuPlugin *self, gboolean thread_safe)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	g_return_if_fail(FU_IS_PLUGIN(self));
+	priv->thread_safe = thread_safe;
+}
+
 /**
  * fu_plugin_get_priority:
  * @self: a #FuPlugin
@@ -3045,6 +3310,8 @@ fu_plugin_finalize(GObject *object)
 		g_array_unref(priv->device_gtypes);
 	if (priv->config_monitor != NULL)
 		g_object_unref(priv->config_monitor);
+	for (guint i = 0; i < FU_PLUGIN_STATISTIC_KIND_LAST; i++)
+		g_free(priv->statistics[i]);
 	g_free(priv->data);
 
 	G_OBJECT_CLASS(fu_plugin_parent_class)->finalize(object);
@@ -0,0 +1,10 @@
+// Copyright 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#[derive(ToString)]
+enum FuPluginStatisticKind {
+    Coldplug,
+    BackendDeviceAdded,
+    Probe,
+    Setup,
+}
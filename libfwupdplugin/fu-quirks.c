@@ -78,8 +78,10 @@ struct _FuQuirks {
 	GHashTable *possible_keys;
 	GPtrArray *invalid_keys;
 	XbSilo *silo;
-	XbQuery *query_kv;
-	XbQuery *query_vs;
+	GHashTable *cache;  /* (element-type utf8 GPtrArray) of key,value pairs */
+	GRWLock silo_mutex; /* for silo and cache, as lookups can be made from plugin threads */
+	gint cache_hits;   /* atomic */
+	gint cache_misses; /* atomic */
 	gboolean verbose;
 #ifdef HAVE_SQLITE
 	sqlite3 *db;
@@ -352,19 +354,72 @@ fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 	return g_ascii_strcasecmp(entry1, entry2);
 }
 
+/* the values in the cache are borrowed from the silo, which has to outlive the cache */
+static GHashTable *
+fu_quirks_build_cache(XbSilo *silo, GError **error)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GHashTable) cache = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+
+	cache = g_hash_table_new_full(g_str_hash,
+				      g_str_equal,
+				      NULL,
+				      (GDestroyNotify)g_ptr_array_unref);
+	devices = xb_silo_query(silo, "quirk/device", 0, &error_local);
+	if (devices == NULL) {
+		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+			return g_steal_pointer(&cache);
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return NULL;
+	}
+	for (guint i = 0; i < devices->len; i++) {
+		XbNode *n = g_ptr_array_index(devices, i);
+		const gchar *guid = xb_node_get_attr(n, "id");
+		GPtrArray *kvs;
+		g_autoptr(GPtrArray) values = NULL;
+
+		if (guid == NULL)
+			continue;
+		values = xb_node_get_children(n);
+		if (values == NULL)
+			continue;
+
+		/* the same GUID can be specified in multiple files */
+		kvs = g_hash_table_lookup(cache, guid);
+		if (kvs == NULL) {
+			kvs = g_ptr_array_sized_new(values->len * 2);
+			g_hash_table_insert(cache, (gpointer)guid, kvs);
+		}
+		for (guint j = 0; j < values->len; j++) {
+			XbNode *c = g_ptr_array_index(values, j);
+			const gchar *key = xb_node_get_attr(c, "key");
+			if (key == NULL)
+				continue;
+			g_ptr_array_add(kvs, (gpointer)key);
+			g_ptr_array_add(kvs, (gpointer)xb_node_get_text(c));
+		}
+	}
+	g_debug("cached quirks for %u GUIDs", g_hash_table_size(cache));
+
+	/* success */
+	return g_steal_pointer(&cache);
+}
+
+/* must be called with the silo_mutex writer lock held */
 static gboolean
-fu_quirks_check_silo(FuQuirks *self, GError **error)
+fu_quirks_rebuild_silo(FuQuirks *self, GError **error)
 {
 	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_WATCH_BLOB;
 	g_autofree gchar *datadir = NULL;
 	g_autofree gchar *localstatedir = NULL;
 	g_autoptr(GFile) file = NULL;
+	g_autoptr(GHashTable) cache = NULL;
 	g_autoptr(XbBuilder) builder = NULL;
 	g_autoptr(XbNode) n_any = NULL;
 
-	/* everything is okay */
-	if (self->silo != NULL && xb_silo_is_valid(self->silo))
-		return TRUE;
+	/* the cached values all point into the old silo */
+	g_hash_table_remove_all(self->cache);
 
 	/* system datadir */
 	builder = xb_builder_new();
@@ -415,32 +470,37 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 		return TRUE;
 	}
 
-	/* create prepared queries to save time later */
-	self->query_kv = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value[@key=?]",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_kv == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
+	/* build the GUID lookup table */
+	cache = fu_quirks_build_cache(self->silo, error);
+	if (cache == NULL) {
+		g_prefix_error(error, "failed to build cache: ");
 		return FALSE;
 	}
-	self->query_vs = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_vs == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
-	if (!xb_silo_query_build_index(self->silo, "quirk/device", "id", error))
-		return FALSE;
-	if (!xb_silo_query_build_index(self->silo, "quirk/device/value", "key", error))
-		return FALSE;
+	g_hash_table_unref(self->cache);
+	self->cache = g_steal_pointer(&cache);
 
 	/* success */
 	return TRUE;
 }
 
+static gboolean
+fu_quirks_check_silo(FuQuirks *self, GError **error)
+{
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->silo_mutex);
+	g_autoptr(GRWLockWriterLocker) locker_writer = NULL;
+
+	/* everything is okay */
+	if (self->silo != NULL && xb_silo_is_valid(self->silo))
+		return TRUE;
+	g_clear_pointer(&locker, g_rw_lock_reader_locker_free);
+
+	/* another thread may have rebuilt the silo while waiting for the lock */
+	locker_writer = g_rw_lock_writer_locker_new(&self->silo_mutex);
+	if (self->silo != NULL && xb_silo_is_valid(self->silo))
+		return TRUE;
+	return fu_quirks_rebuild_silo(self, error);
+}
+
 /**
  * fu_quirks_lookup_by_id:
  * @self: a #FuQuirks
@@ -456,9 +516,9 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 const gchar *
 fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 {
+	GPtrArray *kvs;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(XbNode) n = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
 	g_return_val_if_fail(guid != NULL, NULL);
@@ -493,26 +553,24 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 		return NULL;
 	}
 
-	/* no quirk data */
-	if (self->query_kv == NULL)
-		return NULL;
-
 	/* query */
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
-	n = xb_silo_query_first_with_context(self->silo, self->query_kv, &context, &error);
-	if (n == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return NULL;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			return NULL;
-		g_warning("failed to query: %s", error->message);
+	locker = g_rw_lock_reader_locker_new(&self->silo_mutex);
+	kvs = g_hash_table_lookup(self->cache, guid);
+	if (kvs == NULL) {
+		g_atomic_int_inc(&self->cache_misses);
 		return NULL;
 	}
-	if (self->verbose)
-		g_debug("%s:%s → %s", guid, key, xb_node_get_text(n));
-	return xb_node_get_text(n);
+	g_atomic_int_inc(&self->cache_hits);
+	for (guint i = 0; i < kvs->len; i += 2) {
+		const gchar *key_tmp = g_ptr_array_index(kvs, i);
+		const gchar *value = g_ptr_array_index(kvs, i + 1);
+		if (g_strcmp0(key_tmp, key) != 0)
+			continue;
+		if (self->verbose)
+			g_debug("%s:%s → %s", guid, key, value);
+		return value;
+	}
+	return NULL;
 }
 
 /**
@@ -536,9 +594,10 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    FuQuirksIter iter_cb,
 			    gpointer user_data)
 {
+	GPtrArray *kvs;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(GPtrArray) results = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+	g_autoptr(GPtrArray) kvs_copy = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
@@ -585,39 +644,88 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		return FALSE;
 	}
 
-	/* no quirk data */
-	if (self->query_vs == NULL) {
-		g_debug("no quirk data");
-		return FALSE;
-	}
-
 	/* query */
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	if (key != NULL) {
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
-		results = xb_silo_query_with_context(self->silo, self->query_kv, &context, &error);
-	} else {
-		results = xb_silo_query_with_context(self->silo, self->query_vs, &context, &error);
-	}
-	if (results == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return FALSE;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			return FALSE;
-		g_warning("failed to query: %s", error->message);
+	locker = g_rw_lock_reader_locker_new(&self->silo_mutex);
+	kvs = g_hash_table_lookup(self->cache, guid);
+	if (kvs == NULL) {
+		g_atomic_int_inc(&self->cache_misses);
 		return FALSE;
 	}
-	for (guint i = 0; i < results->len; i++) {
-		XbNode *n = g_ptr_array_index(results, i);
+	g_atomic_int_inc(&self->cache_hits);
+
+	/* the callback may look up other quirks, so do not hold the lock */
+	kvs_copy = g_ptr_array_copy(kvs, NULL, NULL);
+	g_clear_pointer(&locker, g_rw_lock_reader_locker_free);
+	for (guint i = 0; i < kvs_copy->len; i += 2) {
+		const gchar *key_tmp = g_ptr_array_index(kvs_copy, i);
+		const gchar *value = g_ptr_array_index(kvs_copy, i + 1);
+		if (key != NULL && g_strcmp0(key_tmp, key) != 0)
+			continue;
 		if (self->verbose)
-			g_debug("%s → %s", guid, xb_node_get_text(n));
-		iter_cb(self, xb_node_get_attr(n, "key"), xb_node_get_text(n), user_data);
+			g_debug("%s → %s", guid, value);
+		iter_cb(self, key_tmp, value, user_data);
 	}
 
 	return TRUE;
 }
 
+/**
+ * fu_quirks_get_cache_hits:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of GUID lookups that were found in the quirk cache.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.2
+ **/
+guint
+fu_quirks_get_cache_hits(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), 0);
+	return (guint)g_atomic_int_get(&self->cache_hits);
+}
+
+/**
+ * fu_quirks_get_cache_misses:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of GUID lookups that were not found in the quirk cache.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.2
+ **/
+guint
+fu_quirks_get_cache_misses(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), 0);
+	return (guint)g_atomic_int_get(&self->cache_misses);
+}
+
+/**
+ * fu_quirks_get_guid:
+ * @self: a #FuQuirks
+ *
+ * Gets a GUID that changes when any of the loaded quirk files are modified, added or removed.
+ *
+ * Returns: (transfer full) (nullable): a GUID, or %NULL if the quirks are not loaded
+ *
+ * Since: 2.0.2
+ **/
+gchar *
+fu_quirks_get_guid(FuQuirks *self)
+{
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
+
+	locker = g_rw_lock_reader_locker_new(&self->silo_mutex);
+	if (self->silo == NULL)
+		return NULL;
+	return xb_silo_get_guid(self->silo);
+}
+
 #ifdef HAVE_SQLITE
 
 typedef struct {
@@ -1005,6 +1113,11 @@ fu_quirks_init(FuQuirks *self)
 {
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
+	g_rw_lock_init(&self->silo_mutex);
+	self->cache = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    NULL,
+					    (GDestroyNotify)g_ptr_array_unref);
 
 	/* built in */
 	fu_quirks_add_possible_key(self, FU_QUIRKS_BRANCH);
@@ -1055,12 +1168,10 @@ static void
 fu_quirks_finalize(GObject *obj)
 {
 	FuQuirks *self = FU_QUIRKS(obj);
-	if (self->query_kv != NULL)
-		g_object_unref(self->query_kv);
-	if (self->query_vs != NULL)
-		g_object_unref(self->query_vs);
+	g_hash_table_unref(self->cache);
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
+	g_rw_lock_clear(&self->silo_mutex);
 #ifdef HAVE_SQLITE
 	if (self->db != NULL)
 		sqlite3_close(self->db);
@@ -40,3 +40,9 @@ gboolean
 fu_security_attrs_equal(FuSecurityAttrs *attrs1, FuSecurityAttrs *attrs2) G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_security_attrs_compare(FuSecurityAttrs *attrs1, FuSecurityAttrs *attrs2) G_GNUC_NON_NULL(1, 2);
+gchar *
+fu_security_attrs_get_digest(FuSecurityAttrs *self) G_GNUC_NON_NULL(1);
+gchar *
+fu_security_attrs_attr_to_digest_string(FwupdSecurityAttr *attr) G_GNUC_NON_NULL(1);
+guint
+fu_security_attrs_get_lookup_cnt(FuSecurityAttrs *self) G_GNUC_NON_NULL(1);
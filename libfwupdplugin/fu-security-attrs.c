@@ -11,6 +11,7 @@
 #include <fwupd.h>
 #include <glib/gi18n.h>
 
+#include "fwupd-enums-private.h"
 #include "fwupd-security-attr-private.h"
 
 #include "fu-security-attrs-private.h"
@@ -25,6 +26,7 @@
 struct _FuSecurityAttrs {
 	GObject parent_instance;
 	GPtrArray *attrs;
+	guint lookup_cnt;
 };
 
 /* probably sane to *not* make this part of the ABI */
@@ -131,6 +133,7 @@ fu_security_attrs_get_by_appstream_id(FuSecurityAttrs *self,
 				      GError **error)
 {
 	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), NULL);
+	self->lookup_cnt++;
 	if (self->attrs->len == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -147,6 +150,24 @@ fu_security_attrs_get_by_appstream_id(FuSecurityAttrs *self,
 	return NULL;
 }
 
+/**
+ * fu_security_attrs_get_lookup_cnt:
+ * @self: a #FuSecurityAttrs
+ *
+ * Gets the number of times fu_security_attrs_get_by_appstream_id() has been called, which can
+ * be used to find out if an attribute producer depends on attributes added by others.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.2
+ **/
+guint
+fu_security_attrs_get_lookup_cnt(FuSecurityAttrs *self)
+{
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), G_MAXUINT);
+	return self->lookup_cnt;
+}
+
 /**
  * fu_security_attrs_to_variant:
  * @self: a #FuSecurityAttrs
@@ -673,6 +694,108 @@ fu_security_attrs_equal(FuSecurityAttrs *attrs1, FuSecurityAttrs *attrs2)
 	return compare->len == 0;
 }
 
+static gint
+fu_security_attrs_obsolete_sort_cb(gconstpointer item1, gconstpointer item2)
+{
+	const gchar *obsolete1 = *((const gchar **)item1);
+	const gchar *obsolete2 = *((const gchar **)item2);
+	return g_strcmp0(obsolete1, obsolete2);
+}
+
+static gint
+fu_security_attrs_digest_sort_cb(gconstpointer item1, gconstpointer item2)
+{
+	FwupdSecurityAttr *attr1 = *((FwupdSecurityAttr **)item1);
+	FwupdSecurityAttr *attr2 = *((FwupdSecurityAttr **)item2);
+	return g_strcmp0(fwupd_security_attr_get_appstream_id(attr1),
+			 fwupd_security_attr_get_appstream_id(attr2));
+}
+
+/**
+ * fu_security_attrs_attr_to_digest_string:
+ * @attr: a #FwupdSecurityAttr
+ *
+ * Gets everything that is stored for the attribute, except the created timestamp, in a stable
+ * order. Two attributes with the same string can be considered equal.
+ *
+ * Returns: (transfer full): a string
+ *
+ * Since: 2.0.2
+ */
+gchar *
+fu_security_attrs_attr_to_digest_string(FwupdSecurityAttr *attr)
+{
+	GPtrArray *obsoletes = fwupd_security_attr_get_obsoletes(attr);
+	JsonObject *json_obj;
+	g_autoptr(GList) members = NULL;
+	g_autoptr(GPtrArray) obsoletes_sorted = g_ptr_array_new();
+	g_autoptr(GString) str = g_string_new(NULL);
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonNode) json_node = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_SECURITY_ATTR(attr), NULL);
+
+	json_builder_begin_object(builder);
+	fwupd_codec_to_json(FWUPD_CODEC(attr), builder, FWUPD_CODEC_FLAG_NONE);
+	json_builder_end_object(builder);
+	json_node = json_builder_get_root(builder);
+	json_obj = json_node_get_object(json_node);
+	json_object_remove_member(json_obj, FWUPD_RESULT_KEY_CREATED);
+
+	/* the metadata is added in hash table order */
+	members = g_list_sort(json_object_get_members(json_obj), (GCompareFunc)g_strcmp0);
+	for (GList *l = members; l != NULL; l = l->next) {
+		const gchar *member = l->data;
+		g_autofree gchar *value = NULL;
+		g_autoptr(JsonGenerator) json_generator = json_generator_new();
+
+		json_generator_set_root(json_generator, json_object_get_member(json_obj, member));
+		value = json_generator_to_data(json_generator, NULL);
+		g_string_append_printf(str, "%s=%s\n", member, value);
+	}
+
+	/* not included in the JSON */
+	for (guint i = 0; i < obsoletes->len; i++)
+		g_ptr_array_add(obsoletes_sorted, g_ptr_array_index(obsoletes, i));
+	g_ptr_array_sort(obsoletes_sorted, (GCompareFunc)fu_security_attrs_obsolete_sort_cb);
+	for (guint i = 0; i < obsoletes_sorted->len; i++) {
+		const gchar *obsolete = g_ptr_array_index(obsoletes_sorted, i);
+		g_string_append_printf(str, "Obsoletes=%s\n", obsolete);
+	}
+	return g_string_free(g_steal_pointer(&str), FALSE);
+}
+
+/**
+ * fu_security_attrs_get_digest:
+ * @self: a #FuSecurityAttrs
+ *
+ * Gets a digest of everything that is stored for each attribute, so that sets of attributes can
+ * be compared in the same way as the history database without keeping both sets of attributes.
+ * The created timestamp is not included.
+ *
+ * Returns: (transfer full): a SHA-256 hash
+ *
+ * Since: 2.0.2
+ */
+gchar *
+fu_security_attrs_get_digest(FuSecurityAttrs *self)
+{
+	g_autoptr(GPtrArray) items = NULL;
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(self), NULL);
+
+	/* the attributes are sorted by HSI level, so use a stable order */
+	items = fu_security_attrs_get_all(self);
+	g_ptr_array_sort(items, fu_security_attrs_digest_sort_cb);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		g_autofree gchar *attr_str = fu_security_attrs_attr_to_digest_string(attr);
+		g_string_append_printf(str, "%s\n", attr_str);
+	}
+	return g_compute_checksum_for_string(G_CHECKSUM_SHA256, str->str, str->len);
+}
+
 /**
  * fu_security_attrs_new:
  *
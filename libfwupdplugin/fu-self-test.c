@@ -28,10 +28,12 @@
 #include "fu-efi-lz77-decompressor.h"
 #include "fu-efivars-private.h"
 #include "fu-lzma-common.h"
+#include "fu-mem-private.h"
 #include "fu-plugin-private.h"
 #include "fu-security-attrs-private.h"
 #include "fu-self-test-struct.h"
 #include "fu-smbios-private.h"
+#include "fu-sum-private.h"
 #include "fu-test-device.h"
 #include "fu-volume-private.h"
 
@@ -772,6 +774,40 @@ fu_context_firmware_gtypes_func(void)
 	g_assert_cmpint(fu_context_get_firmware_gtype_by_id(ctx, "n/a"), ==, G_TYPE_INVALID);
 }
 
+static void
+fu_context_firmware_cache_func(void)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(FuFirmware) firmware_tmp1 = NULL;
+	g_autoptr(FuFirmware) firmware_tmp2 = NULL;
+	g_autoptr(FuFirmware) firmware_tmp3 = NULL;
+	g_autoptr(FuFirmware) firmware_tmp4 = NULL;
+
+	/* the GType is part of the key */
+	fu_context_add_firmware_cache(ctx, "abc", firmware);
+	firmware_tmp1 = fu_context_get_firmware_cache(ctx, FU_TYPE_HID_DESCRIPTOR, "abc");
+	g_assert_null(firmware_tmp1);
+	firmware_tmp2 = fu_context_get_firmware_cache(ctx, FU_TYPE_FIRMWARE, "abc");
+	g_assert_true(firmware_tmp2 == firmware);
+
+	/* fill the cache, using the first entry so that it is not the one dropped */
+	for (guint i = 0; i < 64; i++) {
+		g_autofree gchar *key = g_strdup_printf("key%u", i);
+		g_autoptr(FuFirmware) firmware_new = fu_firmware_new();
+		if (i == 32) {
+			g_autoptr(FuFirmware) firmware_hit =
+			    fu_context_get_firmware_cache(ctx, FU_TYPE_FIRMWARE, "abc");
+			g_assert_nonnull(firmware_hit);
+		}
+		fu_context_add_firmware_cache(ctx, key, firmware_new);
+	}
+	firmware_tmp3 = fu_context_get_firmware_cache(ctx, FU_TYPE_FIRMWARE, "abc");
+	g_assert_true(firmware_tmp3 == firmware);
+	firmware_tmp4 = fu_context_get_firmware_cache(ctx, FU_TYPE_FIRMWARE, "key0");
+	g_assert_null(firmware_tmp4);
+}
+
 static void
 fu_context_hwids_dmi_func(void)
 {
@@ -830,6 +866,108 @@ fu_common_memmem_func(void)
 			     &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
 	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* needle right at the end of the haystack */
+	ret = fu_memmem_safe(haystack, sizeof(haystack), haystack + 2, 2, &offset, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(offset, ==, 0x2);
+
+	/* the fallback used when memmem() is not available */
+	g_assert_true(
+	    fu_memmem_fallback(haystack, sizeof(haystack), needle, sizeof(needle), &offset));
+	g_assert_cmpint(offset, ==, 0x1);
+	g_assert_false(
+	    fu_memmem_fallback(haystack + 2, sizeof(haystack) - 2, needle, sizeof(needle), NULL));
+	g_assert_true(fu_memmem_fallback(haystack, sizeof(haystack), haystack + 2, 2, &offset));
+	g_assert_cmpint(offset, ==, 0x2);
+	g_assert_true(fu_memmem_fallback(haystack, sizeof(haystack), haystack, 4, &offset));
+	g_assert_cmpint(offset, ==, 0x0);
+}
+
+static void
+fu_common_memmem_fallback_func(void)
+{
+	guint8 haystack[64];
+	g_autoptr(GRand) rand = g_rand_new_with_seed(0x1234);
+
+	/* a small alphabet so that there are lots of partial matches */
+	for (guint i = 0; i < sizeof(haystack); i++)
+		haystack[i] = g_rand_int_range(rand, 'A', 'D');
+	for (guint i = 0; i < 1000; i++) {
+		guint8 needle[4];
+		gsize needle_sz = g_rand_int_range(rand, 1, sizeof(needle) + 1);
+		gsize offset = G_MAXSIZE;
+		gsize offset_safe = G_MAXSIZE;
+		gboolean ret;
+		gboolean ret_safe;
+
+		for (guint j = 0; j < needle_sz; j++)
+			needle[j] = g_rand_int_range(rand, 'A', 'D');
+		ret = fu_memmem_fallback(haystack, sizeof(haystack), needle, needle_sz, &offset);
+		ret_safe = fu_memmem_safe(haystack,
+					  sizeof(haystack),
+					  needle,
+					  needle_sz,
+					  &offset_safe,
+					  NULL);
+		g_assert_cmpint(ret, ==, ret_safe);
+		if (ret)
+			g_assert_cmpint(offset, ==, offset_safe);
+	}
+}
+
+static void
+fu_common_sum_func(void)
+{
+	guint8 buf[512];
+	g_autoptr(GRand) rand = g_rand_new_with_seed(0x1234);
+	struct {
+		const gchar *id;
+		guint64 (*func)(const guint8 *buf, gsize bufsz); /* nullable */
+	} impls[] = {
+	    {"scalar", fu_sum_bytes_scalar},
+#ifdef __SSE2__
+	    {"sse2", fu_sum_bytes_sse2},
+#endif
+#ifdef HAVE_AVX2
+	    {"avx2", __builtin_cpu_supports("avx2") ? fu_sum_bytes_avx2 : NULL},
+#endif
+#ifdef __ARM_NEON
+	    {"neon", fu_sum_bytes_neon},
+#endif
+	};
+
+	/* compare every implementation against the trivial loop for all alignments and tails */
+	for (guint i = 0; i < sizeof(buf); i++)
+		buf[i] = g_rand_int_range(rand, 0x00, 0x100);
+	for (gsize offset = 0; offset < 64; offset++) {
+		for (gsize bufsz = 0; bufsz <= sizeof(buf) - 64; bufsz++) {
+			guint64 sum = 0;
+			for (gsize i = 0; i < bufsz; i++)
+				sum += buf[offset + i];
+			for (guint j = 0; j < G_N_ELEMENTS(impls); j++) {
+				if (impls[j].func == NULL)
+					continue;
+				g_assert_cmpint(impls[j].func(buf + offset, bufsz), ==, sum);
+			}
+			g_assert_cmpint(fu_sum8(buf + offset, bufsz), ==, (guint8)sum);
+			g_assert_cmpint(fu_sum16(buf + offset, bufsz), ==, (guint16)sum);
+			g_assert_cmpint(fu_sum32(buf + offset, bufsz), ==, (guint32)sum);
+		}
+	}
+
+	/* make sure the wide accumulators do not saturate */
+	memset(buf, 0xFF, sizeof(buf));
+	for (guint j = 0; j < G_N_ELEMENTS(impls); j++) {
+		if (impls[j].func == NULL) {
+			g_debug("skipping %s as not supported", impls[j].id);
+			continue;
+		}
+		g_assert_cmpint(impls[j].func(buf, sizeof(buf)), ==, 0xFF * sizeof(buf));
+	}
+	g_assert_cmpint(fu_sum32(buf, sizeof(buf)), ==, 0xFF * sizeof(buf));
 }
 
 static void
@@ -1367,6 +1505,18 @@ fu_plugin_quirks_func(void)
 	g_assert_cmpstr(tmp, ==, "clever");
 }
 
+static gpointer
+fu_plugin_quirks_thread_cb(gpointer user_data)
+{
+	FuQuirks *quirks = FU_QUIRKS(user_data);
+	for (guint j = 0; j < 1000; j++) {
+		const gchar *group = "bb9ec3e2-77b3-53bc-a1f1-b05916715627";
+		const gchar *tmp = fu_quirks_lookup_by_id(quirks, group, "Name");
+		g_assert_cmpstr(tmp, !=, NULL);
+	}
+	return NULL;
+}
+
 static void
 fu_plugin_quirks_performance_func(void)
 {
@@ -1376,6 +1526,7 @@ fu_plugin_quirks_performance_func(void)
 	g_autoptr(GTimer) timer = g_timer_new();
 	g_autoptr(GError) error = NULL;
 	const gchar *keys[] = {"Name", "Children", "Flags", NULL};
+	GThread *threads[4] = {NULL};
 
 	ret = fu_quirks_load(quirks, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
 	g_assert_no_error(error);
@@ -1391,6 +1542,26 @@ fu_plugin_quirks_performance_func(void)
 		}
 	}
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_quirks_get_cache_hits(quirks), ==, 3000);
+
+	/* lookup of a GUID with no quirks */
+	g_timer_reset(timer);
+	for (guint j = 0; j < 1000; j++) {
+		const gchar *group = "00000000-0000-0000-0000-000000000000";
+		for (guint i = 0; keys[i] != NULL; i++) {
+			const gchar *tmp = fu_quirks_lookup_by_id(quirks, group, keys[i]);
+			g_assert_cmpstr(tmp, ==, NULL);
+		}
+	}
+	g_print("miss=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_quirks_get_cache_misses(quirks), ==, 3000);
+
+	/* lookup from plugin threads at the same time */
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		threads[i] = g_thread_new("fu-quirks", fu_plugin_quirks_thread_cb, quirks);
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		g_thread_join(threads[i]);
+	g_assert_cmpint(fu_quirks_get_cache_hits(quirks), ==, 7000);
 }
 
 typedef struct {
@@ -1563,11 +1734,16 @@ static void
 fu_plugin_backend_device_func(void)
 {
 	gboolean ret;
+	guint32 count = 0;
+	const gchar *kind = NULL;
+	GVariantBuilder builder;
 	g_autoptr(FuContext) ctx = fu_context_new();
 	g_autoptr(FuDevice) device = fu_device_new(ctx);
 	g_autoptr(FuPlugin) plugin = fu_plugin_new(ctx);
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRFUNC);
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) statistics = NULL;
+	g_autoptr(GVariant) statistic = NULL;
 
 	ret = fu_plugin_runner_backend_device_changed(plugin, device, &error);
 	g_assert_no_error(error);
@@ -1578,6 +1754,17 @@ fu_plugin_backend_device_func(void)
 	ret = fu_plugin_runner_backend_device_added(plugin, device, progress, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* the time taken was recorded */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	fu_plugin_add_statistics(plugin, &builder);
+	statistics = g_variant_ref_sink(g_variant_builder_end(&builder));
+	g_assert_cmpint(g_variant_n_children(statistics), ==, 1);
+	statistic = g_variant_get_child_value(statistics, 0);
+	g_assert_true(g_variant_lookup(statistic, "Kind", "&s", &kind));
+	g_assert_cmpstr(kind, ==, "backend-device-added");
+	g_assert_true(g_variant_lookup(statistic, "Count", "u", &count));
+	g_assert_cmpint(count, ==, 1);
 }
 
 static void
@@ -2407,6 +2594,60 @@ fu_device_incorporate_func(void)
 	g_assert_cmpstr(fu_device_get_custom_flags(device), ==, "ignore-runtime");
 }
 
+static void
+fu_device_setup_snapshot_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *key1 = NULL;
+	g_autofree gchar *key2 = NULL;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device1 = fu_device_new(ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(ctx);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JsonNode) json_node = NULL;
+
+	/* probe-time properties */
+	fu_device_set_physical_id(device1, "usb:00:01");
+	fu_device_add_instance_id(device1, "USB\\VID_273F&PID_1004");
+	key1 = fu_device_build_setup_cache_key(device1);
+	g_assert_nonnull(key1);
+
+	/* setup-time properties */
+	fu_device_set_version_format(device1, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device1, "1.2.3");
+	fu_device_add_instance_id(device1, "USB\\VID_273F&PID_1004&REV_0001");
+	fu_device_add_flag(device1, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_private_flag(device1, FU_DEVICE_PRIVATE_FLAG_NO_SERIAL_NUMBER);
+	fu_device_set_firmware_size_max(device1, 0x10000);
+	fu_device_set_metadata(device1, "key", "value");
+	fu_device_set_update_state(device1, FWUPD_UPDATE_STATE_FAILED);
+	ret = fu_device_ensure_id(device1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	json_node = fu_device_save_setup_snapshot(device1);
+	g_assert_nonnull(json_node);
+
+	/* same hardware after a daemon restart */
+	fu_device_set_physical_id(device2, "usb:00:01");
+	fu_device_add_instance_id(device2, "USB\\VID_273F&PID_1004");
+	key2 = fu_device_build_setup_cache_key(device2);
+	g_assert_cmpstr(key1, ==, key2);
+	ret = fu_device_restore_setup_snapshot(device2, json_node, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(fu_device_get_id(device2), ==, fu_device_get_id(device1));
+	g_assert_cmpstr(fu_device_get_version(device2), ==, "1.2.3");
+	g_assert_cmpint(fu_device_get_version_format(device2), ==, FWUPD_VERSION_FORMAT_TRIPLET);
+	g_assert_true(fu_device_has_instance_id(device2, "USB\\VID_273F&PID_1004&REV_0001"));
+	g_assert_true(fu_device_has_flag(device2, FWUPD_DEVICE_FLAG_UPDATABLE));
+	g_assert_true(fu_device_has_private_flag(device2, FU_DEVICE_PRIVATE_FLAG_NO_SERIAL_NUMBER));
+	g_assert_cmpint(fu_device_get_firmware_size_max(device2), ==, 0x10000);
+	g_assert_cmpstr(fu_device_get_metadata(device2, "key"), ==, "value");
+
+	/* runtime state is not restored */
+	g_assert_cmpint(fu_device_get_update_state(device2), ==, FWUPD_UPDATE_STATE_UNKNOWN);
+}
+
 static void
 fu_backend_emulate_count_cb(FuBackend *backend, FuDevice *device, gpointer user_data)
 {
@@ -3962,6 +4203,90 @@ fu_hid_descriptor_func(void)
 	g_assert_null(report3);
 }
 
+static void
+fu_hid_descriptor_parse_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuFirmware) firmware1 = fu_hid_descriptor_new();
+	g_autoptr(FuFirmware) firmware2 = fu_hid_descriptor_new();
+	g_autoptr(FuFirmware) item_id = NULL;
+	g_autoptr(FuFirmware) item_usage = NULL;
+	g_autoptr(FuHidReport) report1 = NULL;
+	g_autoptr(FuHidReport) report2 = NULL;
+	g_autoptr(FuHidReport) report3 = NULL;
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) reports = NULL;
+
+	filename = g_test_build_filename(G_TEST_DIST, "tests", "hid-descriptor.builder.xml", NULL);
+	ret = fu_firmware_build_from_filename(firmware1, filename, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob1 = fu_firmware_write(firmware1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob1);
+
+	/* parse into the compiled table */
+	ret = fu_firmware_parse_bytes(firmware2, blob1, 0x0, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	reports = fu_firmware_get_images(firmware2);
+	g_assert_cmpint(reports->len, ==, 9);
+
+	/* find report-id from usage */
+	report1 = fu_hid_descriptor_find_report(FU_HID_DESCRIPTOR(firmware2),
+						&error,
+						"usage",
+						0xC8,
+						NULL);
+	g_assert_no_error(error);
+	g_assert_nonnull(report1);
+	item_id = fu_firmware_get_image_by_id(FU_FIRMWARE(report1), "report-id", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(item_id);
+	g_assert_cmpint(fu_hid_report_item_get_value(FU_HID_REPORT_ITEM(item_id)), ==, 0xF1);
+
+	/* find usage from report-id */
+	report2 = fu_hid_descriptor_find_report(FU_HID_DESCRIPTOR(firmware2),
+						&error,
+						"usage-page",
+						0xFF0B,
+						"report-id",
+						0xF1,
+						NULL);
+	g_assert_no_error(error);
+	g_assert_nonnull(report2);
+	item_usage = fu_firmware_get_image_by_id(FU_FIRMWARE(report2), "usage", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(item_usage);
+	g_assert_cmpint(fu_hid_report_item_get_value(FU_HID_REPORT_ITEM(item_usage)), ==, 0xC8);
+
+	/* not found */
+	report3 = fu_hid_descriptor_find_report(FU_HID_DESCRIPTOR(firmware2),
+						&error,
+						"usage-page",
+						0x1234,
+						"report-id",
+						0xF1,
+						NULL);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(report3);
+	g_clear_error(&error);
+
+	/* the reports are created when parsing */
+	str = fu_firmware_to_string(firmware2);
+	g_assert_nonnull(g_strstr_len(str, -1, "FuHidReport"));
+	blob2 = fu_firmware_write(firmware2, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	ret = fu_bytes_compare(blob1, blob2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_firmware_func(void)
 {
@@ -4056,6 +4381,7 @@ fu_firmware_common_func(void)
 {
 	gboolean ret;
 	guint8 value = 0;
+	guint8 buf[4] = {0x0};
 	g_autoptr(GError) error = NULL;
 
 	ret = fu_firmware_strparse_uint8_safe("ff00XX", 6, 0, &value, &error);
@@ -4071,6 +4397,24 @@ fu_firmware_common_func(void)
 	ret = fu_firmware_strparse_uint8_safe("ff00XX", 6, 4, &value, &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
 	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fu_firmware_strparse_buf_safe("ff00aB9cXX", 10, 0, buf, 4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(buf[0], ==, 0xFF);
+	g_assert_cmpint(buf[1], ==, 0x00);
+	g_assert_cmpint(buf[2], ==, 0xAB);
+	g_assert_cmpint(buf[3], ==, 0x9C);
+
+	ret = fu_firmware_strparse_buf_safe("ff00aB9cXX", 10, 4, buf, 3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	ret = fu_firmware_strparse_buf_safe("ff00aB9cXX", 10, 6, buf, 3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
 }
 
 static void
@@ -4349,6 +4693,28 @@ fu_device_retry_success_3rd_try(FuDevice *device, gpointer user_data, GError **e
 	return FALSE;
 }
 
+static gboolean
+fu_device_retry_poll_busy_3rd_try(FuDevice *device, gpointer user_data, GError **error)
+{
+	FuDeviceRetryHelper *helper = (FuDeviceRetryHelper *)user_data;
+	if (helper->cnt_failed == 2) {
+		helper->cnt_success++;
+		return TRUE;
+	}
+	helper->cnt_failed++;
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_BUSY, "busy");
+	return FALSE;
+}
+
+static gboolean
+fu_device_retry_poll_busy_forever(FuDevice *device, gpointer user_data, GError **error)
+{
+	FuDeviceRetryHelper *helper = (FuDeviceRetryHelper *)user_data;
+	helper->cnt_failed++;
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_BUSY, "busy");
+	return FALSE;
+}
+
 static void
 fu_device_retry_success_func(void)
 {
@@ -4391,6 +4757,56 @@ fu_device_retry_failed_func(void)
 	g_assert_cmpint(helper.cnt_failed, ==, 3);
 }
 
+static void
+fu_device_retry_poll_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error2 = NULL;
+	g_autoptr(GError) error3 = NULL;
+	FuDeviceRetryHelper helper = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+	FuDeviceRetryHelper helper2 = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+	FuDeviceRetryHelper helper3 = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+
+	/* keeps polling while busy */
+	ret = fu_device_retry_poll(device,
+				   fu_device_retry_poll_busy_3rd_try,
+				   1000, /* ms */
+				   &helper,
+				   &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.cnt_success, ==, 1);
+	g_assert_cmpint(helper.cnt_failed, ==, 2);
+
+	/* any other error is fatal */
+	ret = fu_device_retry_poll(device, fu_device_retry_failed, 1000, &helper2, &error2);
+	g_assert_error(error2, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_assert_cmpint(helper2.cnt_failed, ==, 1);
+
+	/* an emulated device does not sleep, but still gives up */
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_EMULATED);
+	ret = fu_device_retry_poll(device,
+				   fu_device_retry_poll_busy_forever,
+				   1000, /* ms */
+				   &helper3,
+				   &error3);
+	g_assert_error(error3, FWUPD_ERROR, FWUPD_ERROR_BUSY);
+	g_assert_false(ret);
+	g_assert_cmpint(helper3.cnt_failed, ==, 21);
+}
+
 static void
 fu_device_retry_hardware_func(void)
 {
@@ -4697,6 +5113,24 @@ fu_security_attrs_hsi_func(void)
 	g_clear_object(&attr);
 }
 
+static void
+fu_security_attrs_lookup_func(void)
+{
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(FwupdSecurityAttr) attr = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr_tmp = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* producers that look at other attributes are detected */
+	fwupd_security_attr_set_plugin(attr, "foo");
+	fu_security_attrs_append(attrs, attr);
+	g_assert_cmpint(fu_security_attrs_get_lookup_cnt(attrs), ==, 0);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs, "org.fwupd.hsi.bar", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(attr_tmp);
+	g_assert_cmpint(fu_security_attrs_get_lookup_cnt(attrs), ==, 1);
+}
+
 static void
 fu_security_attrs_compare_func(void)
 {
@@ -5597,6 +6031,90 @@ fu_input_stream_find_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_input_stream_find_all_func(void)
+{
+	const gchar *haystack = "ushers his hershe";
+	const gchar *needles_str[] = {"he", "she", "his", "hers", "he"};
+	const struct {
+		guint idx;
+		gsize offset;
+	} matches_expected[] = {
+	    {1, 1},
+	    {0, 2},
+	    {3, 2},
+	    {4, 2},
+	    {2, 7},
+	    {0, 11},
+	    {3, 11},
+	    {4, 11},
+	    {1, 14},
+	    {0, 15},
+	    {4, 15},
+	};
+	gboolean ret;
+	gsize offset = 0;
+	g_autoptr(GArray) matches = NULL;
+	g_autoptr(GArray) matches_limit = NULL;
+	g_autoptr(GArray) matches_split = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GInputStream) stream_split = NULL;
+	g_autoptr(GPtrArray) needles =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+
+	for (guint i = 0; i < G_N_ELEMENTS(needles_str); i++) {
+		g_ptr_array_add(needles,
+				g_bytes_new_static(needles_str[i], strlen(needles_str[i])));
+	}
+	stream =
+	    g_memory_input_stream_new_from_data((const guint8 *)haystack, strlen(haystack), NULL);
+	matches = fu_input_stream_find_all(stream, needles, G_MAXUINT, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(matches);
+	g_assert_cmpint(matches->len, ==, G_N_ELEMENTS(matches_expected));
+	for (guint i = 0; i < matches->len; i++) {
+		FuInputStreamMatch *match = &g_array_index(matches, FuInputStreamMatch, i);
+		g_assert_cmpint(match->offset, ==, matches_expected[i].offset);
+		g_assert_cmpint(match->idx, ==, matches_expected[i].idx);
+	}
+
+	/* stop at the first needles to end, i.e. "she", "he" and "he" but not "hers" */
+	matches_limit = fu_input_stream_find_all(stream, needles, 3, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(matches_limit);
+	g_assert_cmpint(matches_limit->len, ==, 3);
+	g_assert_cmpint(g_array_index(matches_limit, FuInputStreamMatch, 0).idx, ==, 1);
+	g_assert_cmpint(g_array_index(matches_limit, FuInputStreamMatch, 1).idx, ==, 0);
+	g_assert_cmpint(g_array_index(matches_limit, FuInputStreamMatch, 2).idx, ==, 4);
+	g_assert_cmpint(g_array_index(matches_limit, FuInputStreamMatch, 2).offset, ==, 2);
+
+	/* needles split across the internal blocks */
+	fu_byte_array_set_size(buf, 0x20000, 0x00);
+	memcpy(buf->data + 0xFFFE, "hers", 4);
+	memcpy(buf->data + buf->len - 3, "his", 3);
+	stream_split = g_memory_input_stream_new_from_data(buf->data, buf->len, NULL);
+	matches_split = fu_input_stream_find_all(stream_split, needles, G_MAXUINT, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(matches_split);
+	g_assert_cmpint(matches_split->len, ==, 4);
+	g_assert_cmpint(g_array_index(matches_split, FuInputStreamMatch, 0).offset, ==, 0xFFFE);
+	g_assert_cmpint(g_array_index(matches_split, FuInputStreamMatch, 3).idx, ==, 2);
+	g_assert_cmpint(g_array_index(matches_split, FuInputStreamMatch, 3).offset,
+			==,
+			buf->len - 3);
+
+	ret = fu_input_stream_find(stream_split, (const guint8 *)"hers", 4, &offset, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(offset, ==, 0xFFFE);
+	ret = fu_input_stream_find(stream_split, (const guint8 *)"his", 3, &offset, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(offset, ==, buf->len - 3);
+}
+
 static void
 fu_input_stream_sum_overflow_func(void)
 {
@@ -6056,6 +6574,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/input-stream{sum-overflow}", fu_input_stream_sum_overflow_func);
 	g_test_add_func("/fwupd/input-stream{chunkify}", fu_input_stream_chunkify_func);
 	g_test_add_func("/fwupd/input-stream{find}", fu_input_stream_find_func);
+	g_test_add_func("/fwupd/input-stream{find-all}", fu_input_stream_find_all_func);
 	g_test_add_func("/fwupd/partial-input-stream", fu_partial_input_stream_func);
 	g_test_add_func("/fwupd/partial-input-stream{simple}", fu_partial_input_stream_simple_func);
 	g_test_add_func("/fwupd/composite-input-stream", fu_composite_input_stream_func);
@@ -6070,6 +6589,8 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{strnsplit}", fu_strsplit_func);
 	g_test_add_func("/fwupd/common{olson-timezone-id}", fu_common_olson_timezone_id_func);
 	g_test_add_func("/fwupd/common{memmem}", fu_common_memmem_func);
+	g_test_add_func("/fwupd/common{memmem-fallback}", fu_common_memmem_fallback_func);
+	g_test_add_func("/fwupd/common{sum}", fu_common_sum_func);
 	if (g_test_slow())
 		g_test_add_func("/fwupd/progress", fu_progress_func);
 	g_test_add_func("/fwupd/progress{scaling}", fu_progress_scaling_func);
@@ -6081,6 +6602,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/bios-attrs{load}", fu_bios_settings_load_func);
 	g_test_add_func("/fwupd/security-attrs{hsi}", fu_security_attrs_hsi_func);
 	g_test_add_func("/fwupd/security-attrs{compare}", fu_security_attrs_compare_func);
+	g_test_add_func("/fwupd/security-attrs{lookup}", fu_security_attrs_lookup_func);
 	g_test_add_func("/fwupd/config", fu_config_func);
 	g_test_add_func("/fwupd/plugin", fu_plugin_func);
 	g_test_add_func("/fwupd/plugin{vfuncs}", fu_plugin_vfuncs_func);
@@ -6128,6 +6650,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/context{backends}", fu_context_backends_func);
 	g_test_add_func("/fwupd/context{hwids-dmi}", fu_context_hwids_dmi_func);
 	g_test_add_func("/fwupd/context{firmware-gtypes}", fu_context_firmware_gtypes_func);
+	g_test_add_func("/fwupd/context{firmware-cache}", fu_context_firmware_cache_func);
 	g_test_add_func("/fwupd/context{state}", fu_context_state_func);
 	g_test_add_func("/fwupd/string{utf16}", fu_string_utf16_func);
 	g_test_add_func("/fwupd/smbios", fu_smbios_func);
@@ -6136,6 +6659,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/kernel{config}", fu_kernel_config_func);
 	g_test_add_func("/fwupd/hid{descriptor}", fu_hid_descriptor_func);
 	g_test_add_func("/fwupd/hid{descriptor-container}", fu_hid_descriptor_container_func);
+	g_test_add_func("/fwupd/hid{descriptor-parse}", fu_hid_descriptor_parse_func);
 	g_test_add_func("/fwupd/firmware", fu_firmware_func);
 	g_test_add_func("/fwupd/firmware{common}", fu_firmware_common_func);
 	g_test_add_func("/fwupd/firmware{convert-version}", fu_firmware_convert_version_func);
@@ -6176,6 +6700,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{parent}", fu_device_parent_func);
 	g_test_add_func("/fwupd/device{children}", fu_device_children_func);
 	g_test_add_func("/fwupd/device{incorporate}", fu_device_incorporate_func);
+	g_test_add_func("/fwupd/device{setup-snapshot}", fu_device_setup_snapshot_func);
 	g_test_add_func("/fwupd/device{incorporate-flag}", fu_device_incorporate_flag_func);
 	g_test_add_func("/fwupd/device{incorporate-descendant}",
 			fu_device_incorporate_descendant_func);
@@ -6189,6 +6714,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{retry-success}", fu_device_retry_success_func);
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
+	g_test_add_func("/fwupd/device{retry-poll}", fu_device_retry_poll_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
 	g_test_add_func("/fwupd/device{progress}", fu_plugin_device_progress_func);
 	return g_test_run();
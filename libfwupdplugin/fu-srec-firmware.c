@@ -14,6 +14,7 @@
 #include "fu-chunk-array.h"
 #include "fu-common.h"
 #include "fu-firmware-common.h"
+#include "fu-input-stream.h"
 #include "fu-srec-firmware.h"
 #include "fu-string.h"
 
@@ -25,8 +26,35 @@
  * See also: [class@FuFirmware]
  */
 
+#define FU_SREC_FIRMWARE_TOKENS_MAX 100000 /* lines */
+#define FU_SREC_FIRMWARE_LINE_MAX   514	   /* chars, with a count of 0xff */
+
+typedef struct {
+	FwupdInstallFlags flags;
+	GByteArray *outbuf; /* (nullable): only when building the image */
+	GPtrArray *records; /* (nullable): only when building the records */
+	gchar *id;	    /* (nullable) */
+	GError *error;	    /* (nullable): first error building the image */
+	guint32 addr_min;
+	guint32 addr_max;
+	gchar line[FU_SREC_FIRMWARE_LINE_MAX];
+	gsize linesz;
+	guint line_idx;
+	gboolean line_ignore;	/* after \r or ^Z */
+	gboolean line_overflow; /* longer than any valid record */
+	gboolean got_nul;
+	gboolean got_eof;
+	gboolean got_hdr;
+	guint16 data_cnt;
+	guint32 addr32_last;
+	guint32 img_address;
+} FuSrecFirmwareParseHelper;
+
 typedef struct {
-	GPtrArray *records;
+	GPtrArray *records;		   /* (nullable): built on demand */
+	GInputStream *stream;		   /* (nullable): as tokenized */
+	FwupdInstallFlags flags;	   /* as tokenized */
+	FuSrecFirmwareParseHelper *helper; /* (nullable): from ->tokenize() */
 	guint32 addr_min;
 	guint32 addr_max;
 } FuSrecFirmwarePrivate;
@@ -34,29 +62,6 @@ typedef struct {
 G_DEFINE_TYPE_WITH_PRIVATE(FuSrecFirmware, fu_srec_firmware, FU_TYPE_FIRMWARE)
 #define GET_PRIVATE(o) (fu_srec_firmware_get_instance_private(o))
 
-#define FU_SREC_FIRMWARE_TOKENS_MAX 100000 /* lines */
-
-/**
- * fu_srec_firmware_get_records:
- * @self: A #FuSrecFirmware
- *
- * Returns the raw records from SREC tokenization.
- *
- * This might be useful if the plugin is expecting the SREC file to be a list
- * of operations, rather than a simple linear image with filled holes.
- *
- * Returns: (transfer none) (element-type FuSrecFirmwareRecord): records
- *
- * Since: 1.3.2
- **/
-GPtrArray *
-fu_srec_firmware_get_records(FuSrecFirmware *self)
-{
-	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
-	g_return_val_if_fail(FU_IS_SREC_FIRMWARE(self), NULL);
-	return priv->records;
-}
-
 /**
  * fu_srec_firmware_set_addr_min:
  * @self: A #FuSrecFirmware
@@ -158,98 +163,217 @@ fu_srec_firmware_record_get_type(void)
 	return type_id;
 }
 
-typedef struct {
-	FuSrecFirmware *self;
-	FwupdInstallFlags flags;
-	gboolean got_eof;
-} FuSrecFirmwareTokenHelper;
+static void
+fu_srec_firmware_parse_helper_free(FuSrecFirmwareParseHelper *helper)
+{
+	if (helper->outbuf != NULL)
+		g_byte_array_unref(helper->outbuf);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper->id);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuSrecFirmwareParseHelper, fu_srec_firmware_parse_helper_free)
 
 static gboolean
-fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data, GError **error)
+fu_srec_firmware_parse_data(FuSrecFirmwareParseHelper *helper,
+			    guint ln,
+			    guint8 rec_kind,
+			    guint32 rec_addr32,
+			    const guint8 *data,
+			    gsize datasz,
+			    GError **error)
 {
-	FuSrecFirmwareTokenHelper *helper = (FuSrecFirmwareTokenHelper *)user_data;
-	FuSrecFirmwarePrivate *priv = GET_PRIVATE(helper->self);
-	g_autoptr(FuSrecFirmwareRecord) rcd = NULL;
-	gboolean require_data = FALSE;
-	guint32 rec_addr32;
-	guint16 rec_addr16;
-	guint8 addrsz = 0; /* bytes */
-	guint8 rec_count;  /* words */
-	guint8 rec_kind;
+	/* header */
+	if (rec_kind == FU_FIRMWARE_SREC_RECORD_KIND_S0_HEADER) {
+		g_autoptr(GString) modname = g_string_new(NULL);
 
-	/* sanity check */
-	if (token_idx > FU_SREC_FIRMWARE_TOKENS_MAX) {
-		g_set_error_literal(error,
+		/* check for duplicate */
+		if (helper->got_hdr) {
+			g_set_error(error,
 				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_DATA,
-				    "file has too many lines");
-		return FALSE;
-	}
+				    FWUPD_ERROR_INVALID_FILE,
+				    "duplicate header record at line %u",
+				    ln);
+			return FALSE;
+		}
 
-	/* remove WIN32 line endings */
-	g_strdelimit(token->str, "\r\x1a", '\0');
-	token->len = strlen(token->str);
+		/* could be anything, lets assume text */
+		for (guint i = 0; i < datasz; i++) {
+			gchar tmp = data[i];
+			if (!g_ascii_isgraph(tmp))
+				break;
+			g_string_append_c(modname, tmp);
+		}
+		if (modname->len != 0)
+			helper->id = g_string_free(g_steal_pointer(&modname), FALSE);
+		helper->got_hdr = TRUE;
+		return TRUE;
+	}
 
-	/* ignore blank lines */
-	if (token->len == 0)
+	/* verify we got all records */
+	if (rec_kind == FU_FIRMWARE_SREC_RECORD_KIND_S5_COUNT_16) {
+		if (rec_addr32 != helper->data_cnt) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "count record was not valid, got 0x%02x expected "
+				    "0x%02x at line %u",
+				    (guint)rec_addr32,
+				    (guint)helper->data_cnt,
+				    ln);
+			return FALSE;
+		}
 		return TRUE;
+	}
+
+	/* data */
+	if (rec_kind == FU_FIRMWARE_SREC_RECORD_KIND_S1_DATA_16 ||
+	    rec_kind == FU_FIRMWARE_SREC_RECORD_KIND_S2_DATA_24 ||
+	    rec_kind == FU_FIRMWARE_SREC_RECORD_KIND_S3_DATA_32) {
+		/* invalid */
+		if (!helper->got_hdr) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "missing header record at line %u",
+				    ln);
+			return FALSE;
+		}
+
+		/* does not make sense */
+		if (rec_addr32 < helper->addr32_last) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "invalid address 0x%x, last was 0x%x at line %u",
+				    (guint)rec_addr32,
+				    (guint)helper->addr32_last,
+				    ln);
+			return FALSE;
+		}
+		if (rec_addr32 < helper->addr_min) {
+			g_debug("ignoring data at 0x%x as before start address 0x%x at line %u",
+				(guint)rec_addr32,
+				helper->addr_min,
+				ln);
+		} else if (helper->addr_max > 0 && rec_addr32 < helper->addr_max) {
+			g_debug("ignoring data at 0x%x as after end address 0x%x at line %u",
+				(guint)rec_addr32,
+				helper->addr_max,
+				ln);
+		} else {
+			guint32 len_hole = rec_addr32 - helper->addr32_last;
+
+			/* fill any holes, but only up to 1Mb to avoid a DoS */
+			if (helper->addr32_last > 0 && len_hole > 0x100000) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "hole of 0x%x bytes too large to fill at line %u",
+					    (guint)len_hole,
+					    ln);
+				return FALSE;
+			}
+			if (helper->addr32_last > 0x0 && len_hole > 1) {
+				g_debug("filling address 0x%08x to 0x%08x at line %u",
+					helper->addr32_last + 1,
+					helper->addr32_last + len_hole - 1,
+					ln);
+				fu_byte_array_set_size(helper->outbuf,
+						       helper->outbuf->len + len_hole,
+						       0xff);
+			}
+
+			/* add data */
+			g_byte_array_append(helper->outbuf, data, datasz);
+			if (helper->img_address == 0x0)
+				helper->img_address = rec_addr32;
+			helper->addr32_last = rec_addr32 + datasz;
+			if (helper->addr32_last < rec_addr32) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "overflow from address 0x%x at line %u",
+					    (guint)rec_addr32,
+					    ln);
+				return FALSE;
+			}
+		}
+		helper->data_cnt++;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_srec_firmware_parse_record(FuSrecFirmwareParseHelper *helper,
+			      const gchar *line,
+			      gsize linesz,
+			      guint ln,
+			      GError **error)
+{
+	gboolean require_data = FALSE;
+	guint8 buf[0xff] = {0x0};
+	guint32 rec_addr32 = 0;
+	guint8 addrsz = 0; /* bytes */
+	guint8 rec_count;  /* words */
+	guint8 rec_kind;
+	const guint8 *data;
+	gsize datasz = 0;
 
 	/* check starting token */
-	if (token->str[0] != 'S' || token->len < 3) {
-		g_autofree gchar *strsafe = fu_strsafe(token->str, 3);
+	if (line[0] != 'S' || linesz < 3) {
+		g_autofree gchar *strsafe = fu_strsafe(line, MIN(linesz, 3));
 		if (strsafe != NULL) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "invalid starting token, got '%s' at line %u",
 				    strsafe,
-				    token_idx + 1);
+				    ln);
 			return FALSE;
 		}
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "invalid starting token at line %u",
-			    token_idx + 1);
+			    ln);
 		return FALSE;
 	}
 
 	/* kind, count, address, (data), checksum, linefeed */
-	rec_kind = token->str[1] - '0';
-	if (!fu_firmware_strparse_uint8_safe(token->str, token->len, 2, &rec_count, error))
+	rec_kind = line[1] - '0';
+	if (!fu_firmware_strparse_buf_safe(line, linesz, 2, &rec_count, 1, error))
 		return FALSE;
-	if (rec_count * 2 != token->len - 4) {
+	if (helper->line_overflow || (gsize)rec_count * 2 != linesz - 4) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "count incomplete at line %u, "
 			    "length %u, expected %u",
-			    token_idx + 1,
-			    (guint)token->len - 4,
+			    ln,
+			    (guint)linesz - 4,
 			    (guint)rec_count * 2);
 		return FALSE;
 	}
 
-	/* checksum check */
+	/* decode the count, address and data, verifying the checksum in the same pass */
+	buf[0] = rec_count;
+	if (!fu_firmware_strparse_buf_safe(line, linesz, 4, buf + 1, rec_count - 1, error))
+		return FALSE;
 	if ((helper->flags & FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM) == 0) {
 		guint8 rec_csum = 0;
-		guint8 rec_csum_expected;
-		for (guint8 i = 0; i < rec_count; i++) {
-			guint8 csum_tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(token->str,
-							     token->len,
-							     (i * 2) + 2,
-							     &csum_tmp,
-							     error))
-				return FALSE;
-			rec_csum += csum_tmp;
-		}
+		guint8 rec_csum_expected = 0;
+		for (guint i = 0; i < rec_count; i++)
+			rec_csum += buf[i];
 		rec_csum ^= 0xff;
-		if (!fu_firmware_strparse_uint8_safe(token->str,
-						     token->len,
-						     (rec_count * 2) + 2,
-						     &rec_csum_expected,
-						     error))
+		if (!fu_firmware_strparse_buf_safe(line,
+						   linesz,
+						   (rec_count * 2) + 2,
+						   &rec_csum_expected,
+						   1,
+						   error))
 			return FALSE;
 		if (rec_csum != rec_csum_expected) {
 			g_set_error(error,
@@ -257,7 +381,7 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 				    FWUPD_ERROR_INVALID_FILE,
 				    "checksum incorrect line %u, "
 				    "expected %02x, got %02x",
-				    token_idx + 1,
+				    ln,
 				    rec_csum_expected,
 				    rec_csum);
 			return FALSE;
@@ -303,46 +427,10 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "invalid srec record type S%c at line %u",
-			    token->str[1],
-			    token_idx + 1);
+			    line[1],
+			    ln);
 		return FALSE;
 	}
-
-	/* parse address */
-	switch (addrsz) {
-	case 2:
-		if (!fu_firmware_strparse_uint16_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr16,
-						      error))
-			return FALSE;
-		rec_addr32 = rec_addr16;
-		break;
-	case 3:
-		if (!fu_firmware_strparse_uint24_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr32,
-						      error))
-			return FALSE;
-		break;
-	case 4:
-		if (!fu_firmware_strparse_uint32_safe(token->str,
-						      token->len,
-						      4,
-						      &rec_addr32,
-						      error))
-			return FALSE;
-		break;
-	default:
-		g_assert_not_reached();
-	}
-	g_debug("line %03u S%u addr:0x%04x datalen:0x%02x",
-		token_idx + 1,
-		rec_kind,
-		rec_addr32,
-		(guint)rec_count - addrsz - 1);
 	if (require_data && rec_count == addrsz) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -351,194 +439,234 @@ fu_srec_firmware_tokenize_cb(GString *token, guint token_idx, gpointer user_data
 			    rec_kind);
 		return FALSE;
 	}
+	if (rec_count <= addrsz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "S%u record too short at line %u",
+			    rec_kind,
+			    ln);
+		return FALSE;
+	}
 
-	/* data */
-	rcd = fu_srec_firmware_record_new(token_idx + 1, rec_kind, rec_addr32);
-	if (rec_kind == 1 || rec_kind == 2 || rec_kind == 3) {
-		for (gsize i = 4 + (addrsz * 2); i <= rec_count * 2; i += 2) {
-			guint8 tmp = 0;
-			if (!fu_firmware_strparse_uint8_safe(token->str,
-							     token->len,
-							     i,
-							     &tmp,
-							     error))
-				return FALSE;
-			fu_byte_array_append_uint8(rcd->buf, tmp);
-		}
+	/* parse address */
+	for (guint i = 0; i < addrsz; i++)
+		rec_addr32 = (rec_addr32 << 8) | buf[1 + i];
+	data = buf + 1 + addrsz;
+	if (rec_kind == 1 || rec_kind == 2 || rec_kind == 3)
+		datasz = rec_count - addrsz - 1;
+
+	/* only allocated when fu_srec_firmware_get_records() is used */
+	if (helper->records != NULL) {
+		FuSrecFirmwareRecord *rcd = fu_srec_firmware_record_new(ln, rec_kind, rec_addr32);
+		g_byte_array_append(rcd->buf, data, datasz);
+		g_ptr_array_add(helper->records, rcd);
 	}
-	g_ptr_array_add(priv->records, g_steal_pointer(&rcd));
+
+	/* a record that does not fit into the image is only fatal in ->parse(), as subclasses
+	 * may replace that with their own interpretation of the records */
+	if (helper->outbuf != NULL && helper->error == NULL)
+		fu_srec_firmware_parse_data(helper,
+					    ln,
+					    rec_kind,
+					    rec_addr32,
+					    data,
+					    datasz,
+					    &helper->error);
 	return TRUE;
 }
 
 static gboolean
-fu_srec_firmware_tokenize(FuFirmware *firmware,
-			  GInputStream *stream,
-			  FwupdInstallFlags flags,
-			  GError **error)
+fu_srec_firmware_parse_line(FuSrecFirmwareParseHelper *helper, GError **error)
 {
-	FuSrecFirmware *self = FU_SREC_FIRMWARE(firmware);
-	FuSrecFirmwareTokenHelper helper = {.self = self, .flags = flags, .got_eof = FALSE};
-
-	/* parse records */
-	if (!fu_strsplit_stream(stream, 0x0, "\n", fu_srec_firmware_tokenize_cb, &helper, error))
-		return FALSE;
+	guint ln = ++helper->line_idx;
 
-	/* no EOF */
-	if (!helper.got_eof) {
+	/* sanity check */
+	if (ln - 1 > FU_SREC_FIRMWARE_TOKENS_MAX) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "no EOF, perhaps truncated file");
+				    FWUPD_ERROR_INVALID_DATA,
+				    "file has too many lines");
 		return FALSE;
 	}
+
+	/* ignore blank lines */
+	if (helper->linesz > 0) {
+		if (!fu_srec_firmware_parse_record(helper, helper->line, helper->linesz, ln, error))
+			return FALSE;
+	}
+	helper->linesz = 0;
+	helper->line_ignore = FALSE;
+	helper->line_overflow = FALSE;
 	return TRUE;
 }
 
 static gboolean
-fu_srec_firmware_parse(FuFirmware *firmware,
-		       GInputStream *stream,
-		       FwupdInstallFlags flags,
-		       GError **error)
+fu_srec_firmware_parse_chunk_cb(const guint8 *buf, gsize bufsz, gpointer user_data, GError **error)
 {
-	FuSrecFirmware *self = FU_SREC_FIRMWARE(firmware);
-	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
-	gboolean got_hdr = FALSE;
-	guint16 data_cnt = 0;
-	guint32 addr32_last = 0;
-	guint32 img_address = 0;
-	g_autoptr(GBytes) img_bytes = NULL;
-	g_autoptr(GByteArray) outbuf = g_byte_array_new();
-
-	/* parse records */
-	for (guint j = 0; j < priv->records->len; j++) {
-		FuSrecFirmwareRecord *rcd = g_ptr_array_index(priv->records, j);
-
-		/* header */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S0_HEADER) {
-			g_autoptr(GString) modname = g_string_new(NULL);
+	FuSrecFirmwareParseHelper *helper = (FuSrecFirmwareParseHelper *)user_data;
 
-			/* check for duplicate */
-			if (got_hdr) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "duplicate header record at line %u",
-					    rcd->ln);
+	for (gsize i = 0; i < bufsz && !helper->got_nul; i++) {
+		gchar c = (gchar)buf[i];
+		if (c == '\n' || c == '\0') {
+			helper->got_nul = c == '\0';
+			if (!fu_srec_firmware_parse_line(helper, error))
 				return FALSE;
-			}
-
-			/* could be anything, lets assume text */
-			for (guint i = 0; i < rcd->buf->len; i++) {
-				gchar tmp = rcd->buf->data[i];
-				if (!g_ascii_isgraph(tmp))
-					break;
-				g_string_append_c(modname, tmp);
-			}
-			if (modname->len != 0)
-				fu_firmware_set_id(firmware, modname->str);
-			got_hdr = TRUE;
 			continue;
 		}
+		if (helper->line_ignore)
+			continue;
 
-		/* verify we got all records */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S5_COUNT_16) {
-			if (rcd->addr != data_cnt) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "count record was not valid, got 0x%02x expected "
-					    "0x%02x at line %u",
-					    (guint)rcd->addr,
-					    (guint)data_cnt,
-					    rcd->ln);
-				return FALSE;
-			}
+		/* remove WIN32 line endings */
+		if (c == '\r' || c == '\x1a') {
+			helper->line_ignore = TRUE;
+			continue;
+		}
+		if (helper->linesz == sizeof(helper->line)) {
+			helper->line_ignore = TRUE;
+			helper->line_overflow = TRUE;
 			continue;
 		}
+		helper->line[helper->linesz++] = c;
+	}
+	return TRUE;
+}
 
-		/* data */
-		if (rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S1_DATA_16 ||
-		    rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S2_DATA_24 ||
-		    rcd->kind == FU_FIRMWARE_SREC_RECORD_KIND_S3_DATA_32) {
-			/* invalid */
-			if (!got_hdr) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "missing header record at line %u",
-					    rcd->ln);
-				return FALSE;
-			}
+/* decodes each line in a single pass, building the image and/or the records */
+static FuSrecFirmwareParseHelper *
+fu_srec_firmware_decode(FuSrecFirmware *self,
+			GInputStream *stream,
+			FwupdInstallFlags flags,
+			gboolean with_image,
+			GPtrArray *records,
+			GError **error)
+{
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuSrecFirmwareParseHelper) helper = g_new0(FuSrecFirmwareParseHelper, 1);
+
+	helper->flags = flags;
+	helper->records = records;
+	helper->addr_min = priv->addr_min;
+	helper->addr_max = priv->addr_max;
+	if (with_image)
+		helper->outbuf = g_byte_array_new();
+	if (!fu_input_stream_chunkify(stream, fu_srec_firmware_parse_chunk_cb, helper, error))
+		return NULL;
+	if (helper->linesz > 0 && !helper->got_nul) {
+		if (!fu_srec_firmware_parse_line(helper, error))
+			return NULL;
+	}
 
-			/* does not make sense */
-			if (rcd->addr < addr32_last) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "invalid address 0x%x, last was 0x%x at line %u",
-					    (guint)rcd->addr,
-					    (guint)addr32_last,
-					    rcd->ln);
-				return FALSE;
-			}
-			if (rcd->addr < priv->addr_min) {
-				g_debug(
-				    "ignoring data at 0x%x as before start address 0x%x at line %u",
-				    (guint)rcd->addr,
-				    priv->addr_min,
-				    rcd->ln);
-			} else if (priv->addr_max > 0 && rcd->addr < priv->addr_max) {
-				g_debug(
-				    "ignoring data at 0x%x as after end address 0x%x at line %u",
-				    (guint)rcd->addr,
-				    priv->addr_max,
-				    rcd->ln);
-			} else {
-				guint32 len_hole = rcd->addr - addr32_last;
-
-				/* fill any holes, but only up to 1Mb to avoid a DoS */
-				if (addr32_last > 0 && len_hole > 0x100000) {
-					g_set_error(
-					    error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "hole of 0x%x bytes too large to fill at line %u",
-					    (guint)len_hole,
-					    rcd->ln);
-					return FALSE;
-				}
-				if (addr32_last > 0x0 && len_hole > 1) {
-					g_debug("filling address 0x%08x to 0x%08x at line %u",
-						addr32_last + 1,
-						addr32_last + len_hole - 1,
-						rcd->ln);
-					for (guint i = 0; i < len_hole; i++)
-						fu_byte_array_append_uint8(outbuf, 0xff);
-				}
-
-				/* add data */
-				g_byte_array_append(outbuf, rcd->buf->data, rcd->buf->len);
-				if (img_address == 0x0)
-					img_address = rcd->addr;
-				addr32_last = rcd->addr + rcd->buf->len;
-				if (addr32_last < rcd->addr) {
-					g_set_error(error,
-						    FWUPD_ERROR,
-						    FWUPD_ERROR_INVALID_FILE,
-						    "overflow from address 0x%x at line %u",
-						    (guint)rcd->addr,
-						    rcd->ln);
-					return FALSE;
-				}
+	/* no EOF */
+	if (!helper->got_eof) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "no EOF, perhaps truncated file");
+		return NULL;
+	}
+	return g_steal_pointer(&helper);
+}
+
+/**
+ * fu_srec_firmware_get_records:
+ * @self: A #FuSrecFirmware
+ *
+ * Returns the raw records from SREC tokenization.
+ *
+ * This might be useful if the plugin is expecting the SREC file to be a list
+ * of operations, rather than a simple linear image with filled holes.
+ *
+ * Returns: (transfer none) (element-type FuSrecFirmwareRecord): records
+ *
+ * Since: 1.3.2
+ **/
+GPtrArray *
+fu_srec_firmware_get_records(FuSrecFirmware *self)
+{
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SREC_FIRMWARE(self), NULL);
+
+	/* the stream was already validated by ->tokenize() */
+	if (priv->records == NULL) {
+		priv->records =
+		    g_ptr_array_new_with_free_func((GFreeFunc)fu_srec_firmware_record_free);
+		if (priv->stream != NULL) {
+			g_autoptr(FuSrecFirmwareParseHelper) helper = NULL;
+			g_autoptr(GError) error_local = NULL;
+			helper = fu_srec_firmware_decode(self,
+							 priv->stream,
+							 priv->flags,
+							 FALSE,
+							 priv->records,
+							 &error_local);
+			if (helper == NULL) {
+				g_warning("failed to build records: %s", error_local->message);
+				g_ptr_array_set_size(priv->records, 0);
 			}
-			data_cnt++;
 		}
 	}
+	return priv->records;
+}
+
+static gboolean
+fu_srec_firmware_parse(FuFirmware *firmware,
+		       GInputStream *stream,
+		       FwupdInstallFlags flags,
+		       GError **error)
+{
+	FuSrecFirmware *self = FU_SREC_FIRMWARE(firmware);
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuSrecFirmwareParseHelper) helper = g_steal_pointer(&priv->helper);
+	g_autoptr(GBytes) img_bytes = NULL;
+
+	/* the image is normally built by ->tokenize() */
+	if (helper == NULL || helper->outbuf == NULL) {
+		g_clear_pointer(&helper, fu_srec_firmware_parse_helper_free);
+		helper = fu_srec_firmware_decode(self, stream, flags, TRUE, NULL, error);
+		if (helper == NULL)
+			return FALSE;
+	}
+	if (helper->error != NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return FALSE;
+	}
+	if (helper->id != NULL)
+		fu_firmware_set_id(firmware, helper->id);
 
 	/* add single image */
-	img_bytes = g_bytes_new(outbuf->data, outbuf->len);
+	img_bytes = g_byte_array_free_to_bytes(g_steal_pointer(&helper->outbuf));
 	fu_firmware_set_bytes(firmware, img_bytes);
-	fu_firmware_set_addr(firmware, img_address);
+	fu_firmware_set_addr(firmware, helper->img_address);
+	return TRUE;
+}
+
+static gboolean
+fu_srec_firmware_tokenize(FuFirmware *firmware,
+			  GInputStream *stream,
+			  FwupdInstallFlags flags,
+			  GError **error)
+{
+	FuSrecFirmware *self = FU_SREC_FIRMWARE(firmware);
+	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(firmware);
+	g_autoptr(FuSrecFirmwareParseHelper) helper = NULL;
+
+	/* validate every record, building the image at the same time unless a subclass
+	 * is going to use the records instead */
+	helper = fu_srec_firmware_decode(self,
+					 stream,
+					 flags,
+					 klass->parse == fu_srec_firmware_parse,
+					 NULL,
+					 error);
+	if (helper == NULL)
+		return FALSE;
+	g_clear_pointer(&priv->records, g_ptr_array_unref);
+	g_clear_pointer(&priv->helper, fu_srec_firmware_parse_helper_free);
+	g_set_object(&priv->stream, stream);
+	priv->flags = flags;
+	priv->helper = g_steal_pointer(&helper);
 	return TRUE;
 }
 
@@ -654,15 +782,18 @@ fu_srec_firmware_finalize(GObject *object)
 {
 	FuSrecFirmware *self = FU_SREC_FIRMWARE(object);
 	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
-	g_ptr_array_unref(priv->records);
+	if (priv->records != NULL)
+		g_ptr_array_unref(priv->records);
+	if (priv->stream != NULL)
+		g_object_unref(priv->stream);
+	if (priv->helper != NULL)
+		fu_srec_firmware_parse_helper_free(priv->helper);
 	G_OBJECT_CLASS(fu_srec_firmware_parent_class)->finalize(object);
 }
 
 static void
 fu_srec_firmware_init(FuSrecFirmware *self)
 {
-	FuSrecFirmwarePrivate *priv = GET_PRIVATE(self);
-	priv->records = g_ptr_array_new_with_free_func((GFreeFunc)fu_srec_firmware_record_free);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_CHECKSUM);
 }
 
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2017 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-sum.h"
+
+guint64
+fu_sum_bytes_scalar(const guint8 *buf, gsize bufsz);
+#ifdef __SSE2__
+guint64
+fu_sum_bytes_sse2(const guint8 *buf, gsize bufsz);
+#endif
+#ifdef HAVE_AVX2
+guint64
+fu_sum_bytes_avx2(const guint8 *buf, gsize bufsz);
+#endif
+#ifdef __ARM_NEON
+guint64
+fu_sum_bytes_neon(const guint8 *buf, gsize bufsz);
+#endif
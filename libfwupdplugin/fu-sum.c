@@ -8,8 +8,97 @@
 
 #include "config.h"
 
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 #include "fu-mem.h"
-#include "fu-sum.h"
+#include "fu-sum-private.h"
+
+/* the 8, 16 and 32 bit byte sums are all just the total truncated to the return type */
+guint64
+fu_sum_bytes_scalar(const guint8 *buf, gsize bufsz)
+{
+	guint64 total = 0;
+	for (gsize i = 0; i < bufsz; i++)
+		total += buf[i];
+	return total;
+}
+
+#ifdef __SSE2__
+guint64
+fu_sum_bytes_sse2(const guint8 *buf, gsize bufsz)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc = _mm_setzero_si128();
+	guint64 lanes[2] = {0};
+	gsize i = 0;
+
+	/* PSADBW against zero adds each group of 8 bytes into a 64 bit lane */
+	for (; i + 16 <= bufsz; i += 16) {
+		__m128i val = _mm_loadu_si128((const __m128i *)(buf + i));
+		acc = _mm_add_epi64(acc, _mm_sad_epu8(val, zero));
+	}
+	_mm_storeu_si128((__m128i *)lanes, acc);
+	return lanes[0] + lanes[1] + fu_sum_bytes_scalar(buf + i, bufsz - i);
+}
+#endif
+
+#ifdef HAVE_AVX2
+__attribute__((target("avx2"))) guint64
+fu_sum_bytes_avx2(const guint8 *buf, gsize bufsz)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc = _mm256_setzero_si256();
+	guint64 lanes[4] = {0};
+	gsize i = 0;
+
+	for (; i + 32 <= bufsz; i += 32) {
+		__m256i val = _mm256_loadu_si256((const __m256i *)(buf + i));
+		acc = _mm256_add_epi64(acc, _mm256_sad_epu8(val, zero));
+	}
+	_mm256_storeu_si256((__m256i *)lanes, acc);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + fu_sum_bytes_scalar(buf + i, bufsz - i);
+}
+#endif
+
+#ifdef __ARM_NEON
+guint64
+fu_sum_bytes_neon(const guint8 *buf, gsize bufsz)
+{
+	uint64x2_t acc = vdupq_n_u64(0);
+	gsize i = 0;
+
+	/* widen pairwise until each 64 bit lane holds the sum of 8 bytes */
+	for (; i + 16 <= bufsz; i += 16) {
+		uint8x16_t val = vld1q_u8(buf + i);
+		acc = vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(val)));
+	}
+	return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1) +
+	       fu_sum_bytes_scalar(buf + i, bufsz - i);
+}
+#endif
+
+static guint64
+fu_sum_bytes(const guint8 *buf, gsize bufsz)
+{
+#ifdef HAVE_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		return fu_sum_bytes_avx2(buf, bufsz);
+#endif
+#if defined(__SSE2__)
+	return fu_sum_bytes_sse2(buf, bufsz);
+#elif defined(__ARM_NEON)
+	return fu_sum_bytes_neon(buf, bufsz);
+#else
+	return fu_sum_bytes_scalar(buf, bufsz);
+#endif
+}
 
 /**
  * fu_sum8:
@@ -25,11 +114,8 @@
 guint8
 fu_sum8(const guint8 *buf, gsize bufsz)
 {
-	guint8 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT8);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint8)fu_sum_bytes(buf, bufsz);
 }
 
 /**
@@ -65,11 +151,8 @@ fu_sum8_bytes(GBytes *blob)
 guint16
 fu_sum16(const guint8 *buf, gsize bufsz)
 {
-	guint16 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT16);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint16)fu_sum_bytes(buf, bufsz);
 }
 
 /**
@@ -146,11 +229,8 @@ fu_sum16w_bytes(GBytes *blob, FuEndianType endian)
 guint32
 fu_sum32(const guint8 *buf, gsize bufsz)
 {
-	guint32 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT32);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint32)fu_sum_bytes(buf, bufsz);
 }
 
 /**
@@ -80,6 +80,7 @@ fu_bios_plugin_add_security_attrs(FuPlugin *plugin, FuSecurityAttrs *attrs)
 static void
 fu_bios_plugin_init(FuBiosPlugin *self)
 {
+	fu_plugin_set_thread_safe(FU_PLUGIN(self), TRUE);
 }
 
 static void
@@ -448,32 +448,41 @@ fu_dfu_target_manifest_wait(FuDfuTarget *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_dfu_target_check_status_cb(FuDevice *device, gpointer user_data, GError **error)
+{
+	FuDfuDevice *dfu_device = FU_DFU_DEVICE(device);
+
+	if (!fu_dfu_device_refresh(dfu_device, 0, error))
+		return FALSE;
+	if (fu_dfu_device_get_state(dfu_device) == FU_DFU_STATE_DFU_DNBUSY) {
+		/* the device is allowed to ignore GETSTATUS until bwPollTimeout, and the poll
+		 * delay includes this wait */
+		fu_device_sleep(device, fu_dfu_device_get_download_timeout(dfu_device));
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_BUSY,
+				    "waiting for FU_DFU_STATE_DFU_DNBUSY to clear");
+		return FALSE;
+	}
+	return TRUE;
+}
+
 gboolean
 fu_dfu_target_check_status(FuDfuTarget *self, GError **error)
 {
 	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
 	FuDfuStatus status;
-	g_autoptr(GTimer) timer = g_timer_new();
 
-	/* get the status */
-	if (!fu_dfu_device_refresh(device, 0, error))
+	/* wait for dfuDNBUSY to not be set -- this is a really long time to save fwupd in case
+	 * the device has got wedged */
+	if (!fu_device_retry_poll(FU_DEVICE(device),
+				  fu_dfu_target_check_status_cb,
+				  120000, /* ms */
+				  NULL,
+				  error)) {
+		g_prefix_error(error, "failed to wait for DFU_DNBUSY: ");
 		return FALSE;
-
-	/* wait for dfuDNBUSY to not be set */
-	while (fu_dfu_device_get_state(device) == FU_DFU_STATE_DFU_DNBUSY) {
-		g_debug("waiting for FU_DFU_STATE_DFU_DNBUSY to clear");
-		fu_device_sleep(FU_DEVICE(device), fu_dfu_device_get_download_timeout(device));
-		if (!fu_dfu_device_refresh(device, 0, error))
-			return FALSE;
-		/* this is a really long time to save fwupd in case
-		 * the device has got wedged */
-		if (g_timer_elapsed(timer, NULL) > 120.f) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INTERNAL,
-					    "Stuck in DFU_DNBUSY");
-			return FALSE;
-		}
 	}
 
 	/* not in an error state */
@@ -655,6 +655,7 @@ fu_msr_plugin_constructed(GObject *obj)
 {
 	FuPlugin *plugin = FU_PLUGIN(obj);
 	fu_plugin_add_device_udev_subsystem(plugin, "msr");
+	fu_plugin_set_thread_safe(plugin, TRUE);
 
 	/* defaults changed here will also be reflected in the fwupd.conf man page */
 	fu_plugin_set_config_default(plugin, "MinimumSmeKernelVersion", "5.18.0");
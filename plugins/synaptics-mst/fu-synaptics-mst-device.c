@@ -117,6 +117,9 @@ fu_synaptics_mst_device_init(FuSynapticsMstDevice *self)
 	fu_device_add_flag(FU_DEVICE(self), FWUPD_DEVICE_FLAG_UPDATABLE);
 	fu_device_add_request_flag(FU_DEVICE(self), FWUPD_REQUEST_FLAG_ALLOW_GENERIC_MESSAGE);
 
+	/* the hub may be restarted by the dock without the aux device being re-enumerated */
+	fu_device_add_private_flag(FU_DEVICE(self), FU_DEVICE_PRIVATE_FLAG_NO_SETUP_CACHE);
+
 	/* this is set from ->incorporate() */
 	g_signal_connect(FU_UDEV_DEVICE(self),
 			 "notify::udev-device",
@@ -187,14 +190,20 @@ fu_synaptics_mst_device_rc_send_command_and_wait_cb(FuDevice *device,
 	FuSynapticsMstDevice *self = FU_SYNAPTICS_MST_DEVICE(device);
 	FuSynapticsMstUpdcRcHelper *helper = (FuSynapticsMstUpdcRcHelper *)user_data;
 	guint8 buf[2] = {0};
+	g_autoptr(GError) error_local = NULL;
 
+	/* the AUX channel can fail while the command is being processed, so retry */
 	if (!fu_dpaux_device_read(FU_DPAUX_DEVICE(self),
 				  FU_SYNAPTICS_MST_REG_RC_CMD,
 				  buf,
 				  sizeof(buf),
 				  FU_SYNAPTICS_MST_DEVICE_READ_TIMEOUT,
-				  error)) {
-		g_prefix_error(error, "failed to read command: ");
+				  &error_local)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_BUSY,
+			    "failed to read command: %s",
+			    error_local->message);
 		return FALSE;
 	}
 	if (buf[0] & 0x80) {
@@ -232,10 +241,9 @@ fu_synaptics_mst_device_rc_send_command_and_wait(FuSynapticsMstDevice *self,
 	}
 
 	/* wait command complete */
-	if (!fu_device_retry_full(FU_DEVICE(self),
+	if (!fu_device_retry_poll(FU_DEVICE(self),
 				  fu_synaptics_mst_device_rc_send_command_and_wait_cb,
-				  30,
-				  100, /* ms */
+				  3000, /* ms */
 				  &helper,
 				  error)) {
 		g_prefix_error(error, "remote command failed: ");
@@ -10,10 +10,53 @@
 
 struct _FuTestPlugin {
 	FuPlugin parent_instance;
+	gint64 startup_begin; /* µs */
+	gint64 startup_end;   /* µs */
 };
 
 G_DEFINE_TYPE(FuTestPlugin, fu_test_plugin, FU_TYPE_PLUGIN)
 
+/* for the self tests only */
+gint64
+fu_test_plugin_get_startup_begin(FuTestPlugin *self)
+{
+	g_return_val_if_fail(FU_IS_TEST_PLUGIN(self), 0);
+	return self->startup_begin;
+}
+
+/* for the self tests only */
+gint64
+fu_test_plugin_get_startup_end(FuTestPlugin *self)
+{
+	g_return_val_if_fail(FU_IS_TEST_PLUGIN(self), 0);
+	return self->startup_end;
+}
+
+static gboolean
+fu_test_plugin_startup(FuPlugin *plugin, FuProgress *progress, GError **error)
+{
+	FuTestPlugin *self = FU_TEST_PLUGIN(plugin);
+	guint64 delay_startup_ms = 0;
+	g_autofree gchar *startup_delay_str = NULL;
+
+	self->startup_begin = g_get_monotonic_time();
+	startup_delay_str = fu_plugin_get_config_value(plugin, "StartupDelay");
+	if (startup_delay_str != NULL) {
+		if (!fu_strtoull(startup_delay_str,
+				 &delay_startup_ms,
+				 0,
+				 10000,
+				 FU_INTEGER_BASE_AUTO,
+				 error)) {
+			g_prefix_error(error, "failed to parse StartupDelay: ");
+			return FALSE;
+		}
+	}
+	g_usleep(delay_startup_ms * 1000);
+	self->startup_end = g_get_monotonic_time();
+	return TRUE;
+}
+
 static gboolean
 fu_test_plugin_coldplug(FuPlugin *plugin, FuProgress *progress, GError **error)
 {
@@ -99,6 +142,8 @@ fu_test_plugin_modify_config(FuPlugin *plugin, const gchar *key, const gchar *va
 			       "RegistrationSupported",
 			       "RequestDelay",
 			       "RequestSupported",
+			       "SecurityAttrs",
+			       "StartupDelay",
 			       "VerifyDelay",
 			       "WriteDelay",
 			       "WriteSupported",
@@ -120,6 +165,18 @@ fu_test_plugin_device_registered(FuPlugin *plugin, FuDevice *device)
 	fu_device_set_metadata(device, "BestDevice", "/dev/urandom");
 }
 
+static void
+fu_test_plugin_add_security_attrs(FuPlugin *plugin, FuSecurityAttrs *attrs)
+{
+	g_autoptr(FwupdSecurityAttr) attr = NULL;
+
+	if (!fu_plugin_get_config_value_boolean(plugin, "SecurityAttrs"))
+		return;
+	attr = fu_plugin_security_attr_new(plugin, FWUPD_SECURITY_ATTR_ID_ENCRYPTED_RAM);
+	fwupd_security_attr_set_result_success(attr, FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+	fu_security_attrs_append(attrs, attr);
+}
+
 static gboolean
 fu_test_plugin_verify(FuPlugin *plugin,
 		      FuDevice *device,
@@ -395,6 +452,8 @@ fu_test_plugin_constructed(GObject *obj)
 	fu_plugin_set_config_default(plugin, "RegistrationSupported", "false");
 	fu_plugin_set_config_default(plugin, "RequestDelay", "10"); /* ms */
 	fu_plugin_set_config_default(plugin, "RequestSupported", "false");
+	fu_plugin_set_config_default(plugin, "SecurityAttrs", "false");
+	fu_plugin_set_config_default(plugin, "StartupDelay", "0"); /* ms */
 	fu_plugin_set_config_default(plugin, "VerifyDelay", "0");
 	fu_plugin_set_config_default(plugin, "WriteDelay", "0");
 	fu_plugin_set_config_default(plugin, "WriteSupported", "true");
@@ -421,7 +480,9 @@ fu_test_plugin_class_init(FuTestPluginClass *klass)
 	plugin_class->activate = fu_test_plugin_activate;
 	plugin_class->write_firmware = fu_test_plugin_write_firmware;
 	plugin_class->verify = fu_test_plugin_verify;
+	plugin_class->startup = fu_test_plugin_startup;
 	plugin_class->coldplug = fu_test_plugin_coldplug;
 	plugin_class->device_registered = fu_test_plugin_device_registered;
+	plugin_class->add_security_attrs = fu_test_plugin_add_security_attrs;
 	plugin_class->modify_config = fu_test_plugin_modify_config;
 }
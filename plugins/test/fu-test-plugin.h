@@ -9,3 +9,8 @@
 #include <fwupdplugin.h>
 
 G_DECLARE_FINAL_TYPE(FuTestPlugin, fu_test_plugin, FU, TEST_PLUGIN, FuPlugin)
+
+gint64
+fu_test_plugin_get_startup_begin(FuTestPlugin *self);
+gint64
+fu_test_plugin_get_startup_end(FuTestPlugin *self);
@@ -162,11 +162,14 @@ fu_tpm_eventlog_parse_v2_func(void)
 	const gchar *tmp;
 	gboolean ret;
 	gsize bufsz = 0;
+	FuTpmEventlogReplay replay;
 	g_autofree gchar *fn = NULL;
 	g_autofree guint8 *buf = NULL;
 	g_autoptr(GPtrArray) items = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) pcr0s = NULL;
+	g_autoptr(GPtrArray) pcr0s_replay = NULL;
+	g_autoptr(GPtrArray) items_half = NULL;
 
 	fn = g_test_build_filename(G_TEST_DIST, "tests", "binary_bios_measurements-v2", NULL);
 	if (!g_file_test(fn, G_FILE_TEST_EXISTS) && ci == NULL) {
@@ -191,6 +194,22 @@ fu_tpm_eventlog_parse_v2_func(void)
 	g_assert_cmpstr(tmp,
 			==,
 			"6d9fed68092cfb91c9552bcb7879e75e1df36efd407af67690dc3389a5722fab");
+
+	/* replaying in two steps gives the same result */
+	items_half = g_ptr_array_new();
+	for (guint i = 0; i < items->len / 2; i++)
+		g_ptr_array_add(items_half, g_ptr_array_index(items, i));
+	fu_tpm_eventlog_replay_init(&replay, 0);
+	fu_tpm_eventlog_replay_update(&replay, items_half);
+	fu_tpm_eventlog_replay_update(&replay, items);
+	fu_tpm_eventlog_replay_update(&replay, items);
+	g_assert_cmpint(replay.items_cnt, ==, items->len);
+	pcr0s_replay = fu_tpm_eventlog_replay_get_checksums(&replay, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(pcr0s_replay);
+	g_assert_cmpint(pcr0s_replay->len, ==, 2);
+	g_assert_cmpstr(g_ptr_array_index(pcr0s_replay, 0), ==, g_ptr_array_index(pcr0s, 0));
+	g_assert_cmpstr(g_ptr_array_index(pcr0s_replay, 1), ==, g_ptr_array_index(pcr0s, 1));
 }
 
 static void
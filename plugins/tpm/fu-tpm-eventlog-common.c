@@ -6,6 +6,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-tpm-eventlog-common.h"
 
 const gchar *
@@ -75,34 +77,37 @@ fu_tpm_eventlog_blobstr(GBytes *blob)
 			       g_bytes_get_size(blob));
 }
 
-GPtrArray *
-fu_tpm_eventlog_calc_checksums(GPtrArray *items, guint8 pcr, GError **error)
+void
+fu_tpm_eventlog_replay_init(FuTpmEventlogReplay *self, guint8 pcr)
 {
-	guint cnt_sha1 = 0;
-	guint cnt_sha256 = 0;
-	guint cnt_sha384 = 0;
-	guint8 digest_sha1[TPM2_SHA1_DIGEST_SIZE] = {0x0};
-	guint8 digest_sha256[TPM2_SHA256_DIGEST_SIZE] = {0x0};
-	guint8 digest_sha384[TPM2_SHA384_DIGEST_SIZE] = {0x0};
-	gsize digest_sha1_len = sizeof(digest_sha1);
-	gsize digest_sha256_len = sizeof(digest_sha256);
-	gsize digest_sha384_len = sizeof(digest_sha384);
-	g_autoptr(GPtrArray) csums = g_ptr_array_new_with_free_func(g_free);
+	memset(self, 0x0, sizeof(*self));
+	self->pcr = pcr;
+}
 
-	/* sanity check */
-	if (items->len == 0) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_DATA,
-				    "no event log data");
-		return NULL;
-	}
+static void
+fu_tpm_eventlog_replay_extend(GChecksumType csum_kind,
+			      guint8 *digest,
+			      gsize digestsz,
+			      GBytes *measurement)
+{
+	gsize digest_len = digestsz;
+	g_autoptr(GChecksum) csum = g_checksum_new(csum_kind);
+	g_checksum_update(csum, (const guchar *)digest, digestsz);
+	g_checksum_update(csum,
+			  (const guchar *)g_bytes_get_data(measurement, NULL),
+			  g_bytes_get_size(measurement));
+	g_checksum_get_digest(csum, digest, &digest_len);
+}
 
+/* only the items added since the last call are replayed */
+void
+fu_tpm_eventlog_replay_update(FuTpmEventlogReplay *self, GPtrArray *items)
+{
 	/* take existing PCR hash, append new measurement to that,
 	 * hash that with the same algorithm */
-	for (guint i = 0; i < items->len; i++) {
+	for (guint i = self->items_cnt; i < items->len; i++) {
 		FuTpmEventlogItem *item = g_ptr_array_index(items, i);
-		if (item->pcr != pcr)
+		if (item->pcr != self->pcr)
 			continue;
 
 		/* if TXT is enabled then the first event for PCR0 should be a StartupLocality */
@@ -115,69 +120,81 @@ fu_tpm_eventlog_calc_checksums(GPtrArray *items, guint8 pcr, GError **error)
 			if (st_loc != NULL) {
 				guint8 locality =
 				    fu_struct_tpm_efi_startup_locality_event_get_locality(st_loc);
-				digest_sha384[TPM2_SHA384_DIGEST_SIZE - 1] = locality;
-				digest_sha256[TPM2_SHA256_DIGEST_SIZE - 1] = locality;
-				digest_sha1[TPM2_SHA1_DIGEST_SIZE - 1] = locality;
+				self->digest_sha384[TPM2_SHA384_DIGEST_SIZE - 1] = locality;
+				self->digest_sha256[TPM2_SHA256_DIGEST_SIZE - 1] = locality;
+				self->digest_sha1[TPM2_SHA1_DIGEST_SIZE - 1] = locality;
 				continue;
 			}
 		}
 
 		if (item->checksum_sha1 != NULL) {
-			g_autoptr(GChecksum) csum_sha1 = g_checksum_new(G_CHECKSUM_SHA1);
-			g_checksum_update(csum_sha1, (const guchar *)digest_sha1, digest_sha1_len);
-			g_checksum_update(
-			    csum_sha1,
-			    (const guchar *)g_bytes_get_data(item->checksum_sha1, NULL),
-			    g_bytes_get_size(item->checksum_sha1));
-			g_checksum_get_digest(csum_sha1, digest_sha1, &digest_sha1_len);
-			cnt_sha1++;
+			fu_tpm_eventlog_replay_extend(G_CHECKSUM_SHA1,
+						      self->digest_sha1,
+						      sizeof(self->digest_sha1),
+						      item->checksum_sha1);
+			self->cnt_sha1++;
 		}
 		if (item->checksum_sha256 != NULL) {
-			g_autoptr(GChecksum) csum_sha256 = g_checksum_new(G_CHECKSUM_SHA256);
-			g_checksum_update(csum_sha256,
-					  (const guchar *)digest_sha256,
-					  digest_sha256_len);
-			g_checksum_update(
-			    csum_sha256,
-			    (const guchar *)g_bytes_get_data(item->checksum_sha256, NULL),
-			    g_bytes_get_size(item->checksum_sha256));
-			g_checksum_get_digest(csum_sha256, digest_sha256, &digest_sha256_len);
-			cnt_sha256++;
+			fu_tpm_eventlog_replay_extend(G_CHECKSUM_SHA256,
+						      self->digest_sha256,
+						      sizeof(self->digest_sha256),
+						      item->checksum_sha256);
+			self->cnt_sha256++;
 		}
 		if (item->checksum_sha384 != NULL) {
-			g_autoptr(GChecksum) csum_sha384 = g_checksum_new(G_CHECKSUM_SHA384);
-			g_checksum_update(csum_sha384,
-					  (const guchar *)digest_sha384,
-					  digest_sha384_len);
-			g_checksum_update(
-			    csum_sha384,
-			    (const guchar *)g_bytes_get_data(item->checksum_sha384, NULL),
-			    g_bytes_get_size(item->checksum_sha384));
-			g_checksum_get_digest(csum_sha384, digest_sha384, &digest_sha384_len);
-			cnt_sha384++;
+			fu_tpm_eventlog_replay_extend(G_CHECKSUM_SHA384,
+						      self->digest_sha384,
+						      sizeof(self->digest_sha384),
+						      item->checksum_sha384);
+			self->cnt_sha384++;
 		}
 	}
-	if (cnt_sha1 == 0 && cnt_sha256 == 0 && cnt_sha384 == 0) {
+	self->items_cnt = MAX(self->items_cnt, items->len);
+}
+
+GPtrArray *
+fu_tpm_eventlog_replay_get_checksums(FuTpmEventlogReplay *self, GError **error)
+{
+	g_autoptr(GPtrArray) csums = g_ptr_array_new_with_free_func(g_free);
+
+	/* sanity check */
+	if (self->items_cnt == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "no event log data");
+		return NULL;
+	}
+	if (self->cnt_sha1 == 0 && self->cnt_sha256 == 0 && self->cnt_sha384 == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_DATA,
 				    "no SHA1, SHA256, or SHA384 data");
 		return NULL;
 	}
-	if (cnt_sha1 > 0) {
+	if (self->cnt_sha1 > 0) {
 		g_autoptr(GBytes) blob_sha1 = NULL;
-		blob_sha1 = g_bytes_new_static(digest_sha1, sizeof(digest_sha1));
+		blob_sha1 = g_bytes_new_static(self->digest_sha1, sizeof(self->digest_sha1));
 		g_ptr_array_add(csums, fu_tpm_eventlog_strhex(blob_sha1));
 	}
-	if (cnt_sha256 > 0) {
+	if (self->cnt_sha256 > 0) {
 		g_autoptr(GBytes) blob_sha256 = NULL;
-		blob_sha256 = g_bytes_new_static(digest_sha256, sizeof(digest_sha256));
+		blob_sha256 = g_bytes_new_static(self->digest_sha256, sizeof(self->digest_sha256));
 		g_ptr_array_add(csums, fu_tpm_eventlog_strhex(blob_sha256));
 	}
-	if (cnt_sha384 > 0) {
+	if (self->cnt_sha384 > 0) {
 		g_autoptr(GBytes) blob_sha384 = NULL;
-		blob_sha384 = g_bytes_new_static(digest_sha384, sizeof(digest_sha384));
+		blob_sha384 = g_bytes_new_static(self->digest_sha384, sizeof(self->digest_sha384));
 		g_ptr_array_add(csums, fu_tpm_eventlog_strhex(blob_sha384));
 	}
 	return g_steal_pointer(&csums);
 }
+
+GPtrArray *
+fu_tpm_eventlog_calc_checksums(GPtrArray *items, guint8 pcr, GError **error)
+{
+	FuTpmEventlogReplay replay;
+	fu_tpm_eventlog_replay_init(&replay, pcr);
+	fu_tpm_eventlog_replay_update(&replay, items);
+	return fu_tpm_eventlog_replay_get_checksums(&replay, error);
+}
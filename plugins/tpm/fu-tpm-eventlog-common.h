@@ -21,6 +21,17 @@ typedef struct {
 	GBytes *blob;
 } FuTpmEventlogItem;
 
+typedef struct {
+	guint8 pcr;
+	guint items_cnt; /* already replayed */
+	guint cnt_sha1;
+	guint cnt_sha256;
+	guint cnt_sha384;
+	guint8 digest_sha1[TPM2_SHA1_DIGEST_SIZE];
+	guint8 digest_sha256[TPM2_SHA256_DIGEST_SIZE];
+	guint8 digest_sha384[TPM2_SHA384_DIGEST_SIZE];
+} FuTpmEventlogReplay;
+
 const gchar *
 fu_tpm_eventlog_pcr_to_string(gint pcr);
 guint32
@@ -31,3 +42,9 @@ gchar *
 fu_tpm_eventlog_blobstr(GBytes *blob);
 GPtrArray *
 fu_tpm_eventlog_calc_checksums(GPtrArray *items, guint8 pcr, GError **error);
+void
+fu_tpm_eventlog_replay_init(FuTpmEventlogReplay *self, guint8 pcr);
+void
+fu_tpm_eventlog_replay_update(FuTpmEventlogReplay *self, GPtrArray *items);
+GPtrArray *
+fu_tpm_eventlog_replay_get_checksums(FuTpmEventlogReplay *self, GError **error);
@@ -16,10 +16,19 @@ struct _FuTpmPlugin {
 	FuTpmDevice *tpm_device;
 	FuDevice *bios_device;
 	GPtrArray *ev_items; /* of FuTpmEventlogItem */
+	FuTpmEventlogReplay ev_replay;
 };
 
 G_DEFINE_TYPE(FuTpmPlugin, fu_tpm_plugin, FU_TYPE_PLUGIN)
 
+/* the pre-OS log does not change after boot, so only replay items not yet seen */
+static GPtrArray *
+fu_tpm_plugin_eventlog_pcr0_checksums(FuTpmPlugin *self, GError **error)
+{
+	fu_tpm_eventlog_replay_update(&self->ev_replay, self->ev_items);
+	return fu_tpm_eventlog_replay_get_checksums(&self->ev_replay, error);
+}
+
 static void
 fu_tpm_plugin_to_string(FuPlugin *plugin, guint idt, GString *str)
 {
@@ -157,7 +166,7 @@ fu_tpm_plugin_add_security_attr_eventlog(FuPlugin *plugin, FuSecurityAttrs *attr
 	}
 
 	/* calculate from the eventlog */
-	pcr0s_calc = fu_tpm_eventlog_calc_checksums(self->ev_items, 0, &error);
+	pcr0s_calc = fu_tpm_plugin_eventlog_pcr0_checksums(self, &error);
 	if (pcr0s_calc == NULL) {
 		g_warning("failed to get eventlog reconstruction: %s", error->message);
 		fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_NOT_VALID);
@@ -276,7 +285,7 @@ fu_tpm_plugin_eventlog_report_metadata(FuPlugin *plugin)
 			g_string_append_printf(str, " [%s]", blobstr);
 		g_string_append(str, "\n");
 	}
-	pcrs = fu_tpm_eventlog_calc_checksums(self->ev_items, 0, NULL);
+	pcrs = fu_tpm_plugin_eventlog_pcr0_checksums(self, NULL);
 	if (pcrs != NULL) {
 		for (guint j = 0; j < pcrs->len; j++) {
 			const gchar *csum = g_ptr_array_index(pcrs, j);
@@ -323,6 +332,7 @@ fu_tpm_plugin_coldplug_eventlog(FuPlugin *plugin, GError **error)
 	    fu_tpm_eventlog_parser_new(buf, bufsz, FU_TPM_EVENTLOG_PARSER_FLAG_NONE, error);
 	if (self->ev_items == NULL)
 		return FALSE;
+	fu_tpm_eventlog_replay_init(&self->ev_replay, 0);
 
 	/* add optional report metadata */
 	str = fu_tpm_plugin_eventlog_report_metadata(plugin);
@@ -378,6 +388,7 @@ fu_tpm_plugin_constructed(GObject *obj)
 
 	/* old name */
 	fu_plugin_add_rule(plugin, FU_PLUGIN_RULE_CONFLICTS, "tpm_eventlog");
+	fu_plugin_set_thread_safe(plugin, TRUE);
 	fu_plugin_add_device_udev_subsystem(plugin, "tpm");
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_TPM_V2_DEVICE);
 }
@@ -0,0 +1,720 @@
+/*
+ * Copyright 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuBenchmark"
+
+#include "config.h"
+
+#include <fwupdplugin.h>
+
+#include <json-glib/json-glib.h>
+#include <stdlib.h>
+#ifdef HAVE_MALLOC_H
+#include <malloc.h>
+#endif
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#endif
+
+#include "../plugins/test/fu-test-plugin.h"
+#include "fu-context-private.h"
+#include "fu-engine.h"
+
+typedef struct {
+	guint iterations;
+	gsize size;
+	GBytes *blob;
+	GBytes *firmware; /* (nullable) */
+	FuEngine *engine; /* (nullable) */
+	FuDevice *device; /* (nullable) */
+	gboolean profile;
+	gchar *traceback; /* (nullable) */
+	GPtrArray *results; /* of FuBenchmarkResult */
+} FuBenchmarkPrivate;
+
+typedef struct {
+	gchar *id;
+	guint iterations;
+	gsize bytes;
+	gint64 wall_us;
+	gint64 user_us;
+	gint64 sys_us;
+	gint64 minflt;
+	gint64 nvcsw;
+	gint64 nivcsw;
+	gint64 maxrss_kb;
+	gint64 heap_delta;
+	gchar *traceback;
+} FuBenchmarkResult;
+
+typedef struct {
+	gint64 wall_us;
+#ifdef HAVE_GETRUSAGE
+	struct rusage usage;
+#endif
+#ifdef HAVE_MALLINFO2
+	gsize heap_used;
+#endif
+} FuBenchmarkSample;
+
+typedef gboolean (*FuBenchmarkFunc)(FuBenchmarkPrivate *priv, GError **error);
+
+static void
+fu_benchmark_result_free(FuBenchmarkResult *result)
+{
+	g_free(result->id);
+	g_free(result->traceback);
+	g_free(result);
+}
+
+static void
+fu_benchmark_private_free(FuBenchmarkPrivate *priv)
+{
+	if (priv->blob != NULL)
+		g_bytes_unref(priv->blob);
+	if (priv->firmware != NULL)
+		g_bytes_unref(priv->firmware);
+	if (priv->device != NULL)
+		g_object_unref(priv->device);
+	if (priv->engine != NULL)
+		g_object_unref(priv->engine);
+	g_free(priv->traceback);
+	g_ptr_array_unref(priv->results);
+	g_free(priv);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuBenchmarkPrivate, fu_benchmark_private_free)
+
+static void
+fu_benchmark_sample(FuBenchmarkSample *sample)
+{
+	sample->wall_us = g_get_monotonic_time();
+#ifdef HAVE_GETRUSAGE
+	getrusage(RUSAGE_SELF, &sample->usage);
+#endif
+#ifdef HAVE_MALLINFO2
+	sample->heap_used = mallinfo2().uordblks;
+#endif
+}
+
+#ifdef HAVE_GETRUSAGE
+static gint64
+fu_benchmark_timeval_to_us(const struct timeval *tv)
+{
+	return ((gint64)tv->tv_sec * G_USEC_PER_SEC) + tv->tv_usec;
+}
+#endif
+
+static FuBenchmarkResult *
+fu_benchmark_result_new(const gchar *id,
+			guint iterations,
+			gsize bytes,
+			const FuBenchmarkSample *before,
+			const FuBenchmarkSample *after)
+{
+	FuBenchmarkResult *result = g_new0(FuBenchmarkResult, 1);
+	result->id = g_strdup(id);
+	result->iterations = iterations;
+	result->bytes = bytes;
+	result->wall_us = after->wall_us - before->wall_us;
+#ifdef HAVE_GETRUSAGE
+	result->user_us = fu_benchmark_timeval_to_us(&after->usage.ru_utime) -
+			  fu_benchmark_timeval_to_us(&before->usage.ru_utime);
+	result->sys_us = fu_benchmark_timeval_to_us(&after->usage.ru_stime) -
+			 fu_benchmark_timeval_to_us(&before->usage.ru_stime);
+	result->minflt = after->usage.ru_minflt - before->usage.ru_minflt;
+	result->nvcsw = after->usage.ru_nvcsw - before->usage.ru_nvcsw;
+	result->nivcsw = after->usage.ru_nivcsw - before->usage.ru_nivcsw;
+	result->maxrss_kb = after->usage.ru_maxrss;
+#endif
+#ifdef HAVE_MALLINFO2
+	result->heap_delta = (gint64)after->heap_used - (gint64)before->heap_used;
+#endif
+	return result;
+}
+
+static gdouble
+fu_benchmark_result_get_throughput(FuBenchmarkResult *result)
+{
+	if (result->bytes == 0 || result->wall_us == 0)
+		return 0.f;
+	return ((gdouble)result->bytes / (1024.f * 1024.f)) /
+	       ((gdouble)result->wall_us / G_USEC_PER_SEC);
+}
+
+static gboolean
+fu_benchmark_run(FuBenchmarkPrivate *priv, const gchar *id, FuBenchmarkFunc func, GError **error)
+{
+	FuBenchmarkSample before = {0};
+	FuBenchmarkSample after = {0};
+	FuBenchmarkResult *result;
+	g_autoptr(GError) error_local = NULL;
+
+	/* warm up, which also checks the stage actually works */
+	if (!func(priv, &error_local)) {
+		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+			g_info("skipping %s: %s", id, error_local->message);
+			return TRUE;
+		}
+		g_propagate_prefixed_error(error, g_steal_pointer(&error_local), "%s: ", id);
+		return FALSE;
+	}
+
+	fu_benchmark_sample(&before);
+	for (guint i = 0; i < priv->iterations; i++) {
+		if (!func(priv, error)) {
+			g_prefix_error(error, "%s: ", id);
+			return FALSE;
+		}
+	}
+	fu_benchmark_sample(&after);
+	result = fu_benchmark_result_new(id,
+					 priv->iterations,
+					 priv->size * priv->iterations,
+					 &before,
+					 &after);
+	g_ptr_array_add(priv->results, result);
+
+	/* profiling makes FuProgress slow, so get the time of each step from an extra run */
+	priv->profile = TRUE;
+	if (!func(priv, error)) {
+		g_prefix_error(error, "%s: ", id);
+		return FALSE;
+	}
+	priv->profile = FALSE;
+	result->traceback = g_steal_pointer(&priv->traceback);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_crc32(FuBenchmarkPrivate *priv, GError **error)
+{
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(priv->blob, &bufsz);
+	volatile guint32 value = fu_crc32(FU_CRC_KIND_B32_STANDARD, buf, bufsz);
+	(void)value;
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum8(FuBenchmarkPrivate *priv, GError **error)
+{
+	volatile guint8 value = fu_sum8_bytes(priv->blob);
+	(void)value;
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum16(FuBenchmarkPrivate *priv, GError **error)
+{
+	volatile guint16 value = fu_sum16_bytes(priv->blob);
+	(void)value;
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum32(FuBenchmarkPrivate *priv, GError **error)
+{
+	volatile guint32 value = fu_sum32_bytes(priv->blob);
+	(void)value;
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_memmem(FuBenchmarkPrivate *priv, GError **error)
+{
+	gsize bufsz = 0;
+	gsize offset = 0;
+	const guint8 *buf = g_bytes_get_data(priv->blob, &bufsz);
+
+	/* worst case: the needle is right at the end of the haystack */
+	return fu_memmem_safe(buf, bufsz, buf + bufsz - 16, 16, &offset, error);
+}
+
+static gboolean
+fu_benchmark_chunk_array(FuBenchmarkPrivate *priv, GError **error)
+{
+	g_autoptr(FuChunkArray) chunks = fu_chunk_array_new_from_bytes(priv->blob, 0x0, 64);
+
+	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+		g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, i, error);
+		if (chk == NULL)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_chunkify_cb(const guint8 *buf, gsize bufsz, gpointer user_data, GError **error)
+{
+	guint32 *value = (guint32 *)user_data;
+	*value += fu_sum32(buf, bufsz);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_chunkify(FuBenchmarkPrivate *priv, GError **error)
+{
+	guint32 value = 0;
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(priv->blob);
+	return fu_input_stream_chunkify(stream, fu_benchmark_chunkify_cb, &value, error);
+}
+
+static gboolean
+fu_benchmark_find_all(FuBenchmarkPrivate *priv, GError **error)
+{
+	const gchar *signatures[] = {"__FMAP__", "$IFD", "_FVH", "$CPD"};
+	g_autoptr(GArray) matches = NULL;
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(priv->blob);
+	g_autoptr(GPtrArray) needles =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+
+	for (guint i = 0; i < G_N_ELEMENTS(signatures); i++)
+		g_ptr_array_add(needles, g_bytes_new_static(signatures[i], strlen(signatures[i])));
+	matches = fu_input_stream_find_all(stream, needles, 0x1000, error);
+	return matches != NULL;
+}
+
+static gboolean
+fu_benchmark_firmware_write(FuBenchmarkPrivate *priv, GError **error)
+{
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(GBytes) blob = NULL;
+
+	/* split the payload into a few images like a typical container */
+	for (guint i = 0; i < 4; i++) {
+		gsize chunksz = priv->size / 4;
+		g_autoptr(FuFirmware) img = fu_firmware_new();
+		g_autoptr(GBytes) img_blob = NULL;
+
+		img_blob = g_bytes_new_from_bytes(priv->blob, i * chunksz, chunksz);
+		fu_firmware_set_idx(img, i);
+		fu_firmware_set_bytes(img, img_blob);
+		fu_firmware_add_image(firmware, img);
+	}
+	blob = fu_firmware_write(firmware, error);
+	return blob != NULL;
+}
+
+static gboolean
+fu_benchmark_firmware_roundtrip(FuBenchmarkPrivate *priv,
+				FuFirmware *firmware,
+				FuFirmware *firmware_new,
+				GError **error)
+{
+	g_autoptr(GBytes) blob = NULL;
+
+	fu_firmware_set_bytes(firmware, priv->blob);
+	blob = fu_firmware_write(firmware, error);
+	if (blob == NULL)
+		return FALSE;
+	return fu_firmware_parse_bytes(firmware_new,
+				       blob,
+				       0x0,
+				       FWUPD_INSTALL_FLAG_NO_SEARCH,
+				       error);
+}
+
+static gboolean
+fu_benchmark_ihex(FuBenchmarkPrivate *priv, GError **error)
+{
+	g_autoptr(FuFirmware) firmware = fu_ihex_firmware_new();
+	g_autoptr(FuFirmware) firmware_new = fu_ihex_firmware_new();
+	return fu_benchmark_firmware_roundtrip(priv, firmware, firmware_new, error);
+}
+
+static gboolean
+fu_benchmark_srec(FuBenchmarkPrivate *priv, GError **error)
+{
+	g_autoptr(FuFirmware) firmware = fu_srec_firmware_new();
+	g_autoptr(FuFirmware) firmware_new = fu_srec_firmware_new();
+
+	/* use S3 records so payloads larger than 64KiB do not wrap */
+	fu_firmware_set_addr(firmware, 0x1000000);
+	return fu_benchmark_firmware_roundtrip(priv, firmware, firmware_new, error);
+}
+
+static gboolean
+fu_benchmark_engine_install_setup(FuBenchmarkPrivate *priv, GError **error)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new(ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	/* the test plugin only reads the payload, so this mostly measures the engine */
+	fu_engine_add_plugin(engine, plugin);
+	if (!fu_engine_load(engine,
+			    FU_ENGINE_LOAD_FLAG_READONLY | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				FU_ENGINE_LOAD_FLAG_NO_IDLE_SOURCES,
+			    progress,
+			    error))
+		return FALSE;
+	if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "test plugin is disabled, set TestDevices=true");
+		return FALSE;
+	}
+
+	/* add a device that is handled by the test plugin */
+	fu_device_set_id(device, "benchmark_device");
+	fu_device_set_name(device, "Benchmark Device");
+	fu_device_set_plugin(device, "test");
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.2");
+	fu_device_build_vendor_id_u16(device, "USB", 0xFFFF);
+	fu_device_add_protocol(device, "com.acme");
+	fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+	fu_engine_add_device(engine, device);
+
+	/* success */
+	priv->engine = g_steal_pointer(&engine);
+	priv->device = g_steal_pointer(&device);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_install_blob(FuBenchmarkPrivate *priv,
+			  FuEngine *engine,
+			  FuDevice *device,
+			  GBytes *blob,
+			  GError **error)
+{
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+
+	fu_progress_set_profile(progress, priv->profile);
+	if (!fu_engine_install_blob(engine,
+				    device,
+				    stream,
+				    progress,
+				    FWUPD_INSTALL_FLAG_NO_HISTORY,
+				    FWUPD_FEATURE_FLAG_REQUESTS |
+					FWUPD_FEATURE_FLAG_REQUESTS_NON_GENERIC,
+				    error))
+		return FALSE;
+
+	/* the prepare, detach, write, attach and cleanup times */
+	if (priv->profile) {
+		g_free(priv->traceback);
+		priv->traceback = fu_progress_traceback(progress);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_engine_install(FuBenchmarkPrivate *priv, GError **error)
+{
+	/* set up the first time, which is not measured */
+	if (priv->engine == NULL) {
+		if (!fu_benchmark_engine_install_setup(priv, error))
+			return FALSE;
+	}
+	return fu_benchmark_install_blob(priv, priv->engine, priv->device, priv->blob, error);
+}
+
+/* replay the archive, which re-adds every recorded device, and then replay the recorded install
+ * phases by writing the firmware to each updatable device */
+static gboolean
+fu_benchmark_emulation_replay(FuBenchmarkPrivate *priv,
+			      FuEngine *engine,
+			      GInputStream *stream,
+			      gsize *bytes,
+			      GError **error)
+{
+	gsize streamsz = 0;
+	g_autoptr(GPtrArray) devices = NULL;
+
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return FALSE;
+	if (!fu_engine_emulation_load(engine, stream, error))
+		return FALSE;
+	*bytes += streamsz;
+	if (priv->firmware == NULL)
+		return TRUE;
+	devices = fu_engine_get_devices(engine, error);
+	if (devices == NULL)
+		return FALSE;
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED) ||
+		    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE))
+			continue;
+		if (!fu_benchmark_install_blob(priv, engine, device, priv->firmware, error)) {
+			g_prefix_error(error, "%s: ", fu_device_get_id(device));
+			return FALSE;
+		}
+		*bytes += g_bytes_get_size(priv->firmware);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_emulation(FuBenchmarkPrivate *priv, const gchar *filename, GError **error)
+{
+	FuBenchmarkSample before = {0};
+	FuBenchmarkSample after = {0};
+	FuBenchmarkResult *result;
+	gsize bytes = 0;
+	gsize bytes_profile = 0;
+	g_autofree gchar *basename = g_path_get_basename(filename);
+	g_autofree gchar *id = g_strdup_printf("emulation:%s", basename);
+	g_autofree gchar *traceback_load = NULL;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuEngine) engine = fu_engine_new(ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GString) traceback = g_string_new(NULL);
+
+	/* load the engine without touching the real hardware */
+	fu_progress_set_profile(progress, TRUE);
+	if (!fu_engine_load(engine,
+			    FU_ENGINE_LOAD_FLAG_READONLY | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				FU_ENGINE_LOAD_FLAG_NO_IDLE_SOURCES |
+				FU_ENGINE_LOAD_FLAG_BUILTIN_PLUGINS,
+			    progress,
+			    error))
+		return FALSE;
+	stream = fu_input_stream_from_path(filename, error);
+	if (stream == NULL)
+		return FALSE;
+
+	fu_benchmark_sample(&before);
+	for (guint i = 0; i < priv->iterations; i++) {
+		if (!fu_benchmark_emulation_replay(priv, engine, stream, &bytes, error)) {
+			g_prefix_error(error, "%s: ", id);
+			return FALSE;
+		}
+	}
+	fu_benchmark_sample(&after);
+	result = fu_benchmark_result_new(id, priv->iterations, bytes, &before, &after);
+	g_ptr_array_add(priv->results, result);
+
+	/* profiling makes FuProgress slow, so get the time of each step from an extra run */
+	priv->profile = TRUE;
+	if (!fu_benchmark_emulation_replay(priv, engine, stream, &bytes_profile, error)) {
+		g_prefix_error(error, "%s: ", id);
+		return FALSE;
+	}
+	priv->profile = FALSE;
+	traceback_load = fu_progress_traceback(progress);
+	if (traceback_load != NULL)
+		g_string_append(traceback, traceback_load);
+	if (priv->traceback != NULL) {
+		g_string_append(traceback, priv->traceback);
+		g_clear_pointer(&priv->traceback, g_free);
+	}
+	if (traceback->len > 0)
+		result->traceback = g_string_free(g_steal_pointer(&traceback), FALSE);
+	return TRUE;
+}
+
+static void
+fu_benchmark_print_text(FuBenchmarkPrivate *priv)
+{
+	g_print("%-32s %10s %10s %10s %10s %10s %12s\n",
+		"Stage",
+		"MB/s",
+		"Wall/ms",
+		"User/ms",
+		"Sys/ms",
+		"MinFlt",
+		"HeapDelta");
+	for (guint i = 0; i < priv->results->len; i++) {
+		FuBenchmarkResult *result = g_ptr_array_index(priv->results, i);
+		g_print("%-32s %10.1f %10.2f %10.2f %10.2f %10" G_GINT64_FORMAT
+			" %12" G_GINT64_FORMAT "\n",
+			result->id,
+			fu_benchmark_result_get_throughput(result),
+			(gdouble)result->wall_us / 1000.f,
+			(gdouble)result->user_us / 1000.f,
+			(gdouble)result->sys_us / 1000.f,
+			result->minflt,
+			result->heap_delta);
+	}
+	for (guint i = 0; i < priv->results->len; i++) {
+		FuBenchmarkResult *result = g_ptr_array_index(priv->results, i);
+		if (result->traceback != NULL)
+			g_print("\n%s steps:\n%s", result->id, result->traceback);
+	}
+}
+
+static gchar *
+fu_benchmark_to_json_string(FuBenchmarkPrivate *priv)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "Version");
+	json_builder_add_string_value(builder, PACKAGE_VERSION);
+	json_builder_set_member_name(builder, "Iterations");
+	json_builder_add_int_value(builder, priv->iterations);
+	json_builder_set_member_name(builder, "Size");
+	json_builder_add_int_value(builder, priv->size);
+	json_builder_set_member_name(builder, "Stages");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < priv->results->len; i++) {
+		FuBenchmarkResult *result = g_ptr_array_index(priv->results, i);
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "Id");
+		json_builder_add_string_value(builder, result->id);
+		json_builder_set_member_name(builder, "Iterations");
+		json_builder_add_int_value(builder, result->iterations);
+		json_builder_set_member_name(builder, "Bytes");
+		json_builder_add_int_value(builder, result->bytes);
+		json_builder_set_member_name(builder, "Throughput");
+		json_builder_add_double_value(builder, fu_benchmark_result_get_throughput(result));
+		json_builder_set_member_name(builder, "WallUs");
+		json_builder_add_int_value(builder, result->wall_us);
+		json_builder_set_member_name(builder, "UserUs");
+		json_builder_add_int_value(builder, result->user_us);
+		json_builder_set_member_name(builder, "SysUs");
+		json_builder_add_int_value(builder, result->sys_us);
+		json_builder_set_member_name(builder, "MinorFaults");
+		json_builder_add_int_value(builder, result->minflt);
+		json_builder_set_member_name(builder, "VoluntaryCtxSwitches");
+		json_builder_add_int_value(builder, result->nvcsw);
+		json_builder_set_member_name(builder, "InvoluntaryCtxSwitches");
+		json_builder_add_int_value(builder, result->nivcsw);
+		json_builder_set_member_name(builder, "MaxRssKb");
+		json_builder_add_int_value(builder, result->maxrss_kb);
+		json_builder_set_member_name(builder, "HeapDelta");
+		json_builder_add_int_value(builder, result->heap_delta);
+		if (result->traceback != NULL) {
+			json_builder_set_member_name(builder, "Traceback");
+			json_builder_add_string_value(builder, result->traceback);
+		}
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+
+	json_root = json_builder_get_root(builder);
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	return json_generator_to_data(json_generator, NULL);
+}
+
+int
+main(int argc, char **argv)
+{
+	gboolean as_json = FALSE;
+	gint iterations = 10;
+	g_autofree gchar *firmware = NULL;
+	gint size = 1024 * 1024;
+	g_autoptr(FuBenchmarkPrivate) priv = g_new0(FuBenchmarkPrivate, 1);
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOptionContext) context = g_option_context_new("[EMULATION-ARCHIVE…]");
+	const GOptionEntry options[] = {
+	    {"json",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_NONE,
+	     &as_json,
+	     "Output in JSON format",
+	     NULL},
+	    {"iterations",
+	     'n',
+	     0,
+	     G_OPTION_ARG_INT,
+	     &iterations,
+	     "Number of iterations for each stage",
+	     "COUNT"},
+	    {"size",
+	     's',
+	     0,
+	     G_OPTION_ARG_INT,
+	     &size,
+	     "Size of the synthetic payload in bytes",
+	     "BYTES"},
+	    {"firmware",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_FILENAME,
+	     &firmware,
+	     "Firmware to install on each emulated device",
+	     "FILENAME"},
+	    {NULL}};
+	struct {
+		const gchar *id;
+		FuBenchmarkFunc func;
+	} stages[] = {
+	    {"crc32", fu_benchmark_crc32},
+	    {"sum8", fu_benchmark_sum8},
+	    {"sum16", fu_benchmark_sum16},
+	    {"sum32", fu_benchmark_sum32},
+	    {"memmem", fu_benchmark_memmem},
+	    {"chunk-array", fu_benchmark_chunk_array},
+	    {"input-stream-chunkify", fu_benchmark_chunkify},
+	    {"input-stream-find-all", fu_benchmark_find_all},
+	    {"firmware-write", fu_benchmark_firmware_write},
+	    {"ihex-write-parse", fu_benchmark_ihex},
+	    {"srec-write-parse", fu_benchmark_srec},
+	    {"engine-install-blob", fu_benchmark_engine_install},
+	};
+
+	g_option_context_set_summary(context,
+				     "Measure firmware write pipeline throughput; any emulation "
+				     "archives are also replayed through the engine, installing "
+				     "the --firmware file on each emulated device");
+	g_option_context_add_main_entries(context, options, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("Failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	if (iterations <= 0 || size < 16) {
+		g_printerr("Invalid iterations or size\n");
+		return EXIT_FAILURE;
+	}
+
+	/* show the time of every step, not just the ones that take longer than 5s */
+	(void)g_setenv("FWUPD_PROFILE", "0", FALSE);
+
+	/* deterministic payload so runs are comparable */
+	priv->iterations = iterations;
+	priv->size = (gsize)size;
+	priv->results = g_ptr_array_new_with_free_func((GDestroyNotify)fu_benchmark_result_free);
+	for (gsize i = 0; i < priv->size; i++)
+		fu_byte_array_append_uint8(buf, (guint8)((i * 7) ^ (i >> 8)));
+	priv->blob = g_bytes_new(buf->data, buf->len);
+	if (firmware != NULL) {
+		priv->firmware = fu_bytes_get_contents(firmware, &error);
+		if (priv->firmware == NULL) {
+			g_printerr("Failed to load %s: %s\n", firmware, error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (guint i = 0; i < G_N_ELEMENTS(stages); i++) {
+		if (!fu_benchmark_run(priv, stages[i].id, stages[i].func, &error)) {
+			g_printerr("Failed to run benchmark: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+	}
+	for (gint i = 1; i < argc; i++) {
+		if (!fu_benchmark_emulation(priv, argv[i], &error)) {
+			g_printerr("Failed to replay %s: %s\n", argv[i], error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
+	/* success */
+	if (as_json) {
+		g_autofree gchar *str = fu_benchmark_to_json_string(priv);
+		g_print("%s\n", str);
+	} else {
+		fu_benchmark_print_text(priv);
+	}
+	return EXIT_SUCCESS;
+}
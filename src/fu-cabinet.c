@@ -98,21 +98,48 @@ fu_cabinet_add_file(FuCabinet *self, const gchar *basename, GBytes *data)
 	fu_firmware_add_image(FU_FIRMWARE(self), FU_FIRMWARE(img));
 }
 
-/* sets the firmware and signature blobs on XbNode */
+static gboolean
+fu_cabinet_decompress_image(FuCabinet *self, FuFirmware *img, GError **error)
+{
+	g_autoptr(GPtrArray) imgs = g_ptr_array_new();
+	g_ptr_array_add(imgs, img);
+	return fu_cab_firmware_decompress_images(FU_CAB_FIRMWARE(self), imgs, error);
+}
+
+/* gets the content checksum, and the filename it applies to */
+static XbNode *
+fu_cabinet_get_release_checksum(XbNode *release, const gchar **filename)
+{
+	g_autoptr(XbNode) artifact = NULL;
+	g_autoptr(XbNode) csum_tmp = NULL;
+
+	/* look for source artifact first */
+	artifact = xb_node_query_first(release, "artifacts/artifact[@type='source']", NULL);
+	if (artifact != NULL) {
+		*filename = xb_node_query_text(artifact, "filename", NULL);
+		csum_tmp = xb_node_query_first(artifact, "checksum[@type='sha256']", NULL);
+		if (csum_tmp == NULL)
+			csum_tmp = xb_node_query_first(artifact, "checksum", NULL);
+	} else {
+		csum_tmp = xb_node_query_first(release, "checksum[@target='content']", NULL);
+		if (csum_tmp != NULL)
+			*filename = xb_node_get_attr(csum_tmp, "filename");
+	}
+	return g_steal_pointer(&csum_tmp);
+}
+
+/* sets the firmware basename and size on XbNode, without reading the payload */
 static gboolean
 fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 {
 	const gchar *csum_filename = NULL;
-	gsize streamsz = 0;
+	gsize streamsz;
 	g_autofree gchar *basename = NULL;
 	g_autoptr(FuFirmware) img_blob = NULL;
-	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GError) error_local2 = NULL;
-	g_autoptr(XbNode) artifact = NULL;
 	g_autoptr(XbNode) csum_tmp = NULL;
 	g_autoptr(XbNode) metadata_trust = NULL;
 	g_autoptr(XbNode) nsize = NULL;
-	g_autoptr(JcatItem) item = NULL;
 	g_autoptr(GBytes) release_flags_blob = NULL;
 	g_autoptr(GBytes) filename_blob = NULL;
 	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
@@ -122,21 +149,9 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	if (metadata_trust != NULL)
 		release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_METADATA;
 
-	/* look for source artifact first */
-	artifact = xb_node_query_first(release, "artifacts/artifact[@type='source']", NULL);
-	if (artifact != NULL) {
-		csum_filename = xb_node_query_text(artifact, "filename", NULL);
-		csum_tmp = xb_node_query_first(artifact, "checksum[@type='sha256']", NULL);
-		if (csum_tmp == NULL)
-			csum_tmp = xb_node_query_first(artifact, "checksum", NULL);
-	} else {
-		csum_tmp = xb_node_query_first(release, "checksum[@target='content']", NULL);
-		if (csum_tmp != NULL)
-			csum_filename = xb_node_get_attr(csum_tmp, "filename");
-	}
-
 	/* if this isn't true, a firmware needs to set in the metainfo.xml file
 	 * something like: <checksum target="content" filename="FLASH.ROM"/> */
+	csum_tmp = fu_cabinet_get_release_checksum(release, &csum_filename);
 	if (csum_filename == NULL)
 		csum_filename = "firmware.bin";
 
@@ -155,11 +170,7 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	xb_node_set_data(release, "fwupd::FirmwareBasename", filename_blob);
 
 	/* set as metadata if unset, but error if specified and incorrect */
-	stream = fu_firmware_get_stream(img_blob, error);
-	if (stream == NULL)
-		return FALSE;
-	if (!fu_input_stream_size(stream, &streamsz, error))
-		return FALSE;
+	streamsz = fu_firmware_get_size(img_blob);
 	nsize = xb_node_query_first(release, "size[@type='installed']", NULL);
 	if (nsize != NULL) {
 		guint64 size = 0;
@@ -186,7 +197,86 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 		xb_node_set_data(release, "fwupd::ReleaseSize", blob_sz);
 	}
 
-	/* set if unspecified, but error out if specified and incorrect */
+	/* the payload trust is added in fu_cabinet_verify_release() */
+	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
+	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_cabinet_verify_release:
+ * @self: a #FuCabinet
+ * @release: a #XbNode
+ * @error: (nullable): optional return location for an error
+ *
+ * Decompresses the firmware payload for the release, verifies the content checksum and
+ * checks any signatures. This is only done when the release is actually going to be used,
+ * and calling this function more than once for the same release does nothing.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.2
+ **/
+gboolean
+fu_cabinet_verify_release(FuCabinet *self, XbNode *release, GError **error)
+{
+	const gchar *basename;
+	const gchar *csum_filename = NULL;
+	GBytes *blob_basename;
+	GBytes *blob_flags;
+	g_autoptr(FuFirmware) img_blob = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(XbNode) csum_tmp = NULL;
+	g_autoptr(JcatItem) item = NULL;
+	g_autoptr(GBytes) release_flags_blob = NULL;
+	g_autoptr(GBytes) verified_blob = NULL;
+	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
+
+	g_return_val_if_fail(FU_IS_CABINET(self), FALSE);
+	g_return_val_if_fail(XB_IS_NODE(release), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already done */
+	if (xb_node_get_data(release, "fwupd::ReleaseVerified") != NULL)
+		return TRUE;
+
+	/* set in fu_cabinet_parse_release() */
+	blob_basename = xb_node_get_data(release, "fwupd::FirmwareBasename");
+	if (blob_basename == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "release has no firmware basename");
+		return FALSE;
+	}
+	basename = (const gchar *)g_bytes_get_data(blob_basename, NULL);
+	blob_flags = xb_node_get_data(release, "fwupd::ReleaseFlags");
+	if (blob_flags != NULL) {
+		if (!fu_memcpy_safe((guint8 *)&release_flags,
+				    sizeof(release_flags),
+				    0x0, /* dst */
+				    g_bytes_get_data(blob_flags, NULL),
+				    g_bytes_get_size(blob_flags),
+				    0x0, /* src */
+				    sizeof(release_flags),
+				    error))
+			return FALSE;
+	}
+
+	/* get the main firmware file, decompressing it if required */
+	img_blob = fu_firmware_get_image_by_id(FU_FIRMWARE(self), basename, error);
+	if (img_blob == NULL)
+		return FALSE;
+	if (!fu_cabinet_decompress_image(self, img_blob, error))
+		return FALSE;
+	stream = fu_firmware_get_stream(img_blob, error);
+	if (stream == NULL)
+		return FALSE;
+
+	/* error out if specified and incorrect */
+	csum_tmp = fu_cabinet_get_release_checksum(release, &csum_filename);
 	if (csum_tmp != NULL && xb_node_get_text(csum_tmp) != NULL) {
 		const gchar *checksum_old = xb_node_get_text(csum_tmp);
 		GChecksumType checksum_type = fwupd_checksum_guess_kind(checksum_old);
@@ -284,6 +374,8 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 			g_autoptr(GBytes) data_sig = NULL;
 			g_autoptr(GError) error_local = NULL;
 
+			if (!fu_cabinet_decompress_image(self, img_sig, error))
+				return FALSE;
 			blob = fu_firmware_get_bytes(img_blob, error);
 			if (blob == NULL)
 				return FALSE;
@@ -310,6 +402,8 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	/* this means we can get the data from fu_keyring_get_release_flags */
 	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
 	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
+	verified_blob = g_bytes_new_static("\0", 1);
+	xb_node_set_data(release, "fwupd::ReleaseVerified", verified_blob);
 
 	/* success */
 	return TRUE;
@@ -598,6 +692,7 @@ static gboolean
 fu_cabinet_build_silo(FuCabinet *self, GError **error)
 {
 	g_autoptr(GPtrArray) imgs = NULL;
+	g_autoptr(GPtrArray) imgs_md = g_ptr_array_new();
 	g_autoptr(XbBuilderFixup) fixup1 = NULL;
 	g_autoptr(XbBuilderFixup) fixup2 = NULL;
 	g_autoptr(XbBuilderFixup) fixup3 = NULL;
@@ -610,8 +705,20 @@ fu_cabinet_build_silo(FuCabinet *self, GError **error)
 						 XB_SILO_PROFILE_FLAG_DEBUG);
 	}
 
-	/* load Jcat */
+	/* only the metadata is required to build the silo */
 	imgs = fu_firmware_get_images(FU_FIRMWARE(FU_CAB_FIRMWARE(self)));
+	for (guint i = 0; i < imgs->len; i++) {
+		FuFirmware *img = g_ptr_array_index(imgs, i);
+		const gchar *fn = fu_firmware_get_id(img);
+		if (fn == NULL)
+			continue;
+		if (g_str_has_suffix(fn, ".jcat") || g_str_has_suffix(fn, ".metainfo.xml"))
+			g_ptr_array_add(imgs_md, img);
+	}
+	if (!fu_cab_firmware_decompress_images(FU_CAB_FIRMWARE(self), imgs_md, error))
+		return FALSE;
+
+	/* load Jcat */
 	if (self->jcat_context != NULL) {
 		for (guint i = 0; i < imgs->len; i++) {
 			FuFirmware *img = g_ptr_array_index(imgs, i);
@@ -692,6 +799,8 @@ fu_cabinet_sign_filename(FuCabinet *self,
 	img = fu_firmware_get_image_by_id(FU_FIRMWARE(self), filename, error);
 	if (img == NULL)
 		return FALSE;
+	if (!fu_cabinet_decompress_image(self, img, error))
+		return FALSE;
 	source_blob = fu_firmware_get_bytes(img, error);
 	if (source_blob == NULL)
 		return FALSE;
@@ -979,6 +1088,7 @@ static void
 fu_cabinet_init(FuCabinet *self)
 {
 	fu_cab_firmware_set_only_basename(FU_CAB_FIRMWARE(self), TRUE);
+	fu_cab_firmware_set_lazy_decompress(FU_CAB_FIRMWARE(self), TRUE);
 	fu_firmware_set_size_max(FU_FIRMWARE(self), 1024 * 1024 * 100);
 	self->builder = xb_builder_new();
 	self->jcat_file = jcat_file_new();
@@ -48,6 +48,9 @@ struct _FuDbusDaemon {
 	guint percentage;   /* last emitted */
 	guint owner_id;
 	GPtrArray *system_inhibits;
+	GQueue *exclusive_queue; /* (element-type FuDbusDaemonExclusiveCall) */
+	GDBusMethodInvocation *exclusive_invocation; /* (nullable) (not owned) */
+	guint exclusive_drain_id;
 };
 
 G_DEFINE_TYPE(FuDbusDaemon, fu_dbus_daemon, FU_TYPE_DAEMON)
@@ -77,11 +80,13 @@ static void
 fu_dbus_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDbusDaemon *self)
 {
 	GVariant *val;
+	g_autoptr(FwupdDevice) snapshot = NULL;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
+	snapshot = fu_engine_get_device_snapshot(engine, device);
+	val = fwupd_codec_to_variant(FWUPD_CODEC(snapshot), FWUPD_CODEC_FLAG_NONE);
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
@@ -96,11 +101,13 @@ static void
 fu_dbus_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDbusDaemon *self)
 {
 	GVariant *val;
+	g_autoptr(FwupdDevice) snapshot = NULL;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
+	snapshot = fu_engine_get_device_snapshot(engine, device);
+	val = fwupd_codec_to_variant(FWUPD_CODEC(snapshot), FWUPD_CODEC_FLAG_NONE);
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
@@ -115,11 +122,13 @@ static void
 fu_dbus_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDbusDaemon *self)
 {
 	GVariant *val;
+	g_autoptr(FwupdDevice) snapshot = NULL;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
-	val = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_NONE);
+	snapshot = fu_engine_get_device_snapshot(engine, device);
+	val = fwupd_codec_to_variant(FWUPD_CODEC(snapshot), FWUPD_CODEC_FLAG_NONE);
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
@@ -320,11 +329,37 @@ fu_dbus_daemon_auth_helper_free(FuMainAuthHelper *helper)
 	g_free(helper);
 }
 
+static gboolean
+fu_dbus_daemon_exclusive_drain_cb(gpointer user_data);
+
+/* called when the method has replied, which lets the next queued exclusive call run */
+static void
+fu_dbus_daemon_method_invocation_done(FuDbusDaemon *self, GDBusMethodInvocation *invocation)
+{
+	if (invocation != self->exclusive_invocation)
+		return;
+	self->exclusive_invocation = NULL;
+	if (self->exclusive_drain_id == 0 && !g_queue_is_empty(self->exclusive_queue))
+		self->exclusive_drain_id = g_idle_add(fu_dbus_daemon_exclusive_drain_cb, self);
+}
+
 static void
-fu_dbus_daemon_method_invocation_return_gerror(GDBusMethodInvocation *invocation, GError *error)
+fu_dbus_daemon_method_invocation_return_value(FuDbusDaemon *self,
+					      GDBusMethodInvocation *invocation,
+					      GVariant *parameters)
+{
+	g_dbus_method_invocation_return_value(invocation, parameters);
+	fu_dbus_daemon_method_invocation_done(self, invocation);
+}
+
+static void
+fu_dbus_daemon_method_invocation_return_gerror(FuDbusDaemon *self,
+					       GDBusMethodInvocation *invocation,
+					       GError *error)
 {
 	fu_error_convert(&error);
 	g_dbus_method_invocation_return_gerror(invocation, error);
+	fu_dbus_daemon_method_invocation_done(self, invocation);
 }
 
 #pragma clang diagnostic push
@@ -341,18 +376,22 @@ fu_dbus_daemon_authorize_unlock_cb(GObject *source, GAsyncResult *res, gpointer
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* authenticated */
 	if (!fu_engine_unlock(engine, helper->device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -369,14 +408,16 @@ fu_dbus_daemon_authorize_get_bios_settings_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* authenticated */
 	attrs = fu_context_get_bios_settings(ctx);
 	val = fwupd_codec_to_variant(FWUPD_CODEC(attrs), FWUPD_CODEC_FLAG_TRUSTED);
-	g_dbus_method_invocation_return_value(helper->invocation, val);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, val);
 }
 
 static void
@@ -390,17 +431,21 @@ fu_dbus_daemon_authorize_set_bios_settings_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* authenticated */
 	if (!fu_engine_modify_bios_settings(engine, helper->bios_settings, FALSE, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -414,7 +459,9 @@ fu_dbus_daemon_authorize_set_approved_firmware_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
@@ -423,7 +470,7 @@ fu_dbus_daemon_authorize_set_approved_firmware_cb(GObject *source,
 		const gchar *csum = g_ptr_array_index(helper->checksums, i);
 		fu_engine_add_approved_firmware(engine, csum);
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -437,16 +484,20 @@ fu_dbus_daemon_authorize_set_blocked_firmware_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_set_blocked_firmware(engine, helper->checksums, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -460,16 +511,20 @@ fu_dbus_daemon_authorize_fix_host_security_attr_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_fix_host_security_attr(engine, helper->key, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -483,16 +538,20 @@ fu_dbus_daemon_authorize_undo_host_security_attr_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_undo_host_security_attr(engine, helper->key, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -505,19 +564,25 @@ fu_dbus_daemon_authorize_self_sign_cb(GObject *source, GAsyncResult *res, gpoint
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* authenticated */
 	sig = fu_engine_self_sign(engine, helper->value, helper->flags, &error);
 	if (sig == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, g_variant_new("(s)", sig));
+	fu_dbus_daemon_method_invocation_return_value(helper->self,
+						      helper->invocation,
+						      g_variant_new("(s)", sig));
 }
 
 static void
@@ -529,17 +594,21 @@ fu_dbus_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	if (!fu_engine_modify_config(engine, helper->section, helper->key, helper->value, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -551,16 +620,20 @@ fu_dbus_daemon_reset_config_cb(GObject *source, GAsyncResult *res, gpointer user
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 	if (!fu_engine_reset_config(engine, helper->section, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -595,7 +668,9 @@ fu_dbus_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
@@ -612,12 +687,14 @@ fu_dbus_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* authenticated */
 	if (!fu_engine_activate(engine, helper->device_id, progress, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -630,7 +707,9 @@ fu_dbus_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gp
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
@@ -647,12 +726,14 @@ fu_dbus_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gp
 
 	/* authenticated */
 	if (!fu_engine_verify_update(engine, helper->device_id, progress, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -664,7 +745,9 @@ fu_dbus_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gp
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
@@ -674,12 +757,14 @@ fu_dbus_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gp
 				     helper->key,
 				     helper->value,
 				     &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static FuPolkitAuthorityCheckFlags
@@ -704,7 +789,9 @@ fu_dbus_daemon_authorize_install_cb(GObject *source, GAsyncResult *res, gpointer
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
@@ -712,13 +799,44 @@ fu_dbus_daemon_authorize_install_cb(GObject *source, GAsyncResult *res, gpointer
 	fu_dbus_daemon_authorize_install_queue(g_steal_pointer(&helper));
 }
 
+static void
+fu_dbus_daemon_install_releases_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(FuMainAuthHelper) helper = (FuMainAuthHelper *)user_data;
+	FuDbusDaemon *self = helper->self;
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+
+	/* any queued method call is started when the invocation is finalized */
+	ret = fu_engine_install_releases_finish(FU_ENGINE(source), res, &error);
+	fu_daemon_set_update_in_progress(FU_DAEMON(self), FALSE);
+	if (fu_daemon_get_pending_stop(FU_DAEMON(self))) {
+		g_clear_error(&error);
+		g_set_error_literal(&error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "daemon was stopped");
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
+		return;
+	}
+	if (!ret) {
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
+		return;
+	}
+
+	/* success */
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
+}
+
 static void
 fu_dbus_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 {
 	FuDbusDaemon *self = helper_ref->self;
 	g_autoptr(FuMainAuthHelper) helper = helper_ref;
-	g_autoptr(GError) error = NULL;
-	gboolean ret;
 	FuEngine *engine = fu_daemon_get_engine(FU_DAEMON(helper->self));
 
 	/* still more things to to authenticate */
@@ -749,31 +867,18 @@ fu_dbus_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 			 G_CALLBACK(fu_dbus_daemon_progress_status_changed_cb),
 			 helper->self);
 
-	/* all authenticated, so install all the things */
+	/* all authenticated, so install all the things -- this runs on a worker thread so that
+	 * the daemon can continue to answer other requests */
 	fu_daemon_set_update_in_progress(FU_DAEMON(self), TRUE);
-	ret = fu_engine_install_releases(engine,
-					 helper->request,
-					 helper->releases,
-					 helper->cabinet,
-					 helper->progress,
-					 helper->flags,
-					 &error);
-	fu_daemon_set_update_in_progress(FU_DAEMON(self), FALSE);
-	if (fu_daemon_get_pending_stop(FU_DAEMON(self))) {
-		g_set_error_literal(&error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INTERNAL,
-				    "daemon was stopped");
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
-		return;
-	}
-	if (!ret) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
-		return;
-	}
-
-	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_engine_install_releases_async(engine,
+					 helper_ref->request,
+					 helper_ref->releases,
+					 helper_ref->cabinet,
+					 helper_ref->progress,
+					 helper_ref->flags,
+					 NULL,
+					 fu_dbus_daemon_install_releases_cb,
+					 g_steal_pointer(&helper));
 }
 #endif /* HAVE_GIO_UNIX */
 
@@ -1162,18 +1267,20 @@ fu_dbus_daemon_method_get_devices(FuDbusDaemon *self,
 	GVariant *val;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) snapshots = NULL;
 
 	devices = fu_engine_get_devices(engine, &error);
 	if (devices == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	val = fu_dbus_daemon_device_array_to_variant(self, request, devices, &error);
+	snapshots = fu_engine_get_device_snapshots(engine, devices);
+	val = fu_dbus_daemon_device_array_to_variant(self, request, snapshots, &error);
 	if (val == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, val);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, val);
 }
 
 static void
@@ -1186,7 +1293,33 @@ fu_dbus_daemon_method_get_plugins(FuDbusDaemon *self,
 	GVariant *val;
 
 	val = fwupd_codec_array_to_variant(fu_engine_get_plugins(engine), FWUPD_CODEC_FLAG_NONE);
-	g_dbus_method_invocation_return_value(invocation, val);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, val);
+}
+
+static void
+fu_dbus_daemon_method_get_plugin_statistics(FuDbusDaemon *self,
+					    GVariant *parameters,
+					    FuEngineRequest *request,
+					    GDBusMethodInvocation *invocation)
+{
+	FuEngine *engine = fu_daemon_get_engine(FU_DAEMON(self));
+	GVariant *val = fu_engine_get_plugin_statistics(engine);
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
+}
+
+static void
+fu_dbus_daemon_method_get_engine_statistics(FuDbusDaemon *self,
+					    GVariant *parameters,
+					    FuEngineRequest *request,
+					    GDBusMethodInvocation *invocation)
+{
+	FuEngine *engine = fu_daemon_get_engine(FU_DAEMON(self));
+	GVariant *val = fu_engine_get_statistics(engine);
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1202,15 +1335,16 @@ fu_dbus_daemon_method_get_releases(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	releases = fu_engine_get_releases(engine, request, device_id, &error);
 	if (releases == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(
+	fu_dbus_daemon_method_invocation_return_value(
+	    self,
 	    invocation,
 	    fwupd_codec_array_to_variant(releases, FWUPD_CODEC_FLAG_NONE));
 }
@@ -1232,7 +1366,9 @@ fu_dbus_daemon_method_get_approved_firmware(FuDbusDaemon *self,
 		g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 	}
 	val = g_variant_builder_end(&builder);
-	g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1252,7 +1388,9 @@ fu_dbus_daemon_method_get_blocked_firmware(FuDbusDaemon *self,
 		g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 	}
 	val = g_variant_builder_end(&builder);
-	g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1272,7 +1410,7 @@ fu_dbus_daemon_method_get_report_metadata(FuDbusDaemon *self,
 
 	metadata = fu_engine_get_report_metadata(engine, &error);
 	if (metadata == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ss}"));
@@ -1281,7 +1419,9 @@ fu_dbus_daemon_method_get_report_metadata(FuDbusDaemon *self,
 		g_variant_builder_add_value(&builder, g_variant_new("{ss}", key, value));
 	}
 	val = g_variant_builder_end(&builder);
-	g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1355,13 +1495,15 @@ fu_dbus_daemon_authorize_quit_cb(GObject *source, GAsyncResult *res, gpointer us
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
 	fu_daemon_schedule_process_quit(FU_DAEMON(helper->self));
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -1375,7 +1517,7 @@ fu_dbus_daemon_method_quit(FuDbusDaemon *self,
 	/* is root */
 	if (fu_engine_request_has_converter_flag(request, FWUPD_CODEC_FLAG_TRUSTED)) {
 		fu_daemon_schedule_process_quit(FU_DAEMON(self));
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 
@@ -1449,15 +1591,16 @@ fu_dbus_daemon_method_get_downgrades(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	releases = fu_engine_get_downgrades(engine, request, device_id, &error);
 	if (releases == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(
+	fu_dbus_daemon_method_invocation_return_value(
+	    self,
 	    invocation,
 	    fwupd_codec_array_to_variant(releases, FWUPD_CODEC_FLAG_NONE));
 }
@@ -1475,15 +1618,16 @@ fu_dbus_daemon_method_get_upgrades(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	releases = fu_engine_get_upgrades(engine, request, device_id, &error);
 	if (releases == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(
+	fu_dbus_daemon_method_invocation_return_value(
+	    self,
 	    invocation,
 	    fwupd_codec_array_to_variant(releases, FWUPD_CODEC_FLAG_NONE));
 }
@@ -1500,10 +1644,11 @@ fu_dbus_daemon_method_get_remotes(FuDbusDaemon *self,
 	g_autoptr(GPtrArray) remotes = NULL;
 	remotes = fu_engine_get_remotes(engine, &error);
 	if (remotes == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(
+	fu_dbus_daemon_method_invocation_return_value(
+	    self,
 	    invocation,
 	    fwupd_codec_array_to_variant(remotes, FWUPD_CODEC_FLAG_NONE));
 }
@@ -1521,15 +1666,15 @@ fu_dbus_daemon_method_get_history(FuDbusDaemon *self,
 
 	devices = fu_engine_get_history(engine, &error);
 	if (devices == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	val = fu_dbus_daemon_device_array_to_variant(self, request, devices, &error);
 	if (val == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, val);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, val);
 }
 
 static void
@@ -1544,11 +1689,33 @@ fu_dbus_daemon_method_get_host_security_attrs(FuDbusDaemon *self,
 	g_autoptr(FuSecurityAttrs) attrs = NULL;
 
 	if (!fu_dbus_daemon_hsi_supported(self, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	attrs = fu_engine_get_host_security_attrs(engine);
-	g_dbus_method_invocation_return_value(invocation, fu_security_attrs_to_variant(attrs));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      fu_security_attrs_to_variant(attrs));
+}
+
+static void
+fu_dbus_daemon_method_get_host_security_statistics(FuDbusDaemon *self,
+						   GVariant *parameters,
+						   FuEngineRequest *request,
+						   GDBusMethodInvocation *invocation)
+{
+	FuEngine *engine = fu_daemon_get_engine(FU_DAEMON(self));
+	GVariant *val;
+	g_autoptr(GError) error = NULL;
+
+	if (!fu_dbus_daemon_hsi_supported(self, &error)) {
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
+		return;
+	}
+	val = fu_engine_get_host_security_statistics(engine);
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1566,10 +1733,12 @@ fu_dbus_daemon_method_get_host_security_events(FuDbusDaemon *self,
 	g_variant_get(parameters, "(u)", &limit);
 	attrs = fu_engine_get_host_security_events(engine, limit, &error);
 	if (attrs == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, fu_security_attrs_to_variant(attrs));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      fu_security_attrs_to_variant(attrs));
 #else
 	g_dbus_method_invocation_return_error_literal(invocation,
 						      FWUPD_ERROR,
@@ -1590,10 +1759,10 @@ fu_dbus_daemon_method_clear_results(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_engine_clear_results(engine, device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -1606,29 +1775,32 @@ fu_dbus_daemon_authorize_emulation_load_cb(GObject *source, GAsyncResult *res, g
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* get stream */
 	stream = fu_dbus_daemon_invocation_get_input_stream(helper->invocation, &error);
 	if (stream == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* load data into engine */
 	if (!fu_engine_emulation_load(engine, stream, &error)) {
-		g_dbus_method_invocation_return_error(helper->invocation,
-						      error->domain,
-						      error->code,
-						      "failed to load emulation data: %s",
-						      error->message);
+		g_prefix_error(&error, "failed to load emulation data: ");
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -1668,25 +1840,31 @@ fu_dbus_daemon_authorize_emulation_save_cb(GObject *source, GAsyncResult *res, g
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* get stream */
 	stream = fu_dbus_daemon_invocation_get_output_stream(helper->invocation, &error);
 	if (stream == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* save data from engine */
 	if (!fu_engine_emulation_save(engine, stream, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(helper->self,
+							       helper->invocation,
+							       error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 static void
 fu_dbus_daemon_method_emulation_save(FuDbusDaemon *self,
@@ -1716,19 +1894,20 @@ fu_dbus_daemon_method_emulation_save(FuDbusDaemon *self,
 }
 
 static void
-fu_dbus_daemon_authorize_modify_device_internal(FuEngine *engine,
+fu_dbus_daemon_authorize_modify_device_internal(FuDbusDaemon *self,
 						const gchar *device_id,
 						const gchar *key,
 						const gchar *value,
 						GDBusMethodInvocation *invocation)
 {
+	FuEngine *engine = fu_daemon_get_engine(FU_DAEMON(self));
 	g_autoptr(GError) error = NULL;
 
 	if (!fu_engine_modify_device(engine, device_id, key, value, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -1736,12 +1915,11 @@ fu_dbus_daemon_authorize_modify_device_cb(GObject *source, GAsyncResult *res, gp
 {
 	g_autoptr(FuMainAuthHelper) helper = (FuMainAuthHelper *)user_data;
 
-	fu_dbus_daemon_authorize_modify_device_internal(
-	    fu_daemon_get_engine(FU_DAEMON(helper->self)),
-	    helper->device_id,
-	    helper->key,
-	    helper->value,
-	    helper->invocation);
+	fu_dbus_daemon_authorize_modify_device_internal(helper->self,
+							helper->device_id,
+							helper->key,
+							helper->value,
+							helper->invocation);
 }
 
 static gboolean
@@ -1785,12 +1963,11 @@ fu_dbus_daemon_method_modify_device(FuDbusDaemon *self,
 		    fu_dbus_daemon_authorize_modify_device_cb,
 		    g_steal_pointer(&helper));
 	} else
-		fu_dbus_daemon_authorize_modify_device_internal(
-		    fu_daemon_get_engine(FU_DAEMON(self)),
-		    device_id,
-		    key,
-		    value,
-		    invocation);
+		fu_dbus_daemon_authorize_modify_device_internal(self,
+								device_id,
+								key,
+								value,
+								invocation);
 }
 
 static void
@@ -1807,16 +1984,18 @@ fu_dbus_daemon_method_get_results(FuDbusDaemon *self,
 	g_autoptr(FwupdDevice) result = NULL;
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	result = fu_engine_get_results(engine, device_id, &error);
 	if (result == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	val = fwupd_codec_to_variant(FWUPD_CODEC(result), FWUPD_CODEC_FLAG_TRUSTED);
-	g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new_tuple(&val, 1));
 }
 
 static void
@@ -1841,32 +2020,33 @@ fu_dbus_daemon_method_update_metadata(FuDbusDaemon *self,
 	fd_list = g_dbus_message_get_unix_fd_list(message);
 	if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 2) {
 		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	fd_data = g_unix_fd_list_get(fd_list, 0, &error);
 	if (fd_data < 0) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	fd_sig = g_unix_fd_list_get(fd_list, 1, &error);
 	if (fd_sig < 0) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
 	/* store new metadata (will close the fds when done) */
 	if (!fu_engine_update_metadata(engine, remote_id, fd_data, fd_sig, &error)) {
 		g_prefix_error(&error, "Failed to update metadata for %s: ", remote_id);
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 #else
 	g_dbus_method_invocation_return_error_literal(invocation,
 						      FWUPD_ERROR,
 						      FWUPD_ERROR_INTERNAL,
 						      "unsupported feature");
+	fu_dbus_daemon_method_invocation_done(self, invocation);
 #endif /* HAVE_GIO_UNIX */
 }
 
@@ -1882,7 +2062,7 @@ fu_dbus_daemon_method_unlock(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -1914,7 +2094,7 @@ fu_dbus_daemon_method_activate(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2038,7 +2218,7 @@ fu_dbus_daemon_method_verify_update(FuDbusDaemon *self,
 	g_variant_get(parameters, "(&s)", &device_id);
 
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2073,7 +2253,7 @@ fu_dbus_daemon_method_verify(FuDbusDaemon *self,
 
 	g_variant_get(parameters, "(&s)", &device_id);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2089,10 +2269,10 @@ fu_dbus_daemon_method_verify(FuDbusDaemon *self,
 			 self);
 
 	if (!fu_engine_verify(engine, device_id, progress, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -2109,7 +2289,7 @@ fu_dbus_daemon_method_set_feature_flags(FuDbusDaemon *self,
 	/* old flags for the same sender will be automatically destroyed */
 	client = fu_client_list_register(self->client_list, fu_engine_request_get_sender(request));
 	fu_client_set_feature_flags(client, feature_flags_u64);
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -2129,7 +2309,7 @@ fu_dbus_daemon_method_set_hints(FuDbusDaemon *self,
 		g_debug("got hint %s=%s", prop_key, prop_value);
 		fu_client_insert_hint(client, prop_key, prop_value);
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -2157,7 +2337,9 @@ fu_dbus_daemon_method_inhibit(FuDbusDaemon *self,
 					   NULL);
 	g_ptr_array_add(self->system_inhibits, inhibit);
 	fu_dbus_daemon_ensure_system_inhibit(self);
-	g_dbus_method_invocation_return_value(invocation, g_variant_new("(s)", inhibit->id));
+	fu_dbus_daemon_method_invocation_return_value(self,
+						      invocation,
+						      g_variant_new("(s)", inhibit->id));
 }
 
 static void
@@ -2179,7 +2361,7 @@ fu_dbus_daemon_method_install(FuDbusDaemon *self,
 	/* check the id exists */
 	g_variant_get(parameters, "(&sha{sv})", &device_id, &fd_handle, &iter);
 	if (!fu_dbus_daemon_device_id_valid(device_id, &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2208,14 +2390,14 @@ fu_dbus_daemon_method_install(FuDbusDaemon *self,
 			    "client sent unsupported flag: 0x%x [%s]",
 			    (guint)flags_unsafe,
 			    fwupd_install_flags_to_string(flags_unsafe));
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
 	/* get stream */
 	helper->stream = fu_dbus_daemon_invocation_get_input_stream(invocation, &error);
 	if (helper->stream == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2232,7 +2414,7 @@ fu_dbus_daemon_method_install(FuDbusDaemon *self,
 			     G_CALLBACK(fu_dbus_daemon_client_flags_notify_cb),
 			     helper);
 	if (!fu_dbus_daemon_install_with_helper(g_steal_pointer(&helper), &error)) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 #else
@@ -2240,6 +2422,7 @@ fu_dbus_daemon_method_install(FuDbusDaemon *self,
 						      FWUPD_ERROR,
 						      FWUPD_ERROR_INTERNAL,
 						      "unsupported feature");
+	fu_dbus_daemon_method_invocation_done(self, invocation);
 #endif /* HAVE_GIO_UNIX */
 }
 
@@ -2271,7 +2454,7 @@ fu_dbus_daemon_method_uninhibit(FuDbusDaemon *self,
 							      "Cannot find inhibit ID");
 		return;
 	}
-	g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_dbus_daemon_method_invocation_return_value(self, invocation, NULL);
 }
 
 static void
@@ -2293,17 +2476,18 @@ fu_dbus_daemon_method_get_details(FuDbusDaemon *self,
 	/* get stream */
 	stream = fu_dbus_daemon_invocation_get_input_stream(invocation, &error);
 	if (stream == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
 	/* get details about the file */
 	results = fu_engine_get_details(engine, request, stream, &error);
 	if (results == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(
+	fu_dbus_daemon_method_invocation_return_value(
+	    self,
 	    invocation,
 	    fwupd_codec_array_to_variant(results, FWUPD_CODEC_FLAG_TRUSTED));
 #else
@@ -2311,6 +2495,7 @@ fu_dbus_daemon_method_get_details(FuDbusDaemon *self,
 						      FWUPD_ERROR,
 						      FWUPD_ERROR_INTERNAL,
 						      "unsupported feature");
+	fu_dbus_daemon_method_invocation_done(self, invocation);
 #endif /* HAVE_GIO_UNIX */
 }
 
@@ -2330,7 +2515,8 @@ fu_dbus_daemon_method_get_bios_settings(FuDbusDaemon *self,
 		 * subset of the settings */
 		g_autoptr(FuBiosSettings) attrs =
 		    fu_context_get_bios_settings(fu_engine_get_context(engine));
-		g_dbus_method_invocation_return_value(
+		fu_dbus_daemon_method_invocation_return_value(
+		    self,
 		    invocation,
 		    fwupd_codec_to_variant(FWUPD_CODEC(attrs),
 					   fu_engine_request_get_converter_flags(request)));
@@ -2447,6 +2633,91 @@ typedef void (*FuDbusDaemonMethodFunc)(FuDbusDaemon *self,
 				       FuEngineRequest *request,
 				       GDBusMethodInvocation *invocation);
 
+typedef struct {
+	FuDbusDaemonMethodFunc func;
+	GVariant *parameters;
+	FuEngineRequest *request;
+	GDBusMethodInvocation *invocation; /* not replied to yet */
+} FuDbusDaemonExclusiveCall;
+
+static void
+fu_dbus_daemon_exclusive_call_free(FuDbusDaemonExclusiveCall *call)
+{
+	g_variant_unref(call->parameters);
+	g_object_unref(call->request);
+	g_free(call);
+}
+
+static void
+fu_dbus_daemon_exclusive_call_run(FuDbusDaemon *self,
+				  FuDbusDaemonMethodFunc func,
+				  GVariant *parameters,
+				  FuEngineRequest *request,
+				  GDBusMethodInvocation *invocation)
+{
+	/* the call is finished when the method replies, which may be after a polkit check or
+	 * when the install worker thread has completed */
+	self->exclusive_invocation = invocation;
+	func(self, parameters, request, invocation);
+}
+
+static gboolean
+fu_dbus_daemon_exclusive_drain_cb(gpointer user_data)
+{
+	FuDbusDaemon *self = FU_DBUS_DAEMON(user_data);
+	FuDbusDaemonExclusiveCall *call;
+
+	self->exclusive_drain_id = 0;
+	if (self->exclusive_invocation != NULL)
+		return G_SOURCE_REMOVE;
+	call = g_queue_pop_head(self->exclusive_queue);
+	if (call == NULL)
+		return G_SOURCE_REMOVE;
+	if (fu_daemon_get_pending_stop(FU_DAEMON(self))) {
+		g_dbus_method_invocation_return_error_literal(call->invocation,
+							      FWUPD_ERROR,
+							      FWUPD_ERROR_INTERNAL,
+							      "daemon was stopped");
+	} else {
+		fu_dbus_daemon_exclusive_call_run(self,
+						  call->func,
+						  call->parameters,
+						  call->request,
+						  call->invocation);
+	}
+	fu_dbus_daemon_exclusive_call_free(call);
+
+	/* the call may have finished already */
+	if (self->exclusive_invocation == NULL && !g_queue_is_empty(self->exclusive_queue))
+		self->exclusive_drain_id = g_idle_add(fu_dbus_daemon_exclusive_drain_cb, self);
+	return G_SOURCE_REMOVE;
+}
+
+/* methods that change the engine or device state are only ever run one at a time and never
+ * while a firmware install is running */
+static void
+fu_dbus_daemon_exclusive_call(FuDbusDaemon *self,
+			      const gchar *method_name,
+			      FuDbusDaemonMethodFunc func,
+			      GVariant *parameters,
+			      FuEngineRequest *request,
+			      GDBusMethodInvocation *invocation)
+{
+	FuDbusDaemonExclusiveCall *call;
+
+	if (self->exclusive_invocation == NULL && g_queue_is_empty(self->exclusive_queue)) {
+		fu_dbus_daemon_exclusive_call_run(self, func, parameters, request, invocation);
+		return;
+	}
+	g_info("queuing %s as another method is in progress", method_name);
+	call = g_new0(FuDbusDaemonExclusiveCall, 1);
+	call->func = func;
+	call->parameters = g_variant_ref(parameters);
+	call->request = g_object_ref(request);
+	call->invocation = invocation;
+	g_queue_push_tail(self->exclusive_queue, call);
+}
+
 static void
 fu_dbus_daemon_method_call(GDBusConnection *connection,
 			   const gchar *sender,
@@ -2465,15 +2736,18 @@ fu_dbus_daemon_method_call(GDBusConnection *connection,
 	struct {
 		const gchar *name;
 		FuDbusDaemonMethodFunc func;
+		gboolean exclusive;
 	} method_funcs[] = {
 	    {"GetDevices", fu_dbus_daemon_method_get_devices},
 	    {"GetPlugins", fu_dbus_daemon_method_get_plugins},
+	    {"GetPluginStatistics", fu_dbus_daemon_method_get_plugin_statistics},
+	    {"GetEngineStatistics", fu_dbus_daemon_method_get_engine_statistics},
 	    {"GetReleases", fu_dbus_daemon_method_get_releases},
 	    {"GetApprovedFirmware", fu_dbus_daemon_method_get_approved_firmware},
 	    {"GetBlockedFirmware", fu_dbus_daemon_method_get_blocked_firmware},
 	    {"GetReportMetadata", fu_dbus_daemon_method_get_report_metadata},
-	    {"SetApprovedFirmware", fu_dbus_daemon_method_set_approved_firmware},
-	    {"SetBlockedFirmware", fu_dbus_daemon_method_set_blocked_firmware},
+	    {"SetApprovedFirmware", fu_dbus_daemon_method_set_approved_firmware, TRUE},
+	    {"SetBlockedFirmware", fu_dbus_daemon_method_set_blocked_firmware, TRUE},
 	    {"Quit", fu_dbus_daemon_method_quit},
 	    {"SelfSign", fu_dbus_daemon_method_self_sign},
 	    {"GetDowngrades", fu_dbus_daemon_method_get_downgrades},
@@ -2482,35 +2756,36 @@ fu_dbus_daemon_method_call(GDBusConnection *connection,
 	    {"GetHistory", fu_dbus_daemon_method_get_history},
 	    {"GetHostSecurityAttrs", fu_dbus_daemon_method_get_host_security_attrs},
 	    {"GetHostSecurityEvents", fu_dbus_daemon_method_get_host_security_events},
-	    {"ClearResults", fu_dbus_daemon_method_clear_results},
-	    {"EmulationLoad", fu_dbus_daemon_method_emulation_load},
-	    {"EmulationSave", fu_dbus_daemon_method_emulation_save},
-	    {"ModifyDevice", fu_dbus_daemon_method_modify_device},
+	    {"GetHostSecurityStatistics", fu_dbus_daemon_method_get_host_security_statistics},
+	    {"ClearResults", fu_dbus_daemon_method_clear_results, TRUE},
+	    {"EmulationLoad", fu_dbus_daemon_method_emulation_load, TRUE},
+	    {"EmulationSave", fu_dbus_daemon_method_emulation_save, TRUE},
+	    {"ModifyDevice", fu_dbus_daemon_method_modify_device, TRUE},
 	    {"GetResults", fu_dbus_daemon_method_get_results},
-	    {"UpdateMetadata", fu_dbus_daemon_method_update_metadata},
-	    {"Unlock", fu_dbus_daemon_method_unlock},
-	    {"Activate", fu_dbus_daemon_method_activate},
-	    {"ModifyConfig", fu_dbus_daemon_method_modify_config},
-	    {"ResetConfig", fu_dbus_daemon_method_reset_config},
-	    {"ModifyRemote", fu_dbus_daemon_method_modify_remote},
-	    {"VerifyUpdate", fu_dbus_daemon_method_verify_update},
-	    {"Verify", fu_dbus_daemon_method_verify},
+	    {"UpdateMetadata", fu_dbus_daemon_method_update_metadata, TRUE},
+	    {"Unlock", fu_dbus_daemon_method_unlock, TRUE},
+	    {"Activate", fu_dbus_daemon_method_activate, TRUE},
+	    {"ModifyConfig", fu_dbus_daemon_method_modify_config, TRUE},
+	    {"ResetConfig", fu_dbus_daemon_method_reset_config, TRUE},
+	    {"ModifyRemote", fu_dbus_daemon_method_modify_remote, TRUE},
+	    {"VerifyUpdate", fu_dbus_daemon_method_verify_update, TRUE},
+	    {"Verify", fu_dbus_daemon_method_verify, TRUE},
 	    {"SetFeatureFlags", fu_dbus_daemon_method_set_feature_flags},
 	    {"SetHints", fu_dbus_daemon_method_set_hints},
 	    {"Inhibit", fu_dbus_daemon_method_inhibit},
 	    {"Uninhibit", fu_dbus_daemon_method_uninhibit},
-	    {"Install", fu_dbus_daemon_method_install},
+	    {"Install", fu_dbus_daemon_method_install, TRUE},
 	    {"GetDetails", fu_dbus_daemon_method_get_details},
 	    {"GetBiosSettings", fu_dbus_daemon_method_get_bios_settings},
-	    {"SetBiosSettings", fu_dbus_daemon_method_set_bios_settings},
-	    {"FixHostSecurityAttr", fu_dbus_daemon_method_fix_host_security_attr},
-	    {"UndoHostSecurityAttr", fu_dbus_daemon_method_undo_host_security_attr},
+	    {"SetBiosSettings", fu_dbus_daemon_method_set_bios_settings, TRUE},
+	    {"FixHostSecurityAttr", fu_dbus_daemon_method_fix_host_security_attr, TRUE},
+	    {"UndoHostSecurityAttr", fu_dbus_daemon_method_undo_host_security_attr, TRUE},
 	};
 
 	/* build request */
 	request = fu_dbus_daemon_create_request(self, sender, &error);
 	if (request == NULL) {
-		fu_dbus_daemon_method_invocation_return_gerror(invocation, error);
+		fu_dbus_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 
@@ -2523,10 +2798,19 @@ fu_dbus_daemon_method_call(GDBusConnection *connection,
 
 	/* call the correct vfunc */
 	for (guint i = 0; i < G_N_ELEMENTS(method_funcs); i++) {
-		if (g_strcmp0(method_name, method_funcs[i].name) == 0) {
-			method_funcs[i].func(self, parameters, request, invocation);
+		if (g_strcmp0(method_name, method_funcs[i].name) != 0)
+			continue;
+		if (method_funcs[i].exclusive) {
+			fu_dbus_daemon_exclusive_call(self,
+						      method_funcs[i].name,
+						      method_funcs[i].func,
+						      parameters,
+						      request,
+						      invocation);
 			return;
 		}
+		method_funcs[i].func(self, parameters, request, invocation);
+		return;
 	}
 	g_dbus_method_invocation_return_error(invocation,
 					      G_DBUS_ERROR,
@@ -2899,6 +3183,7 @@ static void
 fu_dbus_daemon_init(FuDbusDaemon *self)
 {
 	self->status = FWUPD_STATUS_IDLE;
+	self->exclusive_queue = g_queue_new();
 	self->system_inhibits =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_dbus_daemon_system_inhibit_free);
 }
@@ -2907,7 +3192,18 @@ static void
 fu_dbus_daemon_finalize(GObject *obj)
 {
 	FuDbusDaemon *self = FU_DBUS_DAEMON(obj);
+	FuDbusDaemonExclusiveCall *call;
 
+	if (self->exclusive_drain_id != 0)
+		g_source_remove(self->exclusive_drain_id);
+	while ((call = g_queue_pop_head(self->exclusive_queue)) != NULL) {
+		g_dbus_method_invocation_return_error_literal(call->invocation,
+							      FWUPD_ERROR,
+							      FWUPD_ERROR_INTERNAL,
+							      "daemon was stopped");
+		fu_dbus_daemon_exclusive_call_free(call);
+	}
+	g_queue_free(self->exclusive_queue);
 	g_ptr_array_unref(self->system_inhibits);
 	if (self->client_list != NULL)
 		g_object_unref(self->client_list);
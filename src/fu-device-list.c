@@ -979,7 +979,7 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 	do {
 		g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
 		g_usleep(1000);
-		g_main_context_iteration(NULL, FALSE);
+		g_main_context_iteration(g_main_context_get_thread_default(), FALSE);
 		devices_wfr_tmp = fu_device_list_get_wait_for_replug(self);
 		if (devices_wfr_tmp->len == 0)
 			break;
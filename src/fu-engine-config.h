@@ -45,6 +45,8 @@ fu_engine_config_get_only_trusted(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 gboolean
 fu_engine_config_get_show_device_private(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 gboolean
+fu_engine_config_get_setup_cache(FuEngineConfig *self) G_GNUC_NON_NULL(1);
+gboolean
 fu_engine_config_get_test_devices(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 gboolean
 fu_engine_config_get_ignore_requirements(FuEngineConfig *self) G_GNUC_NON_NULL(1);
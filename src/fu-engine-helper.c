@@ -152,18 +152,12 @@ fu_engine_update_motd(FuEngine *self, GError **error)
 	return g_file_set_contents(target, str->str, str->len, error);
 }
 
-gboolean
-fu_engine_update_devices_file(FuEngine *self, GError **error)
+JsonNode *
+fu_engine_devices_file_build(FuEngine *self)
 {
 	FwupdCodecFlags flags = FWUPD_CODEC_FLAG_NONE;
-	gsize len;
 	g_autoptr(JsonBuilder) builder = NULL;
-	g_autoptr(JsonGenerator) generator = NULL;
-	g_autoptr(JsonNode) root = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
-	g_autofree gchar *data = NULL;
-	g_autofree gchar *directory = NULL;
-	g_autofree gchar *target = NULL;
 
 	if (fu_engine_config_get_show_device_private(fu_engine_get_config(self)))
 		flags |= FWUPD_CODEC_FLAG_TRUSTED;
@@ -174,8 +168,21 @@ fu_engine_update_devices_file(FuEngine *self, GError **error)
 	devices = fu_engine_get_devices(self, NULL);
 	if (devices != NULL)
 		fwupd_codec_array_to_json(devices, "Devices", builder, flags);
+	json_builder_end_object(builder);
+	return json_builder_get_root(builder);
+}
+
+/* this does not touch any engine or device state and so is safe to call from a thread */
+gchar *
+fu_engine_devices_file_write(JsonNode *root, const gchar *checksum_old, GError **error)
+{
+	gsize len;
+	g_autoptr(JsonGenerator) generator = NULL;
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *data = NULL;
+	g_autofree gchar *directory = NULL;
+	g_autofree gchar *target = NULL;
 
-	root = json_builder_get_root(builder);
 	generator = json_generator_new();
 	json_generator_set_pretty(generator, TRUE);
 	json_generator_set_root(generator, root);
@@ -185,12 +192,128 @@ fu_engine_update_devices_file(FuEngine *self, GError **error)
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INTERNAL,
 				    "Failed to convert to JSON string");
-		return FALSE;
+		return NULL;
 	}
 
+	/* nothing changed since the last write */
+	checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar *)data, len);
+	if (g_strcmp0(checksum, checksum_old) == 0)
+		return g_steal_pointer(&checksum);
+
 	directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
 	target = g_build_filename(directory, "devices.json", NULL);
-	return g_file_set_contents(target, data, (gssize)len, error);
+	if (!g_file_set_contents(target, data, (gssize)len, error))
+		return NULL;
+	return g_steal_pointer(&checksum);
+}
+
+static gchar *
+fu_engine_setup_cache_get_boot_id(GError **error)
+{
+	gchar *buf = NULL;
+	g_autofree gchar *procfs = fu_path_from_kind(FU_PATH_KIND_PROCFS);
+	g_autofree gchar *fn =
+	    g_build_filename(procfs, "sys", "kernel", "random", "boot_id", NULL);
+
+	if (!g_file_get_contents(fn, &buf, NULL, error))
+		return NULL;
+	return g_strstrip(buf);
+}
+
+static gchar *
+fu_engine_setup_cache_get_filename(void)
+{
+	g_autofree gchar *directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	return g_build_filename(directory, "setup-cache.json", NULL);
+}
+
+/* the cache is only valid for the same boot, daemon version, plugins and quirks */
+GHashTable *
+fu_engine_setup_cache_read(const gchar *checksum, GError **error)
+{
+	JsonObject *obj;
+	JsonObject *obj_devices;
+	g_autofree gchar *boot_id = NULL;
+	g_autofree gchar *fn = fu_engine_setup_cache_get_filename();
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GHashTable) setup_cache = NULL;
+	g_autoptr(GList) keys = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	boot_id = fu_engine_setup_cache_get_boot_id(error);
+	if (boot_id == NULL)
+		return NULL;
+	setup_cache = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    g_free,
+					    (GDestroyNotify)json_node_unref);
+	if (!g_file_test(fn, G_FILE_TEST_EXISTS))
+		return g_steal_pointer(&setup_cache);
+	if (!json_parser_load_from_file(parser, fn, &error_local)) {
+		g_debug("ignoring %s: %s", fn, error_local->message);
+		return g_steal_pointer(&setup_cache);
+	}
+	if (!JSON_NODE_HOLDS_OBJECT(json_parser_get_root(parser))) {
+		g_debug("ignoring %s: not JSON object", fn);
+		return g_steal_pointer(&setup_cache);
+	}
+	obj = json_node_get_object(json_parser_get_root(parser));
+	if (g_strcmp0(json_object_get_string_member_with_default(obj, "Version", NULL),
+		      VERSION) != 0 ||
+	    g_strcmp0(json_object_get_string_member_with_default(obj, "BootId", NULL),
+		      boot_id) != 0 ||
+	    g_strcmp0(json_object_get_string_member_with_default(obj, "Checksum", NULL),
+		      checksum) != 0) {
+		g_debug("ignoring %s as out of date", fn);
+		return g_steal_pointer(&setup_cache);
+	}
+	if (!json_object_has_member(obj, "Devices"))
+		return g_steal_pointer(&setup_cache);
+	obj_devices = json_object_get_object_member(obj, "Devices");
+	keys = json_object_get_members(obj_devices);
+	for (GList *l = keys; l != NULL; l = l->next) {
+		const gchar *key = l->data;
+		g_hash_table_insert(setup_cache,
+				    g_strdup(key),
+				    json_node_copy(json_object_get_member(obj_devices, key)));
+	}
+	return g_steal_pointer(&setup_cache);
+}
+
+gboolean
+fu_engine_setup_cache_write(GHashTable *setup_cache, const gchar *checksum, GError **error)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autofree gchar *boot_id = NULL;
+	g_autofree gchar *data = NULL;
+	g_autofree gchar *fn = fu_engine_setup_cache_get_filename();
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) generator = json_generator_new();
+	g_autoptr(JsonNode) root = NULL;
+
+	boot_id = fu_engine_setup_cache_get_boot_id(error);
+	if (boot_id == NULL)
+		return FALSE;
+
+	json_builder_begin_object(builder);
+	fwupd_codec_json_append(builder, "Version", VERSION);
+	fwupd_codec_json_append(builder, "BootId", boot_id);
+	fwupd_codec_json_append(builder, "Checksum", checksum);
+	json_builder_set_member_name(builder, "Devices");
+	json_builder_begin_object(builder);
+	g_hash_table_iter_init(&iter, setup_cache);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		json_builder_set_member_name(builder, key);
+		json_builder_add_value(builder, json_node_copy(value));
+	}
+	json_builder_end_object(builder);
+	json_builder_end_object(builder);
+
+	root = json_builder_get_root(builder);
+	json_generator_set_root(generator, root);
+	data = json_generator_to_data(generator, NULL);
+	return g_file_set_contents(fn, data, -1, error);
 }
 
 static void
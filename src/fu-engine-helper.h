@@ -10,8 +10,16 @@
 
 gboolean
 fu_engine_update_motd(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+JsonNode *
+fu_engine_devices_file_build(FuEngine *self) G_GNUC_NON_NULL(1);
+gchar *
+fu_engine_devices_file_write(JsonNode *root, const gchar *checksum_old, GError **error)
+    G_GNUC_NON_NULL(1);
+GHashTable *
+fu_engine_setup_cache_read(const gchar *checksum, GError **error) G_GNUC_NON_NULL(1);
 gboolean
-fu_engine_update_devices_file(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+fu_engine_setup_cache_write(GHashTable *setup_cache, const gchar *checksum, GError **error)
+    G_GNUC_NON_NULL(1, 2);
 
 GHashTable *
 fu_engine_integrity_new(FuContext *ctx, GError **error);
@@ -53,6 +53,7 @@
 #include "fu-engine.h"
 #include "fu-history.h"
 #include "fu-idle.h"
+#include "fu-metadata-index.h"
 #include "fu-plugin-builtin.h"
 #include "fu-plugin-list.h"
 #include "fu-plugin-private.h"
@@ -86,11 +87,15 @@
 
 #define MINIMUM_BATTERY_PERCENTAGE_FALLBACK 10
 
-#define FU_ENGINE_UPDATE_MOTD_DELAY 5 /* s */
+#define FU_ENGINE_UPDATE_MOTD_DELAY    5   /* s */
+#define FU_ENGINE_UPDATE_DEVICES_DELAY 500 /* ms */
+#define FU_ENGINE_SETUP_CACHE_SAVE_DELAY 500 /* ms */
 
 #define FU_ENGINE_MAX_METADATA_SIZE  0x2000000 /* 32MB */
 #define FU_ENGINE_MAX_SIGNATURE_SIZE 0x100000  /* 1MB */
 
+#define FU_ENGINE_RELEASES_CACHE_MAX 256 /* entries */
+
 static void
 fu_engine_constructed(GObject *obj);
 static void
@@ -101,6 +106,22 @@ static gboolean
 fu_engine_backends_save_phase(FuEngine *self, GError **error);
 static gboolean
 fu_engine_emulation_load_phase(FuEngine *self, GError **error);
+static void
+fu_engine_emit_changed(FuEngine *self);
+static void
+fu_engine_update_devices_file_reset(FuEngine *self);
+static void
+fu_engine_setup_cache_invalidate(FuEngine *self);
+static void
+fu_engine_setup_cache_invalidate_device(FuEngine *self, FuDevice *device);
+static void
+fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device);
+static void
+fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
+static void
+fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
+static void
+fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
 
 struct _FuEngine {
 	GObject parent_instance;
@@ -118,6 +139,7 @@ struct _FuEngine {
 	XbQuery *query_container_checksum1; /* container checksum -> release */
 	XbQuery *query_container_checksum2; /* artifact checksum -> release */
 	XbQuery *query_tag_by_guid_version;
+	FuMetadataIndex *metadata_index; /* (nullable) */
 	guint coldplug_id;
 	FuPluginList *plugin_list;
 	GPtrArray *plugin_filter;
@@ -126,17 +148,38 @@ struct _FuEngine {
 	GHashTable *blocked_firmware;	      /* (nullable) */
 	GHashTable *emulation_phases;	      /* (element-type int GBytes) */
 	GHashTable *device_changed_allowlist; /* (element-type str int) */
+	GHashTable *releases_cache;	      /* (element-type utf8 GPtrArray) */
+	GMutex releases_cache_mutex;	      /* as devices can change in the install worker */
+	guint releases_cache_generation;
+	guint releases_cache_hits;
+	guint releases_cache_misses;
+	GHashTable *device_snapshots; /* (element-type FuDevice FwupdDevice) */
+	GMutex device_snapshots_mutex;
 	gchar *host_machine_id;
 	JcatContext *jcat_context;
 	gboolean loaded;
 	gchar *host_security_id;
 	FuSecurityAttrs *host_security_attrs;
+	GHashTable *host_security_producers; /* (element-type utf-8 FuEngineSecurityProducer) */
 	GPtrArray *local_monitors; /* (element-type GFileMonitor) */
-	GMainLoop *acquiesce_loop;
-	guint acquiesce_id;
+	GMainLoop *acquiesce_loop; /* (nullable) */
+	GSource *acquiesce_source; /* (nullable) */
 	guint acquiesce_delay;
+	GMutex acquiesce_mutex;
 	guint update_motd_id;
+	guint update_devices_id;
+	gboolean update_devices_running;
+	gboolean update_devices_pending; /* changed while a write was running */
+	gchar *update_devices_checksum;	 /* (nullable) of the last written file */
+	guint update_devices_write_cnt;
+	guint update_devices_skip_cnt;
+	gint64 update_devices_write_total; /* us */
+	guint setup_cache_save_id;
+	gboolean setup_cache_save_running;
+	gboolean setup_cache_save_pending; /* changed while a write was running */
 	FuEngineInstallPhase install_phase;
+	GAsyncQueue *plugin_events;    /* (nullable) only set when running plugins in threads */
+	GThread *plugin_events_thread; /* (nullable) the thread processing plugin_events */
 #ifdef HAVE_PASSIM
 	PassimClient *passim_client;
 #endif
@@ -158,6 +201,196 @@ static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE(FuEngine, fu_engine, G_TYPE_OBJECT)
 
+/* the GMainContext of the caller, only set on the install worker thread */
+static GPrivate fu_engine_worker_context;
+
+typedef struct {
+	FuEngine *self;
+	guint signal_idx;
+	GObject *object; /* (nullable) */
+	FwupdStatus status;
+} FuEngineDeferredSignal;
+
+static void
+fu_engine_deferred_signal_free(FuEngineDeferredSignal *helper)
+{
+	g_object_unref(helper->self);
+	if (helper->object != NULL)
+		g_object_unref(helper->object);
+	g_free(helper);
+}
+
+static void
+fu_engine_invoke_in_context(GMainContext *context,
+			    GSourceFunc func,
+			    gpointer user_data,
+			    GDestroyNotify notify)
+{
+	g_autoptr(GSource) source = g_idle_source_new();
+
+	/* use the same priority as the GTask completion so nothing gets reordered */
+	g_source_set_priority(source, G_PRIORITY_DEFAULT);
+	g_source_set_callback(source, func, user_data, notify);
+	g_source_attach(source, context);
+}
+
+static gboolean
+fu_engine_deferred_signal_cb(gpointer user_data)
+{
+	FuEngineDeferredSignal *helper = (FuEngineDeferredSignal *)user_data;
+	FuEngine *self = helper->self;
+
+	if (helper->signal_idx == SIGNAL_CHANGED) {
+		fu_engine_emit_changed(self);
+	} else if (helper->signal_idx == SIGNAL_DEVICE_CHANGED) {
+		fu_engine_emit_device_changed_safe(self, FU_DEVICE(helper->object));
+	} else if (helper->signal_idx == SIGNAL_STATUS_CHANGED) {
+		g_signal_emit(self, signals[SIGNAL_STATUS_CHANGED], 0, helper->status);
+	} else {
+		g_signal_emit(self, signals[helper->signal_idx], 0, helper->object);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+/* copy the device so that it can be exported while the install worker is changing it */
+static void
+fu_engine_device_snapshot_add(FuEngine *self, FuDevice *device)
+{
+	g_autoptr(FwupdDevice) snapshot = fwupd_device_new();
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	value = fwupd_codec_to_variant(FWUPD_CODEC(device), FWUPD_CODEC_FLAG_TRUSTED);
+	g_variant_ref_sink(value);
+	if (!fwupd_codec_from_variant(FWUPD_CODEC(snapshot), value, &error_local)) {
+		g_warning("failed to snapshot %s: %s",
+			  fu_device_get_id(device),
+			  error_local->message);
+		return;
+	}
+	locker = g_mutex_locker_new(&self->device_snapshots_mutex);
+	g_hash_table_insert(self->device_snapshots,
+			    g_object_ref(device),
+			    g_steal_pointer(&snapshot));
+}
+
+static void
+fu_engine_device_snapshot_remove(FuEngine *self, FuDevice *device)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->device_snapshots_mutex);
+	g_hash_table_remove(self->device_snapshots, device);
+}
+
+static void
+fu_engine_device_snapshots_clear(FuEngine *self)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->device_snapshots_mutex);
+	g_hash_table_remove_all(self->device_snapshots);
+}
+
+/**
+ * fu_engine_get_device_snapshot:
+ * @self: a #FuEngine
+ * @device: a #FuDevice
+ *
+ * Gets a copy of the device that is safe to export from the main context. If the device is
+ * not being changed by the install worker thread then this is the device itself.
+ *
+ * Returns: (transfer full): a #FwupdDevice
+ **/
+FwupdDevice *
+fu_engine_get_device_snapshot(FuEngine *self, FuDevice *device)
+{
+	FwupdDevice *snapshot;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(FU_IS_DEVICE(device), NULL);
+
+	locker = g_mutex_locker_new(&self->device_snapshots_mutex);
+	snapshot = g_hash_table_lookup(self->device_snapshots, device);
+	if (snapshot != NULL)
+		return g_object_ref(snapshot);
+	return FWUPD_DEVICE(g_object_ref(device));
+}
+
+/**
+ * fu_engine_get_device_snapshots:
+ * @self: a #FuEngine
+ * @devices: (element-type FuDevice): devices
+ *
+ * Gets copies of the devices that are safe to export from the main context.
+ *
+ * Returns: (transfer container) (element-type FwupdDevice): devices
+ **/
+GPtrArray *
+fu_engine_get_device_snapshots(FuEngine *self, GPtrArray *devices)
+{
+	g_autoptr(GPtrArray) snapshots =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(devices != NULL, NULL);
+
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_ptr_array_add(snapshots, fu_engine_get_device_snapshot(self, device));
+	}
+	return g_steal_pointer(&snapshots);
+}
+
+/* read-only methods are not serialized with the install worker thread, so must not read the
+ * devices it is changing */
+static gboolean
+fu_engine_device_check_not_busy(FuEngine *self, FuDevice *device, GError **error)
+{
+	FwupdDevice *snapshot;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (g_private_get(&fu_engine_worker_context) != NULL)
+		return TRUE;
+	locker = g_mutex_locker_new(&self->device_snapshots_mutex);
+	snapshot = g_hash_table_lookup(self->device_snapshots, device);
+	if (snapshot != NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_BUSY,
+			    "%s is being updated",
+			    fwupd_device_get_id(snapshot));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* signals are only emitted in the main context, so if called from the install worker thread
+ * this schedules the emission in the caller context and returns %TRUE */
+static gboolean
+fu_engine_defer_signal(FuEngine *self, guint signal_idx, gpointer object, FwupdStatus status)
+{
+	GMainContext *context = g_private_get(&fu_engine_worker_context);
+	FuEngineDeferredSignal *helper;
+
+	if (context == NULL)
+		return FALSE;
+
+	/* the main context only sees the device as it was when the signal was emitted */
+	if (signal_idx == SIGNAL_DEVICE_CHANGED || signal_idx == SIGNAL_DEVICE_ADDED)
+		fu_engine_device_snapshot_add(self, FU_DEVICE(object));
+	else if (signal_idx == SIGNAL_DEVICE_REMOVED)
+		fu_engine_device_snapshot_remove(self, FU_DEVICE(object));
+	helper = g_new0(FuEngineDeferredSignal, 1);
+	helper->self = g_object_ref(self);
+	helper->signal_idx = signal_idx;
+	helper->object = object != NULL ? g_object_ref(object) : NULL;
+	helper->status = status;
+	fu_engine_invoke_in_context(context,
+				    fu_engine_deferred_signal_cb,
+				    helper,
+				    (GDestroyNotify)fu_engine_deferred_signal_free);
+	return TRUE;
+}
+
 gboolean
 fu_engine_get_loaded(FuEngine *self)
 {
@@ -193,13 +426,139 @@ fu_engine_update_motd_reset(FuEngine *self)
 }
 
 static void
-fu_engine_emit_changed(FuEngine *self)
+fu_engine_update_devices_file_stats(FuEngine *self, const gchar *checksum, gint64 duration)
+{
+	/* identical content, so the file was not rewritten */
+	if (g_strcmp0(checksum, self->update_devices_checksum) == 0) {
+		self->update_devices_skip_cnt++;
+		g_debug("devices.json unchanged, skipped %u times", self->update_devices_skip_cnt);
+		return;
+	}
+	self->update_devices_write_cnt++;
+	self->update_devices_write_total += duration;
+	g_free(self->update_devices_checksum);
+	self->update_devices_checksum = g_strdup(checksum);
+	g_debug("wrote devices.json in %.1fms, %u writes taking %.1fms in total",
+		(gdouble)duration / 1000.f,
+		self->update_devices_write_cnt,
+		(gdouble)self->update_devices_write_total / 1000.f);
+}
+
+static gboolean
+fu_engine_update_devices_file(FuEngine *self, GError **error)
 {
+	gint64 start = g_get_monotonic_time();
+	g_autofree gchar *checksum = NULL;
+	g_autoptr(JsonNode) root = fu_engine_devices_file_build(self);
+
+	checksum = fu_engine_devices_file_write(root, self->update_devices_checksum, error);
+	if (checksum == NULL)
+		return FALSE;
+	fu_engine_update_devices_file_stats(self, checksum, g_get_monotonic_time() - start);
+	return TRUE;
+}
+
+typedef struct {
+	JsonNode *root;
+	gchar *checksum_old;
+	gint64 duration; /* us */
+} FuEngineUpdateDevicesHelper;
+
+static void
+fu_engine_update_devices_helper_free(FuEngineUpdateDevicesHelper *helper)
+{
+	json_node_unref(helper->root);
+	g_free(helper->checksum_old);
+	g_free(helper);
+}
+
+static void
+fu_engine_update_devices_file_thread_cb(GTask *task,
+					gpointer source_object,
+					gpointer task_data,
+					GCancellable *cancellable)
+{
+	FuEngineUpdateDevicesHelper *helper = (FuEngineUpdateDevicesHelper *)task_data;
+	gint64 start = g_get_monotonic_time();
+	gchar *checksum;
+	GError *error = NULL;
+
+	checksum = fu_engine_devices_file_write(helper->root, helper->checksum_old, &error);
+	helper->duration = g_get_monotonic_time() - start;
+	if (checksum == NULL) {
+		g_task_return_error(task, error);
+		return;
+	}
+	g_task_return_pointer(task, checksum, g_free);
+}
+
+static void
+fu_engine_update_devices_file_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(source_object);
+	FuEngineUpdateDevicesHelper *helper = g_task_get_task_data(G_TASK(res));
+	g_autofree gchar *checksum = NULL;
 	g_autoptr(GError) error = NULL;
 
+	self->update_devices_running = FALSE;
+	checksum = g_task_propagate_pointer(G_TASK(res), &error);
+	if (checksum == NULL)
+		g_info("failed to update list of devices: %s", error->message);
+	else
+		fu_engine_update_devices_file_stats(self, checksum, helper->duration);
+
+	/* devices changed while we were writing */
+	if (self->update_devices_pending) {
+		self->update_devices_pending = FALSE;
+		fu_engine_update_devices_file_reset(self);
+	}
+}
+
+static gboolean
+fu_engine_update_devices_file_timeout_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	FuEngineUpdateDevicesHelper *helper;
+	g_autoptr(GTask) task = NULL;
+
+	self->update_devices_id = 0;
+
+	/* only one writer at a time, try again when it finishes */
+	if (self->update_devices_running) {
+		self->update_devices_pending = TRUE;
+		return G_SOURCE_REMOVE;
+	}
+
+	/* the device objects are only safe to read from the main thread */
+	helper = g_new0(FuEngineUpdateDevicesHelper, 1);
+	helper->root = fu_engine_devices_file_build(self);
+	helper->checksum_old = g_strdup(self->update_devices_checksum);
+	task = g_task_new(self, NULL, fu_engine_update_devices_file_cb, NULL);
+	g_task_set_task_data(task, helper, (GDestroyNotify)fu_engine_update_devices_helper_free);
+	self->update_devices_running = TRUE;
+	g_task_run_in_thread(task, fu_engine_update_devices_file_thread_cb);
+	return G_SOURCE_REMOVE;
+}
+
+/* coalesce bursts of changes, e.g. during coldplug, into one write */
+static void
+fu_engine_update_devices_file_reset(FuEngine *self)
+{
+	if (self->update_devices_id != 0)
+		g_source_remove(self->update_devices_id);
+	self->update_devices_id = g_timeout_add(FU_ENGINE_UPDATE_DEVICES_DELAY,
+						fu_engine_update_devices_file_timeout_cb,
+						self);
+}
+
+static void
+fu_engine_emit_changed(FuEngine *self)
+{
 	/* do nothing */
 	if (!self->loaded)
 		return;
+	if (fu_engine_defer_signal(self, SIGNAL_CHANGED, NULL, FWUPD_STATUS_UNKNOWN))
+		return;
 
 	g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
 	fu_engine_idle_reset(self);
@@ -209,8 +568,55 @@ fu_engine_emit_changed(FuEngine *self)
 		fu_engine_update_motd_reset(self);
 
 	/* update the list of devices */
-	if (!fu_engine_update_devices_file(self, &error))
-		g_info("failed to update list of devices: %s", error->message);
+	fu_engine_update_devices_file_reset(self);
+}
+
+/* the cached attributes added by one device or plugin */
+typedef struct {
+	FuSecurityAttrs *attrs;
+	gchar *plugin;	    /* (nullable) for devices, the plugin that added it */
+	gint64 duration;     /* µs */
+	gboolean dependent;  /* looked at attributes from other producers */
+	gboolean recomputed; /* in the last pass, rather than copied from the cache */
+} FuEngineSecurityProducer;
+
+static void
+fu_engine_security_producer_free(FuEngineSecurityProducer *producer)
+{
+	g_object_unref(producer->attrs);
+	g_free(producer->plugin);
+	g_free(producer);
+}
+
+static gboolean
+fu_engine_security_producer_is_plugin_cb(gpointer key, gpointer value, gpointer user_data)
+{
+	return g_str_has_prefix((const gchar *)key, "plugin:");
+}
+
+/* everything needs to be recomputed, e.g. the metadata changed */
+static void
+fu_engine_security_attrs_invalidate(FuEngine *self)
+{
+	g_hash_table_remove_all(self->host_security_producers);
+	g_clear_pointer(&self->host_security_id, g_free);
+}
+
+static void
+fu_engine_security_attrs_invalidate_device(FuEngine *self, FuDevice *device)
+{
+	g_autofree gchar *key = g_strdup_printf("device:%s", fu_device_get_id(device));
+	g_hash_table_remove(self->host_security_producers, key);
+	g_clear_pointer(&self->host_security_id, g_free);
+}
+
+static void
+fu_engine_security_attrs_invalidate_plugins(FuEngine *self)
+{
+	g_hash_table_foreach_remove(self->host_security_producers,
+				    fu_engine_security_producer_is_plugin_cb,
+				    NULL);
+	g_clear_pointer(&self->host_security_id, g_free);
 }
 
 static void
@@ -219,9 +625,11 @@ fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device)
 	/* do nothing */
 	if (!self->loaded)
 		return;
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_CHANGED, device, FWUPD_STATUS_UNKNOWN))
+		return;
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate_device(self, device);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_CHANGED], 0, device);
 }
 
@@ -251,9 +659,37 @@ static void
 fu_engine_set_status(FuEngine *self, FwupdStatus status)
 {
 	/* emit changed */
+	if (fu_engine_defer_signal(self, SIGNAL_STATUS_CHANGED, NULL, status))
+		return;
 	g_signal_emit(self, signals[SIGNAL_STATUS_CHANGED], 0, status);
 }
 
+static void
+fu_engine_releases_cache_invalidate(FuEngine *self, const gchar *reason)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->releases_cache_mutex);
+
+	/* also stops any results being calculated right now from being added */
+	self->releases_cache_generation++;
+	if (g_hash_table_size(self->releases_cache) == 0)
+		return;
+	g_debug("invalidating release cache: %s", reason);
+	g_hash_table_remove_all(self->releases_cache);
+}
+
+static void
+fu_engine_device_version_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
+{
+	/* requirements can depend on the version of other devices too */
+	fu_engine_releases_cache_invalidate(self, "device version changed");
+}
+
+static void
+fu_engine_device_setup_cache_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
+{
+	fu_engine_setup_cache_invalidate_device(self, device);
+}
+
 static void
 fu_engine_generic_notify_cb(FuDevice *device, GParamSpec *pspec, FuEngine *self)
 {
@@ -335,6 +771,8 @@ static void
 fu_engine_device_request_cb(FuDevice *device, FwupdRequest *request, FuEngine *self)
 {
 	g_info("Emitting DeviceRequest('Message'='%s')", fwupd_request_get_message(request));
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_REQUEST, request, FWUPD_STATUS_UNKNOWN))
+		return;
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REQUEST], 0, request);
 }
 
@@ -353,7 +791,29 @@ fu_engine_watch_device(FuEngine *self, FuDevice *device)
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_generic_notify_cb, self);
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_history_notify_cb, self);
 		g_signal_handlers_disconnect_by_func(device_old, fu_engine_device_request_cb, self);
+		g_signal_handlers_disconnect_by_func(device_old,
+						     fu_engine_device_version_notify_cb,
+						     self);
+		g_signal_handlers_disconnect_by_func(device_old,
+						     fu_engine_device_setup_cache_notify_cb,
+						     self);
 	}
+	g_signal_connect(FU_DEVICE(device),
+			 "notify::version",
+			 G_CALLBACK(fu_engine_device_version_notify_cb),
+			 self);
+	g_signal_connect(FU_DEVICE(device),
+			 "notify::version-bootloader",
+			 G_CALLBACK(fu_engine_device_version_notify_cb),
+			 self);
+	g_signal_connect(FU_DEVICE(device),
+			 "notify::version",
+			 G_CALLBACK(fu_engine_device_setup_cache_notify_cb),
+			 self);
+	g_signal_connect(FU_DEVICE(device),
+			 "notify::flags",
+			 G_CALLBACK(fu_engine_device_setup_cache_notify_cb),
+			 self);
 	g_signal_connect(FU_DEVICE(device),
 			 "notify::flags",
 			 G_CALLBACK(fu_engine_generic_notify_cb),
@@ -450,32 +910,60 @@ static gboolean
 fu_engine_acquiesce_timeout_cb(gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->acquiesce_mutex);
+
+	/* reset from the main context while this was being dispatched */
+	if (self->acquiesce_source != g_main_current_source())
+		return G_SOURCE_REMOVE;
 	g_info("system acquiesced after %ums", self->acquiesce_delay);
 	g_main_loop_quit(self->acquiesce_loop);
-	self->acquiesce_id = 0;
+	g_clear_pointer(&self->acquiesce_source, g_source_unref);
 	return G_SOURCE_REMOVE;
 }
 
+/* called with acquiesce_mutex held */
+static void
+fu_engine_acquiesce_schedule(FuEngine *self)
+{
+	if (self->acquiesce_source != NULL) {
+		g_source_destroy(self->acquiesce_source);
+		g_source_unref(self->acquiesce_source);
+	}
+	self->acquiesce_source = g_timeout_source_new(self->acquiesce_delay);
+	g_source_set_callback(self->acquiesce_source, fu_engine_acquiesce_timeout_cb, self, NULL);
+	g_source_attach(self->acquiesce_source, g_main_loop_get_context(self->acquiesce_loop));
+}
+
 static void
 fu_engine_acquiesce_reset(FuEngine *self)
 {
-	if (!g_main_loop_is_running(self->acquiesce_loop))
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->acquiesce_mutex);
+
+	if (self->acquiesce_loop == NULL)
 		return;
 	g_info("resetting system acquiesce timeout");
-	if (self->acquiesce_id != 0)
-		g_source_remove(self->acquiesce_id);
-	self->acquiesce_id =
-	    g_timeout_add(self->acquiesce_delay, fu_engine_acquiesce_timeout_cb, self);
+	fu_engine_acquiesce_schedule(self);
 }
 
 static void
 fu_engine_wait_for_acquiesce(FuEngine *self, guint acquiesce_delay)
 {
+	g_autoptr(GMainLoop) loop = NULL;
+
 	if (acquiesce_delay == 0)
 		return;
+
+	/* the device list is modified from the main context, but this may be the install worker */
+	loop = g_main_loop_new(g_main_context_get_thread_default(), FALSE);
+	g_mutex_lock(&self->acquiesce_mutex);
 	self->acquiesce_delay = acquiesce_delay;
-	self->acquiesce_id = g_timeout_add(acquiesce_delay, fu_engine_acquiesce_timeout_cb, self);
-	g_main_loop_run(self->acquiesce_loop);
+	self->acquiesce_loop = g_main_loop_ref(loop);
+	fu_engine_acquiesce_schedule(self);
+	g_mutex_unlock(&self->acquiesce_mutex);
+	g_main_loop_run(loop);
+	g_mutex_lock(&self->acquiesce_mutex);
+	g_clear_pointer(&self->acquiesce_loop, g_main_loop_unref);
+	g_mutex_unlock(&self->acquiesce_mutex);
 }
 
 static void
@@ -493,6 +981,7 @@ fu_engine_ensure_context_flag_save_events(FuEngine *self)
 static void
 fu_engine_device_added_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	fu_engine_releases_cache_invalidate(self, "device added");
 	fu_engine_watch_device(self, device);
 	fu_engine_ensure_device_problem_priority(self, device);
 	fu_engine_ensure_device_power_inhibit(self, device);
@@ -500,6 +989,8 @@ fu_engine_device_added_cb(FuDeviceList *device_list, FuDevice *device, FuEngine
 	fu_engine_ensure_device_display_required_inhibit(self, device);
 	fu_engine_ensure_device_system_inhibit(self, device);
 	fu_engine_acquiesce_reset(self);
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_ADDED, device, FWUPD_STATUS_UNKNOWN))
+		return;
 	g_signal_emit(self, signals[SIGNAL_DEVICE_ADDED], 0, device);
 }
 
@@ -516,15 +1007,19 @@ fu_engine_device_runner_device_removed(FuEngine *self, FuDevice *device)
 static void
 fu_engine_device_removed_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	fu_engine_releases_cache_invalidate(self, "device removed");
 	fu_engine_device_runner_device_removed(self, device);
 	fu_engine_acquiesce_reset(self);
 	g_signal_handlers_disconnect_by_data(device, self);
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_REMOVED, device, FWUPD_STATUS_UNKNOWN))
+		return;
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REMOVED], 0, device);
 }
 
 static void
 fu_engine_device_changed_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
+	fu_engine_releases_cache_invalidate(self, "device replaced");
 	fu_engine_watch_device(self, device);
 	fu_engine_emit_device_changed(self, fu_device_get_id(device));
 	fu_engine_acquiesce_reset(self);
@@ -715,6 +1210,11 @@ static XbNode *
 fu_engine_get_release_for_checksum(FuEngine *self, const gchar *csum)
 {
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+
+	/* use the precomputed index if available */
+	if (self->metadata_index != NULL)
+		return fu_metadata_index_get_release_by_checksum(self->metadata_index, csum);
+
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, csum, NULL);
 	if (self->query_container_checksum1 != NULL) {
 		g_autoptr(XbNode) rel =
@@ -846,6 +1346,7 @@ fu_engine_modify_config(FuEngine *self,
 		    "P2pPolicy",
 		    "ReleaseDedupe",
 		    "ReleasePriority",
+		    "SetupCache",
 		    "ShowDevicePrivate",
 		    "TestDevices",
 		    "TrustedReports",
@@ -943,6 +1444,7 @@ fu_engine_modify_single_bios_setting(FuEngine *self,
 	}
 	if (!fwupd_bios_setting_write_value(attr, value, error))
 		return FALSE;
+	fu_engine_releases_cache_invalidate(self, "BIOS setting changed");
 	if (force_ro)
 		fwupd_bios_setting_set_read_only(attr, TRUE);
 	return TRUE;
@@ -1100,6 +1602,8 @@ fu_engine_emit_device_request_replug_and_install(FuEngine *self, FuDevice *devic
 	fwupd_request_add_flag(request, FWUPD_REQUEST_FLAG_ALLOW_GENERIC_MESSAGE);
 	fwupd_request_set_message(request,
 				  "Unplug and replug the device, then install the firmware.");
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_REQUEST, request, FWUPD_STATUS_UNKNOWN))
+		return;
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REQUEST], 0, request);
 }
 
@@ -1114,6 +1618,8 @@ fu_engine_emit_device_request_restart_daemon(FuEngine *self, FuDevice *device)
 	fwupd_request_set_message(
 	    request,
 	    "Please restart the fwupd service so device enumeration is recorded.");
+	if (fu_engine_defer_signal(self, SIGNAL_DEVICE_REQUEST, request, FWUPD_STATUS_UNKNOWN))
+		return;
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REQUEST], 0, request);
 }
 
@@ -1366,6 +1872,10 @@ fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 	g_autoptr(XbNode) component = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
+	/* use the precomputed index if available */
+	if (self->metadata_index != NULL)
+		return fu_metadata_index_get_component_by_guid(self->metadata_index, guid);
+
 	/* no components in silo */
 	if (self->query_component_by_guid == NULL)
 		return NULL;
@@ -2321,6 +2831,234 @@ fu_engine_install_releases(FuEngine *self,
 	return TRUE;
 }
 
+typedef struct {
+	FuEngineRequest *request;
+	GPtrArray *releases; /* (element-type FuRelease) */
+	FuCabinet *cabinet;
+	FuProgress *progress; /* only used from @context */
+	FwupdInstallFlags flags;
+	GMainContext *context;
+} FuEngineInstallHelper;
+
+static void
+fu_engine_install_helper_free(FuEngineInstallHelper *helper)
+{
+	g_object_unref(helper->request);
+	g_ptr_array_unref(helper->releases);
+	g_object_unref(helper->cabinet);
+	g_object_unref(helper->progress);
+	g_main_context_unref(helper->context);
+	g_free(helper);
+}
+
+typedef struct {
+	FuProgress *progress;
+	guint percentage; /* or G_MAXUINT for a status change */
+	FwupdStatus status;
+} FuEngineProgressHelper;
+
+static void
+fu_engine_progress_helper_free(FuEngineProgressHelper *helper)
+{
+	g_object_unref(helper->progress);
+	g_free(helper);
+}
+
+static gboolean
+fu_engine_install_progress_cb(gpointer user_data)
+{
+	FuEngineProgressHelper *helper = (FuEngineProgressHelper *)user_data;
+	if (helper->percentage == G_MAXUINT)
+		fu_progress_set_status(helper->progress, helper->status);
+	else
+		fu_progress_set_percentage(helper->progress, helper->percentage);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_engine_install_progress_forward(FuEngineInstallHelper *helper,
+				   guint percentage,
+				   FwupdStatus status)
+{
+	FuEngineProgressHelper *helper_progress = g_new0(FuEngineProgressHelper, 1);
+	helper_progress->progress = g_object_ref(helper->progress);
+	helper_progress->percentage = percentage;
+	helper_progress->status = status;
+	fu_engine_invoke_in_context(helper->context,
+				    fu_engine_install_progress_cb,
+				    helper_progress,
+				    (GDestroyNotify)fu_engine_progress_helper_free);
+}
+
+static void
+fu_engine_install_progress_percentage_changed_cb(FuProgress *progress,
+						 guint percentage,
+						 FuEngineInstallHelper *helper)
+{
+	fu_engine_install_progress_forward(helper, percentage, FWUPD_STATUS_UNKNOWN);
+}
+
+static void
+fu_engine_install_progress_status_changed_cb(FuProgress *progress,
+					     FwupdStatus status,
+					     FuEngineInstallHelper *helper)
+{
+	fu_engine_install_progress_forward(helper, G_MAXUINT, status);
+}
+
+static void
+fu_engine_install_releases_thread_cb(GTask *task,
+				     gpointer source_object,
+				     gpointer task_data,
+				     GCancellable *cancellable)
+{
+	FuEngine *self = FU_ENGINE(source_object);
+	FuEngineInstallHelper *helper = (FuEngineInstallHelper *)task_data;
+	gboolean ret;
+	g_autoptr(GMainContext) context = g_main_context_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+	/* anything this thread waits for is dispatched here, and everything the caller sees
+	 * is deferred back into the caller context */
+	g_main_context_push_thread_default(context);
+	g_private_set(&fu_engine_worker_context, helper->context);
+	fu_progress_set_profile(progress, fu_progress_get_profile(helper->progress));
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_engine_install_progress_percentage_changed_cb),
+			 helper);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "status-changed",
+			 G_CALLBACK(fu_engine_install_progress_status_changed_cb),
+			 helper);
+	ret = fu_engine_install_releases(self,
+					 helper->request,
+					 helper->releases,
+					 helper->cabinet,
+					 progress,
+					 helper->flags,
+					 &error);
+	g_private_set(&fu_engine_worker_context, NULL);
+	g_main_context_pop_thread_default(context);
+
+	/* nothing is changing the devices now */
+	fu_engine_device_snapshots_clear(self);
+	if (!ret) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	g_task_return_boolean(task, TRUE);
+}
+
+static gboolean
+fu_engine_install_releases_needs_main_thread(GPtrArray *releases)
+{
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		FuDevice *device = fu_release_get_device(release);
+		if (fu_device_has_private_flag(device, FU_DEVICE_PRIVATE_FLAG_INSTALL_MAIN_THREAD))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * fu_engine_install_releases_async:
+ * @self: a #FuEngine
+ * @request: a #FuEngineRequest
+ * @releases: (element-type FuRelease): releases to install
+ * @cabinet: a #FuCabinet
+ * @progress: a #FuProgress
+ * @flags: install flags, e.g. %FWUPD_INSTALL_FLAG_ALLOW_OLDER
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Installs the releases like fu_engine_install_releases(), but using a worker thread so that the
+ * calling main context is free to service other requests while the devices are being flashed.
+ *
+ * All engine signals and any changes to @progress are delivered in the calling main context.
+ **/
+void
+fu_engine_install_releases_async(FuEngine *self,
+				 FuEngineRequest *request,
+				 GPtrArray *releases,
+				 FuCabinet *cabinet,
+				 FuProgress *progress,
+				 FwupdInstallFlags flags,
+				 GCancellable *cancellable,
+				 GAsyncReadyCallback callback,
+				 gpointer callback_data)
+{
+	FuEngineInstallHelper *helper;
+	g_autoptr(GTask) task = g_task_new(self, cancellable, callback, callback_data);
+
+	g_return_if_fail(FU_IS_ENGINE(self));
+	g_return_if_fail(FU_IS_ENGINE_REQUEST(request));
+	g_return_if_fail(releases != NULL);
+	g_return_if_fail(FU_IS_CABINET(cabinet));
+	g_return_if_fail(FU_IS_PROGRESS(progress));
+
+	/* some plugins iterate the default main context themselves */
+	if (fu_engine_install_releases_needs_main_thread(releases)) {
+		g_autoptr(GError) error = NULL;
+		if (!fu_engine_install_releases(self,
+						request,
+						releases,
+						cabinet,
+						progress,
+						flags,
+						&error)) {
+			g_task_return_error(task, g_steal_pointer(&error));
+			return;
+		}
+		g_task_return_boolean(task, TRUE);
+		return;
+	}
+
+	/* the worker changes these devices, so only export copies until the install is done */
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		FuDevice *device = fu_release_get_device(release);
+		GPtrArray *children = fu_device_get_children(device);
+		fu_engine_device_snapshot_add(self, device);
+		if (fu_device_get_parent(device) != NULL)
+			fu_engine_device_snapshot_add(self, fu_device_get_parent(device));
+		for (guint j = 0; j < children->len; j++)
+			fu_engine_device_snapshot_add(self, g_ptr_array_index(children, j));
+	}
+
+	helper = g_new0(FuEngineInstallHelper, 1);
+	helper->request = g_object_ref(request);
+	helper->releases = g_ptr_array_ref(releases);
+	helper->cabinet = g_object_ref(cabinet);
+	helper->progress = g_object_ref(progress);
+	helper->flags = flags;
+	helper->context = g_main_context_ref_thread_default();
+	g_task_set_task_data(task, helper, (GDestroyNotify)fu_engine_install_helper_free);
+	g_task_run_in_thread(task, fu_engine_install_releases_thread_cb);
+}
+
+/**
+ * fu_engine_install_releases_finish:
+ * @self: a #FuEngine
+ * @res: a #GAsyncResult
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of fu_engine_install_releases_async().
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_install_releases_finish(FuEngine *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(g_task_is_valid(res, self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return g_task_propagate_boolean(G_TASK(res), error);
+}
+
 static void
 fu_engine_update_release_integrity(FuEngine *self, FuRelease *release, const gchar *key)
 {
@@ -2604,7 +3342,34 @@ GPtrArray *
 fu_engine_get_plugins(FuEngine *self)
 {
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
-	return fu_plugin_list_get_all(self->plugin_list);
+	return fu_plugin_list_get_all(self->plugin_list);
+}
+
+/**
+ * fu_engine_get_plugin_statistics:
+ * @self: a #FuEngine
+ *
+ * Gets the timing statistics for all the plugins.
+ *
+ * Returns: (transfer floating): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fu_engine_get_plugin_statistics(FuEngine *self)
+{
+	GPtrArray *plugins;
+	GVariantBuilder builder;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+
+	plugins = fu_plugin_list_get_all(self->plugin_list);
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		fu_plugin_add_statistics(plugin, &builder);
+	}
+	return g_variant_builder_end(&builder);
 }
 
 /**
@@ -3244,6 +4009,7 @@ fu_engine_activate(FuEngine *self, const gchar *device_id, FuProgress *progress,
 	    fu_plugin_list_find_by_name(self->plugin_list, fu_device_get_plugin(device), error);
 	if (plugin == NULL)
 		return FALSE;
+	fu_engine_setup_cache_invalidate(self);
 	if (!fu_plugin_runner_activate(plugin, device, progress, error))
 		return FALSE;
 
@@ -3490,6 +4256,9 @@ fu_engine_install_blob(FuEngine *self,
 		return FALSE;
 	fu_progress_step_done(progress);
 
+	/* the device will have to be set up again */
+	fu_engine_setup_cache_invalidate(self);
+
 	/* plugins can set FWUPD_DEVICE_FLAG_ANOTHER_WRITE_REQUIRED to run again, but they
 	 * must return TRUE rather than an error */
 	do {
@@ -3664,14 +4433,50 @@ fu_engine_get_item_by_id_fallback_history(FuEngine *self, const gchar *id, GErro
 	return NULL;
 }
 
+static void
+fu_engine_ensure_metadata_index(FuEngine *self, FuEngineLoadFlags flags)
+{
+	g_autoptr(FuMetadataIndex) metadata_index = fu_metadata_index_new();
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	/* reuse the index saved alongside metadata.xmlb if it is for the same silo */
+	if ((flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) == 0) {
+		g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+		g_autofree gchar *fn = g_build_filename(cachedirpkg, "metadata.idx", NULL);
+		g_autoptr(GError) error_load = NULL;
+
+		file = g_file_new_for_path(fn);
+		if (fu_metadata_index_load_file(metadata_index, self->silo, file, &error_load)) {
+			self->metadata_index = g_steal_pointer(&metadata_index);
+			return;
+		}
+		g_debug("rebuilding %s: %s", fn, error_load->message);
+	}
+
+	/* build from the silo, falling back to the XPath queries on failure */
+	if (!fu_metadata_index_build(metadata_index, self->silo, &error_local)) {
+		g_warning("failed to build metadata index: %s", error_local->message);
+		return;
+	}
+	if (file != NULL && (flags & FU_ENGINE_LOAD_FLAG_READONLY) == 0) {
+		if (!fu_metadata_index_save_file(metadata_index, file, &error_local))
+			g_warning("failed to save metadata index: %s", error_local->message);
+	}
+	self->metadata_index = g_steal_pointer(&metadata_index);
+}
+
 static gboolean
-fu_engine_create_silo_index(FuEngine *self, GError **error)
+fu_engine_create_silo_index(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 {
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GError) error_container_checksum1 = NULL;
 	g_autoptr(GError) error_container_checksum2 = NULL;
 	g_autoptr(GError) error_tag_by_guid_version = NULL;
 
+	/* the old index refers to nodes in the old silo */
+	g_clear_object(&self->metadata_index);
+
 	/* print what we've got */
 	components = xb_silo_query(self->silo, "components/component[@type='firmware']", 0, NULL);
 	if (components == NULL)
@@ -3745,6 +4550,9 @@ fu_engine_create_silo_index(FuEngine *self, GError **error)
 	if (self->query_tag_by_guid_version == NULL)
 		g_debug("ignoring prepared query: %s", error_tag_by_guid_version->message);
 
+	/* GUID and checksum lookups without evaluating XPath */
+	fu_engine_ensure_metadata_index(self, flags);
+
 	/* success */
 	return TRUE;
 }
@@ -3757,7 +4565,8 @@ fu_engine_set_silo(FuEngine *self, XbSilo *silo)
 	g_return_if_fail(FU_IS_ENGINE(self));
 	g_return_if_fail(XB_IS_SILO(silo));
 	g_set_object(&self->silo, silo);
-	if (!fu_engine_create_silo_index(self, &error_local))
+	fu_engine_releases_cache_invalidate(self, "metadata reloaded");
+	if (!fu_engine_create_silo_index(self, FU_ENGINE_LOAD_FLAG_NO_CACHE, &error_local))
 		g_warning("failed to create indexes: %s", error_local->message);
 }
 
@@ -4004,6 +4813,8 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 	g_autoptr(XbBuilder) builder = xb_builder_new();
 
 	/* clear existing silo */
+	fu_engine_releases_cache_invalidate(self, "metadata reloaded");
+	g_clear_object(&self->metadata_index);
 	g_clear_object(&self->silo);
 
 #ifdef SOURCE_VERSION
@@ -4118,7 +4929,7 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 	}
 
 	/* success */
-	return fu_engine_create_silo_index(self, error);
+	return fu_engine_create_silo_index(self, flags, error);
 }
 
 static void
@@ -4143,6 +4954,7 @@ fu_engine_config_changed_cb(FuEngineConfig *config, FuEngine *self)
 	GPtrArray *remotes = fu_remote_list_get_all(self->remote_list);
 
 	fu_idle_set_timeout(self->idle, fu_engine_config_get_idle_timeout(config));
+	fu_engine_releases_cache_invalidate(self, "config changed");
 
 	/* allow changing the hardcoded ESP location */
 	if (fu_engine_config_get_esp_location(config) != NULL)
@@ -4166,7 +4978,7 @@ fu_engine_metadata_changed(FuEngine *self)
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate(self);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
@@ -4431,7 +5243,7 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_security_attrs_invalidate(self);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
@@ -4565,7 +5377,9 @@ fu_engine_get_result_from_component(FuEngine *self,
 		if (guid == NULL)
 			continue;
 		device = fu_device_list_get_by_guid(self->device_list, guid, NULL);
-		if (device != NULL) {
+		if (device != NULL && !fu_engine_device_check_not_busy(self, device, NULL)) {
+			fu_device_inhibit(dev, "busy", "Device is being updated");
+		} else if (device != NULL) {
 			fu_device_incorporate(dev, device, FU_DEVICE_INCORPORATE_FLAG_ALL);
 		} else {
 			fu_device_inhibit(dev, "not-found", "Device was not found");
@@ -5242,13 +6056,213 @@ fu_engine_get_branch_fallback(const gchar *nullable_branch)
 	return nullable_branch;
 }
 
+static GPtrArray *
+fu_engine_get_releases_for_device_guids(FuEngine *self, FuEngineRequest *request, FuDevice *device)
+{
+	GPtrArray *device_guids = fu_device_get_guids(device);
+	g_autoptr(GPtrArray) releases =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	/* get all the components that provide any of these GUIDs */
+	for (guint j = 0; j < device_guids->len; j++) {
+		const gchar *guid = g_ptr_array_index(device_guids, j);
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GPtrArray) components = NULL;
+		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+
+		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
+		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
+		components = xb_silo_query_with_context(self->silo,
+							self->query_component_by_guid,
+							&context,
+							&error_local);
+		if (components == NULL) {
+			g_debug("%s was not found: %s", guid, error_local->message);
+			continue;
+		}
+
+		/* find all the releases that pass all the requirements */
+		g_debug("%s matched %u components", guid, components->len);
+		for (guint i = 0; i < components->len; i++) {
+			XbNode *component = XB_NODE(g_ptr_array_index(components, i));
+			g_autoptr(GError) error_tmp = NULL;
+			if (!fu_engine_add_releases_for_device_component(self,
+									 request,
+									 device,
+									 component,
+									 releases,
+									 &error_tmp)) {
+				g_debug("%s", error_tmp->message);
+				continue;
+			}
+		}
+		g_debug("%s matched %u releases", guid, releases->len);
+
+		/* if we're only checking for SUPPORTED then *any* release is good enough */
+		if (fu_engine_request_has_flag(request, FU_ENGINE_REQUEST_FLAG_ANY_RELEASE) &&
+		    releases->len > 0)
+			break;
+	}
+	return g_steal_pointer(&releases);
+}
+
+static gchar *
+fu_engine_releases_cache_key(FuEngine *self, FuEngineRequest *request, FuDevice *device)
+{
+	const gchar *values[] = {
+	    fu_device_get_version(device),
+	    fu_device_get_version_lowest(device),
+	    fu_device_get_version_bootloader(device),
+	    fu_device_get_branch(device),
+	    fu_engine_request_get_locale(request),
+	};
+	GString *str = g_string_new(fu_device_get_id(device));
+
+	for (guint i = 0; i < G_N_ELEMENTS(values); i++)
+		g_string_append_printf(str, "|%s", values[i] != NULL ? values[i] : "");
+	g_string_append_printf(
+	    str,
+	    "|%" G_GUINT64_FORMAT "|%" G_GUINT64_FORMAT "|%u|%u",
+	    fu_device_get_flags(device),
+	    fu_engine_request_get_feature_flags(request),
+	    fu_engine_request_has_flag(request, FU_ENGINE_REQUEST_FLAG_NO_REQUIREMENTS),
+	    fu_engine_request_has_flag(request, FU_ENGINE_REQUEST_FLAG_ANY_RELEASE));
+	return g_string_free(str, FALSE);
+}
+
+/* the request and device are not shared with the cached releases */
+static GPtrArray *
+fu_engine_releases_cache_copy(GPtrArray *releases,
+			      FuEngineRequest *request,
+			      FuDevice *device,
+			      GError **error)
+{
+	g_autoptr(GPtrArray) releases_new =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		g_autoptr(FuRelease) release_new = fu_release_copy(release, error);
+		if (release_new == NULL)
+			return NULL;
+		fu_release_set_request(release_new, request);
+		if (device != NULL)
+			fu_release_set_device(release_new, device);
+		g_ptr_array_add(releases_new, g_steal_pointer(&release_new));
+	}
+	return g_steal_pointer(&releases_new);
+}
+
+static GPtrArray *
+fu_engine_releases_cache_lookup(FuEngine *self,
+				FuEngineRequest *request,
+				FuDevice *device,
+				const gchar *key,
+				guint *generation)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->releases_cache_mutex);
+	g_autoptr(GPtrArray) releases = NULL;
+	g_autoptr(GPtrArray) releases_new = NULL;
+
+	*generation = self->releases_cache_generation;
+	releases = g_hash_table_lookup(self->releases_cache, key);
+	if (releases != NULL) {
+		g_ptr_array_ref(releases);
+		self->releases_cache_hits++;
+	} else {
+		self->releases_cache_misses++;
+	}
+	g_debug("release cache %s for %s, hit ratio %u/%u",
+		releases != NULL ? "hit" : "miss",
+		key,
+		self->releases_cache_hits,
+		self->releases_cache_hits + self->releases_cache_misses);
+	g_clear_pointer(&locker, g_mutex_locker_free);
+	if (releases == NULL)
+		return NULL;
+
+	releases_new = fu_engine_releases_cache_copy(releases, request, device, &error_local);
+	if (releases_new == NULL) {
+		g_warning("failed to copy cached releases: %s", error_local->message);
+		return NULL;
+	}
+	return g_steal_pointer(&releases_new);
+}
+
+static void
+fu_engine_releases_cache_insert(FuEngine *self,
+				const gchar *key,
+				guint generation,
+				GPtrArray *releases)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GPtrArray) releases_new = NULL;
+
+	/* the caller may modify the releases it was given */
+	releases_new = fu_engine_releases_cache_copy(releases, NULL, NULL, &error_local);
+	if (releases_new == NULL) {
+		g_warning("failed to copy releases for cache: %s", error_local->message);
+		return;
+	}
+
+	/* invalidated while the releases were being built */
+	locker = g_mutex_locker_new(&self->releases_cache_mutex);
+	if (generation != self->releases_cache_generation)
+		return;
+
+	/* the key includes the device version and flags, so stale entries would otherwise grow */
+	if (g_hash_table_size(self->releases_cache) >= FU_ENGINE_RELEASES_CACHE_MAX) {
+		g_debug("release cache full, removing all");
+		g_hash_table_remove_all(self->releases_cache);
+	}
+	g_hash_table_insert(self->releases_cache, g_strdup(key), g_steal_pointer(&releases_new));
+}
+
+/**
+ * fu_engine_get_statistics:
+ * @self: a #FuEngine
+ *
+ * Gets the statistics for the daemon caches.
+ *
+ * Returns: (transfer floating): a #GVariant of type `a{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fu_engine_get_statistics(FuEngine *self)
+{
+	GVariantBuilder builder;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+
+	locker = g_mutex_locker_new(&self->releases_cache_mutex);
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      "ReleasesCacheHits",
+			      g_variant_new_uint32(self->releases_cache_hits));
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      "ReleasesCacheMisses",
+			      g_variant_new_uint32(self->releases_cache_misses));
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      "ReleasesCacheSize",
+			      g_variant_new_uint32(g_hash_table_size(self->releases_cache)));
+	return g_variant_builder_end(&builder);
+}
+
 GPtrArray *
 fu_engine_get_releases_for_device(FuEngine *self,
 				  FuEngineRequest *request,
 				  FuDevice *device,
 				  GError **error)
 {
-	GPtrArray *device_guids;
+	guint cache_generation = 0;
+	g_autofree gchar *cache_key = NULL;
 	g_autoptr(GPtrArray) branches = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 
@@ -5291,47 +6305,13 @@ fu_engine_get_releases_for_device(FuEngine *self,
 		return NULL;
 	}
 
-	/* get all the components that provide any of these GUIDs */
-	device_guids = fu_device_get_guids(device);
-	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	for (guint j = 0; j < device_guids->len; j++) {
-		const gchar *guid = g_ptr_array_index(device_guids, j);
-		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GPtrArray) components = NULL;
-		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-
-		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		components = xb_silo_query_with_context(self->silo,
-							self->query_component_by_guid,
-							&context,
-							&error_local);
-		if (components == NULL) {
-			g_debug("%s was not found: %s", guid, error_local->message);
-			continue;
-		}
-
-		/* find all the releases that pass all the requirements */
-		g_debug("%s matched %u components", guid, components->len);
-		for (guint i = 0; i < components->len; i++) {
-			XbNode *component = XB_NODE(g_ptr_array_index(components, i));
-			g_autoptr(GError) error_tmp = NULL;
-			if (!fu_engine_add_releases_for_device_component(self,
-									 request,
-									 device,
-									 component,
-									 releases,
-									 &error_tmp)) {
-				g_debug("%s", error_tmp->message);
-				continue;
-			}
-		}
-		g_debug("%s matched %u releases", guid, releases->len);
-
-		/* if we're only checking for SUPPORTED then *any* release is good enough */
-		if (fu_engine_request_has_flag(request, FU_ENGINE_REQUEST_FLAG_ANY_RELEASE) &&
-		    releases->len > 0)
-			break;
+	/* reuse the releases found for an identical device and request */
+	cache_key = fu_engine_releases_cache_key(self, request, device);
+	releases =
+	    fu_engine_releases_cache_lookup(self, request, device, cache_key, &cache_generation);
+	if (releases == NULL) {
+		releases = fu_engine_get_releases_for_device_guids(self, request, device);
+		fu_engine_releases_cache_insert(self, cache_key, cache_generation, releases);
 	}
 
 	/* are there multiple branches available */
@@ -5387,6 +6367,8 @@ fu_engine_get_releases(FuEngine *self,
 	device = fu_device_list_get_by_id(self->device_list, device_id, error);
 	if (device == NULL)
 		return NULL;
+	if (!fu_engine_device_check_not_busy(self, device, error))
+		return NULL;
 
 	/* get all the releases for the device */
 	releases = fu_engine_get_releases_for_device(self, request, device, error);
@@ -5464,6 +6446,8 @@ fu_engine_get_downgrades(FuEngine *self,
 	device = fu_device_list_get_by_id(self->device_list, device_id, error);
 	if (device == NULL)
 		return NULL;
+	if (!fu_engine_device_check_not_busy(self, device, error))
+		return NULL;
 
 	/* get all the releases for the device */
 	releases_tmp = fu_engine_get_releases_for_device(self, request, device, error);
@@ -5563,6 +6547,7 @@ fu_engine_add_approved_firmware(FuEngine *self, const gchar *checksum)
 		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	}
 	g_hash_table_add(self->approved_firmware, g_strdup(checksum));
+	fu_engine_releases_cache_invalidate(self, "approved firmware changed");
 }
 
 GPtrArray *
@@ -5587,12 +6572,14 @@ fu_engine_add_blocked_firmware(FuEngine *self, const gchar *checksum)
 		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	}
 	g_hash_table_add(self->blocked_firmware, g_strdup(checksum));
+	fu_engine_releases_cache_invalidate(self, "blocked firmware changed");
 }
 
 gboolean
 fu_engine_set_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **error)
 {
 	/* update in-memory hash */
+	fu_engine_releases_cache_invalidate(self, "blocked firmware changed");
 	if (self->blocked_firmware != NULL) {
 		g_hash_table_unref(self->blocked_firmware);
 		self->blocked_firmware = NULL;
@@ -5669,6 +6656,8 @@ fu_engine_get_upgrades(FuEngine *self,
 	device = fu_device_list_get_by_id(self->device_list, device_id, error);
 	if (device == NULL)
 		return NULL;
+	if (!fu_engine_device_check_not_busy(self, device, error))
+		return NULL;
 
 	/* there is no point checking each release */
 	if (!fu_device_is_updatable(device)) {
@@ -5844,59 +6833,342 @@ fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error)
 	g_return_val_if_fail(device_id != NULL, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
-	/* find the device */
-	device = fu_engine_get_item_by_id_fallback_history(self, device_id, error);
-	if (device == NULL)
-		return NULL;
+	/* find the device */
+	device = fu_engine_get_item_by_id_fallback_history(self, device_id, error);
+	if (device == NULL)
+		return NULL;
+	if (!fu_engine_device_check_not_busy(self, device, error))
+		return NULL;
+
+	/* the notification has already been shown to the user */
+	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NOTIFIED)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOTHING_TO_DO,
+			    "User has already been notified about %s [%s]",
+			    fu_device_get_name(device),
+			    fu_device_get_id(device));
+		return NULL;
+	}
+
+	/* try to set some release properties for the UI */
+	fu_engine_fixup_history_device(self, device);
+
+	/* we did not either record or find the AppStream ID */
+	rel = fu_device_get_release_default(device);
+	if (rel == NULL || fwupd_release_get_appstream_id(rel) == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "device %s appstream id was not found",
+			    fu_device_get_id(device));
+		return NULL;
+	}
+
+	/* success */
+	return g_object_ref(FWUPD_DEVICE(device));
+}
+
+typedef enum {
+	FU_ENGINE_PLUGIN_PHASE_STARTUP,
+	FU_ENGINE_PLUGIN_PHASE_COLDPLUG,
+} FuEnginePluginPhase;
+
+typedef enum {
+	FU_ENGINE_PLUGIN_EVENT_KIND_DONE,
+	FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_ADDED,
+	FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REMOVED,
+	FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REGISTER,
+} FuEnginePluginEventKind;
+
+typedef struct {
+	FuPlugin *plugin;
+	FuProgress *progress;
+	FuEnginePluginPhase phase;
+	gboolean ret;
+	GError *error;
+	gint64 elapsed; /* us */
+} FuEnginePluginJob;
+
+typedef struct {
+	FuEnginePluginEventKind kind;
+	FuPlugin *plugin;	/* (nullable) */
+	FuDevice *device;	/* (nullable) */
+	FuEnginePluginJob *job; /* (nullable) */
+} FuEnginePluginEvent;
+
+static void
+fu_engine_plugin_job_free(FuEnginePluginJob *job)
+{
+	g_object_unref(job->plugin);
+	g_object_unref(job->progress);
+	if (job->error != NULL)
+		g_error_free(job->error);
+	g_free(job);
+}
+
+static void
+fu_engine_plugin_event_free(FuEnginePluginEvent *event)
+{
+	if (event->plugin != NULL)
+		g_object_unref(event->plugin);
+	if (event->device != NULL)
+		g_object_unref(event->device);
+	g_free(event);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuEnginePluginEvent, fu_engine_plugin_event_free)
+
+/* plugin signals from a worker thread are processed by the thread running the phase */
+static gboolean
+fu_engine_plugin_event_defer(FuEngine *self,
+			     FuEnginePluginEventKind kind,
+			     FuPlugin *plugin,
+			     FuDevice *device)
+{
+	FuEnginePluginEvent *event;
+
+	if (self->plugin_events == NULL || g_thread_self() == self->plugin_events_thread)
+		return FALSE;
+	event = g_new0(FuEnginePluginEvent, 1);
+	event->kind = kind;
+	event->plugin = g_object_ref(plugin);
+	event->device = g_object_ref(device);
+	g_async_queue_push(self->plugin_events, event);
+	return TRUE;
+}
+
+static gboolean
+fu_engine_plugin_phase_run(FuPlugin *plugin,
+			   FuEnginePluginPhase phase,
+			   FuProgress *progress,
+			   GError **error)
+{
+	if (phase == FU_ENGINE_PLUGIN_PHASE_STARTUP)
+		return fu_plugin_runner_startup(plugin, progress, error);
+	return fu_plugin_runner_coldplug(plugin, progress, error);
+}
+
+static void
+fu_engine_plugin_phase_failed(FuPlugin *plugin, FuEnginePluginPhase phase, const GError *error)
+{
+	fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+	if (phase == FU_ENGINE_PLUGIN_PHASE_STARTUP &&
+	    g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
+	}
+	g_info("disabling plugin because: %s", error->message);
+}
+
+static void
+fu_engine_plugin_job_thread_cb(gpointer data, gpointer user_data)
+{
+	FuEnginePluginJob *job = (FuEnginePluginJob *)data;
+	FuEngine *self = FU_ENGINE(user_data);
+	FuEnginePluginEvent *event = g_new0(FuEnginePluginEvent, 1);
+	gint64 start = g_get_monotonic_time();
+
+	job->ret = fu_engine_plugin_phase_run(job->plugin, job->phase, job->progress, &job->error);
+	job->elapsed = g_get_monotonic_time() - start;
+	event->kind = FU_ENGINE_PLUGIN_EVENT_KIND_DONE;
+	event->job = job;
+	g_async_queue_push(self->plugin_events, event);
+}
+
+static void
+fu_engine_plugin_event_process(FuEngine *self, FuEnginePluginEvent *event)
+{
+	if (event->kind == FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_ADDED) {
+		fu_engine_plugin_device_added_cb(event->plugin, event->device, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REMOVED) {
+		fu_engine_plugin_device_removed_cb(event->plugin, event->device, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REGISTER) {
+		fu_engine_plugin_device_register_cb(event->plugin, event->device, self);
+		return;
+	}
+}
+
+static void
+fu_engine_plugins_run_serial(FuEngine *self,
+			     FuPlugin *plugin,
+			     FuEnginePluginPhase phase,
+			     FuProgress *progress)
+{
+	g_autoptr(GError) error = NULL;
+	if (!fu_engine_plugin_phase_run(plugin, phase, fu_progress_get_child(progress), &error)) {
+		fu_engine_plugin_phase_failed(plugin, phase, error);
+		fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
+	}
+	fu_progress_step_done(progress);
+}
+
+static gboolean
+fu_engine_plugins_run_threaded(FuPlugin *plugin, GThreadPool *pool)
+{
+	return pool != NULL && fu_plugin_get_thread_safe(plugin) &&
+	       !fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+}
 
-	/* the notification has already been shown to the user */
-	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NOTIFIED)) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOTHING_TO_DO,
-			    "User has already been notified about %s [%s]",
-			    fu_device_get_name(device),
-			    fu_device_get_id(device));
-		return NULL;
-	}
+/* returns TRUE if a threaded plugin has finished */
+static gboolean
+fu_engine_plugins_process_event(FuEngine *self,
+				FuEnginePluginEvent *event,
+				FuEnginePluginPhase phase)
+{
+	FuEnginePluginJob *job = event->job;
 
-	/* try to set some release properties for the UI */
-	fu_engine_fixup_history_device(self, device);
+	if (event->kind != FU_ENGINE_PLUGIN_EVENT_KIND_DONE) {
+		fu_engine_plugin_event_process(self, event);
+		return FALSE;
+	}
+	if (!job->ret)
+		fu_engine_plugin_phase_failed(job->plugin, phase, job->error);
+	g_debug("%s(%s) took %.1fms in a thread",
+		phase == FU_ENGINE_PLUGIN_PHASE_STARTUP ? "startup" : "coldplug",
+		fu_plugin_get_name(job->plugin),
+		(gdouble)job->elapsed / 1000.f);
+	return TRUE;
+}
 
-	/* we did not either record or find the AppStream ID */
-	rel = fu_device_get_release_default(device);
-	if (rel == NULL || fwupd_release_get_appstream_id(rel) == NULL) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_FOUND,
-			    "device %s appstream id was not found",
-			    fu_device_get_id(device));
-		return NULL;
+/*
+ * Plugins with the same depsolved order have no run-after or run-before rules between them, so
+ * the plugins marked as thread-safe can run at the same time as each other and as the rest of
+ * the plugins in the same order. Devices are still added and registered in this thread.
+ *
+ * Each order is a step of @progress, with the plugins run in this thread as child steps and a
+ * final child step named after the slowest threaded plugin -- which is the critical path.
+ */
+static void
+fu_engine_plugins_run_order(FuEngine *self,
+			    GPtrArray *plugins,
+			    FuEnginePluginPhase phase,
+			    GThreadPool *pool,
+			    FuProgress *progress)
+{
+	guint jobs_pending;
+	FuEnginePluginJob *job_slowest = NULL;
+	g_autoptr(GPtrArray) jobs =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_plugin_job_free);
+	g_autoptr(GPtrArray) plugins_serial = g_ptr_array_new();
+
+	/* start the threaded plugins first -- deciding only once, as a threaded plugin can
+	 * change its own flags while the others are running */
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		FuEnginePluginJob *job;
+		if (!fu_engine_plugins_run_threaded(plugin, pool)) {
+			g_ptr_array_add(plugins_serial, plugin);
+			continue;
+		}
+		job = g_new0(FuEnginePluginJob, 1);
+		job->plugin = g_object_ref(plugin);
+		job->progress = fu_progress_new(G_STRLOC);
+		job->phase = phase;
+		g_ptr_array_add(jobs, job);
+		g_thread_pool_push(pool, job, NULL);
+	}
+	jobs_pending = jobs->len;
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, plugins_serial->len + (jobs->len > 0 ? 1 : 0));
+
+	/* run the rest, processing any devices added by the threaded plugins in between */
+	for (guint i = 0; i < plugins_serial->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins_serial, i);
+		fu_engine_plugins_run_serial(self, plugin, phase, progress);
+		while (jobs_pending > 0) {
+			g_autoptr(FuEnginePluginEvent) event =
+			    g_async_queue_try_pop(self->plugin_events);
+			if (event == NULL)
+				break;
+			if (fu_engine_plugins_process_event(self, event, phase))
+				jobs_pending--;
+		}
 	}
 
-	/* success */
-	return g_object_ref(FWUPD_DEVICE(device));
+	/* wait for the threaded plugins */
+	if (jobs->len == 0)
+		return;
+	while (jobs_pending > 0) {
+		g_autoptr(FuEnginePluginEvent) event = g_async_queue_pop(self->plugin_events);
+		if (fu_engine_plugins_process_event(self, event, phase))
+			jobs_pending--;
+	}
+	for (guint i = 0; i < jobs->len; i++) {
+		FuEnginePluginJob *job = g_ptr_array_index(jobs, i);
+		if (job_slowest == NULL || job->elapsed > job_slowest->elapsed)
+			job_slowest = job;
+	}
+	fu_progress_set_name(fu_progress_get_child(progress),
+			     fu_plugin_get_name(job_slowest->plugin));
+	fu_progress_step_done(progress);
 }
 
 static void
-fu_engine_plugins_startup(FuEngine *self, FuProgress *progress)
+fu_engine_plugins_run_phase(FuEngine *self, FuEnginePluginPhase phase, FuProgress *progress)
 {
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, plugins->len);
+	guint orders = 0;
+	GThreadPool *pool = NULL;
+
+	/* only create the pool if any plugin can use it */
 	for (guint i = 0; i < plugins->len; i++) {
-		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_startup(plugin, fu_progress_get_child(progress), &error)) {
-			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
-			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
-			}
-			g_info("disabling plugin because: %s", error->message);
-			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
+		if (fu_plugin_get_thread_safe(plugin) &&
+		    !fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED)) {
+			pool = g_thread_pool_new(fu_engine_plugin_job_thread_cb,
+						 self,
+						 (gint)g_get_num_processors(),
+						 FALSE,
+						 NULL);
+			break;
+		}
+	}
+	if (pool != NULL) {
+		self->plugin_events = g_async_queue_new();
+		self->plugin_events_thread = g_thread_self();
+	}
+
+	/* the plugins are already sorted by order */
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		if (i == 0 || fu_plugin_get_order(plugin) !=
+				  fu_plugin_get_order(g_ptr_array_index(plugins, i - 1)))
+			orders++;
+	}
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, orders);
+	for (guint i = 0; i < plugins->len;) {
+		guint order = fu_plugin_get_order(g_ptr_array_index(plugins, i));
+		g_autoptr(GPtrArray) plugins_order = g_ptr_array_new();
+		for (; i < plugins->len; i++) {
+			FuPlugin *plugin = g_ptr_array_index(plugins, i);
+			if (fu_plugin_get_order(plugin) != order)
+				break;
+			g_ptr_array_add(plugins_order, plugin);
 		}
+		fu_engine_plugins_run_order(self,
+					    plugins_order,
+					    phase,
+					    pool,
+					    fu_progress_get_child(progress));
 		fu_progress_step_done(progress);
 	}
+
+	if (pool != NULL) {
+		g_thread_pool_free(pool, FALSE, TRUE);
+		g_clear_pointer(&self->plugin_events, g_async_queue_unref);
+		self->plugin_events_thread = NULL;
+	}
+}
+
+static void
+fu_engine_plugins_startup(FuEngine *self, FuProgress *progress)
+{
+	fu_engine_plugins_run_phase(self, FU_ENGINE_PLUGIN_PHASE_STARTUP, progress);
 }
 
 static void
@@ -5926,21 +7198,10 @@ fu_engine_plugins_coldplug(FuEngine *self, FuProgress *progress)
 	g_autoptr(GString) str = g_string_new(NULL);
 
 	/* exec */
-	plugins = fu_plugin_list_get_all(self->plugin_list);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, plugins->len);
-	for (guint i = 0; i < plugins->len; i++) {
-		g_autoptr(GError) error = NULL;
-		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_coldplug(plugin, fu_progress_get_child(progress), &error)) {
-			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
-			g_info("disabling plugin because: %s", error->message);
-			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
-		}
-		fu_progress_step_done(progress);
-	}
+	fu_engine_plugins_run_phase(self, FU_ENGINE_PLUGIN_PHASE_COLDPLUG, progress);
 
 	/* print what we do have */
+	plugins = fu_plugin_list_get_all(self->plugin_list);
 	for (guint i = 0; i < plugins->len; i++) {
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
 		if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED))
@@ -5978,6 +7239,11 @@ static void
 fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REGISTER,
+					 plugin,
+					 device))
+		return;
 	fu_engine_plugin_device_register(self, device);
 }
 
@@ -5986,6 +7252,13 @@ fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer us
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
+	/* added from a threaded plugin */
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_ADDED,
+					 plugin,
+					 device))
+		return;
+
 	/* plugin has prio and device not already set from quirk */
 	if (fu_plugin_get_priority(plugin) > 0 && fu_device_get_priority(device) == 0) {
 		g_info("auto-setting %s priority to %u",
@@ -6391,8 +7664,9 @@ fu_engine_context_security_changed_cb(FuContext *ctx, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
-	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	/* invalidate host security attributes from plugins, which have no way of saying which
+	 * producer changed -- device attributes are invalidated using ::device-changed */
+	fu_engine_security_attrs_invalidate_plugins(self);
 
 	/* make UI refresh */
 	fu_engine_emit_changed(self);
@@ -6405,6 +7679,13 @@ fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer
 	FuPlugin *plugin_old;
 	g_autoptr(GError) error = NULL;
 
+	/* removed from a threaded plugin */
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_KIND_DEVICE_REMOVED,
+					 plugin,
+					 device))
+		return;
+
 	/* get the plugin */
 	plugin_old =
 	    fu_plugin_list_find_by_name(self->plugin_list, fu_device_get_plugin(device), &error);
@@ -6647,37 +7928,29 @@ fu_engine_attrs_calculate_hsi_for_chassis(FuEngine *self)
 static gboolean
 fu_engine_record_security_attrs(FuEngine *self, GError **error)
 {
-	g_autoptr(GPtrArray) attrs_array = NULL;
-	g_autofree gchar *json = NULL;
-
-	/* convert attrs to json string */
-	json = fwupd_codec_to_json_string(FWUPD_CODEC(self->host_security_attrs),
-					  FWUPD_CODEC_FLAG_NONE,
-					  error);
-	if (json == NULL) {
-		g_prefix_error(error, "cannot convert current attrs to string: ");
-		return FALSE;
-	}
+	g_autofree gchar *digest = fu_security_attrs_get_digest(self->host_security_attrs);
+	g_autofree gchar *digest_old = NULL;
+	g_autoptr(GError) error_local = NULL;
 
 	/* check that we did not store this already last boot */
-	attrs_array = fu_history_get_security_attrs(self->history, 1, error);
-	if (attrs_array == NULL) {
-		g_prefix_error(error, "failed to get historical attr: ");
-		return FALSE;
-	}
-	if (attrs_array->len > 0) {
-		FuSecurityAttrs *attrs_tmp = g_ptr_array_index(attrs_array, 0);
-		if (fu_security_attrs_equal(attrs_tmp, self->host_security_attrs)) {
-			g_info("skipping writing HSI attrs to database as unchanged");
-			return TRUE;
+	digest_old = fu_history_get_security_attrs_digest(self->history, &error_local);
+	if (digest_old == NULL) {
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND)) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&error_local),
+						   "failed to get historical attr: ");
+			return FALSE;
 		}
+	} else if (g_strcmp0(digest_old, digest) == 0) {
+		g_info("skipping writing HSI attrs to database as unchanged");
+		return TRUE;
 	}
 
 	/* write new values */
-	if (!fu_history_add_security_attribute(self->history,
-					       json,
-					       self->host_security_id,
-					       error)) {
+	if (!fu_history_add_security_attrs(self->history,
+					   self->host_security_attrs,
+					   self->host_security_id,
+					   error)) {
 		g_prefix_error(error, "failed to write to DB: ");
 		return FALSE;
 	}
@@ -6817,6 +8090,7 @@ fu_engine_fix_host_security_attr(FuEngine *self, const gchar *appstream_id, GErr
 		g_debug("ignoring %s", error_local->message);
 	} else {
 		g_info("fixed %s", fwupd_security_attr_get_appstream_id(hsi_attr));
+		fu_engine_releases_cache_invalidate(self, "BIOS setting changed");
 		return TRUE;
 	}
 
@@ -6838,10 +8112,13 @@ fu_engine_fix_host_security_attr(FuEngine *self, const gchar *appstream_id, GErr
 			    fwupd_security_attr_get_bios_setting_id(hsi_attr));
 		return FALSE;
 	}
-	return fwupd_bios_setting_write_value(
-	    bios_attr,
-	    fwupd_security_attr_get_bios_setting_target_value(hsi_attr),
-	    error);
+	if (!fwupd_bios_setting_write_value(
+		bios_attr,
+		fwupd_security_attr_get_bios_setting_target_value(hsi_attr),
+		error))
+		return FALSE;
+	fu_engine_releases_cache_invalidate(self, "BIOS setting changed");
+	return TRUE;
 }
 
 /**
@@ -6923,10 +8200,13 @@ fu_engine_undo_host_security_attr(FuEngine *self, const gchar *appstream_id, GEr
 	    error);
 	if (hsi_attr_old == NULL)
 		return FALSE;
-	return fwupd_bios_setting_write_value(
-	    bios_attr,
-	    fwupd_security_attr_get_bios_setting_current_value(hsi_attr_old),
-	    error);
+	if (!fwupd_bios_setting_write_value(
+		bios_attr,
+		fwupd_security_attr_get_bios_setting_current_value(hsi_attr_old),
+		error))
+		return FALSE;
+	fu_engine_releases_cache_invalidate(self, "BIOS setting changed");
+	return TRUE;
 }
 
 static gboolean
@@ -7038,13 +8318,121 @@ fu_engine_load_host_emulation(FuEngine *self, const gchar *fn, GError **error)
 	return TRUE;
 }
 
+#ifdef HAVE_HSI
+typedef void (*FuEngineSecurityProducerFunc)(GObject *producer, FuSecurityAttrs *attrs);
+
+static void
+fu_engine_security_producer_device_cb(GObject *producer, FuSecurityAttrs *attrs)
+{
+	fu_device_add_security_attrs(FU_DEVICE(producer), attrs);
+}
+
+static void
+fu_engine_security_producer_plugin_cb(GObject *producer, FuSecurityAttrs *attrs)
+{
+	fu_plugin_runner_add_security_attrs(FU_PLUGIN(producer), attrs);
+}
+
+/* the merged attributes are modified by depsolving and by other producers */
+static FwupdSecurityAttr *
+fu_engine_security_attr_copy(FuEngine *self, FwupdSecurityAttr *attr)
+{
+	g_autoptr(FwupdSecurityAttr) attr_copy = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	attr_copy = fu_security_attr_new(self->ctx, fwupd_security_attr_get_appstream_id(attr));
+	value = fwupd_codec_to_variant(FWUPD_CODEC(attr), FWUPD_CODEC_FLAG_TRUSTED);
+	if (!fwupd_codec_from_variant(FWUPD_CODEC(attr_copy), value, &error_local)) {
+		g_warning("failed to copy %s: %s",
+			  fwupd_security_attr_get_appstream_id(attr),
+			  error_local->message);
+		return g_object_ref(attr);
+	}
+	return g_steal_pointer(&attr_copy);
+}
+
+/* returns TRUE if the producer had to be recomputed */
+static gboolean
+fu_engine_security_producer_ensure(FuEngine *self,
+				   GHashTable *producers,
+				   const gchar *key,
+				   const gchar *plugin,
+				   GObject *object,
+				   FuEngineSecurityProducerFunc func)
+{
+	FuEngineSecurityProducer *producer = NULL;
+	gpointer key_old = NULL;
+	guint lookup_cnt;
+	gint64 start;
+	g_autoptr(GPtrArray) items_before = NULL;
+	g_autoptr(GPtrArray) items_after = NULL;
+
+	/* still valid, so just use a copy of the cached values */
+	if (g_hash_table_steal_extended(self->host_security_producers,
+					key,
+					&key_old,
+					(gpointer *)&producer)) {
+		g_free(key_old);
+		if (!producer->dependent) {
+			g_autoptr(GPtrArray) items = fu_security_attrs_get_all(producer->attrs);
+			for (guint i = 0; i < items->len; i++) {
+				FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+				g_autoptr(FwupdSecurityAttr) attr_copy =
+				    fu_engine_security_attr_copy(self, attr);
+				fu_security_attrs_append_internal(self->host_security_attrs,
+								  attr_copy);
+			}
+			producer->recomputed = FALSE;
+			g_hash_table_insert(producers, g_strdup(key), producer);
+			return FALSE;
+		}
+		fu_engine_security_producer_free(producer);
+	}
+
+	/* the producer can see what was added before it, so run it on the merged set */
+	items_before = fu_security_attrs_get_all(self->host_security_attrs);
+	lookup_cnt = fu_security_attrs_get_lookup_cnt(self->host_security_attrs);
+	start = g_get_monotonic_time();
+	func(object, self->host_security_attrs);
+	items_after = fu_security_attrs_get_all(self->host_security_attrs);
+
+	/* save a pristine copy of anything new */
+	producer = g_new0(FuEngineSecurityProducer, 1);
+	producer->attrs = fu_security_attrs_new();
+	producer->plugin = g_strdup(plugin);
+	producer->duration = g_get_monotonic_time() - start;
+	producer->recomputed = TRUE;
+	producer->dependent =
+	    fu_security_attrs_get_lookup_cnt(self->host_security_attrs) != lookup_cnt;
+	for (guint i = items_before->len; i < items_after->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items_after, i);
+		g_autoptr(FwupdSecurityAttr) attr_copy = fu_engine_security_attr_copy(self, attr);
+		fu_security_attrs_append_internal(producer->attrs, attr_copy);
+	}
+	g_debug("recomputed %u HSI attrs for %s in %.1fms%s",
+		items_after->len - items_before->len,
+		key,
+		(gdouble)producer->duration / 1000.f,
+		producer->dependent ? " (dependent)" : "");
+	g_hash_table_insert(producers, g_strdup(key), producer);
+	return TRUE;
+}
+#endif
+
 static void
 fu_engine_ensure_security_attrs(FuEngine *self)
 {
 #ifdef HAVE_HSI
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	guint recomputed_cnt = 0;
+	gint64 start = g_get_monotonic_time();
+	FuEngineSecurityProducer *producer = NULL;
+	GHashTableIter iter;
 	g_autoptr(GPtrArray) devices = fu_device_list_get_active(self->device_list);
+	g_autoptr(GPtrArray) plugins_dirty = NULL;
 	g_autoptr(GPtrArray) vals = NULL;
+	g_autoptr(GHashTable) producers = NULL;
 	g_autoptr(GError) error = NULL;
 
 	/* already valid */
@@ -7058,17 +8446,62 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	fu_engine_ensure_security_attrs_supported_cpu(self);
 	fu_engine_ensure_security_attrs_tainted(self);
 
-	/* call into devices */
+	/* call into devices and plugins, but only the ones that have been invalidated */
+	producers = g_hash_table_new_full(g_str_hash,
+					  g_str_equal,
+					  g_free,
+					  (GDestroyNotify)fu_engine_security_producer_free);
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *device = g_ptr_array_index(devices, i);
-		fu_device_add_security_attrs(device, self->host_security_attrs);
+		const gchar *plugin = fu_device_get_plugin(device);
+		g_autofree gchar *key = g_strdup_printf("device:%s", fu_device_get_id(device));
+		if (fu_engine_security_producer_ensure(self,
+						       producers,
+						       key,
+						       plugin,
+						       G_OBJECT(device),
+						       fu_engine_security_producer_device_cb)) {
+			if (plugin != NULL) {
+				g_autofree gchar *key_plugin = g_strdup_printf("plugin:%s", plugin);
+				g_hash_table_remove(self->host_security_producers, key_plugin);
+			}
+			recomputed_cnt++;
+		}
 	}
 
-	/* call into plugins */
+	/* plugins usually look at their own devices, so recompute if any were added or removed */
+	plugins_dirty = g_ptr_array_new_with_free_func(g_free);
+	g_hash_table_iter_init(&iter, self->host_security_producers);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&producer)) {
+		if (producer->plugin != NULL)
+			g_ptr_array_add(plugins_dirty,
+					g_strdup_printf("plugin:%s", producer->plugin));
+	}
+	for (guint i = 0; i < plugins_dirty->len; i++) {
+		const gchar *key_plugin = g_ptr_array_index(plugins_dirty, i);
+		g_hash_table_remove(self->host_security_producers, key_plugin);
+	}
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
-		fu_plugin_runner_add_security_attrs(plugin_tmp, self->host_security_attrs);
+		g_autofree gchar *key = NULL;
+
+		key = g_strdup_printf("plugin:%s", fu_plugin_get_name(plugin_tmp));
+		if (fu_engine_security_producer_ensure(self,
+						       producers,
+						       key,
+						       NULL,
+						       G_OBJECT(plugin_tmp),
+						       fu_engine_security_producer_plugin_cb))
+			recomputed_cnt++;
 	}
+	g_debug("recomputed HSI attrs for %u of %u producers in %.1fms",
+		recomputed_cnt,
+		g_hash_table_size(producers),
+		(gdouble)(g_get_monotonic_time() - start) / 1000.f);
+
+	/* anything left over was removed */
+	g_hash_table_unref(self->host_security_producers);
+	self->host_security_producers = g_steal_pointer(&producers);
 
 	/* sanity check */
 	vals = fu_security_attrs_get_all(self->host_security_attrs);
@@ -7104,6 +8537,58 @@ fu_engine_get_host_security_id(FuEngine *self)
 	return self->host_security_id;
 }
 
+/**
+ * fu_engine_get_host_security_statistics:
+ * @self: a #FuEngine
+ *
+ * Gets how long each device and plugin took to add the host security attributes the last time
+ * they were computed, and if the cached attributes were used instead.
+ *
+ * Returns: (transfer floating): a #GVariant of type `aa{sv}`
+ *
+ * Since: 2.0.2
+ **/
+GVariant *
+fu_engine_get_host_security_statistics(FuEngine *self)
+{
+	GVariantBuilder builder;
+	g_autoptr(GList) keys = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	keys = g_hash_table_get_keys(self->host_security_producers);
+	keys = g_list_sort(keys, (GCompareFunc)g_strcmp0);
+	for (GList *l = keys; l != NULL; l = l->next) {
+		const gchar *key = l->data;
+		FuEngineSecurityProducer *producer =
+		    g_hash_table_lookup(self->host_security_producers, key);
+		GVariantBuilder builder_tmp;
+		g_autoptr(GPtrArray) items = fu_security_attrs_get_all(producer->attrs);
+
+		g_variant_builder_init(&builder_tmp, G_VARIANT_TYPE_VARDICT);
+		g_variant_builder_add(&builder_tmp, "{sv}", "Producer", g_variant_new_string(key));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "Duration",
+				      g_variant_new_uint64(producer->duration));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "AttrCount",
+				      g_variant_new_uint32(items->len));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "Cached",
+				      g_variant_new_boolean(!producer->recomputed));
+		g_variant_builder_add(&builder_tmp,
+				      "{sv}",
+				      "Dependent",
+				      g_variant_new_boolean(producer->dependent));
+		g_variant_builder_add_value(&builder, g_variant_builder_end(&builder_tmp));
+	}
+	return g_variant_builder_end(&builder);
+}
+
 FuSecurityAttrs *
 fu_engine_get_host_security_attrs(FuEngine *self)
 {
@@ -7409,6 +8894,7 @@ fu_engine_check_firmware_attributes(FuEngine *self, FuDevice *device, gboolean a
 			g_debug("%s", error->message);
 			return;
 		}
+		fu_engine_releases_cache_invalidate(self, "BIOS settings reloaded");
 		if (!fu_engine_apply_default_bios_settings_policy(self, &error)) {
 			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO))
 				g_debug("%s", error->message);
@@ -7525,6 +9011,206 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 	}
 }
 
+/* devices may be handled by a different plugin, or have different quirks */
+static gchar *
+fu_engine_setup_cache_build_checksum(FuEngine *self)
+{
+	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	g_autofree gchar *quirks_guid = fu_context_get_quirks_guid(self->ctx);
+	g_autoptr(GString) str = g_string_new(quirks_guid);
+
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED))
+			continue;
+		g_string_append_printf(str, "\n%s", fu_plugin_get_name(plugin));
+	}
+	return g_compute_checksum_for_string(G_CHECKSUM_SHA1, str->str, str->len);
+}
+
+static void
+fu_engine_setup_cache_load(FuEngine *self, FuEngineLoadFlags flags)
+{
+	g_autofree gchar *checksum = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GHashTable) setup_cache = NULL;
+
+	if (!fu_engine_config_get_setup_cache(self->config))
+		return;
+	if (flags & (FU_ENGINE_LOAD_FLAG_NO_CACHE | FU_ENGINE_LOAD_FLAG_READONLY))
+		return;
+	checksum = fu_engine_setup_cache_build_checksum(self);
+	setup_cache = fu_engine_setup_cache_read(checksum, &error_local);
+	if (setup_cache == NULL) {
+		g_info("failed to load setup cache: %s", error_local->message);
+		return;
+	}
+	g_debug("loaded %u devices from setup cache", g_hash_table_size(setup_cache));
+	fu_context_set_setup_cache(self->ctx, setup_cache);
+}
+
+static void
+fu_engine_setup_cache_save(FuEngine *self)
+{
+	GHashTable *setup_cache = fu_context_get_setup_cache(self->ctx);
+	g_autofree gchar *checksum = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (setup_cache == NULL)
+		return;
+	checksum = fu_engine_setup_cache_build_checksum(self);
+	if (!fu_engine_setup_cache_write(setup_cache, checksum, &error_local))
+		g_info("failed to save setup cache: %s", error_local->message);
+}
+
+typedef struct {
+	GHashTable *setup_cache; /* (element-type utf-8 JsonNode) */
+	gchar *checksum;
+} FuEngineSetupCacheHelper;
+
+static void
+fu_engine_setup_cache_helper_free(FuEngineSetupCacheHelper *helper)
+{
+	g_hash_table_unref(helper->setup_cache);
+	g_free(helper->checksum);
+	g_free(helper);
+}
+
+static void
+fu_engine_setup_cache_save_reset(FuEngine *self);
+
+static void
+fu_engine_setup_cache_save_thread_cb(GTask *task,
+				     gpointer source_object,
+				     gpointer task_data,
+				     GCancellable *cancellable)
+{
+	FuEngineSetupCacheHelper *helper = (FuEngineSetupCacheHelper *)task_data;
+	GError *error = NULL;
+
+	if (!fu_engine_setup_cache_write(helper->setup_cache, helper->checksum, &error)) {
+		g_task_return_error(task, error);
+		return;
+	}
+	g_task_return_boolean(task, TRUE);
+}
+
+static void
+fu_engine_setup_cache_save_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(source_object);
+	g_autoptr(GError) error = NULL;
+
+	self->setup_cache_save_running = FALSE;
+	if (!g_task_propagate_boolean(G_TASK(res), &error))
+		g_info("failed to save setup cache: %s", error->message);
+
+	/* cache changed while we were writing */
+	if (self->setup_cache_save_pending) {
+		self->setup_cache_save_pending = FALSE;
+		fu_engine_setup_cache_save_reset(self);
+	}
+}
+
+static gboolean
+fu_engine_setup_cache_save_timeout_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	GHashTable *setup_cache = fu_context_get_setup_cache(self->ctx);
+	GHashTableIter iter;
+	gpointer key, value;
+	FuEngineSetupCacheHelper *helper;
+	g_autoptr(GTask) task = NULL;
+
+	self->setup_cache_save_id = 0;
+	if (setup_cache == NULL)
+		return G_SOURCE_REMOVE;
+
+	/* only one writer at a time, try again when it finishes */
+	if (self->setup_cache_save_running) {
+		self->setup_cache_save_pending = TRUE;
+		return G_SOURCE_REMOVE;
+	}
+
+	/* the cache is only safe to read from the main thread */
+	helper = g_new0(FuEngineSetupCacheHelper, 1);
+	helper->setup_cache = g_hash_table_new_full(g_str_hash,
+						    g_str_equal,
+						    g_free,
+						    (GDestroyNotify)json_node_unref);
+	g_hash_table_iter_init(&iter, setup_cache);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+		g_hash_table_insert(helper->setup_cache, g_strdup(key), json_node_ref(value));
+	helper->checksum = fu_engine_setup_cache_build_checksum(self);
+	task = g_task_new(self, NULL, fu_engine_setup_cache_save_cb, NULL);
+	g_task_set_task_data(task, helper, (GDestroyNotify)fu_engine_setup_cache_helper_free);
+	self->setup_cache_save_running = TRUE;
+	g_task_run_in_thread(task, fu_engine_setup_cache_save_thread_cb);
+	return G_SOURCE_REMOVE;
+}
+
+/* coalesce hotplug bursts into one write */
+static void
+fu_engine_setup_cache_save_reset(FuEngine *self)
+{
+	if (self->setup_cache_save_id != 0)
+		g_source_remove(self->setup_cache_save_id);
+	self->setup_cache_save_id = g_timeout_add(FU_ENGINE_SETUP_CACHE_SAVE_DELAY,
+						  fu_engine_setup_cache_save_timeout_cb,
+						  self);
+}
+
+static gboolean
+fu_engine_setup_cache_invalidate_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	g_hash_table_remove_all(fu_context_get_setup_cache(self->ctx));
+	fu_engine_setup_cache_save_reset(self);
+	return G_SOURCE_REMOVE;
+}
+
+/* the version may change without the device being re-enumerated; the cache is only used from
+ * the main context, so if called from the install worker thread this is deferred */
+static void
+fu_engine_setup_cache_invalidate(FuEngine *self)
+{
+	GMainContext *context = g_private_get(&fu_engine_worker_context);
+
+	if (fu_context_get_setup_cache(self->ctx) == NULL)
+		return;
+	if (context != NULL) {
+		fu_engine_invoke_in_context(context,
+					    fu_engine_setup_cache_invalidate_cb,
+					    g_object_ref(self),
+					    (GDestroyNotify)g_object_unref);
+		return;
+	}
+	fu_engine_setup_cache_invalidate_cb(self);
+}
+
+/* the version or flags set by ->setup() changed without the device being re-enumerated */
+static void
+fu_engine_setup_cache_invalidate_device(FuEngine *self, FuDevice *device)
+{
+	GHashTable *setup_cache = fu_context_get_setup_cache(self->ctx);
+	const gchar *key = fu_device_get_setup_cache_key(device);
+	JsonNode *json_node;
+
+	if (setup_cache == NULL || key == NULL)
+		return;
+
+	/* the whole cache is invalidated when installing */
+	if (g_private_get(&fu_engine_worker_context) != NULL)
+		return;
+	json_node = g_hash_table_lookup(setup_cache, key);
+	if (json_node == NULL || fu_device_matches_setup_snapshot(device, json_node))
+		return;
+	g_info("%s changed, removing from setup cache", fu_device_get_id(device));
+	g_hash_table_remove(setup_cache, key);
+	fu_device_set_setup_cache_key(device, NULL);
+	fu_engine_setup_cache_save_reset(self);
+}
+
 static void
 fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
 {
@@ -7579,11 +9265,18 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 static void
 fu_engine_backend_device_added_cb(FuBackend *backend, FuDevice *device, FuEngine *self)
 {
+	GHashTable *setup_cache = fu_context_get_setup_cache(self->ctx);
+	guint setup_cache_size = setup_cache != NULL ? g_hash_table_size(setup_cache) : 0;
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 	g_autoptr(GPtrArray) possible_plugins = NULL;
 
 	fu_engine_backend_device_added(self, device, progress);
 
+	/* a device was hotplugged and set up, coldplug is saved once when loaded */
+	if (self->loaded && setup_cache != NULL &&
+	    g_hash_table_size(setup_cache) != setup_cache_size)
+		fu_engine_setup_cache_save_reset(self);
+
 	/* there's no point keeping this in the cache */
 	possible_plugins = fu_device_get_possible_plugins(device);
 	if (possible_plugins->len == 0) {
@@ -8423,8 +10116,10 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	}
 
 	/* coldplug backends */
-	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG)
+	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG) {
+		fu_engine_setup_cache_load(self, flags);
 		fu_engine_backends_coldplug(self, fu_progress_get_child(progress));
+	}
 	fu_progress_step_done(progress);
 
 	/* coldplug done, so plugin is ready */
@@ -8457,6 +10152,9 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	if (!fu_engine_update_devices_file(self, &error_json_devices))
 		g_info("failed to update list of devices: %s", error_json_devices->message);
 
+	/* save the state of the devices that were set up for the next start */
+	fu_engine_setup_cache_save(self);
+
 #ifdef HAVE_PASSIM
 	/* connect to passimd */
 	if (!passim_client_load(self->passim_client, &error_passim))
@@ -8511,6 +10209,12 @@ fu_engine_dispose(GObject *obj)
 {
 	FuEngine *self = FU_ENGINE(obj);
 
+	/* flush any pending write while the plugins still exist */
+	if (self->setup_cache_save_id != 0) {
+		g_source_remove(self->setup_cache_save_id);
+		self->setup_cache_save_id = 0;
+		fu_engine_setup_cache_save(self);
+	}
 	if (self->plugin_list != NULL) {
 		GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
 		for (guint i = 0; i < plugins->len; i++) {
@@ -8519,6 +10223,14 @@ fu_engine_dispose(GObject *obj)
 		}
 		fu_plugin_list_remove_all(self->plugin_list);
 	}
+	/* flush any pending write while the devices still exist */
+	if (self->update_devices_id != 0) {
+		g_autoptr(GError) error_local = NULL;
+		g_source_remove(self->update_devices_id);
+		self->update_devices_id = 0;
+		if (!fu_engine_update_devices_file(self, &error_local))
+			g_info("failed to update list of devices: %s", error_local->message);
+	}
 	if (self->device_list != NULL)
 		fu_device_list_remove_all(self->device_list);
 	if (self->config != NULL)
@@ -8873,14 +10585,29 @@ fu_engine_init(FuEngine *self)
 	self->plugin_list = fu_plugin_list_new();
 	self->plugin_filter = g_ptr_array_new_with_free_func(g_free);
 	self->host_security_attrs = fu_security_attrs_new();
+	self->host_security_producers =
+	    g_hash_table_new_full(g_str_hash,
+				  g_str_equal,
+				  g_free,
+				  (GDestroyNotify)fu_engine_security_producer_free);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	self->acquiesce_loop = g_main_loop_new(NULL, FALSE);
+	g_mutex_init(&self->acquiesce_mutex);
 	self->emulation_phases = g_hash_table_new_full(g_direct_hash,
 						       g_direct_equal,
 						       NULL,
 						       (GDestroyNotify)g_bytes_unref);
 	self->device_changed_allowlist =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->releases_cache = g_hash_table_new_full(g_str_hash,
+						     g_str_equal,
+						     g_free,
+						     (GDestroyNotify)g_ptr_array_unref);
+	g_mutex_init(&self->releases_cache_mutex);
+	self->device_snapshots = g_hash_table_new_full(g_direct_hash,
+						       g_direct_equal,
+						       (GDestroyNotify)g_object_unref,
+						       (GDestroyNotify)g_object_unref);
+	g_mutex_init(&self->device_snapshots_mutex);
 #ifdef HAVE_PASSIM
 	self->passim_client = passim_client_new();
 #endif
@@ -8907,6 +10634,8 @@ fu_engine_finalize(GObject *obj)
 		g_object_unref(self->query_container_checksum1);
 	if (self->query_container_checksum2 != NULL)
 		g_object_unref(self->query_container_checksum2);
+	if (self->metadata_index != NULL)
+		g_object_unref(self->metadata_index);
 	if (self->query_tag_by_guid_version != NULL)
 		g_object_unref(self->query_tag_by_guid_version);
 	if (self->coldplug_id != 0)
@@ -8915,19 +10644,23 @@ fu_engine_finalize(GObject *obj)
 		g_hash_table_unref(self->approved_firmware);
 	if (self->blocked_firmware != NULL)
 		g_hash_table_unref(self->blocked_firmware);
-	if (self->acquiesce_id != 0)
-		g_source_remove(self->acquiesce_id);
+	if (self->acquiesce_source != NULL) {
+		g_source_destroy(self->acquiesce_source);
+		g_source_unref(self->acquiesce_source);
+	}
 	if (self->update_motd_id != 0)
 		g_source_remove(self->update_motd_id);
+	g_free(self->update_devices_checksum);
 #ifdef HAVE_PASSIM
 	if (self->passim_client != NULL)
 		g_object_unref(self->passim_client);
 #endif
-	g_main_loop_unref(self->acquiesce_loop);
+	g_mutex_clear(&self->acquiesce_mutex);
 
 	g_free(self->host_machine_id);
 	g_free(self->host_security_id);
 	g_object_unref(self->host_security_attrs);
+	g_hash_table_unref(self->host_security_producers);
 	g_object_unref(self->idle);
 	g_object_unref(self->config);
 	g_object_unref(self->remote_list);
@@ -8938,6 +10671,10 @@ fu_engine_finalize(GObject *obj)
 	g_ptr_array_unref(self->local_monitors);
 	g_hash_table_unref(self->emulation_phases);
 	g_hash_table_unref(self->device_changed_allowlist);
+	g_hash_table_unref(self->releases_cache);
+	g_mutex_clear(&self->releases_cache_mutex);
+	g_hash_table_unref(self->device_snapshots);
+	g_mutex_clear(&self->device_snapshots_mutex);
 	g_object_unref(self->plugin_list);
 
 	G_OBJECT_CLASS(fu_engine_parent_class)->finalize(obj);
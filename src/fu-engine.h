@@ -87,6 +87,10 @@ FuEngineConfig *
 fu_engine_get_config(FuEngine *self) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_engine_get_plugins(FuEngine *self) G_GNUC_NON_NULL(1);
+GVariant *
+fu_engine_get_plugin_statistics(FuEngine *self) G_GNUC_NON_NULL(1);
+GVariant *
+fu_engine_get_statistics(FuEngine *self) G_GNUC_NON_NULL(1);
 FuPlugin *
 fu_engine_get_plugin_by_name(FuEngine *self, const gchar *name, GError **error)
     G_GNUC_NON_NULL(1, 2);
@@ -94,6 +98,10 @@ GPtrArray *
 fu_engine_get_devices(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
 FuDevice *
 fu_engine_get_device(FuEngine *self, const gchar *device_id, GError **error) G_GNUC_NON_NULL(1, 2);
+FwupdDevice *
+fu_engine_get_device_snapshot(FuEngine *self, FuDevice *device) G_GNUC_NON_NULL(1, 2);
+GPtrArray *
+fu_engine_get_device_snapshots(FuEngine *self, GPtrArray *devices) G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_engine_get_devices_by_guid(FuEngine *self, const gchar *guid, GError **error)
     G_GNUC_NON_NULL(1, 2);
@@ -126,6 +134,8 @@ FwupdDevice *
 fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error) G_GNUC_NON_NULL(1, 2);
 FuSecurityAttrs *
 fu_engine_get_host_security_attrs(FuEngine *self) G_GNUC_NON_NULL(1);
+GVariant *
+fu_engine_get_host_security_statistics(FuEngine *self) G_GNUC_NON_NULL(1);
 FuSecurityAttrs *
 fu_engine_get_host_security_events(FuEngine *self, guint limit, GError **error) G_GNUC_NON_NULL(1);
 GHashTable *
@@ -208,6 +218,19 @@ fu_engine_install_releases(FuEngine *self,
 			   FuProgress *progress,
 			   FwupdInstallFlags flags,
 			   GError **error) G_GNUC_NON_NULL(1, 2, 3, 4, 5);
+void
+fu_engine_install_releases_async(FuEngine *self,
+				 FuEngineRequest *request,
+				 GPtrArray *releases,
+				 FuCabinet *cabinet,
+				 FuProgress *progress,
+				 FwupdInstallFlags flags,
+				 GCancellable *cancellable,
+				 GAsyncReadyCallback callback,
+				 gpointer callback_data) G_GNUC_NON_NULL(1, 2, 3, 4, 5);
+gboolean
+fu_engine_install_releases_finish(FuEngine *self, GAsyncResult *res, GError **error)
+    G_GNUC_NON_NULL(1, 2);
 gboolean
 fu_engine_activate(FuEngine *self, const gchar *device_id, FuProgress *progress, GError **error)
     G_GNUC_NON_NULL(1, 2, 3);
@@ -66,7 +66,7 @@ enum FuUdevMonitorNetlinkGroup {
     Udev,
 }
 
-#[derive(FromString)]
+#[derive(ToString, FromString)]
 enum FuUdevAction {
     Unknown,
     Add,
@@ -78,3 +78,21 @@ enum FuUdevAction {
     Bind,
     Unbind,
 }
+
+#[derive(New, ParseBytes)]
+struct FuStructMetadataIndex {
+    magic: [char; 8] == "FWUPDIDX",
+    version: u32le == 0x1,
+    silo_guid: [char; 36],
+    components: u32le,
+    guids: u32le,
+    checksums: u32le,
+    strtab_size: u32le,
+}
+
+#[derive(New)]
+struct FuStructMetadataIndexEntry {
+    key_offset: u32le,
+    component_idx: u32le,
+    release_idx: u32le,
+}
@@ -37,8 +37,12 @@
  * v12	add install_duration to history
  * v13	add release_flags to history
  * v14	create table emulation_tag
+ * v15	add hsi_digest, hsi_compact and hsi_removed to hsi_history
  */
-#define FU_HISTORY_CURRENT_SCHEMA_VERSION 14
+#define FU_HISTORY_CURRENT_SCHEMA_VERSION 15
+
+/* store a full set of HSI attributes every so often, and only the changes otherwise */
+#define FU_HISTORY_HSI_KEYFRAME_INTERVAL 16
 
 static void
 fu_history_finalize(GObject *object);
@@ -233,7 +237,10 @@ fu_history_create_database(FuHistory *self, GError **error)
 			  "CREATE TABLE IF NOT EXISTS hsi_history ("
 			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
 			  "hsi_details TEXT DEFAULT NULL,"
-			  "hsi_score TEXT DEFAULT NULL);"
+			  "hsi_score TEXT DEFAULT NULL,"
+			  "hsi_digest TEXT DEFAULT NULL,"
+			  "hsi_compact INTEGER DEFAULT 0,"
+			  "hsi_removed TEXT DEFAULT NULL);"
 			  "CREATE TABLE emulation_tag (device_id TEXT);"
 			  "CREATE UNIQUE INDEX idx_device_id ON emulation_tag (device_id);"
 			  "COMMIT;",
@@ -476,6 +483,22 @@ fu_history_migrate_database_v12(FuHistory *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_history_migrate_database_v13(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "ALTER TABLE hsi_history ADD COLUMN hsi_digest TEXT DEFAULT NULL;"
+			  "ALTER TABLE hsi_history ADD COLUMN hsi_compact INTEGER DEFAULT 0;"
+			  "ALTER TABLE hsi_history ADD COLUMN hsi_removed TEXT DEFAULT NULL;",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK)
+		g_debug("ignoring database error: %s", sqlite3_errmsg(self->db));
+	return TRUE;
+}
+
 /* returns 0 if database is not initialized */
 static guint
 fu_history_get_schema_version(FuHistory *self)
@@ -561,6 +584,10 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	case 13:
 		if (!fu_history_migrate_database_v12(self, error))
 			return FALSE;
+	/* fall through */
+	case 14:
+		if (!fu_history_migrate_database_v13(self, error))
+			return FALSE;
 		/* no longer fall through */
 		break;
 	default:
@@ -1486,26 +1513,184 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 #endif
 }
 
+#ifdef HAVE_SQLITE
+typedef struct {
+	gchar *timestamp; /* (nullable) */
+	gchar *json;
+	gchar *removed; /* (nullable) */
+	gboolean compact;
+	FuSecurityAttrs *attrs; /* (nullable) */
+} FuHistoryHsiRow;
+
+static void
+fu_history_hsi_row_free(FuHistoryHsiRow *row)
+{
+	if (row->attrs != NULL)
+		g_object_unref(row->attrs);
+	g_free(row->timestamp);
+	g_free(row->json);
+	g_free(row->removed);
+	g_free(row);
+}
+
+static GHashTable *
+fu_history_security_attrs_to_hash(FuSecurityAttrs *attrs)
+{
+	GHashTable *hash =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)g_object_unref);
+	g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs);
+
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		if (fwupd_security_attr_get_appstream_id(attr) == NULL)
+			continue;
+		g_hash_table_insert(hash,
+				    (gpointer)fwupd_security_attr_get_appstream_id(attr),
+				    g_object_ref(attr));
+	}
+	return hash;
+}
+
+/* uses the same fields as the digest stored in each row */
+static gboolean
+fu_history_security_attr_equal(FwupdSecurityAttr *attr1, FwupdSecurityAttr *attr2)
+{
+	g_autofree gchar *str1 = NULL;
+	g_autofree gchar *str2 = NULL;
+
+	/* quick checks first */
+	if (fwupd_security_attr_get_result(attr1) != fwupd_security_attr_get_result(attr2))
+		return FALSE;
+	if (fwupd_security_attr_get_flags(attr1) != fwupd_security_attr_get_flags(attr2))
+		return FALSE;
+	if (fwupd_security_attr_get_level(attr1) != fwupd_security_attr_get_level(attr2))
+		return FALSE;
+
+	/* result-fallback, GUIDs, metadata, BIOS settings, URL, obsoletes, etc. */
+	str1 = fu_security_attrs_attr_to_digest_string(attr1);
+	str2 = fu_security_attrs_attr_to_digest_string(attr2);
+	return g_strcmp0(str1, str2) == 0;
+}
+
+/* only the attributes that were added or changed, and the IDs of the ones that were removed */
+static FuSecurityAttrs *
+fu_history_security_attrs_delta(FuSecurityAttrs *attrs_old,
+				FuSecurityAttrs *attrs_new,
+				GPtrArray *removed)
+{
+	g_autoptr(FuSecurityAttrs) delta = fu_security_attrs_new();
+	g_autoptr(GHashTable) hash_old = fu_history_security_attrs_to_hash(attrs_old);
+	g_autoptr(GHashTable) hash_new = fu_history_security_attrs_to_hash(attrs_new);
+	g_autoptr(GPtrArray) items_old = fu_security_attrs_get_all(attrs_old);
+	g_autoptr(GPtrArray) items_new = fu_security_attrs_get_all(attrs_new);
+
+	for (guint i = 0; i < items_new->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items_new, i);
+		FwupdSecurityAttr *attr_old =
+		    g_hash_table_lookup(hash_old, fwupd_security_attr_get_appstream_id(attr));
+		if (attr_old == NULL || !fu_history_security_attr_equal(attr_old, attr))
+			fu_security_attrs_append_internal(delta, attr);
+	}
+	for (guint i = 0; i < items_old->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items_old, i);
+		const gchar *appstream_id = fwupd_security_attr_get_appstream_id(attr);
+		if (appstream_id != NULL && !g_hash_table_contains(hash_new, appstream_id))
+			g_ptr_array_add(removed, g_strdup(appstream_id));
+	}
+	return g_steal_pointer(&delta);
+}
+
+/* the number of compacted rows since the last full set of attributes */
+static guint
+fu_history_get_security_attrs_compact_cnt(FuHistory *self)
+{
+	gint rc;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT COUNT(*) FROM hsi_history WHERE rowid > "
+				"(SELECT MAX(rowid) FROM hsi_history WHERE hsi_compact = 0);",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_debug("failed to count compact rows: %s", sqlite3_errmsg(self->db));
+		return G_MAXUINT;
+	}
+	if (sqlite3_step(stmt) != SQLITE_ROW)
+		return G_MAXUINT;
+	return sqlite3_column_int(stmt, 0);
+}
+#endif
+
+/**
+ * fu_history_add_security_attrs:
+ * @self: a #FuHistory
+ * @attrs: a #FuSecurityAttrs
+ * @hsi_score: the HSI string, e.g. `HSI:1`
+ * @error: (nullable): optional return location for an error
+ *
+ * Adds the security attributes to the history database, along with a digest that can be used
+ * to quickly check if the attributes have changed.
+ *
+ * To save space, only the attributes that changed since the last entry are normally stored,
+ * with a full set of attributes stored every %FU_HISTORY_HSI_KEYFRAME_INTERVAL entries.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 2.0.2
+ **/
 gboolean
-fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
-				  const gchar *hsi_score,
-				  GError **error)
+fu_history_add_security_attrs(FuHistory *self,
+			      FuSecurityAttrs *attrs,
+			      const gchar *hsi_score,
+			      GError **error)
 {
 #ifdef HAVE_SQLITE
 	gint rc;
+	gboolean compact = FALSE;
+	guint compact_cnt;
+	g_autofree gchar *digest = NULL;
+	g_autofree gchar *json = NULL;
+	g_autofree gchar *removed_str = NULL;
+	g_autoptr(FuSecurityAttrs) delta = NULL;
+	g_autoptr(GPtrArray) removed = g_ptr_array_new_with_free_func(g_free);
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(attrs), FALSE);
 
 	/* lazy load */
 	if (!fu_history_load(self, error))
 		return FALSE;
 
-	/* remove entries */
+	/* only store what changed since the last entry */
+	compact_cnt = fu_history_get_security_attrs_compact_cnt(self);
+	if (compact_cnt < FU_HISTORY_HSI_KEYFRAME_INTERVAL - 1) {
+		g_autoptr(GPtrArray) attrs_array = fu_history_get_security_attrs(self, 1, error);
+		if (attrs_array == NULL)
+			return FALSE;
+		if (attrs_array->len > 0) {
+			FuSecurityAttrs *attrs_old = g_ptr_array_index(attrs_array, 0);
+			delta = fu_history_security_attrs_delta(attrs_old, attrs, removed);
+			compact = TRUE;
+		}
+	}
+	json = fwupd_codec_to_json_string(FWUPD_CODEC(compact ? delta : attrs),
+					  FWUPD_CODEC_FLAG_NONE,
+					  error);
+	if (json == NULL)
+		return FALSE;
+	if (removed->len > 0) {
+		g_ptr_array_add(removed, NULL);
+		removed_str = g_strjoinv(",", (gchar **)removed->pdata);
+	}
+	digest = fu_security_attrs_get_digest(attrs);
+
+	/* add entry */
 	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO hsi_history (hsi_details, hsi_score)"
-				"VALUES (?1, ?2)",
+				"INSERT INTO hsi_history (hsi_details, hsi_score, hsi_digest, "
+				"hsi_compact, hsi_removed) VALUES (?1, ?2, ?3, ?4, ?5)",
 				-1,
 				&stmt,
 				NULL);
@@ -1517,8 +1702,11 @@ fu_history_add_security_attribute(FuHistory *self,
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
-	sqlite3_bind_text(stmt, 1, security_attr_json, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 1, json, -1, SQLITE_STATIC);
 	sqlite3_bind_text(stmt, 2, hsi_score, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 3, digest, -1, SQLITE_STATIC);
+	sqlite3_bind_int(stmt, 4, compact);
+	sqlite3_bind_text(stmt, 5, removed_str, -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
@@ -1526,6 +1714,143 @@ fu_history_add_security_attribute(FuHistory *self,
 #endif
 }
 
+/**
+ * fu_history_get_security_attrs_digest:
+ * @self: a #FuHistory
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the digest of the most recent security attributes in the history database, which can be
+ * compared with fu_security_attrs_get_digest() without parsing the stored attributes.
+ *
+ * Returns: a SHA-256 hash, or %NULL if there are no attributes stored
+ *
+ * Since: 2.0.2
+ **/
+gchar *
+fu_history_get_security_attrs_digest(FuHistory *self, GError **error)
+{
+#ifdef HAVE_SQLITE
+	gint rc;
+	const gchar *digest;
+	g_autoptr(GPtrArray) attrs_array = NULL;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return NULL;
+
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT hsi_digest FROM hsi_history ORDER BY rowid DESC LIMIT 1;",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get security attrs digest: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+	rc = sqlite3_step(stmt);
+	if (rc == SQLITE_DONE) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_FOUND,
+				    "no security attributes stored");
+		return NULL;
+	}
+	if (rc != SQLITE_ROW) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+	digest = (const gchar *)sqlite3_column_text(stmt, 0);
+	if (digest != NULL)
+		return g_strdup(digest);
+
+	/* written by an older version, so parse the attributes */
+	attrs_array = fu_history_get_security_attrs(self, 1, error);
+	if (attrs_array == NULL)
+		return NULL;
+	if (attrs_array->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_FOUND,
+				    "no valid security attributes stored");
+		return NULL;
+	}
+	return fu_security_attrs_get_digest(g_ptr_array_index(attrs_array, 0));
+#else
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
+	return NULL;
+#endif
+}
+
+#ifdef HAVE_SQLITE
+/* apply a full or compacted row on top of the previous attributes */
+static gboolean
+fu_history_hsi_row_build(FuHistoryHsiRow *row, GHashTable *state, GPtrArray *order, GError **error)
+{
+	g_autoptr(FuSecurityAttrs) attrs_tmp = fu_security_attrs_new();
+	g_autoptr(GPtrArray) items = NULL;
+	g_autoptr(GDateTime) created_dt = NULL;
+	g_autoptr(GTimeZone) tz_utc = g_time_zone_new_utc();
+
+	/* parse JSON */
+	g_debug("parsing %s", row->timestamp);
+	if (!fwupd_codec_from_json_string(FWUPD_CODEC(attrs_tmp), row->json, error))
+		return FALSE;
+	if (!row->compact) {
+		g_hash_table_remove_all(state);
+		g_ptr_array_set_size(order, 0);
+	}
+	if (row->removed != NULL) {
+		g_auto(GStrv) split = g_strsplit(row->removed, ",", -1);
+		for (guint i = 0; split[i] != NULL; i++) {
+			guint idx = 0;
+			g_hash_table_remove(state, split[i]);
+			if (g_ptr_array_find_with_equal_func(order, split[i], g_str_equal, &idx))
+				g_ptr_array_remove_index(order, idx);
+		}
+	}
+	items = fu_security_attrs_get_all(attrs_tmp);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		const gchar *appstream_id = fwupd_security_attr_get_appstream_id(attr);
+		if (appstream_id == NULL)
+			continue;
+		if (!g_hash_table_contains(state, appstream_id))
+			g_ptr_array_add(order, g_strdup(appstream_id));
+		g_hash_table_insert(state, g_strdup(appstream_id), g_object_ref(attr));
+	}
+
+	/* each row needs its own copy as the created timestamp is set from the row */
+	if (row->timestamp == NULL)
+		return TRUE;
+	created_dt = g_date_time_new_from_iso8601(row->timestamp, tz_utc);
+	row->attrs = fu_security_attrs_new();
+	for (guint i = 0; i < order->len; i++) {
+		FwupdSecurityAttr *attr = g_hash_table_lookup(state, g_ptr_array_index(order, i));
+		g_autoptr(FwupdSecurityAttr) attr_copy = fwupd_security_attr_new(NULL);
+		g_autoptr(GVariant) value = NULL;
+
+		value = fwupd_codec_to_variant(FWUPD_CODEC(attr), FWUPD_CODEC_FLAG_TRUSTED);
+		if (!fwupd_codec_from_variant(FWUPD_CODEC(attr_copy), value, error))
+			return FALSE;
+		if (created_dt != NULL)
+			fwupd_security_attr_set_created(attr_copy, g_date_time_to_unix(created_dt));
+		fu_security_attrs_append_internal(row->attrs, attr_copy);
+	}
+	return TRUE;
+}
+#endif
+
 /**
  * fu_history_get_security_attrs:
  * @self: a #FuHistory
@@ -1533,7 +1858,7 @@ fu_history_add_security_attribute(FuHistory *self,
  * @error: (nullable): optional return location for an error
  *
  * Gets the security attributes in the history database.
- * Attributes with the same stores JSON data will be deduplicated as required.
+ * Attributes with the same results will be deduplicated as required.
  *
  * Returns: (element-type #FuSecurityAttrs) (transfer container): attrs
  *
@@ -1546,7 +1871,14 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 #ifdef HAVE_SQLITE
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 	gint rc;
-	guint old_hash = 0;
+	guint distinct_cnt = 0;
+	g_autofree gchar *key_old = NULL;
+	g_autofree gchar *digest_old = NULL;
+	g_autoptr(GHashTable) state =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	g_autoptr(GPtrArray) order = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) rows =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_history_hsi_row_free);
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1556,10 +1888,10 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 			return NULL;
 	}
 
-	/* get all the devices */
+	/* get the newest entries, and as far back as the last full set of attributes */
 	rc = sqlite3_prepare_v2(self->db,
-				"SELECT timestamp, hsi_details FROM hsi_history "
-				"ORDER BY timestamp DESC;",
+				"SELECT timestamp, hsi_details, hsi_compact, hsi_removed, "
+				"hsi_digest FROM hsi_history ORDER BY rowid DESC;",
 				-1,
 				&stmt,
 				NULL);
@@ -1572,50 +1904,25 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 		return NULL;
 	}
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-		const gchar *json;
-		guint hash;
-		const gchar *timestamp;
-		g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
-		g_autoptr(GDateTime) created_dt = NULL;
-		g_autoptr(GTimeZone) tz_utc = g_time_zone_new_utc();
-
-		/* old */
-		timestamp = (const gchar *)sqlite3_column_text(stmt, 0);
-		if (timestamp == NULL)
-			continue;
+		const gchar *digest = (const gchar *)sqlite3_column_text(stmt, 4);
+		const gchar *json = (const gchar *)sqlite3_column_text(stmt, 1);
+		FuHistoryHsiRow *row;
 
-		/* device_id */
-		json = (const gchar *)sqlite3_column_text(stmt, 1);
 		if (json == NULL)
 			continue;
-
-		/* do not create dups */
-		hash = g_str_hash(json);
-		if (hash == old_hash) {
-			g_debug("skipping %s as unchanged", timestamp);
-			continue;
-		}
-		old_hash = hash;
-
-		/* parse JSON */
-		g_debug("parsing %s", timestamp);
-		if (!fwupd_codec_from_json_string(FWUPD_CODEC(attrs), json, error))
-			return NULL;
-
-		/* parse timestamp */
-		created_dt = g_date_time_new_from_iso8601(timestamp, tz_utc);
-		if (created_dt != NULL) {
-			guint64 created_unix = g_date_time_to_unix(created_dt);
-			g_autoptr(GPtrArray) attr_array = fu_security_attrs_get_all(attrs);
-			for (guint i = 0; i < attr_array->len; i++) {
-				FwupdSecurityAttr *attr = g_ptr_array_index(attr_array, i);
-				fwupd_security_attr_set_created(attr, created_unix);
-			}
-		}
-
-		/* success */
-		g_ptr_array_add(array, g_steal_pointer(&attrs));
-		if (limit > 0 && array->len >= limit) {
+		row = g_new0(FuHistoryHsiRow, 1);
+		row->timestamp = g_strdup((const gchar *)sqlite3_column_text(stmt, 0));
+		row->json = g_strdup(json);
+		row->compact = sqlite3_column_int(stmt, 2) != 0;
+		row->removed = g_strdup((const gchar *)sqlite3_column_text(stmt, 3));
+		g_ptr_array_add(rows, row);
+
+		/* older entries do not have a digest, so fall back to the JSON */
+		if (g_strcmp0(digest != NULL ? digest : json, key_old) != 0)
+			distinct_cnt++;
+		g_free(key_old);
+		key_old = g_strdup(digest != NULL ? digest : json);
+		if (limit > 0 && distinct_cnt >= limit && !row->compact) {
 			rc = SQLITE_DONE;
 			break;
 		}
@@ -1628,6 +1935,34 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+
+	/* build each set of attributes, oldest first */
+	for (guint i = rows->len; i > 0; i--) {
+		FuHistoryHsiRow *row = g_ptr_array_index(rows, i - 1);
+		if (!fu_history_hsi_row_build(row, state, order, error))
+			return NULL;
+	}
+
+	/* do not create dups */
+	for (guint i = 0; i < rows->len; i++) {
+		FuHistoryHsiRow *row = g_ptr_array_index(rows, i);
+		g_autofree gchar *digest = NULL;
+
+		if (row->attrs == NULL)
+			continue;
+		digest = fu_security_attrs_get_digest(row->attrs);
+		if (g_strcmp0(digest, digest_old) == 0) {
+			g_debug("skipping %s as unchanged", row->timestamp);
+			continue;
+		}
+		g_free(digest_old);
+		digest_old = g_steal_pointer(&digest);
+
+		/* success */
+		g_ptr_array_add(array, g_object_ref(row->attrs));
+		if (limit > 0 && array->len >= limit)
+			break;
+	}
 #endif
 	return g_steal_pointer(&array);
 }
@@ -51,10 +51,12 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 GPtrArray *
 fu_history_get_blocked_firmware(FuHistory *self, GError **error) G_GNUC_NON_NULL(1);
 gboolean
-fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
-				  const gchar *hsi_score,
-				  GError **error) G_GNUC_NON_NULL(1, 2, 3);
+fu_history_add_security_attrs(FuHistory *self,
+			      FuSecurityAttrs *attrs,
+			      const gchar *hsi_score,
+			      GError **error) G_GNUC_NON_NULL(1, 2, 3);
+gchar *
+fu_history_get_security_attrs_digest(FuHistory *self, GError **error) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error) G_GNUC_NON_NULL(1);
 
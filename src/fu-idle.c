@@ -19,6 +19,8 @@ struct _FuIdle {
 	guint idle_id;
 	guint timeout;
 	FuIdleInhibit inhibit_old;
+	GMutex mutex; /* for items and idle_id, as the install worker also inhibits */
+	GMainContext *context; /* signals are only emitted here */
 };
 
 enum { SIGNAL_INHIBIT_CHANGED, SIGNAL_TIMEOUT, SIGNAL_LAST };
@@ -60,16 +62,52 @@ fu_idle_stop(FuIdle *self)
 	self->idle_id = 0;
 }
 
+static gboolean
+fu_idle_has_inhibit_unlocked(FuIdle *self, FuIdleInhibit inhibit)
+{
+	for (guint i = 0; i < self->items->len; i++) {
+		FuIdleItem *item = g_ptr_array_index(self->items, i);
+		if (item->inhibit & inhibit)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+fu_idle_emit_inhibit_changed(FuIdle *self);
+
+static gboolean
+fu_idle_emit_inhibit_changed_cb(gpointer user_data)
+{
+	FuIdle *self = FU_IDLE(user_data);
+	fu_idle_emit_inhibit_changed(self);
+	return G_SOURCE_REMOVE;
+}
+
 static void
 fu_idle_emit_inhibit_changed(FuIdle *self)
 {
 	FuIdleInhibit inhibit_global = FU_IDLE_INHIBIT_NONE;
+	g_autoptr(GMainContext) context = g_main_context_ref_thread_default();
+
+	/* called from the install worker thread, so let the owner context do this */
+	if (context != self->context) {
+		g_autoptr(GSource) source = g_idle_source_new();
+		g_source_set_callback(source,
+				      fu_idle_emit_inhibit_changed_cb,
+				      g_object_ref(self),
+				      (GDestroyNotify)g_object_unref);
+		g_source_attach(source, self->context);
+		return;
+	}
 
 	fu_idle_reset(self);
+	g_mutex_lock(&self->mutex);
 	for (guint i = 0; i < self->items->len; i++) {
 		FuIdleItem *item = g_ptr_array_index(self->items, i);
 		inhibit_global |= item->inhibit;
 	}
+	g_mutex_unlock(&self->mutex);
 	if (self->inhibit_old != inhibit_global) {
 		g_autofree gchar *inhibit_str = fu_idle_inhibit_to_string(inhibit_global);
 		g_debug("now inhibited: %s", inhibit_str);
@@ -81,9 +119,13 @@ fu_idle_emit_inhibit_changed(FuIdle *self)
 void
 fu_idle_reset(FuIdle *self)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	g_return_if_fail(FU_IS_IDLE(self));
+
+	locker = g_mutex_locker_new(&self->mutex);
 	fu_idle_stop(self);
-	if (!fu_idle_has_inhibit(self, FU_IDLE_INHIBIT_TIMEOUT))
+	if (!fu_idle_has_inhibit_unlocked(self, FU_IDLE_INHIBIT_TIMEOUT))
 		fu_idle_start(self);
 }
 
@@ -93,6 +135,7 @@ fu_idle_uninhibit(FuIdle *self, guint32 token)
 	g_return_if_fail(FU_IS_IDLE(self));
 	g_return_if_fail(token != 0);
 
+	g_mutex_lock(&self->mutex);
 	for (guint i = 0; i < self->items->len; i++) {
 		FuIdleItem *item = g_ptr_array_index(self->items, i);
 		if (item->token == token) {
@@ -102,6 +145,7 @@ fu_idle_uninhibit(FuIdle *self, guint32 token)
 			break;
 		}
 	}
+	g_mutex_unlock(&self->mutex);
 	fu_idle_emit_inhibit_changed(self);
 }
 
@@ -109,6 +153,7 @@ guint32
 fu_idle_inhibit(FuIdle *self, FuIdleInhibit inhibit, const gchar *reason)
 {
 	FuIdleItem *item;
+	guint32 token;
 	g_autofree gchar *inhibit_str = fu_idle_inhibit_to_string(inhibit);
 
 	g_return_val_if_fail(FU_IS_IDLE(self), 0);
@@ -119,24 +164,25 @@ fu_idle_inhibit(FuIdle *self, FuIdleInhibit inhibit, const gchar *reason)
 	item->inhibit = inhibit;
 	item->reason = g_strdup(reason);
 	item->token = g_random_int_range(1, G_MAXINT);
+	token = item->token;
+	g_mutex_lock(&self->mutex);
 	g_ptr_array_add(self->items, item);
+	g_mutex_unlock(&self->mutex);
 
 	fu_idle_emit_inhibit_changed(self);
-	return item->token;
+	return token;
 }
 
 gboolean
 fu_idle_has_inhibit(FuIdle *self, FuIdleInhibit inhibit)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	g_return_val_if_fail(FU_IS_IDLE(self), FALSE);
 	g_return_val_if_fail(inhibit != FU_IDLE_INHIBIT_NONE, FALSE);
 
-	for (guint i = 0; i < self->items->len; i++) {
-		FuIdleItem *item = g_ptr_array_index(self->items, i);
-		if (item->inhibit & inhibit)
-			return TRUE;
-	}
-	return FALSE;
+	locker = g_mutex_locker_new(&self->mutex);
+	return fu_idle_has_inhibit_unlocked(self, inhibit);
 }
 
 void
@@ -205,6 +251,8 @@ static void
 fu_idle_init(FuIdle *self)
 {
 	self->items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_idle_item_free);
+	g_mutex_init(&self->mutex);
+	self->context = g_main_context_ref_thread_default();
 }
 
 static void
@@ -214,6 +262,8 @@ fu_idle_finalize(GObject *obj)
 
 	fu_idle_stop(self);
 	g_ptr_array_unref(self->items);
+	g_mutex_clear(&self->mutex);
+	g_main_context_unref(self->context);
 
 	G_OBJECT_CLASS(fu_idle_parent_class)->finalize(obj);
 }
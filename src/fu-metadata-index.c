@@ -0,0 +1,498 @@
+/*
+ * Copyright 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuMetadataIndex"
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fu-engine-struct.h"
+#include "fu-metadata-index.h"
+
+/*
+ * The index is a header, a table of GUID entries, a table of checksum entries and a string
+ * table. Each entry table is sorted by key so a lookup is just a binary search, and the whole
+ * blob can be used directly from a mapped file without being parsed first.
+ */
+
+static void
+fu_metadata_index_finalize(GObject *obj);
+
+struct _FuMetadataIndex {
+	GObject parent_instance;
+	GBytes *blob;		/* (nullable) */
+	GPtrArray *components;	/* (nullable) (element-type XbNode) */
+	gsize guids_offset;	/* in blob */
+	guint32 guids_cnt;
+	gsize checksums_offset; /* in blob */
+	guint32 checksums_cnt;
+	gsize strtab_offset;	/* in blob */
+	gsize strtab_size;
+};
+
+typedef struct {
+	guint32 component_idx;
+	guint32 release_idx;
+} FuMetadataIndexItem;
+
+G_DEFINE_TYPE(FuMetadataIndex, fu_metadata_index, G_TYPE_OBJECT)
+
+static GPtrArray *
+fu_metadata_index_query_components(XbSilo *silo, GError **error)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) components = NULL;
+
+	components = xb_silo_query(silo, "components/component", 0, &error_local);
+	if (components == NULL) {
+		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+		    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+			return g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		fwupd_error_convert(error);
+		return NULL;
+	}
+	return g_steal_pointer(&components);
+}
+
+static gboolean
+fu_metadata_index_parse(FuMetadataIndex *self, XbSilo *silo, GBytes *blob, GError **error)
+{
+	gsize bufsz = 0;
+	guint64 size_expected;
+	const guint8 *buf = g_bytes_get_data(blob, &bufsz);
+	g_autofree gchar *silo_guid = xb_silo_get_guid(silo);
+	g_autofree gchar *silo_guid_idx = NULL;
+	g_autoptr(FuStructMetadataIndex) st = NULL;
+	g_autoptr(GPtrArray) components = NULL;
+
+	/* check this is for the same silo */
+	st = fu_struct_metadata_index_parse_bytes(blob, 0x0, error);
+	if (st == NULL)
+		return FALSE;
+	silo_guid_idx = fu_struct_metadata_index_get_silo_guid(st);
+	if (g_strcmp0(silo_guid_idx, silo_guid) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "index is for silo %s, expected %s",
+			    silo_guid_idx,
+			    silo_guid);
+		return FALSE;
+	}
+	components = fu_metadata_index_query_components(silo, error);
+	if (components == NULL)
+		return FALSE;
+	if (fu_struct_metadata_index_get_components(st) != components->len) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "index has %u components, expected %u",
+			    fu_struct_metadata_index_get_components(st),
+			    components->len);
+		return FALSE;
+	}
+
+	/* check the tables fit exactly, and that every key is NUL-terminated */
+	size_expected = FU_STRUCT_METADATA_INDEX_SIZE;
+	size_expected += (guint64)fu_struct_metadata_index_get_guids(st) *
+			 FU_STRUCT_METADATA_INDEX_ENTRY_SIZE;
+	size_expected += (guint64)fu_struct_metadata_index_get_checksums(st) *
+			 FU_STRUCT_METADATA_INDEX_ENTRY_SIZE;
+	size_expected += fu_struct_metadata_index_get_strtab_size(st);
+	if (size_expected != bufsz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "index size 0x%x, expected 0x%x",
+			    (guint)bufsz,
+			    (guint)size_expected);
+		return FALSE;
+	}
+	if (fu_struct_metadata_index_get_strtab_size(st) > 0 && buf[bufsz - 1] != '\0') {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "index string table not NUL-terminated");
+		return FALSE;
+	}
+
+	/* success */
+	if (self->blob != NULL)
+		g_bytes_unref(self->blob);
+	self->blob = g_bytes_ref(blob);
+	if (self->components != NULL)
+		g_ptr_array_unref(self->components);
+	self->components = g_steal_pointer(&components);
+	self->guids_cnt = fu_struct_metadata_index_get_guids(st);
+	self->guids_offset = FU_STRUCT_METADATA_INDEX_SIZE;
+	self->checksums_cnt = fu_struct_metadata_index_get_checksums(st);
+	self->checksums_offset =
+	    self->guids_offset + (gsize)self->guids_cnt * FU_STRUCT_METADATA_INDEX_ENTRY_SIZE;
+	self->strtab_offset = self->checksums_offset +
+			      (gsize)self->checksums_cnt * FU_STRUCT_METADATA_INDEX_ENTRY_SIZE;
+	self->strtab_size = fu_struct_metadata_index_get_strtab_size(st);
+	return TRUE;
+}
+
+/**
+ * fu_metadata_index_load_file:
+ * @self: a #FuMetadataIndex
+ * @silo: a #XbSilo
+ * @file: a #GFile
+ * @error: (nullable): optional return location for an error
+ *
+ * Maps a previously saved index, checking it was created for @silo.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_metadata_index_load_file(FuMetadataIndex *self, XbSilo *silo, GFile *file, GError **error)
+{
+	g_autofree gchar *fn = g_file_get_path(file);
+	g_autoptr(GBytes) blob = NULL;
+
+	g_return_val_if_fail(FU_IS_METADATA_INDEX(self), FALSE);
+	g_return_val_if_fail(XB_IS_SILO(silo), FALSE);
+	g_return_val_if_fail(G_IS_FILE(file), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	blob = fu_bytes_get_contents(fn, error);
+	if (blob == NULL)
+		return FALSE;
+	return fu_metadata_index_parse(self, silo, blob, error);
+}
+
+/**
+ * fu_metadata_index_save_file:
+ * @self: a #FuMetadataIndex
+ * @file: a #GFile
+ * @error: (nullable): optional return location for an error
+ *
+ * Saves the index so that it can be mapped by fu_metadata_index_load_file() next time.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_metadata_index_save_file(FuMetadataIndex *self, GFile *file, GError **error)
+{
+	g_autofree gchar *fn = g_file_get_path(file);
+
+	g_return_val_if_fail(FU_IS_METADATA_INDEX(self), FALSE);
+	g_return_val_if_fail(G_IS_FILE(file), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->blob == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "index not built");
+		return FALSE;
+	}
+	return fu_bytes_set_contents(fn, self->blob, error);
+}
+
+static void
+fu_metadata_index_add_item(GHashTable *items,
+			   const gchar *key,
+			   guint32 component_idx,
+			   guint32 release_idx)
+{
+	FuMetadataIndexItem *item;
+
+	/* the first match in document order wins, just like the XPath query */
+	if (key == NULL || g_hash_table_contains(items, key))
+		return;
+	item = g_new0(FuMetadataIndexItem, 1);
+	item->component_idx = component_idx;
+	item->release_idx = release_idx;
+	g_hash_table_insert(items, g_strdup(key), item);
+}
+
+static void
+fu_metadata_index_add_items_for_query(GHashTable *items,
+				      XbNode *n,
+				      const gchar *xpath,
+				      guint32 component_idx,
+				      guint32 release_idx)
+{
+	g_autoptr(GPtrArray) nodes = xb_node_query(n, xpath, 0, NULL);
+	if (nodes == NULL)
+		return;
+	for (guint i = 0; i < nodes->len; i++) {
+		XbNode *n_key = g_ptr_array_index(nodes, i);
+		fu_metadata_index_add_item(items,
+					   xb_node_get_text(n_key),
+					   component_idx,
+					   release_idx);
+	}
+}
+
+static void
+fu_metadata_index_merge_items(GHashTable *items, GHashTable *items_fallback)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, items_fallback);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuMetadataIndexItem *item = (FuMetadataIndexItem *)value;
+		fu_metadata_index_add_item(items, key, item->component_idx, item->release_idx);
+	}
+}
+
+static gint
+fu_metadata_index_key_sort_cb(gconstpointer a, gconstpointer b)
+{
+	const gchar *key1 = *((const gchar **)a);
+	const gchar *key2 = *((const gchar **)b);
+	return strcmp(key1, key2);
+}
+
+static void
+fu_metadata_index_append_table(GByteArray *buf, GByteArray *strtab, GHashTable *items)
+{
+	g_autoptr(GPtrArray) keys = g_ptr_array_new();
+	g_autoptr(GList) keys_list = g_hash_table_get_keys(items);
+
+	for (GList *l = keys_list; l != NULL; l = l->next)
+		g_ptr_array_add(keys, l->data);
+	g_ptr_array_sort(keys, fu_metadata_index_key_sort_cb);
+	for (guint i = 0; i < keys->len; i++) {
+		const gchar *key = g_ptr_array_index(keys, i);
+		FuMetadataIndexItem *item = g_hash_table_lookup(items, key);
+		g_autoptr(FuStructMetadataIndexEntry) st = fu_struct_metadata_index_entry_new();
+
+		fu_struct_metadata_index_entry_set_key_offset(st, strtab->len);
+		fu_struct_metadata_index_entry_set_component_idx(st, item->component_idx);
+		fu_struct_metadata_index_entry_set_release_idx(st, item->release_idx);
+		g_byte_array_append(buf, st->data, st->len);
+		g_byte_array_append(strtab, (const guint8 *)key, strlen(key) + 1);
+	}
+}
+
+/**
+ * fu_metadata_index_build:
+ * @self: a #FuMetadataIndex
+ * @silo: a #XbSilo
+ * @error: (nullable): optional return location for an error
+ *
+ * Builds the index of provided GUID to component, and of container or artifact checksum to
+ * release, for all the components in @silo.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_metadata_index_build(FuMetadataIndex *self, XbSilo *silo, GError **error)
+{
+	g_autofree gchar *silo_guid = xb_silo_get_guid(silo);
+	g_autoptr(FuStructMetadataIndex) st = fu_struct_metadata_index_new();
+	g_autoptr(GByteArray) strtab = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GHashTable) guids = NULL;
+	g_autoptr(GHashTable) checksums1 = NULL;
+	g_autoptr(GHashTable) checksums2 = NULL;
+	g_autoptr(GPtrArray) components = NULL;
+
+	g_return_val_if_fail(FU_IS_METADATA_INDEX(self), FALSE);
+	g_return_val_if_fail(XB_IS_SILO(silo), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	components = fu_metadata_index_query_components(silo, error);
+	if (components == NULL)
+		return FALSE;
+
+	/* find all the keys, preferring container checksums over artifact checksums */
+	guids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	checksums1 = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	checksums2 = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	for (guint i = 0; i < components->len; i++) {
+		XbNode *component = g_ptr_array_index(components, i);
+		g_autoptr(GPtrArray) releases = NULL;
+
+		fu_metadata_index_add_items_for_query(guids,
+						      component,
+						      "provides/firmware[@type='flashed']",
+						      i,
+						      G_MAXUINT32);
+		if (g_strcmp0(xb_node_get_attr(component, "type"), "firmware") != 0)
+			continue;
+		releases = xb_node_query(component, "releases/release", 0, NULL);
+		if (releases == NULL)
+			continue;
+		for (guint j = 0; j < releases->len; j++) {
+			XbNode *rel = g_ptr_array_index(releases, j);
+			fu_metadata_index_add_items_for_query(checksums1,
+							      rel,
+							      "checksum[@target='container']",
+							      i,
+							      j);
+			fu_metadata_index_add_items_for_query(
+			    checksums2,
+			    rel,
+			    "artifacts/artifact[@type='binary']/checksum",
+			    i,
+			    j);
+		}
+	}
+	fu_metadata_index_merge_items(checksums1, checksums2);
+
+	/* write the header, then both sorted tables, then the string table */
+	if (!fu_struct_metadata_index_set_silo_guid(st, silo_guid, error))
+		return FALSE;
+	fu_struct_metadata_index_set_components(st, components->len);
+	fu_struct_metadata_index_set_guids(st, g_hash_table_size(guids));
+	fu_struct_metadata_index_set_checksums(st, g_hash_table_size(checksums1));
+	fu_metadata_index_append_table(st, strtab, guids);
+	fu_metadata_index_append_table(st, strtab, checksums1);
+	fu_struct_metadata_index_set_strtab_size(st, strtab->len);
+	g_byte_array_append(st, strtab->data, strtab->len);
+	blob = g_bytes_new(st->data, st->len);
+	return fu_metadata_index_parse(self, silo, blob, error);
+}
+
+static gboolean
+fu_metadata_index_search(FuMetadataIndex *self,
+			 gsize offset,
+			 guint32 cnt,
+			 const gchar *key,
+			 guint32 *component_idx,
+			 guint32 *release_idx)
+{
+	const guint8 *buf;
+	guint32 lo = 0;
+	guint32 hi = cnt;
+
+	if (self->blob == NULL)
+		return FALSE;
+	buf = g_bytes_get_data(self->blob, NULL);
+	while (lo < hi) {
+		guint32 mid = lo + (hi - lo) / 2;
+		const guint8 *entry = buf + offset;
+		guint32 key_offset;
+		gint rc;
+
+		entry += (gsize)mid * FU_STRUCT_METADATA_INDEX_ENTRY_SIZE;
+		key_offset =
+		    fu_memread_uint32(entry + FU_STRUCT_METADATA_INDEX_ENTRY_OFFSET_KEY_OFFSET,
+				      G_LITTLE_ENDIAN);
+
+		/* the index might be corrupt */
+		if (key_offset >= self->strtab_size)
+			return FALSE;
+		rc = strcmp(key, (const gchar *)buf + self->strtab_offset + key_offset);
+		if (rc == 0) {
+			*component_idx = fu_memread_uint32(
+			    entry + FU_STRUCT_METADATA_INDEX_ENTRY_OFFSET_COMPONENT_IDX,
+			    G_LITTLE_ENDIAN);
+			*release_idx = fu_memread_uint32(
+			    entry + FU_STRUCT_METADATA_INDEX_ENTRY_OFFSET_RELEASE_IDX,
+			    G_LITTLE_ENDIAN);
+			return *component_idx < self->components->len;
+		}
+		if (rc < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return FALSE;
+}
+
+/**
+ * fu_metadata_index_get_component_by_guid:
+ * @self: a #FuMetadataIndex
+ * @guid: a GUID
+ *
+ * Finds the first component that provides @guid.
+ *
+ * Returns: (transfer full) (nullable): a #XbNode, or %NULL if not found
+ **/
+XbNode *
+fu_metadata_index_get_component_by_guid(FuMetadataIndex *self, const gchar *guid)
+{
+	guint32 component_idx = 0;
+	guint32 release_idx = 0;
+
+	g_return_val_if_fail(FU_IS_METADATA_INDEX(self), NULL);
+	g_return_val_if_fail(guid != NULL, NULL);
+
+	if (!fu_metadata_index_search(self,
+				      self->guids_offset,
+				      self->guids_cnt,
+				      guid,
+				      &component_idx,
+				      &release_idx))
+		return NULL;
+	return g_object_ref(g_ptr_array_index(self->components, component_idx));
+}
+
+/**
+ * fu_metadata_index_get_release_by_checksum:
+ * @self: a #FuMetadataIndex
+ * @csum: a container or artifact checksum
+ *
+ * Finds the first release with the container checksum @csum, falling back to the first release
+ * with a binary artifact of that checksum.
+ *
+ * Returns: (transfer full) (nullable): a #XbNode, or %NULL if not found
+ **/
+XbNode *
+fu_metadata_index_get_release_by_checksum(FuMetadataIndex *self, const gchar *csum)
+{
+	XbNode *component;
+	guint32 component_idx = 0;
+	guint32 release_idx = 0;
+	g_autoptr(GPtrArray) releases = NULL;
+
+	g_return_val_if_fail(FU_IS_METADATA_INDEX(self), NULL);
+	g_return_val_if_fail(csum != NULL, NULL);
+
+	if (!fu_metadata_index_search(self,
+				      self->checksums_offset,
+				      self->checksums_cnt,
+				      csum,
+				      &component_idx,
+				      &release_idx))
+		return NULL;
+	component = g_ptr_array_index(self->components, component_idx);
+	releases = xb_node_query(component, "releases/release", 0, NULL);
+	if (releases == NULL || release_idx >= releases->len)
+		return NULL;
+	return g_object_ref(g_ptr_array_index(releases, release_idx));
+}
+
+static void
+fu_metadata_index_class_init(FuMetadataIndexClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_metadata_index_finalize;
+}
+
+static void
+fu_metadata_index_init(FuMetadataIndex *self)
+{
+}
+
+static void
+fu_metadata_index_finalize(GObject *obj)
+{
+	FuMetadataIndex *self = FU_METADATA_INDEX(obj);
+
+	if (self->blob != NULL)
+		g_bytes_unref(self->blob);
+	if (self->components != NULL)
+		g_ptr_array_unref(self->components);
+
+	G_OBJECT_CLASS(fu_metadata_index_parent_class)->finalize(obj);
+}
+
+FuMetadataIndex *
+fu_metadata_index_new(void)
+{
+	return g_object_new(FU_TYPE_METADATA_INDEX, NULL);
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+#include <xmlb.h>
+
+#define FU_TYPE_METADATA_INDEX (fu_metadata_index_get_type())
+G_DECLARE_FINAL_TYPE(FuMetadataIndex, fu_metadata_index, FU, METADATA_INDEX, GObject)
+
+FuMetadataIndex *
+fu_metadata_index_new(void);
+gboolean
+fu_metadata_index_build(FuMetadataIndex *self, XbSilo *silo, GError **error) G_GNUC_NON_NULL(1, 2);
+gboolean
+fu_metadata_index_load_file(FuMetadataIndex *self, XbSilo *silo, GFile *file, GError **error)
+    G_GNUC_NON_NULL(1, 2, 3);
+gboolean
+fu_metadata_index_save_file(FuMetadataIndex *self, GFile *file, GError **error)
+    G_GNUC_NON_NULL(1, 2);
+XbNode *
+fu_metadata_index_get_component_by_guid(FuMetadataIndex *self, const gchar *guid)
+    G_GNUC_NON_NULL(1, 2);
+XbNode *
+fu_metadata_index_get_release_by_checksum(FuMetadataIndex *self, const gchar *csum)
+    G_GNUC_NON_NULL(1, 2);
@@ -1118,21 +1118,6 @@ fu_release_load(FuRelease *self,
 		}
 	}
 
-	/* get per-release firmware stream */
-	blob_basename = xb_node_get_data(rel, "fwupd::FirmwareBasename");
-	if (cabinet != NULL && blob_basename != NULL) {
-		const gchar *basename = (const gchar *)g_bytes_get_data(blob_basename, NULL);
-		g_autoptr(FuFirmware) img = NULL;
-		img = fu_firmware_get_image_by_id(FU_FIRMWARE(cabinet), basename, error);
-		if (img == NULL) {
-			g_prefix_error(error, "failed to find %s: ", basename);
-			return FALSE;
-		}
-		self->stream = fu_firmware_get_stream(img, error);
-		if (self->stream == NULL)
-			return FALSE;
-	}
-
 	/* to build the firmware */
 	tmp = g_object_get_data(G_OBJECT(component), "fwupd::BuilderScript");
 	if (tmp != NULL) {
@@ -1157,6 +1142,29 @@ fu_release_load(FuRelease *self,
 			return FALSE;
 	}
 
+	/* get per-release firmware stream, only decompressing the payload we actually need */
+	blob_basename = xb_node_get_data(rel, "fwupd::FirmwareBasename");
+	if (cabinet != NULL && blob_basename != NULL) {
+		const gchar *basename = (const gchar *)g_bytes_get_data(blob_basename, NULL);
+		g_autoptr(FuFirmware) img = NULL;
+		if (!fu_cabinet_verify_release(cabinet, rel, error))
+			return FALSE;
+		img = fu_firmware_get_image_by_id(FU_FIRMWARE(cabinet), basename, error);
+		if (img == NULL) {
+			g_prefix_error(error, "failed to find %s: ", basename);
+			return FALSE;
+		}
+		self->stream = fu_firmware_get_stream(img, error);
+		if (self->stream == NULL)
+			return FALSE;
+
+		/* the payload trust is only known now */
+		fwupd_release_remove_flag(FWUPD_RELEASE(self), FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD);
+		fwupd_release_remove_flag(FWUPD_RELEASE(self), FWUPD_RELEASE_FLAG_TRUSTED_METADATA);
+		if (!fu_release_ensure_trust_flags(self, rel, error))
+			return FALSE;
+	}
+
 	/* success */
 	return TRUE;
 }
@@ -1165,6 +1173,7 @@ static gboolean
 fu_release_ensure_trust_flags(FuRelease *self, XbNode *rel, GError **error)
 {
 	GBytes *blob;
+	FwupdReleaseFlags flags_tmp;
 
 	g_return_val_if_fail(FU_IS_RELEASE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
@@ -1195,8 +1204,11 @@ fu_release_ensure_trust_flags(FuRelease *self, XbNode *rel, GError **error)
 			fu_release_add_flag(self, FWUPD_RELEASE_FLAG_TRUSTED_METADATA);
 	}
 
-	/* do not require signatures for anything installed to the immutable datadir */
-	if (fu_release_get_flags(self) == FWUPD_RELEASE_FLAG_NONE && self->remote != NULL) {
+	/* do not require signatures for anything installed to the immutable datadir; this is
+	 * called again after the payload is verified, when the version flags may also be set */
+	flags_tmp = fu_release_get_flags(self) &
+		    ~(FWUPD_RELEASE_FLAG_IS_UPGRADE | FWUPD_RELEASE_FLAG_IS_DOWNGRADE);
+	if (flags_tmp == FWUPD_RELEASE_FLAG_NONE && self->remote != NULL) {
 		g_debug("remote %s has kind=%s and so marking as trusted",
 			fwupd_remote_get_id(self->remote),
 			fwupd_remote_kind_to_string(fwupd_remote_get_kind(self->remote)));
@@ -1337,3 +1349,39 @@ fu_release_new(void)
 	self = g_object_new(FU_TYPE_RELEASE, NULL);
 	return FU_RELEASE(self);
 }
+
+/**
+ * fu_release_copy:
+ * @self: a #FuRelease
+ * @error: (nullable): optional return location for an error
+ *
+ * Copies a release that has already been loaded. The request and device are not copied, and
+ * have to be set by the caller.
+ *
+ * Returns: (transfer full): a #FuRelease, or %NULL on error
+ **/
+FuRelease *
+fu_release_copy(FuRelease *self, GError **error)
+{
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GVariant) value = NULL;
+
+	g_return_val_if_fail(FU_IS_RELEASE(self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	value = fwupd_codec_to_variant(FWUPD_CODEC(self), FWUPD_CODEC_FLAG_TRUSTED);
+	g_variant_ref_sink(value);
+	if (!fwupd_codec_from_variant(FWUPD_CODEC(release), value, error))
+		return NULL;
+	fu_release_set_remote(release, self->remote);
+	fu_release_set_config(release, self->config);
+	fu_release_set_update_request_id(release, self->update_request_id);
+	fu_release_set_priority(release, self->priority);
+	if (self->stream != NULL)
+		release->stream = g_object_ref(self->stream);
+	if (self->soft_reqs != NULL)
+		release->soft_reqs = g_ptr_array_ref(self->soft_reqs);
+	if (self->hard_reqs != NULL)
+		release->hard_reqs = g_ptr_array_ref(self->hard_reqs);
+	return g_steal_pointer(&release);
+}
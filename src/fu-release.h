@@ -17,6 +17,8 @@ G_DECLARE_FINAL_TYPE(FuRelease, fu_release, FU, RELEASE, FwupdRelease)
 
 FuRelease *
 fu_release_new(void);
+FuRelease *
+fu_release_copy(FuRelease *self, GError **error) G_GNUC_NON_NULL(1);
 
 #define fu_release_get_appstream_id(r)	 fwupd_release_get_appstream_id(FWUPD_RELEASE(r))
 #define fu_release_get_filename(r)	 fwupd_release_get_filename(FWUPD_RELEASE(r))
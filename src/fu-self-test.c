@@ -31,6 +31,7 @@
 #include "fu-engine.h"
 #include "fu-history.h"
 #include "fu-idle.h"
+#include "fu-metadata-index.h"
 #include "fu-plugin-list.h"
 #include "fu-plugin-private.h"
 #include "fu-release-common.h"
@@ -43,6 +44,9 @@
 #ifdef HAVE_GIO_UNIX
 #include "fu-unix-seekable-input-stream.h"
 #endif
+#ifdef HAVE_UDEV
+#include "fu-udev-backend.h"
+#endif
 
 typedef struct {
 	FuPlugin *plugin;
@@ -232,6 +236,230 @@ fu_idle_func(void)
 	g_assert_false(fu_idle_has_inhibit(idle, FU_IDLE_INHIBIT_SIGNALS));
 }
 
+#ifdef HAVE_UDEV
+static void
+fu_udev_backend_coalesce_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuBackend) backend = fu_udev_backend_new(self->ctx);
+	g_autoptr(FuUdevDevice) donor_ab = fu_udev_device_new(self->ctx, "/sys/devices/a/b");
+	g_autoptr(FuUdevDevice) donor_c = fu_udev_device_new(self->ctx, "/sys/devices/c");
+	g_autoptr(FuUdevDevice) donor_f = fu_udev_device_new(self->ctx, "/sys/devices/f");
+	g_autoptr(FuUdevDevice) donor_fg = fu_udev_device_new(self->ctx, "/sys/devices/f/g");
+
+	/* add followed by remove is dropped */
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_ADD,
+				  "/sys/devices/a/b",
+				  donor_ab);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_REMOVE,
+				  "/sys/devices/a/b",
+				  NULL);
+
+	/* remove followed by add is a replug */
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_REMOVE,
+				  "/sys/devices/c",
+				  NULL);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_ADD,
+				  "/sys/devices/c",
+				  donor_c);
+
+	/* duplicate changes are merged */
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_CHANGE,
+				  "/sys/devices/h",
+				  NULL);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_CHANGE,
+				  "/sys/devices/h",
+				  NULL);
+
+	/* removals of children first, additions of parents first */
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_REMOVE,
+				  "/sys/devices/d",
+				  NULL);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_REMOVE,
+				  "/sys/devices/d/e",
+				  NULL);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_ADD,
+				  "/sys/devices/f/g",
+				  donor_fg);
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_ADD,
+				  "/sys/devices/f",
+				  donor_f);
+
+	str = fu_udev_backend_pending_events_to_string(FU_UDEV_BACKEND(backend));
+	g_assert_cmpstr(str,
+			==,
+			"remove:/sys/devices/d/e\n"
+			"remove:/sys/devices/d\n"
+			"add,replug:/sys/devices/c\n"
+			"add:/sys/devices/f\n"
+			"change:/sys/devices/h\n"
+			"add:/sys/devices/f/g\n");
+}
+
+static gboolean
+fu_udev_backend_deadline_cb(gpointer user_data)
+{
+	FuUdevBackend *backend = FU_UDEV_BACKEND(user_data);
+	g_autofree gchar *str = fu_udev_backend_pending_events_to_string(backend);
+
+	/* the last batch was processed even though events never stopped arriving */
+	if (g_strcmp0(str, "") == 0) {
+		fu_test_loop_quit();
+		return G_SOURCE_REMOVE;
+	}
+	fu_udev_backend_add_event(backend, FU_UDEV_ACTION_CHANGE, "/sys/devices/h", NULL);
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+fu_udev_backend_deadline_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	guint feed_id;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuBackend) backend = fu_udev_backend_new(self->ctx);
+
+	/* an event every 10ms would keep postponing a plain debounce timer forever */
+	fu_udev_backend_add_event(FU_UDEV_BACKEND(backend),
+				  FU_UDEV_ACTION_CHANGE,
+				  "/sys/devices/h",
+				  NULL);
+	feed_id = g_timeout_add(10, fu_udev_backend_deadline_cb, backend);
+	fu_test_loop_run_with_timeout(10000);
+	fu_test_loop_quit();
+	str = fu_udev_backend_pending_events_to_string(FU_UDEV_BACKEND(backend));
+	if (g_strcmp0(str, "") != 0)
+		g_source_remove(feed_id);
+	g_assert_cmpstr(str, ==, "");
+}
+#endif
+
+static XbSilo *
+fu_metadata_index_silo_from_xml(const gchar *xml)
+{
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbBuilder) builder = xb_builder_new();
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+	g_autoptr(XbSilo) silo = NULL;
+
+	ret = xb_builder_source_load_xml(source, xml, XB_BUILDER_SOURCE_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	xb_builder_import_source(builder, source);
+	silo = xb_builder_compile(builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+	return g_steal_pointer(&silo);
+}
+
+static void
+fu_metadata_index_func(void)
+{
+	gboolean ret;
+	const gchar *xml =
+	    "<components>\n"
+	    "  <component type=\"firmware\">\n"
+	    "    <id>com.acme.one</id>\n"
+	    "    <provides>\n"
+	    "      <firmware type=\"flashed\">2d47f29b-83a2-4f31-a2e8-63474f4d4c2e</firmware>\n"
+	    "    </provides>\n"
+	    "    <releases>\n"
+	    "      <release version=\"1.2.4\">\n"
+	    "        <checksum target=\"container\" type=\"sha1\">aaaa</checksum>\n"
+	    "      </release>\n"
+	    "      <release version=\"1.2.3\">\n"
+	    "        <artifacts>\n"
+	    "          <artifact type=\"binary\">\n"
+	    "            <checksum type=\"sha256\">bbbb</checksum>\n"
+	    "          </artifact>\n"
+	    "        </artifacts>\n"
+	    "      </release>\n"
+	    "    </releases>\n"
+	    "  </component>\n"
+	    "  <component type=\"firmware\">\n"
+	    "    <id>com.acme.two</id>\n"
+	    "    <provides>\n"
+	    "      <firmware type=\"flashed\">2d47f29b-83a2-4f31-a2e8-63474f4d4c2e</firmware>\n"
+	    "      <firmware type=\"flashed\">12345678-1234-1234-1234-123456789012</firmware>\n"
+	    "    </provides>\n"
+	    "    <releases>\n"
+	    "      <release version=\"2.0.0\">\n"
+	    "        <checksum target=\"container\" type=\"sha256\">bbbb</checksum>\n"
+	    "      </release>\n"
+	    "    </releases>\n"
+	    "  </component>\n"
+	    "</components>\n";
+	g_autoptr(FuMetadataIndex) index1 = fu_metadata_index_new();
+	g_autoptr(FuMetadataIndex) index2 = fu_metadata_index_new();
+	g_autoptr(FuMetadataIndex) index3 = fu_metadata_index_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path("/tmp/fwupd-self-test/metadata.idx");
+	g_autoptr(XbNode) component1 = NULL;
+	g_autoptr(XbNode) component2 = NULL;
+	g_autoptr(XbNode) component3 = NULL;
+	g_autoptr(XbNode) rel1 = NULL;
+	g_autoptr(XbNode) rel2 = NULL;
+	g_autoptr(XbNode) rel3 = NULL;
+	g_autoptr(XbSilo) silo = fu_metadata_index_silo_from_xml(xml);
+	g_autoptr(XbSilo) silo_other = fu_metadata_index_silo_from_xml("<components/>");
+
+	ret = fu_metadata_index_build(index1, silo, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the first component wins */
+	component1 =
+	    fu_metadata_index_get_component_by_guid(index1, "2d47f29b-83a2-4f31-a2e8-63474f4d4c2e");
+	g_assert_nonnull(component1);
+	g_assert_cmpstr(xb_node_query_text(component1, "id", NULL), ==, "com.acme.one");
+	component2 =
+	    fu_metadata_index_get_component_by_guid(index1, "12345678-1234-1234-1234-123456789012");
+	g_assert_nonnull(component2);
+	g_assert_cmpstr(xb_node_query_text(component2, "id", NULL), ==, "com.acme.two");
+	component3 =
+	    fu_metadata_index_get_component_by_guid(index1, "00000000-0000-0000-0000-000000000000");
+	g_assert_null(component3);
+
+	/* container checksums are preferred over artifact checksums */
+	rel1 = fu_metadata_index_get_release_by_checksum(index1, "aaaa");
+	g_assert_nonnull(rel1);
+	g_assert_cmpstr(xb_node_get_attr(rel1, "version"), ==, "1.2.4");
+	rel2 = fu_metadata_index_get_release_by_checksum(index1, "bbbb");
+	g_assert_nonnull(rel2);
+	g_assert_cmpstr(xb_node_get_attr(rel2, "version"), ==, "2.0.0");
+	rel3 = fu_metadata_index_get_release_by_checksum(index1, "cccc");
+	g_assert_null(rel3);
+
+	/* save, then map it back */
+	ret = fu_metadata_index_save_file(index1, file, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_metadata_index_load_file(index2, silo, file, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_object(&rel1);
+	rel1 = fu_metadata_index_get_release_by_checksum(index2, "aaaa");
+	g_assert_nonnull(rel1);
+	g_assert_cmpstr(xb_node_get_attr(rel1, "version"), ==, "1.2.4");
+
+	/* not valid for a different silo */
+	ret = fu_metadata_index_load_file(index3, silo_other, file, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_engine_generate_md_func(gconstpointer user_data)
 {
@@ -2046,18 +2274,26 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	FuTest *self = (FuTest *)user_data;
 	FwupdRelease *rel;
 	gboolean ret;
+	guint32 cache_hits = 0;
+	guint32 cache_hits_new = 0;
 	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
 	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(FuEngineRequest) request2 = fu_engine_request_new(NULL);
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_pre = NULL;
 	g_autoptr(GPtrArray) releases_dg = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
+	g_autoptr(GPtrArray) releases_approved = NULL;
+	g_autoptr(GPtrArray) releases_bootloader = NULL;
+	g_autoptr(GPtrArray) releases_cached = NULL;
 	g_autoptr(GPtrArray) releases_up = NULL;
 	g_autoptr(GPtrArray) releases_up2 = NULL;
+	g_autoptr(GPtrArray) releases_version = NULL;
 	g_autoptr(GPtrArray) remotes = NULL;
+	g_autoptr(GVariant) statistics = NULL;
 	g_autoptr(XbSilo) silo_empty = xb_silo_new();
 
 	/* ensure empty tree */
@@ -2192,6 +2428,27 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_assert_nonnull(releases);
 	g_assert_cmpint(releases->len, ==, 4);
 
+	/* the same releases are reused when nothing has changed, but not shared */
+	statistics = fu_engine_get_statistics(engine);
+	g_variant_ref_sink(statistics);
+	g_assert_true(g_variant_lookup(statistics, "ReleasesCacheHits", "u", &cache_hits));
+	g_clear_pointer(&statistics, g_variant_unref);
+	releases_cached =
+	    fu_engine_get_releases(engine, request2, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(releases_cached);
+	g_assert_cmpint(releases_cached->len, ==, 4);
+	g_assert_true(g_ptr_array_index(releases_cached, 0) != g_ptr_array_index(releases, 0));
+	g_assert_cmpstr(fu_release_get_version(g_ptr_array_index(releases_cached, 0)),
+			==,
+			fu_release_get_version(g_ptr_array_index(releases, 0)));
+	g_assert_true(fu_release_get_request(g_ptr_array_index(releases_cached, 0)) == request2);
+	g_assert_true(fu_release_get_device(g_ptr_array_index(releases_cached, 0)) == device);
+	statistics = fu_engine_get_statistics(engine);
+	g_variant_ref_sink(statistics);
+	g_assert_true(g_variant_lookup(statistics, "ReleasesCacheHits", "u", &cache_hits_new));
+	g_assert_cmpint(cache_hits_new, ==, cache_hits + 1);
+
 	/* no upgrades, as no firmware is approved */
 	releases_up = fu_engine_get_upgrades(engine, request, fu_device_get_id(device), &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO);
@@ -2205,6 +2462,14 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	fu_engine_add_approved_firmware(engine, "deadbeefdeadbeefdeadbeefdead4444");
 	fu_engine_add_approved_firmware(engine, "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
 
+	/* the releases are not reused when the approved firmware changes */
+	releases_approved =
+	    fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(releases_approved);
+	g_assert_cmpint(releases_approved->len, ==, 4);
+	g_assert_true(g_ptr_array_index(releases_approved, 0) != g_ptr_array_index(releases, 0));
+
 	/* upgrades */
 	releases_up = fu_engine_get_upgrades(engine, request, fu_device_get_id(device), &error);
 	g_assert_no_error(error);
@@ -2225,6 +2490,28 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	rel = FWUPD_RELEASE(g_ptr_array_index(releases_dg, 0));
 	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.2");
 
+	/* the releases are not reused when the version changes, even when changed back */
+	fu_device_set_version(device, "1.2.4");
+	fu_device_set_version(device, "1.2.3");
+	releases_version =
+	    fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(releases_version);
+	g_assert_cmpint(releases_version->len, ==, 4);
+	g_assert_true(g_ptr_array_index(releases_version, 0) !=
+		      g_ptr_array_index(releases_approved, 0));
+
+	/* or when the bootloader version changes */
+	fu_device_set_version_bootloader(device, "0.1.2");
+	fu_device_set_version_bootloader(device, NULL);
+	releases_bootloader =
+	    fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(releases_bootloader);
+	g_assert_cmpint(releases_bootloader->len, ==, 4);
+	g_assert_true(g_ptr_array_index(releases_bootloader, 0) !=
+		      g_ptr_array_index(releases_version, 0));
+
 	/* enforce that updates have to be explicit */
 	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_ONLY_EXPLICIT_UPDATES);
 	releases_up2 = fu_engine_get_upgrades(engine, request, fu_device_get_id(device), &error);
@@ -2863,6 +3150,192 @@ fu_engine_multiple_rels_func(gconstpointer user_data)
 	g_assert_true(ret);
 }
 
+typedef struct {
+	FuEngine *engine;
+	FuDevice *device;
+	GThread *thread;
+	gint64 last_usec;
+	gint64 max_interval_usec;
+	gint64 max_duration_usec;
+	guint cnt;
+	guint busy_cnt;
+	guint progress_cnt;
+	gboolean ret;
+	GError *error;
+} FuTestInstallAsyncHelper;
+
+static gboolean
+fu_engine_install_async_poll_cb(gpointer user_data)
+{
+	FuTestInstallAsyncHelper *helper = (FuTestInstallAsyncHelper *)user_data;
+	gint64 now = g_get_monotonic_time();
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) snapshots = NULL;
+	g_autoptr(GPtrArray) upgrades = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_upgrades = NULL;
+
+	/* this is what GetDevices() would do while the device is being flashed */
+	devices = fu_engine_get_devices(helper->engine, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	snapshots = fu_engine_get_device_snapshots(helper->engine, devices);
+	value = g_variant_ref_sink(fwupd_codec_array_to_variant(snapshots, FWUPD_CODEC_FLAG_NONE));
+	g_assert_nonnull(value);
+	if (helper->last_usec != 0)
+		helper->max_interval_usec = MAX(helper->max_interval_usec, now - helper->last_usec);
+	helper->last_usec = now;
+	helper->max_duration_usec =
+	    MAX(helper->max_duration_usec, g_get_monotonic_time() - now);
+	helper->cnt++;
+
+	/* GetUpgrades() is not serialized, but must not read the device being flashed */
+	upgrades = fu_engine_get_upgrades(helper->engine,
+					  request,
+					  fu_device_get_id(helper->device),
+					  &error_upgrades);
+	g_assert_null(upgrades);
+	if (g_error_matches(error_upgrades, FWUPD_ERROR, FWUPD_ERROR_BUSY))
+		helper->busy_cnt++;
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+fu_engine_install_async_percentage_changed_cb(FuProgress *progress,
+					      guint percentage,
+					      FuTestInstallAsyncHelper *helper)
+{
+	g_assert_true(g_thread_self() == helper->thread);
+	helper->progress_cnt++;
+}
+
+static void
+fu_engine_install_async_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FuTestInstallAsyncHelper *helper = (FuTestInstallAsyncHelper *)user_data;
+	g_assert_true(g_thread_self() == helper->thread);
+	helper->ret = fu_engine_install_releases_finish(FU_ENGINE(source), res, &helper->error);
+	fu_test_loop_quit();
+}
+
+static void
+fu_engine_install_async_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	guint poll_id;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GPtrArray) releases =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+	FuTestInstallAsyncHelper helper = {
+	    .engine = engine,
+	    .device = device,
+	    .thread = g_thread_self(),
+	};
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* set up dummy plugin that takes a long time to write */
+	ret = fu_plugin_reset_config_values(plugin, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_plugin_set_config_value(plugin, "WriteDelay", "500", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_engine_add_plugin(engine, plugin);
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* add a device so we can get upgrade it */
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.2");
+	fu_device_set_id(device, "test_device");
+	fu_device_build_vendor_id_u16(device, "USB", 0xFFFF);
+	fu_device_add_protocol(device, "com.acme");
+	fu_device_set_name(device, "Test Device");
+	fu_device_set_plugin(device, "test");
+	fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+	fu_device_set_created_usec(device, 1515338000ull * G_USEC_PER_SEC);
+	fu_engine_add_device(engine, device);
+
+	filename =
+	    g_test_build_filename(G_TEST_BUILT, "tests", "missing-hwid", "noreqs-1.2.3.cab", NULL);
+	stream = fu_input_stream_from_path(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream);
+	cabinet = fu_engine_build_cabinet_from_stream(engine, stream, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(cabinet);
+	component = fu_cabinet_get_component(cabinet, "com.hughski.test.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	fu_release_set_device(release, device);
+	ret = fu_release_load(release, cabinet, component, NULL, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_ptr_array_add(releases, g_object_ref(release));
+
+	/* install on the worker thread, and query the engine while that happens */
+	fu_progress_reset(progress);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_engine_install_async_percentage_changed_cb),
+			 &helper);
+	poll_id = g_timeout_add(10, fu_engine_install_async_poll_cb, &helper);
+	fu_engine_install_releases_async(engine,
+					 request,
+					 releases,
+					 cabinet,
+					 progress,
+					 FWUPD_INSTALL_FLAG_NONE,
+					 NULL,
+					 fu_engine_install_async_cb,
+					 &helper);
+	fu_test_loop_run_with_timeout(10000);
+	g_source_remove(poll_id);
+	g_assert_no_error(helper.error);
+	g_assert_true(helper.ret);
+	g_assert_cmpstr(fu_device_get_version(device), ==, "1.2.3");
+
+	/* the main context was never blocked for the duration of the 500ms write, and exporting
+	 * the devices did not wait for the worker */
+	g_debug("GetDevices() was called %u times, max interval %.1fms, max duration %.1fms",
+		helper.cnt,
+		(gdouble)helper.max_interval_usec / 1000.f,
+		(gdouble)helper.max_duration_usec / 1000.f);
+	g_assert_cmpint(helper.cnt, >, 1);
+	g_assert_cmpint(helper.max_interval_usec, <, 400 * 1000);
+	g_assert_cmpint(helper.max_duration_usec, <, 100 * 1000);
+	g_assert_cmpint(helper.busy_cnt, >, 0);
+	g_assert_cmpint(helper.progress_cnt, >, 0);
+
+	/* reset the config back to defaults */
+	ret = fu_engine_reset_config(engine, "test", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_engine_history_inherit(gconstpointer user_data)
 {
@@ -4105,6 +4578,124 @@ fu_plugin_list_depsolve_func(gconstpointer user_data)
 	g_assert_true(fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED));
 }
 
+static void
+fu_history_security_attrs_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuSecurityAttrs *attrs_tmp;
+	gboolean ret;
+	g_autofree gchar *digest = NULL;
+	g_autofree gchar *digest2 = NULL;
+	g_autofree gchar *digest3 = NULL;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuHistory) history = NULL;
+	g_autoptr(FuSecurityAttrs) attrs1 = fu_security_attrs_new();
+	g_autoptr(FuSecurityAttrs) attrs2 = fu_security_attrs_new();
+	g_autoptr(FwupdSecurityAttr) attr_bar = fwupd_security_attr_new("org.fwupd.hsi.bar");
+	g_autoptr(FwupdSecurityAttr) attr_baz = fwupd_security_attr_new("org.fwupd.hsi.baz");
+	g_autoptr(FwupdSecurityAttr) attr_foo1 = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr_foo2 = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr_tmp = NULL;
+	g_autoptr(GPtrArray) attrs_array = NULL;
+	g_autoptr(GError) error = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete the database */
+	history = fu_history_new(self->ctx);
+	dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	(void)g_unlink(filename);
+
+	/* nothing stored yet */
+	digest = fu_history_get_security_attrs_digest(history, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(digest);
+	g_clear_error(&error);
+
+	/* foo and bar */
+	fwupd_security_attr_set_plugin(attr_foo1, "foo");
+	fwupd_security_attr_set_result(attr_foo1, FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	fu_security_attrs_append(attrs1, attr_foo1);
+	fwupd_security_attr_set_plugin(attr_bar, "bar");
+	fwupd_security_attr_set_result(attr_bar, FWUPD_SECURITY_ATTR_RESULT_VALID);
+	fu_security_attrs_append(attrs1, attr_bar);
+	ret = fu_history_add_security_attrs(history, attrs1, "HSI:1", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* foo changed, bar removed and baz added -- stored twice as unchanged */
+	fwupd_security_attr_set_plugin(attr_foo2, "foo");
+	fwupd_security_attr_set_result(attr_foo2, FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	fu_security_attrs_append(attrs2, attr_foo2);
+	fwupd_security_attr_set_plugin(attr_baz, "baz");
+	fwupd_security_attr_set_result(attr_baz, FWUPD_SECURITY_ATTR_RESULT_VALID);
+	fu_security_attrs_append(attrs2, attr_baz);
+	for (guint i = 0; i < 2; i++) {
+		ret = fu_history_add_security_attrs(history, attrs2, "HSI:0", &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+
+	/* the digest is stored */
+	digest = fu_history_get_security_attrs_digest(history, &error);
+	g_assert_no_error(error);
+	digest2 = fu_security_attrs_get_digest(attrs2);
+	g_assert_cmpstr(digest, ==, digest2);
+
+	/* rebuilt from the compacted rows, without the duplicate */
+	attrs_array = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 2);
+	attrs_tmp = g_ptr_array_index(attrs_array, 0);
+	g_assert_true(fu_security_attrs_equal(attrs_tmp, attrs2));
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.bar", NULL);
+	g_assert_null(attr_tmp);
+	attrs_tmp = g_ptr_array_index(attrs_array, 1);
+	g_assert_true(fu_security_attrs_equal(attrs_tmp, attrs1));
+
+	/* the created timestamp is not part of the digest */
+	fwupd_security_attr_set_created(attr_baz, 1234);
+	digest3 = fu_security_attrs_get_digest(attrs2);
+	g_assert_cmpstr(digest3, ==, digest2);
+	g_clear_pointer(&digest3, g_free);
+
+	/* only the URL and fallback result of baz changed, which are compared when compacting and
+	 * so are also part of the digest */
+	fwupd_security_attr_set_url(attr_baz, "https://fwupd.org/");
+	fwupd_security_attr_set_result_fallback(attr_baz, FWUPD_SECURITY_ATTR_RESULT_SUPPORTED);
+	digest3 = fu_security_attrs_get_digest(attrs2);
+	g_assert_cmpstr(digest3, !=, digest2);
+	ret = fu_history_add_security_attrs(history, attrs2, "HSI:0", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_pointer(&digest, g_free);
+	digest = fu_history_get_security_attrs_digest(history, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(digest, ==, digest3);
+	g_clear_pointer(&attrs_array, g_ptr_array_unref);
+	g_clear_object(&attr_tmp);
+	attrs_array = fu_history_get_security_attrs(history, 1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 1);
+	attrs_tmp = g_ptr_array_index(attrs_array, 0);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.baz", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpstr(fwupd_security_attr_get_url(attr_tmp), ==, "https://fwupd.org/");
+	g_assert_cmpint(fwupd_security_attr_get_result_fallback(attr_tmp),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_SUPPORTED);
+}
+
 static void
 fu_history_migrate_v1_func(gconstpointer user_data)
 {
@@ -5345,6 +5936,41 @@ fu_release_no_trusted_report_func(gconstpointer user_data)
 	g_assert_false(fwupd_release_has_flag(rel, FWUPD_RELEASE_FLAG_TRUSTED_REPORT));
 }
 
+static XbNode *
+fu_test_cabinet_get_release(FuCabinet *cabinet)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) rel = NULL;
+	g_autoptr(XbQuery) query = NULL;
+
+	component = fu_cabinet_get_component(cabinet, "com.acme.example.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	query = xb_query_new_full(xb_node_get_silo(component),
+				  "releases/release",
+				  XB_QUERY_FLAG_FORCE_NODE_CACHE,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query);
+	rel = xb_node_query_first_full(component, query, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(rel);
+	return g_steal_pointer(&rel);
+}
+
+static void
+fu_test_cabinet_verify_release(FuCabinet *cabinet)
+{
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) rel = fu_test_cabinet_get_release(cabinet);
+
+	ret = fu_cabinet_verify_release(cabinet, rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_common_store_cab_func(void)
 {
@@ -5463,6 +6089,7 @@ fu_common_store_cab_artifact_func(void)
 				      &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	fu_test_cabinet_verify_release(cabinet1);
 
 	/* create silo (sha1, using artifacts object; mixed case) */
 	blob2 = fu_test_build_cab(FALSE,
@@ -5494,6 +6121,7 @@ fu_common_store_cab_artifact_func(void)
 				      &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	fu_test_cabinet_verify_release(cabinet2);
 
 	/* create silo (sha512, using artifacts object; lower case) */
 	blob3 = fu_test_build_cab(
@@ -5528,6 +6156,7 @@ fu_common_store_cab_artifact_func(void)
 				      &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	fu_test_cabinet_verify_release(cabinet3);
 
 	/* create silo (legacy release object) */
 	blob4 =
@@ -5557,6 +6186,7 @@ fu_common_store_cab_artifact_func(void)
 				      &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	fu_test_cabinet_verify_release(cabinet4);
 }
 
 static void
@@ -5644,6 +6274,7 @@ fu_common_store_cab_sha256_func(void)
 				      &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	fu_test_cabinet_verify_release(cabinet);
 }
 
 static void
@@ -5697,20 +6328,85 @@ fu_common_store_cab_folder_func(void)
 }
 
 static void
-fu_common_store_cab_error_no_metadata_func(void)
+fu_common_store_cab_lazy_func(void)
 {
 	gboolean ret;
 	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
+	g_autoptr(FuFirmware) img_fw = NULL;
+	g_autoptr(FuFirmware) img_other = NULL;
 	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_fw = NULL;
+	g_autoptr(GBytes) blob_other = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) rel = NULL;
 
-	blob = fu_test_build_cab(FALSE, "foo.txt", "hello", "bar.txt", "world", NULL);
-	ret = fu_firmware_parse_bytes(FU_FIRMWARE(cabinet),
-				      blob,
-				      0x0,
-				      FWUPD_INSTALL_FLAG_NONE,
-				      &error);
-	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	/* create compressed archive with a payload that is never used */
+	blob = fu_test_build_cab(
+	    TRUE,
+	    "acme.metainfo.xml",
+	    "<component type=\"firmware\">\n"
+	    "  <id>com.acme.example.firmware</id>\n"
+	    "  <releases>\n"
+	    "    <release version=\"1.2.3\" date=\"2017-09-06\">\n"
+	    "      <checksum target=\"content\" "
+	    "type=\"sha256\">486ea46224d1bb4fb680f34f7c9ad96a8f24ec88be73ea8e5a6c65260e9cb8a7</"
+	    "checksum>\n"
+	    "    </release>\n"
+	    "  </releases>\n"
+	    "</component>",
+	    "firmware.bin",
+	    "world",
+	    "other.bin",
+	    "unused",
+	    NULL);
+	ret = fu_firmware_parse_bytes(FU_FIRMWARE(cabinet),
+				      blob,
+				      0x0,
+				      FWUPD_INSTALL_FLAG_NONE,
+				      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* nothing decompressed yet */
+	img_fw = fu_firmware_get_image_by_id(FU_FIRMWARE(cabinet), "firmware.bin", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img_fw);
+	g_assert_cmpint(fu_firmware_get_size(img_fw), ==, 5);
+	blob_fw = fu_firmware_get_bytes(img_fw, NULL);
+	g_assert_null(blob_fw);
+
+	/* only the payload for the release gets decompressed */
+	rel = fu_test_cabinet_get_release(cabinet);
+	ret = fu_cabinet_verify_release(cabinet, rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob_fw = fu_firmware_get_bytes(img_fw, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_fw);
+	g_assert_cmpint(g_bytes_get_size(blob_fw), ==, 5);
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob_fw, NULL), "world", 5), ==, 0);
+	img_other = fu_firmware_get_image_by_id(FU_FIRMWARE(cabinet), "other.bin", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img_other);
+	blob_other = fu_firmware_get_bytes(img_other, NULL);
+	g_assert_null(blob_other);
+}
+
+static void
+fu_common_store_cab_error_no_metadata_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	blob = fu_test_build_cab(FALSE, "foo.txt", "hello", "bar.txt", "world", NULL);
+	ret = fu_firmware_parse_bytes(FU_FIRMWARE(cabinet),
+				      blob,
+				      0x0,
+				      FWUPD_INSTALL_FLAG_NONE,
+				      &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
 	g_assert_false(ret);
 }
 
@@ -5812,6 +6508,7 @@ fu_common_store_cab_error_wrong_checksum_func(void)
 	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) rel = NULL;
 
 	blob = fu_test_build_cab(FALSE,
 				 "acme.metainfo.xml",
@@ -5832,10 +6529,126 @@ fu_common_store_cab_error_wrong_checksum_func(void)
 				      0x0,
 				      FWUPD_INSTALL_FLAG_NONE,
 				      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the payload is only checked when required */
+	rel = fu_test_cabinet_get_release(cabinet);
+	ret = fu_cabinet_verify_release(cabinet, rel, &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
 	g_assert_false(ret);
 }
 
+static FuCabinet *
+fu_test_cabinet_new_for_release(const gchar *checksum)
+{
+	gboolean ret;
+	g_autofree gchar *xml = NULL;
+	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	xml = g_strdup_printf("<component type=\"firmware\">\n"
+			      "  <id>com.acme.example.firmware</id>\n"
+			      "  <releases>\n"
+			      "    <release version=\"1.2.3\">\n"
+			      "      <checksum filename=\"firmware.bin\" target=\"content\" "
+			      "type=\"sha1\">%s</checksum>\n"
+			      "    </release>\n"
+			      "  </releases>\n"
+			      "</component>",
+			      checksum);
+	blob = fu_test_build_cab(TRUE, "acme.metainfo.xml", xml, "firmware.bin", "world", NULL);
+	ret = fu_firmware_parse_bytes(FU_FIRMWARE(cabinet),
+				      blob,
+				      0x0,
+				      FWUPD_INSTALL_FLAG_NONE,
+				      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	return g_steal_pointer(&cabinet);
+}
+
+static void
+fu_release_load_cab_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GBytes) blob_fw = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) rel = NULL;
+
+	/* the payload is decompressed and verified when loading the release */
+	cabinet = fu_test_cabinet_new_for_release("7c211433f02071597741e6ff5a8ea34789abbf43");
+	component = fu_cabinet_get_component(cabinet, "com.acme.example.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	rel = fu_test_cabinet_get_release(cabinet);
+	fu_release_set_request(release, request);
+	ret = fu_release_load(release, cabinet, component, rel, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_nonnull(fu_release_get_stream(release));
+	blob_fw = fu_input_stream_read_bytes(fu_release_get_stream(release), 0x0, 5, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_fw);
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob_fw, NULL), "world", 5), ==, 0);
+}
+
+static void
+fu_release_load_cab_wrong_checksum_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) rel = NULL;
+
+	/* parsing the archive does not check the payload, but loading the release does */
+	cabinet = fu_test_cabinet_new_for_release("deadbeefdeadbeefdeadbeefdeadbeefdeadbeef");
+	component = fu_cabinet_get_component(cabinet, "com.acme.example.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	rel = fu_test_cabinet_get_release(cabinet);
+	fu_release_set_request(release, request);
+	ret = fu_release_load(release, cabinet, component, rel, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_false(ret);
+	g_assert_null(fu_release_get_stream(release));
+}
+
+static void
+fu_release_load_cab_missing_payload_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(NULL);
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) rel = NULL;
+
+	/* the payload has gone away since the archive was parsed */
+	cabinet = fu_test_cabinet_new_for_release("7c211433f02071597741e6ff5a8ea34789abbf43");
+	component = fu_cabinet_get_component(cabinet, "com.acme.example.firmware", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	rel = fu_test_cabinet_get_release(cabinet);
+	ret = fu_firmware_remove_image_by_id(FU_FIRMWARE(cabinet), "firmware.bin", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_release_set_request(release, request);
+	ret = fu_release_load(release, cabinet, component, rel, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_assert_null(fu_release_get_stream(release));
+}
+
 static void
 fu_engine_modify_bios_settings_func(gconstpointer user_data)
 {
@@ -6531,6 +7344,324 @@ fu_engine_machine_hash_func(void)
 	g_assert_cmpstr(mhash2, !=, mhash1);
 }
 
+static void
+fu_engine_devices_file_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *checksum1 = NULL;
+	g_autofree gchar *checksum2 = NULL;
+	g_autofree gchar *checksum3 = NULL;
+	g_autofree gchar *directory = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *fn = g_build_filename(directory, "devices.json", NULL);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JsonParser) parser1 = json_parser_new();
+	g_autoptr(JsonParser) parser2 = json_parser_new();
+
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = json_parser_load_from_data(parser1, "{\"Devices\":[]}", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = json_parser_load_from_data(parser2, "{\"Devices\":[{\"Name\":\"foo\"}]}", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* first write */
+	checksum1 = fu_engine_devices_file_write(json_parser_get_root(parser1), NULL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksum1);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+
+	/* unchanged content is not written again */
+	g_unlink(fn);
+	checksum2 = fu_engine_devices_file_write(json_parser_get_root(parser1), checksum1, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(checksum2, ==, checksum1);
+	g_assert_false(g_file_test(fn, G_FILE_TEST_EXISTS));
+
+	/* new content is */
+	checksum3 = fu_engine_devices_file_write(json_parser_get_root(parser2), checksum2, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(checksum3, !=, checksum2);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+}
+
+static void
+fu_engine_plugins_threaded_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	FuPlugin *plugins[3] = {NULL};
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuPlugin) plugin1 =
+	    fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuPlugin) plugin2 =
+	    fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuPlugin) plugin3 =
+	    fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* plugin1 and plugin2 have no rules between them, but plugin3 has to run after plugin1 */
+	fu_plugin_set_name(plugin2, "test2");
+	fu_plugin_set_name(plugin3, "test3");
+	fu_plugin_add_rule(plugin3, FU_PLUGIN_RULE_RUN_AFTER, "test");
+	plugins[0] = plugin1;
+	plugins[1] = plugin2;
+	plugins[2] = plugin3;
+	for (guint i = 0; i < G_N_ELEMENTS(plugins); i++) {
+		fu_plugin_set_thread_safe(plugins[i], TRUE);
+		ret = fu_plugin_set_config_value(plugins[i], "StartupDelay", "50", &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		fu_engine_add_plugin(engine, plugins[i]);
+	}
+
+	/* start and coldplug the test plugins in worker threads */
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				 FU_ENGINE_LOAD_FLAG_NO_IDLE_SOURCES,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < G_N_ELEMENTS(plugins); i++) {
+		g_assert_false(fu_plugin_has_flag(plugins[i], FWUPD_PLUGIN_FLAG_DISABLED));
+		g_assert_cmpint(fu_test_plugin_get_startup_end(FU_TEST_PLUGIN(plugins[i])), >, 0);
+	}
+	g_assert_cmpint(fu_plugin_get_order(plugin1), ==, fu_plugin_get_order(plugin2));
+	g_assert_cmpint(fu_plugin_get_order(plugin3), >, fu_plugin_get_order(plugin1));
+
+	/* plugin1 and plugin2 were run at the same time */
+	if (g_get_num_processors() > 1) {
+		g_assert_cmpint(fu_test_plugin_get_startup_begin(FU_TEST_PLUGIN(plugin2)),
+				<,
+				fu_test_plugin_get_startup_end(FU_TEST_PLUGIN(plugin1)));
+		g_assert_cmpint(fu_test_plugin_get_startup_begin(FU_TEST_PLUGIN(plugin1)),
+				<,
+				fu_test_plugin_get_startup_end(FU_TEST_PLUGIN(plugin2)));
+	}
+
+	/* plugin3 only started when everything in the previous order had finished */
+	g_assert_cmpint(fu_test_plugin_get_startup_begin(FU_TEST_PLUGIN(plugin3)),
+			>=,
+			fu_test_plugin_get_startup_end(FU_TEST_PLUGIN(plugin1)));
+	g_assert_cmpint(fu_test_plugin_get_startup_begin(FU_TEST_PLUGIN(plugin3)),
+			>=,
+			fu_test_plugin_get_startup_end(FU_TEST_PLUGIN(plugin2)));
+
+	/* the device was added in this thread */
+	device = fu_engine_get_device(engine, "08d460be0f1f9f128413f816022a6439e0078018", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device);
+
+	/* reset */
+	for (guint i = 0; i < G_N_ELEMENTS(plugins); i++) {
+		ret = fu_plugin_reset_config_values(plugins[i], &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+}
+
+static void
+fu_engine_setup_cache_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	JsonNode *json_node;
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) setup_cache = g_hash_table_new_full(g_str_hash,
+								  g_str_equal,
+								  g_free,
+								  (GDestroyNotify)json_node_unref);
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+	fu_engine_add_plugin(engine, plugin);
+
+	/* do not load the setup cache from disk */
+	fu_context_set_setup_cache(self->ctx, setup_cache);
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				 FU_ENGINE_LOAD_FLAG_NO_IDLE_SOURCES,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* set up the device, which adds it to the cache without the runtime flags */
+	fu_device_set_id(device1, "setup-cache");
+	fu_device_set_backend_id(device1, "usb:FF:FF:06");
+	fu_device_set_physical_id(device1, "usb:FF:FF:06");
+	fu_device_add_instance_id(device1, "USB\\VID_FFFF&PID_0006");
+	fu_device_add_protocol(device1, "com.acme");
+	fu_device_set_version_format(device1, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device1, "1.2.3");
+	fu_device_add_flag(device1, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_flag(device1, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+	fu_device_add_flag(device1, FWUPD_DEVICE_FLAG_NEEDS_ACTIVATION);
+	fu_device_set_specialized_gtype(device1, FU_TYPE_DEVICE);
+	fu_progress_reset(progress);
+	ret = fu_plugin_runner_backend_device_added(plugin, device1, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(g_hash_table_size(setup_cache), ==, 1);
+
+	/* the same hardware is restored from the cache */
+	fu_device_set_id(device2, "setup-cache");
+	fu_device_set_backend_id(device2, "usb:FF:FF:06");
+	fu_device_set_physical_id(device2, "usb:FF:FF:06");
+	fu_device_add_instance_id(device2, "USB\\VID_FFFF&PID_0006");
+	fu_device_set_specialized_gtype(device2, FU_TYPE_DEVICE);
+	fu_progress_reset(progress);
+	ret = fu_plugin_runner_backend_device_added(plugin, device2, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	device = fu_engine_get_device(engine, fu_device_get_id(device2), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device);
+	g_assert_nonnull(fu_device_get_setup_cache_key(device));
+	g_assert_cmpstr(fu_device_get_version(device), ==, "1.2.3");
+	g_assert_true(fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE));
+	g_assert_false(fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NEEDS_ACTIVATION));
+
+	/* runtime flags do not invalidate the cache */
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_NEEDS_REBOOT);
+	json_node = g_hash_table_lookup(setup_cache, fu_device_get_setup_cache_key(device));
+	g_assert_nonnull(json_node);
+	g_assert_true(fu_device_matches_setup_snapshot(device, json_node));
+	g_assert_cmpint(g_hash_table_size(setup_cache), ==, 1);
+
+	/* the version changed without the device being re-enumerated */
+	fu_device_set_version(device, "1.2.4");
+	g_assert_cmpint(g_hash_table_size(setup_cache), ==, 0);
+	g_assert_null(fu_device_get_setup_cache_key(device));
+
+	/* reset */
+	fu_context_set_setup_cache(self->ctx, NULL);
+}
+
+static gboolean
+fu_engine_security_statistics_get_cached(GVariant *statistics, const gchar *producer)
+{
+	GVariant *stat;
+	GVariantIter iter;
+
+	g_variant_iter_init(&iter, statistics);
+	while ((stat = g_variant_iter_next_value(&iter))) {
+		const gchar *producer_tmp = NULL;
+		gboolean cached = FALSE;
+
+		g_variant_lookup(stat, "Producer", "&s", &producer_tmp);
+		g_variant_lookup(stat, "Cached", "b", &cached);
+		if (g_strcmp0(producer_tmp, producer) == 0) {
+			g_variant_unref(stat);
+			return cached;
+		}
+		g_variant_unref(stat);
+	}
+	g_assert_not_reached();
+	return FALSE;
+}
+
+static void
+fu_engine_security_attrs_cache_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	const gchar *device_key = "device:08d460be0f1f9f128413f816022a6439e0078018";
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuSecurityAttrs) attrs = NULL;
+	g_autoptr(FwupdSecurityAttr) attr = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) statistics1 = NULL;
+	g_autoptr(GVariant) statistics2 = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+#ifndef HAVE_HSI
+	g_test_skip("no HSI support");
+	return;
+#endif
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* the test plugin adds one attribute and one device */
+	ret = fu_plugin_reset_config_values(plugin, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_plugin_set_config_value(plugin, "SecurityAttrs", "true", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_engine_add_plugin(engine, plugin);
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				 FU_ENGINE_LOAD_FLAG_NO_IDLE_SOURCES,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* everything is computed the first time */
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	attrs = fu_engine_get_host_security_attrs(engine);
+	attr = fu_security_attrs_get_by_appstream_id(attrs,
+						     FWUPD_SECURITY_ATTR_ID_ENCRYPTED_RAM,
+						     &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attr);
+	g_assert_cmpstr(fwupd_security_attr_get_plugin(attr), ==, "test");
+	statistics1 = g_variant_ref_sink(fu_engine_get_host_security_statistics(engine));
+	g_assert_false(fu_engine_security_statistics_get_cached(statistics1, "plugin:test"));
+	g_assert_false(fu_engine_security_statistics_get_cached(statistics1, device_key));
+
+	/* plugins have to be recomputed, but the device attributes are reused */
+	fu_context_security_changed(self->ctx);
+	g_assert_nonnull(fu_engine_get_host_security_id(engine));
+	statistics2 = g_variant_ref_sink(fu_engine_get_host_security_statistics(engine));
+	g_assert_false(fu_engine_security_statistics_get_cached(statistics2, "plugin:test"));
+	g_assert_true(fu_engine_security_statistics_get_cached(statistics2, device_key));
+
+	/* the recomputed attribute is still merged */
+	g_clear_object(&attrs);
+	g_clear_object(&attr);
+	attrs = fu_engine_get_host_security_attrs(engine);
+	attr = fu_security_attrs_get_by_appstream_id(attrs,
+						     FWUPD_SECURITY_ATTR_ID_ENCRYPTED_RAM,
+						     &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attr);
+
+	/* restore default */
+	ret = fu_plugin_reset_config_values(plugin, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_test_engine_fake_hidraw(gconstpointer user_data)
 {
@@ -6954,6 +8085,11 @@ main(int argc, char **argv)
 		g_test_add_data_func("/fwupd/console", self, fu_console_func);
 	}
 	g_test_add_func("/fwupd/idle", fu_idle_func);
+#ifdef HAVE_UDEV
+	g_test_add_data_func("/fwupd/udev-backend{coalesce}", self, fu_udev_backend_coalesce_func);
+	g_test_add_data_func("/fwupd/udev-backend{deadline}", self, fu_udev_backend_deadline_func);
+#endif
+	g_test_add_func("/fwupd/metadata-index", fu_metadata_index_func);
 	g_test_add_func("/fwupd/client-list", fu_client_list_func);
 	g_test_add_func("/fwupd/remote{download}", fu_remote_download_func);
 	g_test_add_func("/fwupd/remote{no-path}", fu_remote_nopath_func);
@@ -7028,6 +8164,14 @@ main(int argc, char **argv)
 			     self,
 			     fu_engine_multiple_rels_func);
 	g_test_add_data_func("/fwupd/engine{install-request}", self, fu_engine_install_request);
+	g_test_add_data_func("/fwupd/engine{install-async}", self, fu_engine_install_async_func);
+	g_test_add_data_func("/fwupd/engine{plugins-threaded}",
+			     self,
+			     fu_engine_plugins_threaded_func);
+	g_test_add_data_func("/fwupd/engine{setup-cache}", self, fu_engine_setup_cache_func);
+	g_test_add_data_func("/fwupd/engine{security-attrs-cache}",
+			     self,
+			     fu_engine_security_attrs_cache_func);
 	g_test_add_data_func("/fwupd/engine{history-success}", self, fu_engine_history_func);
 	g_test_add_data_func("/fwupd/engine{history-verfmt}", self, fu_engine_history_verfmt_func);
 	g_test_add_data_func("/fwupd/engine{history-modify}", self, fu_engine_history_modify_func);
@@ -7050,6 +8194,7 @@ main(int argc, char **argv)
 			     self,
 			     fu_device_list_replug_user_func);
 	g_test_add_func("/fwupd/engine{machine-hash}", fu_engine_machine_hash_func);
+	g_test_add_func("/fwupd/engine{devices-file}", fu_engine_devices_file_func);
 	g_test_add_data_func("/fwupd/engine{require-hwid}", self, fu_engine_require_hwid_func);
 	g_test_add_data_func("/fwupd/engine{requires-reboot}",
 			     self,
@@ -7134,6 +8279,9 @@ main(int argc, char **argv)
 			     fu_engine_requirements_sibling_device_func);
 	g_test_add_data_func("/fwupd/plugin{composite}", self, fu_plugin_composite_func);
 	g_test_add_data_func("/fwupd/history", self, fu_history_func);
+	g_test_add_data_func("/fwupd/history{security-attrs}",
+			     self,
+			     fu_history_security_attrs_func);
 	g_test_add_data_func("/fwupd/history{migrate-v1}", self, fu_history_migrate_v1_func);
 	g_test_add_data_func("/fwupd/history{migrate-v2}", self, fu_history_migrate_v2_func);
 	g_test_add_data_func("/fwupd/plugin-list", self, fu_plugin_list_func);
@@ -7143,6 +8291,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{cab-success-unsigned}", fu_common_store_cab_unsigned_func);
 	g_test_add_func("/fwupd/common{cab-success-folder}", fu_common_store_cab_folder_func);
 	g_test_add_func("/fwupd/common{cab-success-sha256}", fu_common_store_cab_sha256_func);
+	g_test_add_func("/fwupd/common{cab-success-lazy}", fu_common_store_cab_lazy_func);
 	g_test_add_func("/fwupd/common{cab-error-no-metadata}",
 			fu_common_store_cab_error_no_metadata_func);
 	g_test_add_func("/fwupd/common{cab-error-wrong-size}",
@@ -7152,6 +8301,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{cab-error-missing-file}",
 			fu_common_store_cab_error_missing_file_func);
 	g_test_add_func("/fwupd/common{cab-error-size}", fu_common_store_cab_error_size_func);
+	g_test_add_func("/fwupd/release{load-cab}", fu_release_load_cab_func);
+	g_test_add_func("/fwupd/release{load-cab-wrong-checksum}",
+			fu_release_load_cab_wrong_checksum_func);
+	g_test_add_func("/fwupd/release{load-cab-missing-payload}",
+			fu_release_load_cab_missing_payload_func);
 	g_test_add_data_func("/fwupd/write-bios-attrs", self, fu_engine_modify_bios_settings_func);
 
 	/* these need to be last as they overwrite stuff in the mkroot */
@@ -28,18 +28,134 @@ struct _FuUdevBackend {
 	GHashTable *map_paths;	      /* of str:None */
 	GPtrArray *dpaux_devices;     /* of FuDpauxDevice */
 	guint dpaux_devices_rescan_id;
+	GHashTable *pending_events; /* sysfs:FuUdevBackendEvent */
+	guint pending_events_id;
+	gint64 pending_events_deadline; /* monotonic, us */
+	guint events_received;
+	guint events_coalesced;
+	guint event_batches;
 	gboolean done_coldplug;
 };
 
 G_DEFINE_TYPE(FuUdevBackend, fu_udev_backend, FU_TYPE_BACKEND)
 
 #define FU_UDEV_BACKEND_DPAUX_RESCAN_DELAY 5 /* s */
+#define FU_UDEV_BACKEND_COALESCE_DELAY	   50  /* ms */
+#define FU_UDEV_BACKEND_COALESCE_MAX_DELAY 500 /* ms */
+
+typedef struct {
+	FuUdevAction action;
+	gchar *sysfs_path;
+	FuUdevDevice *donor; /* (nullable) */
+	gboolean remove_first;
+} FuUdevBackendEvent;
+
+static void
+fu_udev_backend_event_free(FuUdevBackendEvent *event)
+{
+	if (event->donor != NULL)
+		g_object_unref(event->donor);
+	g_free(event->sysfs_path);
+	g_free(event);
+}
+
+static guint
+fu_udev_backend_event_get_depth(FuUdevBackendEvent *event)
+{
+	guint depth = 0;
+	for (guint i = 0; event->sysfs_path[i] != '\0'; i++) {
+		if (event->sysfs_path[i] == '/')
+			depth++;
+	}
+	return depth;
+}
+
+/* removals of children first, then additions and changes of parents first */
+static gint
+fu_udev_backend_event_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FuUdevBackendEvent *event1 = *((FuUdevBackendEvent **)a);
+	FuUdevBackendEvent *event2 = *((FuUdevBackendEvent **)b);
+	gboolean remove1 = event1->action == FU_UDEV_ACTION_REMOVE;
+	gboolean remove2 = event2->action == FU_UDEV_ACTION_REMOVE;
+	guint depth1 = fu_udev_backend_event_get_depth(event1);
+	guint depth2 = fu_udev_backend_event_get_depth(event2);
+
+	if (remove1 != remove2)
+		return remove1 ? -1 : 1;
+	if (depth1 != depth2) {
+		if (remove1)
+			return depth1 > depth2 ? -1 : 1;
+		return depth1 < depth2 ? -1 : 1;
+	}
+	return g_strcmp0(event1->sysfs_path, event2->sysfs_path);
+}
+
+/* take everything that survived the coalescing window, in the order it should be processed */
+static GPtrArray *
+fu_udev_backend_steal_pending_events(FuUdevBackend *self)
+{
+	GHashTableIter iter;
+	FuUdevBackendEvent *event;
+	GPtrArray *events =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_udev_backend_event_free);
+
+	g_hash_table_iter_init(&iter, self->pending_events);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&event)) {
+		g_ptr_array_add(events, event);
+		g_hash_table_iter_steal(&iter);
+	}
+	g_ptr_array_sort(events, fu_udev_backend_event_sort_cb);
+	return events;
+}
+
+/**
+ * fu_udev_backend_pending_events_to_string:
+ * @self: a #FuUdevBackend
+ *
+ * Describes the events that are waiting for the coalescing window to close, in the order they
+ * will be processed.
+ *
+ * Returns: (transfer full): a string, one event per line
+ **/
+gchar *
+fu_udev_backend_pending_events_to_string(FuUdevBackend *self)
+{
+	GHashTableIter iter;
+	FuUdevBackendEvent *event;
+	GString *str;
+	g_autoptr(GPtrArray) events = g_ptr_array_new();
+
+	g_return_val_if_fail(FU_IS_UDEV_BACKEND(self), NULL);
+
+	str = g_string_new(NULL);
+	g_hash_table_iter_init(&iter, self->pending_events);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&event))
+		g_ptr_array_add(events, event);
+	g_ptr_array_sort(events, fu_udev_backend_event_sort_cb);
+	for (guint i = 0; i < events->len; i++) {
+		event = g_ptr_array_index(events, i);
+		g_string_append_printf(str,
+				       "%s%s:%s\n",
+				       fu_udev_action_to_string(event->action),
+				       event->remove_first ? ",replug" : "",
+				       event->sysfs_path);
+	}
+	return g_string_free(str, FALSE);
+}
 
 static void
 fu_udev_backend_to_string(FuBackend *backend, guint idt, GString *str)
 {
 	FuUdevBackend *self = FU_UDEV_BACKEND(backend);
 	fwupd_codec_string_append_bool(str, idt, "DoneColdplug", self->done_coldplug);
+	fwupd_codec_string_append_int(str, idt, "EventsReceived", self->events_received);
+	fwupd_codec_string_append_int(str, idt, "EventsCoalesced", self->events_coalesced);
+	fwupd_codec_string_append_int(str, idt, "EventBatches", self->event_batches);
+	if (g_hash_table_size(self->pending_events) > 0) {
+		g_autofree gchar *tmp = fu_udev_backend_pending_events_to_string(self);
+		fwupd_codec_string_append(str, idt, "PendingEvents", tmp);
+	}
 }
 
 static void
@@ -417,6 +533,122 @@ fu_udev_backend_coldplug_subsystem(FuUdevBackend *self, const gchar *fn)
 	}
 }
 
+static void
+fu_udev_backend_device_add_from_donor(FuUdevBackend *self, FuUdevDevice *device_donor)
+{
+	g_autoptr(FuDevice) device_actual = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* now create the actual device from the donor */
+	device_actual = fu_udev_backend_create_device_for_donor(FU_BACKEND(self),
+								FU_DEVICE(device_donor),
+								&error_local);
+	if (device_actual == NULL) {
+		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+			g_debug("ignoring add: %s", error_local->message);
+			return;
+		}
+		g_warning("ignoring add: %s", error_local->message);
+		return;
+	}
+	fu_udev_backend_device_add_from_device(self, FU_UDEV_DEVICE(device_actual));
+}
+
+static gboolean
+fu_udev_backend_pending_events_cb(gpointer user_data)
+{
+	FuUdevBackend *self = FU_UDEV_BACKEND(user_data);
+	g_autoptr(GPtrArray) events = fu_udev_backend_steal_pending_events(self);
+
+	self->pending_events_id = 0;
+	self->pending_events_deadline = 0;
+	self->event_batches++;
+
+	g_debug("processing %u coalesced udev events", events->len);
+	for (guint i = 0; i < events->len; i++) {
+		FuUdevBackendEvent *event = g_ptr_array_index(events, i);
+		if (event->remove_first || event->action == FU_UDEV_ACTION_REMOVE)
+			fu_udev_backend_device_remove(self, event->sysfs_path);
+		if (event->action == FU_UDEV_ACTION_CHANGE)
+			fu_udev_backend_device_changed(self, event->sysfs_path);
+		if (event->action == FU_UDEV_ACTION_ADD)
+			fu_udev_backend_device_add_from_donor(self, event->donor);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+/* merge the new event with any pending event for the same sysfs path */
+static void
+fu_udev_backend_add_pending_event(FuUdevBackend *self, FuUdevBackendEvent *event)
+{
+	FuUdevBackendEvent *event_old;
+	gint64 now = g_get_monotonic_time();
+	guint delay = FU_UDEV_BACKEND_COALESCE_DELAY;
+
+	self->events_received++;
+	event_old = g_hash_table_lookup(self->pending_events, event->sysfs_path);
+	if (event_old == NULL) {
+		g_hash_table_insert(self->pending_events, event->sysfs_path, event);
+	} else if (event->action == FU_UDEV_ACTION_CHANGE) {
+		/* a change after anything else tells us nothing new */
+		self->events_coalesced++;
+		fu_udev_backend_event_free(event);
+	} else if (event->action == FU_UDEV_ACTION_REMOVE &&
+		   event_old->action == FU_UDEV_ACTION_ADD && !event_old->remove_first) {
+		/* the device was never added, so there is nothing to remove */
+		g_debug("ignoring transient device %s", event->sysfs_path);
+		g_hash_table_remove(self->pending_events, event->sysfs_path);
+		self->events_coalesced += 2;
+		fu_udev_backend_event_free(event);
+	} else {
+		/* an add after a remove is a replug of a device we might already know about */
+		if (event->action == FU_UDEV_ACTION_ADD) {
+			event->remove_first = event_old->action == FU_UDEV_ACTION_REMOVE ||
+					      event_old->remove_first;
+		}
+		g_hash_table_replace(self->pending_events, event->sysfs_path, event);
+		self->events_coalesced++;
+	}
+
+	/* process the surviving events when the burst is over, but do not let a steady stream
+	 * of events postpone processing for longer than the maximum latency */
+	if (self->pending_events_deadline == 0)
+		self->pending_events_deadline = now + FU_UDEV_BACKEND_COALESCE_MAX_DELAY * 1000;
+	if (now + delay * 1000 > self->pending_events_deadline)
+		delay = MAX(self->pending_events_deadline - now, 0) / 1000;
+	if (self->pending_events_id != 0)
+		g_source_remove(self->pending_events_id);
+	self->pending_events_id = g_timeout_add(delay, fu_udev_backend_pending_events_cb, self);
+}
+
+/**
+ * fu_udev_backend_add_event:
+ * @self: a #FuUdevBackend
+ * @action: a #FuUdevAction, e.g. %FU_UDEV_ACTION_ADD
+ * @sysfs_path: a sysfs path
+ * @donor: (nullable): a #FuUdevDevice, required for %FU_UDEV_ACTION_ADD
+ *
+ * Queues a hotplug event, which is coalesced with any other events for the same sysfs path that
+ * arrive before the coalescing window closes.
+ **/
+void
+fu_udev_backend_add_event(FuUdevBackend *self,
+			  FuUdevAction action,
+			  const gchar *sysfs_path,
+			  FuUdevDevice *donor)
+{
+	FuUdevBackendEvent *event = g_new0(FuUdevBackendEvent, 1);
+
+	g_return_if_fail(FU_IS_UDEV_BACKEND(self));
+	g_return_if_fail(sysfs_path != NULL);
+
+	event->action = action;
+	event->sysfs_path = g_strdup(sysfs_path);
+	if (donor != NULL)
+		event->donor = g_object_ref(donor);
+	fu_udev_backend_add_pending_event(self, event);
+}
+
 static gboolean
 fu_udev_backend_netlink_parse_blob(FuUdevBackend *self, GBytes *blob, GError **error)
 {
@@ -426,7 +658,6 @@ fu_udev_backend_netlink_parse_blob(FuUdevBackend *self, GBytes *blob, GError **e
 	gsize bufsz = 0;
 	g_autofree gchar *sysfsdir = fu_path_from_kind(FU_PATH_KIND_SYSFSDIR);
 	g_autoptr(FuStructUdevMonitorNetlinkHeader) st_hdr = NULL;
-	g_autoptr(FuUdevDevice) device_actual = NULL;
 	g_autoptr(FuUdevDevice) device_donor = NULL;
 	g_autoptr(GBytes) blob_payload = NULL;
 
@@ -474,15 +705,9 @@ fu_udev_backend_netlink_parse_blob(FuUdevBackend *self, GBytes *blob, GError **e
 		} else if (g_strcmp0(kv[0], "DEVPATH") == 0) {
 			g_autofree gchar *sysfspath = g_build_filename(sysfsdir, kv[1], NULL);
 
-			/* something changed */
-			if (action == FU_UDEV_ACTION_CHANGE) {
-				fu_udev_backend_device_changed(self, sysfspath);
-				return TRUE;
-			}
-
-			/* something got removed */
-			if (action == FU_UDEV_ACTION_REMOVE) {
-				fu_udev_backend_device_remove(self, sysfspath);
+			/* something changed or got removed */
+			if (action == FU_UDEV_ACTION_CHANGE || action == FU_UDEV_ACTION_REMOVE) {
+				fu_udev_backend_add_event(self, action, sysfspath, NULL);
 				return TRUE;
 			}
 
@@ -518,16 +743,11 @@ fu_udev_backend_netlink_parse_blob(FuUdevBackend *self, GBytes *blob, GError **e
 		return FALSE;
 	}
 
-	/* now create the actual device from the donor */
-	device_actual =
-	    FU_UDEV_DEVICE(fu_udev_backend_create_device_for_donor(FU_BACKEND(self),
-								   FU_DEVICE(device_donor),
-								   error));
-	if (device_actual == NULL)
-		return FALSE;
-
-	/* success */
-	fu_udev_backend_device_add_from_device(self, device_actual);
+	/* the device is created when the coalescing window closes */
+	fu_udev_backend_add_event(self,
+				  FU_UDEV_ACTION_ADD,
+				  fu_udev_device_get_sysfs_path(device_donor),
+				  device_donor);
 	return TRUE;
 }
 
@@ -755,9 +975,12 @@ fu_udev_backend_finalize(GObject *object)
 	FuUdevBackend *self = FU_UDEV_BACKEND(object);
 	if (self->dpaux_devices_rescan_id != 0)
 		g_source_remove(self->dpaux_devices_rescan_id);
+	if (self->pending_events_id != 0)
+		g_source_remove(self->pending_events_id);
 	if (self->netlink_fd > 0)
 		g_close(self->netlink_fd, NULL);
 	g_hash_table_unref(self->changed_idle_ids);
+	g_hash_table_unref(self->pending_events);
 	g_hash_table_unref(self->map_paths);
 	g_ptr_array_unref(self->dpaux_devices);
 	G_OBJECT_CLASS(fu_udev_backend_parent_class)->finalize(object);
@@ -768,6 +991,11 @@ fu_udev_backend_init(FuUdevBackend *self)
 {
 	self->map_paths = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->dpaux_devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->pending_events =
+	    g_hash_table_new_full(g_str_hash,
+				  g_str_equal,
+				  NULL,
+				  (GDestroyNotify)fu_udev_backend_event_free);
 	self->changed_idle_ids =
 	    g_hash_table_new_full(g_str_hash,
 				  g_str_equal,
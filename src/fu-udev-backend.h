@@ -7,9 +7,18 @@
 #pragma once
 
 #include "fu-backend.h"
+#include "fu-engine-struct.h"
+#include "fu-udev-device.h"
 
 #define FU_TYPE_UDEV_BACKEND (fu_udev_backend_get_type())
 G_DECLARE_FINAL_TYPE(FuUdevBackend, fu_udev_backend, FU, UDEV_BACKEND, FuBackend)
 
 FuBackend *
 fu_udev_backend_new(FuContext *ctx) G_GNUC_NON_NULL(1);
+void
+fu_udev_backend_add_event(FuUdevBackend *self,
+			  FuUdevAction action,
+			  const gchar *sysfs_path,
+			  FuUdevDevice *donor) G_GNUC_NON_NULL(1, 3);
+gchar *
+fu_udev_backend_pending_events_to_string(FuUdevBackend *self) G_GNUC_NON_NULL(1);
@@ -25,6 +25,9 @@ struct _FuUsbBackend {
 	guint idle_events_id;
 	guint hotplug_poll_id;
 	guint hotplug_poll_interval;
+	guint rescan_cnt;
+	gint64 rescan_duration_total; /* µs */
+	gint64 rescan_duration_max;   /* µs */
 #endif
 };
 
@@ -34,12 +37,17 @@ G_DEFINE_TYPE(FuUsbBackend, fu_usb_backend, FU_TYPE_BACKEND)
 #define FU_USB_BACKEND_POLL_INTERVAL_WAIT_REPLUG 5    /* ms */
 
 #ifndef HAVE_UDEV
+static gchar *
+fu_usb_backend_build_backend_id(guint8 bus, guint8 address)
+{
+	return g_strdup_printf("%02x:%02x", bus, address);
+}
+
 static gchar *
 fu_usb_backend_get_usb_device_backend_id(libusb_device *usb_device)
 {
-	return g_strdup_printf("%02x:%02x",
-			       libusb_get_bus_number(usb_device),
-			       libusb_get_device_address(usb_device));
+	return fu_usb_backend_build_backend_id(libusb_get_bus_number(usb_device),
+					       libusb_get_device_address(usb_device));
 }
 
 static FuUsbDevice *
@@ -82,34 +90,33 @@ fu_usb_backend_remove_device(FuUsbBackend *self, libusb_device *usb_device)
 static void
 fu_usb_backend_rescan(FuUsbBackend *self)
 {
+	gint64 start;
+	gint64 duration;
 	libusb_device **dev_list = NULL;
-	g_autoptr(GList) existing_devices = NULL;
-	g_autoptr(GPtrArray) devices = fu_backend_get_devices(FU_BACKEND(self));
+	g_autoptr(GHashTable) backend_ids = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
 
 	/* skip actual enumeration */
 	if (g_getenv("FWUPD_SELF_TEST") != NULL)
 		return;
 
-	/* copy to a context so we can remove from the array */
-	for (guint i = 0; i < devices->len; i++) {
-		FuUsbDevice *device = g_ptr_array_index(devices, i);
-		existing_devices = g_list_prepend(existing_devices, device);
+	/* this is expensive, so keep track of how often we have to do it */
+	start = g_get_monotonic_time();
+	libusb_get_device_list(self->ctx, &dev_list);
+	backend_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; dev_list != NULL && dev_list[i] != NULL; i++) {
+		g_hash_table_add(backend_ids,
+				 fu_usb_backend_get_usb_device_backend_id(dev_list[i]));
 	}
 
 	/* look for any removed devices */
-	libusb_get_device_list(self->ctx, &dev_list);
-	for (GList *l = existing_devices; l != NULL; l = l->next) {
-		FuUsbDevice *device = FU_USB_DEVICE(l->data);
-		gboolean found = FALSE;
-		for (guint i = 0; dev_list != NULL && dev_list[i] != NULL; i++) {
-			if (libusb_get_bus_number(dev_list[i]) == fu_usb_device_get_bus(device) &&
-			    libusb_get_device_address(dev_list[i]) ==
-				fu_usb_device_get_address(device)) {
-				found = TRUE;
-				break;
-			}
-		}
-		if (!found)
+	devices = fu_backend_get_devices(FU_BACKEND(self));
+	for (guint i = 0; i < devices->len; i++) {
+		FuUsbDevice *device = g_ptr_array_index(devices, i);
+		g_autofree gchar *backend_id =
+		    fu_usb_backend_build_backend_id(fu_usb_device_get_bus(device),
+						    fu_usb_device_get_address(device));
+		if (!g_hash_table_contains(backend_ids, backend_id))
 			fu_backend_device_removed(FU_BACKEND(self), FU_DEVICE(device));
 	}
 
@@ -118,6 +125,11 @@ fu_usb_backend_rescan(FuUsbBackend *self)
 		fu_usb_backend_add_device(self, dev_list[i]);
 
 	libusb_free_device_list(dev_list, 1);
+
+	duration = g_get_monotonic_time() - start;
+	self->rescan_cnt++;
+	self->rescan_duration_total += duration;
+	self->rescan_duration_max = MAX(self->rescan_duration_max, duration);
 }
 
 static gboolean
@@ -264,6 +276,26 @@ fu_usb_backend_event_thread_cb(gpointer data)
 }
 #endif
 
+#ifndef HAVE_UDEV
+static void
+fu_usb_backend_to_string(FuBackend *backend, guint idt, GString *str)
+{
+	FuUsbBackend *self = FU_USB_BACKEND(backend);
+	fwupd_codec_string_append_int(str,
+				      idt,
+				      "HotplugPollInterval",
+				      self->hotplug_poll_interval);
+	fwupd_codec_string_append_int(str, idt, "RescanCount", self->rescan_cnt);
+	if (self->rescan_cnt > 0) {
+		g_autofree gchar *tmp =
+		    g_strdup_printf("total:%.3fms,max:%.3fms",
+				    (gdouble)self->rescan_duration_total / 1000.f,
+				    (gdouble)self->rescan_duration_max / 1000.f);
+		fwupd_codec_string_append(str, idt, "RescanDuration", tmp);
+	}
+}
+#endif
+
 static gboolean
 fu_usb_backend_setup(FuBackend *backend,
 		     FuBackendSetupFlags flags,
@@ -447,6 +479,7 @@ fu_usb_backend_class_init(FuUsbBackendClass *klass)
 	backend_class->setup = fu_usb_backend_setup;
 #ifndef HAVE_UDEV
 	backend_class->coldplug = fu_usb_backend_coldplug;
+	backend_class->to_string = fu_usb_backend_to_string;
 	backend_class->registered = fu_usb_backend_registered;
 	backend_class->get_device_parent = fu_usb_backend_get_device_parent;
 #endif
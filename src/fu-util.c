@@ -39,6 +39,9 @@
 #define EXIT_NOTHING_TO_DO 2
 #define EXIT_NOT_FOUND	   3
 
+/* more than this just competes for the same bandwidth */
+#define FU_UTIL_DOWNLOAD_PARALLEL_MAX 16
+
 typedef enum {
 	FU_UTIL_OPERATION_UNKNOWN,
 	FU_UTIL_OPERATION_UPDATE,
@@ -622,6 +625,26 @@ fu_util_get_devices(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static void
+fu_util_show_engine_statistics(FuUtilPrivate *priv)
+{
+	guint32 hits = 0;
+	guint32 misses = 0;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GVariant) statistics = NULL;
+
+	/* older daemons do not support this */
+	statistics =
+	    fwupd_client_get_engine_statistics(priv->client, priv->cancellable, &error_local);
+	if (statistics == NULL) {
+		g_debug("failed to get engine statistics: %s", error_local->message);
+		return;
+	}
+	g_variant_lookup(statistics, "ReleasesCacheHits", "u", &hits);
+	g_variant_lookup(statistics, "ReleasesCacheMisses", "u", &misses);
+	g_debug("daemon release cache hit ratio %u/%u", hits, hits + misses);
+}
+
 static gboolean
 fu_util_get_plugins(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -634,8 +657,22 @@ fu_util_get_plugins(FuUtilPrivate *priv, gchar **values, GError **error)
 		return FALSE;
 	if (priv->as_json) {
 		g_autoptr(JsonBuilder) builder = json_builder_new();
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GVariant) statistics = NULL;
+
 		json_builder_begin_object(builder);
 		fwupd_codec_array_to_json(plugins, "Plugins", builder, FWUPD_CODEC_FLAG_TRUSTED);
+
+		/* older daemons do not support this */
+		statistics = fwupd_client_get_plugin_statistics(priv->client,
+								priv->cancellable,
+								&error_local);
+		if (statistics == NULL) {
+			g_debug("failed to get plugin statistics: %s", error_local->message);
+		} else {
+			json_builder_set_member_name(builder, "PluginStatistics");
+			json_builder_add_value(builder, json_gvariant_serialize(statistics));
+		}
 		json_builder_end_object(builder);
 		return fu_util_print_builder(priv->console, builder, error);
 	}
@@ -2746,10 +2783,10 @@ fu_util_prompt_warning_composite(FuUtilPrivate *priv,
 }
 
 static gboolean
-fu_util_update_device_with_release(FuUtilPrivate *priv,
-				   FwupdDevice *dev,
-				   FwupdRelease *rel,
-				   GError **error)
+fu_util_update_device_prompt(FuUtilPrivate *priv,
+			     FwupdDevice *dev,
+			     FwupdRelease *rel,
+			     GError **error)
 {
 	if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE)) {
 		const gchar *name = fwupd_device_get_name(dev);
@@ -2776,6 +2813,17 @@ fu_util_update_device_with_release(FuUtilPrivate *priv,
 		if (!fu_util_prompt_warning_bkc(priv, dev, rel, error))
 			return FALSE;
 	}
+	return TRUE;
+}
+
+static gboolean
+fu_util_update_device_with_release(FuUtilPrivate *priv,
+				   FwupdDevice *dev,
+				   FwupdRelease *rel,
+				   GError **error)
+{
+	if (!fu_util_update_device_prompt(priv, dev, rel, error))
+		return FALSE;
 	return fwupd_client_install_release(priv->client,
 					    dev,
 					    rel,
@@ -2809,14 +2857,55 @@ fu_util_maybe_send_reports(FuUtilPrivate *priv, FwupdRelease *rel, GError **erro
 	return TRUE;
 }
 
+static gboolean
+fu_util_update_device_is_selected(FuUtilPrivate *priv, FwupdDevice *dev, gchar **values)
+{
+	gboolean dev_skip_byid = TRUE;
+
+	/* only process particular DEVICE-ID or GUID if specified */
+	for (guint idx = 0; idx < g_strv_length(values); idx++) {
+		const gchar *tmpid = values[idx];
+		if (fwupd_device_has_guid(dev, tmpid) ||
+		    g_strcmp0(fwupd_device_get_id(dev), tmpid) == 0) {
+			dev_skip_byid = FALSE;
+			break;
+		}
+	}
+	if (g_strv_length(values) > 0 && dev_skip_byid)
+		return FALSE;
+	return fwupd_device_match_flags(dev,
+					priv->filter_device_include,
+					priv->filter_device_exclude);
+}
+
+/* download up front so that flashing is not interleaved with waiting for the network */
+static void
+fu_util_update_prefetch(FuUtilPrivate *priv, GPtrArray *releases)
+{
+	g_autoptr(GError) error_local = NULL;
+
+	/* nothing to gain */
+	if (releases->len < 2)
+		return;
+	if (!fwupd_client_download_releases(priv->client,
+					    releases,
+					    priv->download_flags,
+					    priv->cancellable,
+					    &error_local))
+		g_debug("failed to prefetch releases: %s", error_local->message);
+}
+
 static gboolean
 fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 {
 	gboolean supported = FALSE;
 	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_accepted = g_ptr_array_new();
 	g_autoptr(GPtrArray) devices_latest = g_ptr_array_new();
 	g_autoptr(GPtrArray) devices_pending = g_ptr_array_new();
 	g_autoptr(GPtrArray) devices_unsupported = g_ptr_array_new();
+	g_autoptr(GPtrArray) releases_accepted =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 
 	if (priv->flags & FWUPD_INSTALL_FLAG_ALLOW_OLDER) {
 		g_set_error_literal(error,
@@ -2854,11 +2943,9 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 	g_ptr_array_sort(devices, fu_util_sort_devices_by_flags_cb);
 	for (guint i = 0; i < devices->len; i++) {
 		FwupdDevice *dev = g_ptr_array_index(devices, i);
-		const gchar *device_id = fwupd_device_get_id(dev);
 		g_autoptr(FwupdRelease) rel = NULL;
 		g_autoptr(GPtrArray) rels = NULL;
 		g_autoptr(GError) error_local = NULL;
-		gboolean dev_skip_byid = TRUE;
 
 		/* not going to have results, so save a D-Bus round-trip */
 		if (!fwupd_device_has_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE) &&
@@ -2869,19 +2956,7 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 			continue;
 		}
 
-		/* only process particular DEVICE-ID or GUID if specified */
-		for (guint idx = 0; idx < g_strv_length(values); idx++) {
-			const gchar *tmpid = values[idx];
-			if (fwupd_device_has_guid(dev, tmpid) || g_strcmp0(device_id, tmpid) == 0) {
-				dev_skip_byid = FALSE;
-				break;
-			}
-		}
-		if (g_strv_length(values) > 0 && dev_skip_byid)
-			continue;
-		if (!fwupd_device_match_flags(dev,
-					      priv->filter_device_include,
-					      priv->filter_device_exclude))
+		if (!fu_util_update_device_is_selected(priv, dev, values))
 			continue;
 		supported = TRUE;
 
@@ -2914,7 +2989,35 @@ fu_util_update(FuUtilPrivate *priv, gchar **values, GError **error)
 			continue;
 		}
 
-		if (!fu_util_update_device_with_release(priv, dev, rel, &error_local)) {
+		/* ask before anything gets downloaded */
+		if (!fu_util_update_device_prompt(priv, dev, rel, &error_local)) {
+			if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO)) {
+				g_debug("ignoring %s: %s",
+					fwupd_device_get_id(dev),
+					error_local->message);
+				continue;
+			}
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+		g_ptr_array_add(devices_accepted, dev);
+		g_ptr_array_add(releases_accepted, g_steal_pointer(&rel));
+	}
+
+	/* only the releases the user agreed to */
+	fu_util_update_prefetch(priv, releases_accepted);
+	for (guint i = 0; i < devices_accepted->len; i++) {
+		FwupdDevice *dev = g_ptr_array_index(devices_accepted, i);
+		FwupdRelease *rel = g_ptr_array_index(releases_accepted, i);
+		g_autoptr(GError) error_local = NULL;
+
+		if (!fwupd_client_install_release(priv->client,
+						  dev,
+						  rel,
+						  priv->flags,
+						  priv->download_flags,
+						  priv->cancellable,
+						  &error_local)) {
 			if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO)) {
 				g_debug("ignoring %s: %s",
 					fwupd_device_get_id(dev),
@@ -3956,6 +4059,54 @@ fu_util_security_fix_attr(FuUtilPrivate *priv, FwupdSecurityAttr *attr, GError *
 	return TRUE;
 }
 
+static void
+fu_util_security_print_statistics(FuUtilPrivate *priv)
+{
+	GVariant *stat;
+	GVariantIter iter;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GString) str = g_string_new(NULL);
+	g_autoptr(GVariant) statistics = NULL;
+
+	/* older daemons do not support this */
+	statistics = fwupd_client_get_host_security_statistics(priv->client,
+							       priv->cancellable,
+							       &error_local);
+	if (statistics == NULL) {
+		g_debug("failed to get HSI statistics: %s", error_local->message);
+		return;
+	}
+	g_variant_iter_init(&iter, statistics);
+	while ((stat = g_variant_iter_next_value(&iter))) {
+		const gchar *producer = NULL;
+		guint64 duration = 0;
+		guint32 attr_cnt = 0;
+		gboolean cached = FALSE;
+		gboolean dependent = FALSE;
+
+		g_variant_lookup(stat, "Producer", "&s", &producer);
+		g_variant_lookup(stat, "Duration", "t", &duration);
+		g_variant_lookup(stat, "AttrCount", "u", &attr_cnt);
+		g_variant_lookup(stat, "Cached", "b", &cached);
+		g_variant_lookup(stat, "Dependent", "b", &dependent);
+		g_string_append_printf(str,
+				       "  %-40s %8.1fms  %2u attrs%s%s\n",
+				       producer,
+				       (gdouble)duration / 1000.f,
+				       attr_cnt,
+				       cached ? " (cached)" : "",
+				       dependent ? " (dependent)" : "");
+		g_variant_unref(stat);
+	}
+	if (str->len == 0)
+		return;
+
+	/* TRANSLATORS: how long each plugin or device took to check the host security */
+	fu_console_print_literal(priv->console, _("Host Security Cost:"));
+	g_string_truncate(str, str->len - 1);
+	fu_console_print_literal(priv->console, str->str);
+}
+
 static gboolean
 fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -4021,6 +4172,10 @@ fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 	str = fu_util_security_attrs_to_string(attrs, flags);
 	fu_console_print_literal(priv->console, str);
 
+	/* what it cost to get the attributes */
+	if (g_getenv("FWUPD_VERBOSE") != NULL)
+		fu_util_security_print_statistics(priv);
+
 	/* events */
 	if (events != NULL && events->len > 0) {
 		g_autofree gchar *estr = fu_util_security_events_to_string(events, flags);
@@ -4730,12 +4885,14 @@ main(int argc, char *argv[])
 	gboolean verbose = FALSE;
 	gboolean version = FALSE;
 	guint download_retries = 0;
+	gint download_parallel = 4;
 	g_autoptr(FuUtilPrivate) priv = g_new0(FuUtilPrivate, 1);
 	g_autoptr(GDateTime) dt_now = g_date_time_new_now_utc();
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GError) error_console = NULL;
 	g_autoptr(GPtrArray) cmd_array = fu_util_cmd_array_new();
 	g_autofree gchar *cmd_descriptions = NULL;
+	g_autofree gchar *download_cache_dir = NULL;
 	g_autofree gchar *filter_device = NULL;
 	g_autofree gchar *filter_release = NULL;
 	const GOptionEntry options[] = {
@@ -4763,6 +4920,14 @@ main(int argc, char *argv[])
 	     /* TRANSLATORS: command line option */
 	     N_("Set the download retries for transient errors"),
 	     NULL},
+	    {"download-parallel",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_INT,
+	     &download_parallel,
+	     /* TRANSLATORS: command line option */
+	     N_("Set the number of firmware files to download at the same time"),
+	     NULL},
 	    {"allow-reinstall",
 	     '\0',
 	     0,
@@ -5464,6 +5629,11 @@ main(int argc, char *argv[])
 	priv->client = fwupd_client_new();
 	fwupd_client_set_main_context(priv->client, priv->main_ctx);
 	fwupd_client_download_set_retries(priv->client, download_retries);
+	fwupd_client_download_set_max_parallel(
+	    priv->client,
+	    (guint)CLAMP(download_parallel, 1, FU_UTIL_DOWNLOAD_PARALLEL_MAX));
+	download_cache_dir = g_build_filename(g_get_user_cache_dir(), "fwupd", "downloads", NULL);
+	fwupd_client_download_set_cache_dir(priv->client, download_cache_dir);
 	g_signal_connect(FWUPD_CLIENT(priv->client),
 			 "notify::percentage",
 			 G_CALLBACK(fu_util_client_notify_cb),
@@ -5556,6 +5726,8 @@ main(int argc, char *argv[])
 
 	/* run the specified command */
 	ret = fu_util_cmd_array_run(cmd_array, priv, argv[1], (gchar **)&argv[2], &error);
+	if (verbose)
+		fu_util_show_engine_statistics(priv);
 	if (!ret) {
 #ifdef SUPPORTED_BUILD
 		/* sanity check */